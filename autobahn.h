@@ -3,6 +3,97 @@
 
 #include "autobahn_common.h"
 
+/** @brief Structure holding the pre-computed values of an odd modulus. */
+typedef struct {
+    Bigint* modular;              /**< The modulus N. */
+    Bigint* barrett_pre_computed; /**< floor(W^(2n) / N), for Barrett reduction. */
+    Word* r_square;               /**< R^2 mod N with R = W^n, for converting into Montgomery form. */
+    Word* one;                    /**< R mod N, the Montgomery form of one. */
+    size_t digit_num;             /**< Number of digits n of the modulus. */
+    Word mont_inverse;            /**< -N^(-1) mod W. */
+} ModularContext;
+
+/** @brief Job of a batch modular exponentiation. */
+typedef struct {
+    const Bigint* base;            /**< Base value. */
+    const Bigint* exponent;        /**< Exponent value. */
+    const ModularContext* context; /**< Modular context of an odd modulus. */
+    Bigint* result;                /**< Preallocated result, written in place. */
+    bool exponent_is_public;       /**< Use the variable-time path for public exponents. */
+} ExponentiationJob;
+
+/** @brief Pool of worker threads, defined in autobahn_thread.c. */
+typedef struct ThreadPool ThreadPool;
+
+/** @brief Product tree with contiguous levels, defined in autobahn_tree.c. */
+typedef struct ProductTree ProductTree;
+
+/** @brief Task run by a thread pool for each task index. */
+typedef void (*ThreadTask)(void* argument, size_t task_idx, size_t worker_idx);
+
+/** @brief Operation counted by the profiler of a BI_PROFILE build, an entry point or an inner kernel. */
+typedef enum {
+    PROFILE_ADDITION,                           /**< bigint_addition */
+    PROFILE_SUBTRACTION,                        /**< bigint_subtraction */
+    PROFILE_MULTIPLICATION_TEXTBOOK,            /**< bigint_multiplication_textbook */
+    PROFILE_MULTIPLICATION_KARATSUBA,           /**< bigint_multiplication_karatsuba */
+    PROFILE_SQUARING_TEXTBOOK,                  /**< bigint_squaring_textbook */
+    PROFILE_SQUARING_KARATSUBA,                 /**< bigint_squaring_karatsuba */
+    PROFILE_DIVISION_WORD_LONG,                 /**< bigint_division_word_long */
+    PROFILE_DIVISION_BINARY_LONG,               /**< bigint_division_binary_long */
+    PROFILE_DIVISION_NAIVE,                     /**< bigint_division_naive */
+    PROFILE_REDUCTION_BARRETT_PRE_COMPUTED,     /**< bigint_reduction_barrett_pre_computed */
+    PROFILE_REDUCTION_BARRETT,                  /**< bigint_reduction_barrett */
+    PROFILE_FROM_STRING,                        /**< bigint_from_string */
+    PROFILE_TO_STRING,                          /**< bigint_to_string */
+    PROFILE_SQRTREM,                            /**< bigint_sqrtrem */
+    PROFILE_ROOTREM,                            /**< bigint_rootrem */
+    PROFILE_GCD,                                /**< bigint_gcd */
+    PROFILE_GCDEXT,                             /**< bigint_gcdext */
+    PROFILE_MOD_INVERSE,                        /**< bigint_mod_inverse */
+    PROFILE_MOD_INVERSE_BATCH,                  /**< bigint_mod_inverse_batch */
+    PROFILE_IS_PROBABLE_PRIME,                  /**< bigint_is_probable_prime */
+    PROFILE_NEXT_PRIME,                         /**< bigint_next_prime */
+    PROFILE_RANDOM_PRIME,                       /**< bigint_random_prime */
+    PROFILE_PRODUCT_TREE_NEW,                   /**< bigint_product_tree_new */
+    PROFILE_REMAINDER_TREE,                     /**< bigint_remainder_tree */
+    PROFILE_BATCH_GCD,                          /**< bigint_batch_gcd */
+    PROFILE_MODULAR_CONTEXT_NEW,                /**< bigint_modular_context_new */
+    PROFILE_EXPONENTIATION_LEFT_TO_RIGHT,       /**< bigint_exponentiation_modular_left_to_right */
+    PROFILE_EXPONENTIATION_MONTGOMERY_LADDER,   /**< bigint_exponentiation_modular_montgomery_ladder */
+    PROFILE_EXPONENTIATION_FIXED_WINDOW,        /**< bigint_exponentiation_modular_fixed_window */
+    PROFILE_EXPONENTIATION_WINDOW_CONTEXT,      /**< bigint_exponentiation_modular_fixed_window_context */
+    PROFILE_EXPONENTIATION_PUBLIC,              /**< bigint_exponentiation_modular_public */
+    PROFILE_EXPONENTIATION_BATCH,               /**< bigint_exponentiation_modular_batch */
+    PROFILE_EXPONENTIATION_MULTI_BUFFER,        /**< bigint_exponentiation_modular_multi_buffer */
+    PROFILE_WORDS_ADDITION,                     /**< words_addition kernel */
+    PROFILE_WORDS_SUBTRACTION,                  /**< words_subtraction kernel */
+    PROFILE_WORDS_MULTIPLICATION,               /**< words_multiplication kernel */
+    PROFILE_WORDS_DIVISION,                     /**< words_division kernel */
+    PROFILE_WORDS_RECIPROCAL,                   /**< words_reciprocal kernel */
+    PROFILE_WORDS_REDUCTION_BARRETT,            /**< words_reduction_barrett kernel */
+    PROFILE_WORDS_DIVISION_FAST,                /**< words_division_fast kernel */
+    PROFILE_WORDS_MONTGOMERY_MULTIPLICATION,    /**< words_montgomery_multiplication kernel */
+    PROFILE_WORDS_MONTGOMERY_FINAL_SUBTRACTION, /**< Final conditional subtraction of the Montgomery kernels */
+    PROFILE_WORDS_EXPONENTIATION_FIXED_WINDOW,  /**< words_exponentiation_fixed_window kernel */
+    PROFILE_WORDS_EXPONENTIATION_PUBLIC,        /**< words_exponentiation_public kernel */
+    PROFILE_POINT_NUM                           /**< Number of profiled operations. */
+} ProfilePoint;
+
+/** @brief Counters of one profiled operation. */
+typedef struct {
+    uint64_t call_num;  /**< Calls, recursive calls included. */
+    uint64_t limb_num;  /**< Words of the operands summed over the calls, zero for parsing, trees and batches. */
+    uint64_t cycle_num; /**< Inclusive time of the outermost calls, in TSC cycles or nanoseconds. */
+} ProfileCounter;
+
+/** @brief Profiler counters of every thread added together, since the last reset. */
+typedef struct {
+    ProfileCounter counters[PROFILE_POINT_NUM]; /**< Counters indexed by ProfilePoint. */
+    size_t thread_num;                          /**< Threads that ever recorded, finished threads included. */
+    bool cycles_are_tsc;                        /**< cycle_num counts TSC cycles, otherwise nanoseconds. */
+} ProfileSnapshot;
+
 /** @brief Addition and Subtraction */
 void bigint_addition    (Bigint** result, const Bigint* operand_x, const Bigint* operand_y);
 void bigint_subtraction (Bigint** result, const Bigint* operand_x, const Bigint* operand_y);
@@ -24,8 +115,56 @@ void bigint_division_naive       (Bigint** quotient, Bigint** remainder, const B
 void bigint_reduction_barrett_pre_computed (Bigint** barrett_pre_computed, const Bigint* modular);
 void bigint_reduction_barrett              (Bigint** result, const Bigint* bigint, const Bigint* modular, const Bigint* pre_computed);
 
+/** @brief Radix conversion, bases 2 to 36 */
+ConvertStatus bigint_from_string (Bigint** bigint, const char* string, size_t length, Word base);
+ConvertStatus bigint_to_string   (char* buffer, size_t buffer_length, size_t* string_length, const Bigint* bigint, Word base);
+
+/** @brief Roots */
+void bigint_sqrtrem (Bigint** root, Bigint** remainder, const Bigint* operand);
+void bigint_rootrem (Bigint** root, Bigint** remainder, const Bigint* operand, Word degree);
+
+/** @brief GCD and modular inverse */
+void   bigint_gcd               (Bigint** result, const Bigint* operand_x, const Bigint* operand_y);
+void   bigint_gcdext            (Bigint** gcd, Bigint** coefficient_x, Bigint** coefficient_y, const Bigint* operand_x, const Bigint* operand_y);
+bool   bigint_mod_inverse       (Bigint** result, const Bigint* operand, const Bigint* modular);
+size_t bigint_mod_inverse_batch (Bigint** results, bool* invertible, Bigint* const* operands, size_t count, const ModularContext* context);
+
+/** @brief Prime numbers */
+bool bigint_is_probable_prime (const Bigint* candidate, size_t round_num);
+void bigint_next_prime        (Bigint** result, const Bigint* start, size_t round_num);
+void bigint_random_prime      (Bigint** result, size_t bit_length, bool is_safe, size_t round_num, ThreadPool* pool);
+
+/** @brief Product and remainder trees */
+void bigint_product_tree_new    (ProductTree** tree, Bigint* const* leaves, size_t leaf_num, size_t memory_limit, const char* spill_directory, ThreadPool* pool);
+void bigint_product_tree_delete (ProductTree** tree);
+void bigint_product_tree_root   (Bigint** root, const ProductTree* tree);
+void bigint_remainder_tree      (Bigint** remainders, const ProductTree* tree, const Bigint* value, ThreadPool* pool);
+void bigint_batch_gcd           (Bigint** results, Bigint* const* moduli, size_t count, size_t memory_limit, const char* spill_directory, ThreadPool* pool);
+
+/** @brief Modular context */
+void bigint_modular_context_new    (ModularContext** context, const Bigint* modular);
+void bigint_modular_context_delete (ModularContext** context);
+
 /** @brief Exponentiation */
-void bigint_exponentiation_modular_left_to_right     (Bigint** result, const Bigint* base, const Bigint* exponent, const Bigint* modular);
-void bigint_exponentiation_modular_montgomery_ladder (Bigint** result, const Bigint* base, const Bigint* exponent, const Bigint* modular);
+void bigint_exponentiation_modular_left_to_right          (Bigint** result, const Bigint* base, const Bigint* exponent, const Bigint* modular);
+void bigint_exponentiation_modular_montgomery_ladder      (Bigint** result, const Bigint* base, const Bigint* exponent, const Bigint* modular);
+void bigint_exponentiation_modular_fixed_window           (Bigint** result, const Bigint* base, const Bigint* exponent, const Bigint* modular);
+void bigint_exponentiation_modular_fixed_window_context   (Bigint** result, const Bigint* base, const Bigint* exponent, const ModularContext* context);
+void bigint_exponentiation_modular_public                 (Bigint** result, const Bigint* base, const Bigint* exponent, const ModularContext* context); // public exponent only
+void bigint_exponentiation_modular_batch                  (ThreadPool* pool, ExponentiationJob* jobs, size_t job_num);
+void bigint_exponentiation_modular_multi_buffer           (Bigint** results, Bigint* const* bases, Bigint* const* exponents, Bigint* const* modulars, size_t count);
+
+/** @brief Thread pool */
+void   bigint_thread_pool_new     (ThreadPool** pool, size_t thread_num);
+void   bigint_thread_pool_delete  (ThreadPool** pool);
+size_t bigint_thread_pool_size    (const ThreadPool* pool);
+Word*  bigint_thread_pool_scratch (ThreadPool* pool, size_t worker_idx, size_t word_num);
+void   bigint_thread_pool_run     (ThreadPool* pool, ThreadTask task, void* argument, size_t task_num);
+
+/** @brief Profiler */
+bool        bigint_profile_snapshot   (ProfileSnapshot* snapshot); /**< Adds up the counters of every thread, false if the build does not profile. */
+void        bigint_profile_reset      (void);                      /**< Restarts every counter from zero. */
+bool        bigint_profile_dump       (FILE* stream);              /**< Writes a snapshot in the Prometheus text format, false if the build does not profile. */
+const char* bigint_profile_point_name (ProfilePoint point);        /**< Name of an operation in the metric labels. */
 
 #endif
\ No newline at end of file
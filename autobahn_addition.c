@@ -1,25 +1,8 @@
-#include "autobahn.h"
+#include "autobahn_internal.h"
 
 #pragma warning(disable: 28182)
 #pragma warning(disable: 6308)
 
-/**
- * @brief Perform addition of two words with carry.
- * 
- * @param result [out] - The result of the addition.
- * @param next_carry [out] - The carry to be propagated to the next addition.
- * @param current_carry [in] - The carry from the previous addition.
- * @param operand_x [in] - The first operand.
- * @param operand_y [in] - The second operand.
- */
-static void word_addition_with_carry(Word* result, Word* next_carry, Word current_carry, Word operand_x, Word operand_y) 
-{
-    *result     = operand_x + operand_y;        // Calculate sum: r = x + y
-    *next_carry = (*result < operand_x);        // Set carry if r < x
-    *result     += current_carry;               // Add the carry from the previous addition: r = x + y + c
-    *next_carry += (*result < current_carry);   // Set carry if r < c
-}
-
 /**
  * @brief Perform unsigned addition of two big integers.
  * 
@@ -36,11 +19,11 @@ void bigint_addition_unsigned(Bigint** result, Bigint* operand_x, Bigint* operan
     /* Ensure operands have the same number of digits */      
     if (operand_y->digit_num != operand_x->digit_num)
     {
-        Word previous_digit_num = operand_y->digit_num; 
-        Word new_digit_num = operand_x->digit_num;    
+        size_t previous_digit_num = operand_y->digit_num; 
+        size_t new_digit_num = operand_x->digit_num;    
 
         /* Make same number of digits */
-        operand_y->digits = (Word*)realloc(operand_y->digits, (operand_x->digit_num) * SIZE_OF_WORD);
+        operand_y->digits = (Word*)bigint_realloc(operand_y->digits, (operand_x->digit_num) * SIZE_OF_WORD);
         operand_y->digit_num = new_digit_num;
 
         /* Guard the trash data */
@@ -78,6 +61,8 @@ void bigint_addition_unsigned(Bigint** result, Bigint* operand_x, Bigint* operan
  */
 void bigint_addition(Bigint** result, const Bigint* operand_x, const Bigint* operand_y) 
 {
+    PROFILE_SCOPE(PROFILE_ADDITION, operand_x->digit_num + operand_y->digit_num);
+
     /* Use temporary variables to avoid modifying the input operands */
     Bigint* tmp_x = NULL;
     Bigint* tmp_y = NULL;
@@ -119,4 +104,36 @@ void bigint_addition(Bigint** result, const Bigint* operand_x, const Bigint* ope
     /* Free allocated memory */
     bigint_delete(&tmp_x);
     bigint_delete(&tmp_y);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Adds two arrays: result = X + Y, the result may alias the operands.
+ *
+ * @param result [out] Result of digit_num_x words.
+ * @param operand_x [in] First operand.
+ * @param digit_num_x [in] Number of words of the first operand.
+ * @param operand_y [in] Second operand.
+ * @param digit_num_y [in] Number of words of the second operand, at most digit_num_x.
+ * @return Word Final carry.
+ */
+Word words_addition(Word* result, const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_ADDITION, digit_num_x + digit_num_y);
+
+    Word current_carry = 0;
+    Word next_carry = 0;
+
+    /* Addition word by word with carry */
+    for (size_t idx = 0; idx < digit_num_y; idx++) {
+        word_addition_with_carry(&result[idx], &next_carry, current_carry, operand_x[idx], operand_y[idx]);
+        current_carry = next_carry;
+    }
+
+    /* Propagate the carry */
+    for (size_t idx = digit_num_y; idx < digit_num_x; idx++) {
+        result[idx] = operand_x[idx] + current_carry;
+        current_carry = (result[idx] < current_carry);
+    }
+
+    return current_carry;
+}
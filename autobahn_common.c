@@ -1,15 +1,64 @@
-#include "autobahn_common.h"
+#include "autobahn_internal.h"
 
 #pragma warning(disable: 28182)
 #pragma warning(disable: 6308)
 
+#if defined(BI_MEMORY_STATS) || defined(BI_MEMORY_CACHE)
+    #define MEMORY_HAS_HEADER
+    #define MEMORY_HEADER_SIZE 16      /**< Prefix of every block, keeps the alignment of malloc. */
+    #define MEMORY_CACHE_NONE SIZE_MAX /**< Class of a block that is never cached. */
+
+    /** @brief Prefix of a block. */
+    typedef struct {
+        size_t byte_num;   /**< Bytes requested by the caller. */
+        size_t size_class; /**< Cache class of the block, MEMORY_CACHE_NONE outside the cache. */
+    } MemoryHeader;
+#endif
+
+#if defined(BI_MEMORY_STATS)
+    /** @brief Counters of the whole process, updated with relaxed atomics from any thread. */
+    static MemoryStats memory_stats;
+
+    #define MEMORY_COUNT(counter, value) __atomic_fetch_add(&memory_stats.counter, (value), __ATOMIC_RELAXED)
+#endif
+
+#if defined(BI_MEMORY_CACHE)
+    #include <pthread.h>
+
+    #define MEMORY_CACHE_CLASS_NUM 10 /**< Class of the Bigint header, then powers of two from the smallest digit class. */
+    #define MEMORY_CACHE_BYTE_MIN 16  /**< Capacity of the smallest digit class. */
+    #define MEMORY_CACHE_BYTE_MAX (MEMORY_CACHE_BYTE_MIN << (MEMORY_CACHE_CLASS_NUM - 2)) /**< Capacity of the largest digit class. */
+    #define MEMORY_CACHE_DEPTH 64     /**< Free blocks kept per class and thread, the rest go back to the allocator. */
+
+    /** @brief Free blocks of one thread, linked through their first bytes after the prefix. */
+    typedef struct {
+        unsigned char* heads[MEMORY_CACHE_CLASS_NUM]; /**< First free block of each class. */
+        size_t counts[MEMORY_CACHE_CLASS_NUM];        /**< Free blocks of each class. */
+        bool is_registered;                           /**< The thread exit releases the blocks. */
+    } MemoryCache;
+
+    static pthread_once_t memory_cache_once = PTHREAD_ONCE_INIT;
+    static pthread_key_t memory_cache_key;          /**< Releases the cache of an exiting thread. */
+    static _Thread_local MemoryCache memory_cache;  /**< Cache of the calling thread. */
+#endif
+
+static void* memory_default_alloc(void* user_data, size_t byte_num);
+static void* memory_default_realloc(void* user_data, void* pointer, size_t byte_num);
+static void memory_default_free(void* user_data, void* pointer);
+
+/** @brief Allocator under the library, the C library until bigint_set_memory_functions replaces it. */
+static MemoryAlloc memory_alloc = memory_default_alloc;
+static MemoryRealloc memory_realloc = memory_default_realloc;
+static MemoryFree memory_free = memory_default_free;
+static void* memory_user_data = NULL;
+
 /**
  * @brief Allocates memory for a new Bigint.
  * 
  * @param bigint [out] Pointer to the Bigint.
  * @param new_digit_num [in] Number of digits for the new Bigint.
  */
-void bigint_new(Bigint** bigint, Word new_digit_num)
+void bigint_new(Bigint** bigint, size_t new_digit_num)
 {
     /* Free allocated memory */
     if (*bigint != NULL) 
@@ -20,10 +69,10 @@ void bigint_new(Bigint** bigint, Word new_digit_num)
         new_digit_num = 1;
 
     /* Allocate Bigint */
-    *bigint = (Bigint*)malloc(SIZE_OF_BIGINT);
+    *bigint = (Bigint*)bigint_malloc(SIZE_OF_BIGINT);
     (*bigint)->sign = POSITIVE;
     (*bigint)->digit_num = new_digit_num;
-    (*bigint)->digits = (Word*)calloc(new_digit_num, SIZE_OF_WORD);
+    (*bigint)->digits = (Word*)bigint_calloc(new_digit_num, SIZE_OF_WORD);
 }
 
 /**
@@ -38,8 +87,8 @@ void bigint_delete(Bigint** bigint)
         return;
 
     /* Free memory */
-    free((*bigint)->digits);
-    free(*bigint);
+    bigint_free((*bigint)->digits);
+    bigint_free(*bigint);
 }
 
 /**
@@ -54,7 +103,7 @@ void bigint_refine(Bigint* bigint)
         return;
 
     /* New number of digits */
-    Word new_digit_num = bigint->digit_num;
+    size_t new_digit_num = bigint->digit_num;
 
     /* Calculate the new number of digits */
     while (new_digit_num > 1) {
@@ -69,13 +118,504 @@ void bigint_refine(Bigint* bigint)
 
     /* Refine memory */
     bigint->digit_num = new_digit_num;
-    bigint->digits = (Word*)realloc(bigint->digits, SIZE_OF_WORD * new_digit_num);
+    bigint->digits = (Word*)bigint_realloc(bigint->digits, SIZE_OF_WORD * new_digit_num);
 
     /* Zero is always positive */
     if (bigint_is_zero(bigint)) 
         bigint->sign = POSITIVE;
 }
 
+/**
+ * @brief MemoryAlloc of the C library.
+ *
+ * @param user_data [in] Unused.
+ * @param byte_num [in] Number of bytes.
+ * @return void* Memory, NULL on failure.
+ */
+static void* memory_default_alloc(void* user_data, size_t byte_num)
+{
+    (void)user_data;
+    return malloc(byte_num);
+}
+
+/**
+ * @brief MemoryRealloc of the C library.
+ *
+ * @param user_data [in] Unused.
+ * @param pointer [in] Memory from memory_default_alloc.
+ * @param byte_num [in] New number of bytes.
+ * @return void* Memory, NULL on failure with pointer still valid.
+ */
+static void* memory_default_realloc(void* user_data, void* pointer, size_t byte_num)
+{
+    (void)user_data;
+    return realloc(pointer, byte_num);
+}
+
+/**
+ * @brief MemoryFree of the C library.
+ *
+ * @param user_data [in] Unused.
+ * @param pointer [in] Memory from memory_default_alloc or memory_default_realloc.
+ */
+static void memory_default_free(void* user_data, void* pointer)
+{
+    (void)user_data;
+    free(pointer);
+}
+
+/**
+ * @brief Allocates from the installed memory functions, zeroed with calloc when they are the defaults.
+ *
+ * Below the prefix, the cache and the counters, for library memory that is never given back, such
+ * as the profiler blocks.
+ *
+ * @param byte_num [in] Number of bytes.
+ * @param is_zero [in] True to zero the memory.
+ * @return void* Memory, NULL on failure.
+ */
+void* memory_raw_alloc(size_t byte_num, bool is_zero)
+{
+    if (memory_alloc == memory_default_alloc)
+        return is_zero ? calloc(1, byte_num) : malloc(byte_num);
+
+    void* block = memory_alloc(memory_user_data, byte_num);
+    if (block != NULL && is_zero)
+        memset(block, 0, byte_num);
+    return block;
+}
+
+#if defined(BI_MEMORY_STATS)
+/**
+ * @brief Counts a block of live memory and raises the peak.
+ *
+ * @param byte_num [in] Bytes that became live.
+ */
+static void memory_count_live(uint64_t byte_num)
+{
+    uint64_t live = __atomic_add_fetch(&memory_stats.live_byte_num, byte_num, __ATOMIC_RELAXED);
+    uint64_t peak = __atomic_load_n(&memory_stats.peak_byte_num, __ATOMIC_RELAXED);
+    while (live > peak && !__atomic_compare_exchange_n(&memory_stats.peak_byte_num, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+#endif
+
+#if defined(BI_MEMORY_CACHE)
+/**
+ * @brief Returns the cache class of a request.
+ *
+ * The Bigint header has a class of its own, other requests round up to a power of two.
+ *
+ * @param byte_num [in] Bytes requested by the caller.
+ * @return size_t Class, MEMORY_CACHE_NONE above the largest one.
+ */
+static size_t memory_cache_class(size_t byte_num)
+{
+    if (byte_num == SIZE_OF_BIGINT)
+        return 0;
+    if (byte_num > MEMORY_CACHE_BYTE_MAX)
+        return MEMORY_CACHE_NONE;
+
+    size_t size_class = 1;
+    for (size_t capacity = MEMORY_CACHE_BYTE_MIN; capacity < byte_num; capacity <<= 1)
+        size_class++;
+    return size_class;
+}
+
+/**
+ * @brief Returns the bytes after the prefix of a block of a class.
+ *
+ * @param size_class [in] Cache class.
+ * @param byte_num [in] Bytes requested by the caller, the capacity outside the cache.
+ * @return size_t Capacity of the block.
+ */
+static size_t memory_cache_capacity(size_t size_class, size_t byte_num)
+{
+    if (size_class == MEMORY_CACHE_NONE)
+        return byte_num;
+    if (size_class == 0)
+        return SIZE_OF_BIGINT;
+    return (size_t)MEMORY_CACHE_BYTE_MIN << (size_class - 1);
+}
+
+/**
+ * @brief Gives every block of a cache back to the memory functions.
+ *
+ * Also the destructor of memory_cache_key, so the blocks of an exiting thread are not lost.
+ *
+ * @param cache [in] Cache of the calling thread.
+ */
+static void memory_cache_release(void* cache)
+{
+    MemoryCache* thread_cache = (MemoryCache*)cache;
+
+    for (size_t size_class = 0; size_class < MEMORY_CACHE_CLASS_NUM; size_class++) {
+        while (thread_cache->heads[size_class] != NULL) {
+            unsigned char* block = thread_cache->heads[size_class];
+            thread_cache->heads[size_class] = *(unsigned char**)(block + MEMORY_HEADER_SIZE);
+            memory_free(memory_user_data, block);
+        }
+        thread_cache->counts[size_class] = 0;
+    }
+    thread_cache->is_registered = false;
+}
+
+/** @brief Creates the key that releases caches at thread exit. */
+static void memory_cache_key_init(void)
+{
+    pthread_key_create(&memory_cache_key, memory_cache_release);
+}
+
+/**
+ * @brief Takes a free block of a class from the cache of the calling thread.
+ *
+ * @param size_class [in] Cache class.
+ * @return unsigned char* Block with its prefix, NULL if the class is empty.
+ */
+static unsigned char* memory_cache_pop(size_t size_class)
+{
+    if (size_class == MEMORY_CACHE_NONE || memory_cache.heads[size_class] == NULL)
+        return NULL;
+
+    unsigned char* block = memory_cache.heads[size_class];
+    memory_cache.heads[size_class] = *(unsigned char**)(block + MEMORY_HEADER_SIZE);
+    memory_cache.counts[size_class]--;
+    return block;
+}
+
+/**
+ * @brief Keeps a freed block in the cache of the calling thread.
+ *
+ * @param block [in] Block with its prefix.
+ * @return bool True if the cache took the block, false if its class is full or it has none.
+ */
+static bool memory_cache_push(unsigned char* block)
+{
+    size_t size_class = ((MemoryHeader*)block)->size_class;
+    if (size_class == MEMORY_CACHE_NONE || memory_cache.counts[size_class] == MEMORY_CACHE_DEPTH)
+        return false;
+
+    /* First block of the thread, release the cache at its exit */
+    if (!memory_cache.is_registered) {
+        pthread_once(&memory_cache_once, memory_cache_key_init);
+        pthread_setspecific(memory_cache_key, &memory_cache);
+        memory_cache.is_registered = true;
+    }
+
+    *(unsigned char**)(block + MEMORY_HEADER_SIZE) = memory_cache.heads[size_class];
+    memory_cache.heads[size_class] = block;
+    memory_cache.counts[size_class]++;
+    return true;
+}
+#endif
+
+#if defined(MEMORY_HAS_HEADER)
+/**
+ * @brief Allocates a block with its prefix, from the cache of the calling thread when it has one.
+ *
+ * @param byte_num [in] Bytes requested by the caller.
+ * @param is_zero [in] True to zero the requested bytes.
+ * @return void* Memory after the prefix, NULL on failure.
+ */
+static void* memory_block_new(size_t byte_num, bool is_zero)
+{
+    if (byte_num > SIZE_MAX - MEMORY_HEADER_SIZE)
+        return NULL;
+
+#if defined(BI_MEMORY_CACHE)
+    size_t size_class = memory_cache_class(byte_num);
+    unsigned char* block = memory_cache_pop(size_class);
+    if (block != NULL && is_zero)
+        memset(block + MEMORY_HEADER_SIZE, 0, byte_num);
+    else if (block == NULL)
+        block = (unsigned char*)memory_raw_alloc(MEMORY_HEADER_SIZE + memory_cache_capacity(size_class, byte_num), is_zero);
+#else
+    size_t size_class = MEMORY_CACHE_NONE;
+    unsigned char* block = (unsigned char*)memory_raw_alloc(MEMORY_HEADER_SIZE + byte_num, is_zero);
+#endif
+    if (block == NULL)
+        return NULL;
+
+    ((MemoryHeader*)block)->byte_num = byte_num;
+    ((MemoryHeader*)block)->size_class = size_class;
+#if defined(BI_MEMORY_STATS)
+    MEMORY_COUNT(allocated_byte_num, byte_num);
+    memory_count_live(byte_num);
+#endif
+    return block + MEMORY_HEADER_SIZE;
+}
+
+/**
+ * @brief Frees a block with its prefix, into the cache of the calling thread when it has room.
+ *
+ * @param pointer [in] Memory after the prefix.
+ */
+static void memory_block_delete(void* pointer)
+{
+    unsigned char* block = (unsigned char*)pointer - MEMORY_HEADER_SIZE;
+
+#if defined(BI_MEMORY_STATS)
+    __atomic_sub_fetch(&memory_stats.live_byte_num, ((MemoryHeader*)block)->byte_num, __ATOMIC_RELAXED);
+#endif
+#if defined(BI_MEMORY_CACHE)
+    if (memory_cache_push(block))
+        return;
+#endif
+    memory_free(memory_user_data, block);
+}
+
+/**
+ * @brief Resizes a block with its prefix, in place while the size stays in its cache class.
+ *
+ * @param pointer [in] Memory after the prefix.
+ * @param byte_num [in] New number of bytes.
+ * @return void* Memory after the prefix, NULL on failure with pointer still valid.
+ */
+static void* memory_block_resize(void* pointer, size_t byte_num)
+{
+    unsigned char* block = (unsigned char*)pointer - MEMORY_HEADER_SIZE;
+    size_t old_byte_num = ((MemoryHeader*)block)->byte_num;
+
+#if defined(BI_MEMORY_CACHE)
+    size_t size_class = memory_cache_class(byte_num);
+    if (size_class != ((MemoryHeader*)block)->size_class) {
+        /* Moves between classes, counted as a new block and a freed one */
+        void* moved = memory_block_new(byte_num, false);
+        if (moved == NULL)
+            return NULL;
+        memcpy(moved, pointer, old_byte_num < byte_num ? old_byte_num : byte_num);
+        memory_block_delete(pointer);
+        return moved;
+    }
+    if (size_class == MEMORY_CACHE_NONE)
+#endif
+    {
+        if (byte_num > SIZE_MAX - MEMORY_HEADER_SIZE)
+            return NULL;
+        block = (unsigned char*)memory_realloc(memory_user_data, block, MEMORY_HEADER_SIZE + byte_num);
+        if (block == NULL)
+            return NULL;
+    }
+
+    ((MemoryHeader*)block)->byte_num = byte_num;
+#if defined(BI_MEMORY_STATS)
+    /* Only the size difference changes the live bytes */
+    __atomic_sub_fetch(&memory_stats.live_byte_num, old_byte_num, __ATOMIC_RELAXED);
+    MEMORY_COUNT(allocated_byte_num, byte_num);
+    memory_count_live(byte_num);
+#endif
+    return block + MEMORY_HEADER_SIZE;
+}
+#endif
+
+/**
+ * @brief Allocates library memory.
+ *
+ * Every allocation of the library goes through these four functions, so the memory functions set by
+ * bigint_set_memory_functions see all of it, a BI_MEMORY_STATS build counts calls and bytes, and a
+ * BI_MEMORY_CACHE build serves small blocks from its free lists. Memory from them must be freed with
+ * bigint_free and never with free.
+ *
+ * @param byte_num [in] Number of bytes.
+ * @return void* Memory, NULL on failure.
+ */
+void* bigint_malloc(size_t byte_num)
+{
+#if defined(MEMORY_HAS_HEADER)
+#if defined(BI_MEMORY_STATS)
+    MEMORY_COUNT(malloc_num, 1);
+#endif
+    return memory_block_new(byte_num, false);
+#else
+    return memory_alloc(memory_user_data, byte_num);
+#endif
+}
+
+/**
+ * @brief Allocates zeroed library memory.
+ *
+ * @param count [in] Number of elements.
+ * @param byte_num [in] Bytes per element.
+ * @return void* Memory, NULL on failure or overflow.
+ */
+void* bigint_calloc(size_t count, size_t byte_num)
+{
+#if defined(BI_MEMORY_STATS)
+    MEMORY_COUNT(calloc_num, 1);
+#endif
+    if (byte_num != 0 && count > SIZE_MAX / byte_num)
+        return NULL;
+
+#if defined(MEMORY_HAS_HEADER)
+    return memory_block_new(count * byte_num, true);
+#else
+    return memory_raw_alloc(count * byte_num, true);
+#endif
+}
+
+/**
+ * @brief Resizes library memory, keeping the contents up to the smaller size.
+ *
+ * @param pointer [in] Memory from the library allocators, or NULL.
+ * @param byte_num [in] New number of bytes.
+ * @return void* Memory, NULL on failure with pointer still valid.
+ */
+void* bigint_realloc(void* pointer, size_t byte_num)
+{
+#if defined(MEMORY_HAS_HEADER)
+#if defined(BI_MEMORY_STATS)
+    MEMORY_COUNT(realloc_num, 1);
+#endif
+    if (pointer == NULL)
+        return memory_block_new(byte_num, false);
+    return memory_block_resize(pointer, byte_num);
+#else
+    if (pointer == NULL)
+        return memory_alloc(memory_user_data, byte_num);
+    return memory_realloc(memory_user_data, pointer, byte_num);
+#endif
+}
+
+/**
+ * @brief Frees library memory.
+ *
+ * @param pointer [in] Memory from the library allocators, or NULL.
+ */
+void bigint_free(void* pointer)
+{
+    if (pointer == NULL)
+        return;
+
+#if defined(MEMORY_HAS_HEADER)
+#if defined(BI_MEMORY_STATS)
+    MEMORY_COUNT(free_num, 1);
+#endif
+    memory_block_delete(pointer);
+#else
+    memory_free(memory_user_data, pointer);
+#endif
+}
+
+/**
+ * @brief Replaces the memory functions under every allocation of the library, like mp_set_memory_functions of GMP.
+ *
+ * Call it before the library allocates, or after every Bigint, context, tree and ThreadPool is freed:
+ * memory is always given back to the functions that allocated it. A live pool holds its structures and
+ * the caches of its workers, so the call is refused while one exists. The cache of the calling thread is
+ * released first in a BI_MEMORY_CACHE build, other threads must call bigint_memory_cache_flush themselves.
+ * realloc_function is never called with NULL, and free_function never with NULL.
+ *
+ * @param alloc_function [in] Allocates bytes, NULL with the other two for the C library.
+ * @param realloc_function [in] Resizes memory from alloc_function, keeping the contents.
+ * @param free_function [in] Frees memory from alloc_function or realloc_function.
+ * @param user_data [in] First argument of every call, such as a pool or a NUMA node.
+ */
+void bigint_set_memory_functions(MemoryAlloc alloc_function, MemoryRealloc realloc_function, MemoryFree free_function, void* user_data)
+{
+    /* Invalid Case */
+    if ((alloc_function == NULL) != (realloc_function == NULL) || (alloc_function == NULL) != (free_function == NULL)) {
+        printf("Invalid Case: Memory functions must all be set or all be NULL\n");
+        return;
+    }
+    if (thread_pool_live_num() != 0) {
+        printf("Invalid Case: Memory functions cannot change while a thread pool is live\n");
+        return;
+    }
+
+    bigint_memory_cache_flush();
+
+    if (alloc_function == NULL) {
+        alloc_function = memory_default_alloc;
+        realloc_function = memory_default_realloc;
+        free_function = memory_default_free;
+        user_data = NULL;
+    }
+
+    memory_alloc = alloc_function;
+    memory_realloc = realloc_function;
+    memory_free = free_function;
+    memory_user_data = user_data;
+}
+
+/**
+ * @brief Reads the memory functions under the library, the C library ones when none are set.
+ *
+ * A replacement can wrap the functions read before it is set, to count or to log every call.
+ *
+ * @param alloc_function [out] Allocation function, or NULL to skip.
+ * @param realloc_function [out] Resize function, or NULL to skip.
+ * @param free_function [out] Free function, or NULL to skip.
+ * @param user_data [out] User data of the functions, or NULL to skip.
+ */
+void bigint_get_memory_functions(MemoryAlloc* alloc_function, MemoryRealloc* realloc_function, MemoryFree* free_function, void** user_data)
+{
+    if (alloc_function != NULL)
+        *alloc_function = memory_alloc;
+    if (realloc_function != NULL)
+        *realloc_function = memory_realloc;
+    if (free_function != NULL)
+        *free_function = memory_free;
+    if (user_data != NULL)
+        *user_data = memory_user_data;
+}
+
+/**
+ * @brief Gives the free blocks cached by the calling thread back to the memory functions.
+ *
+ * Threads release their cache when they exit, so only long-lived threads need it, for instance before
+ * measuring their footprint. Nothing to do without BI_MEMORY_CACHE.
+ */
+void bigint_memory_cache_flush(void)
+{
+#if defined(BI_MEMORY_CACHE)
+    memory_cache_release(&memory_cache);
+#endif
+}
+
+/**
+ * @brief Reads the memory counters.
+ *
+ * Deltas of two reads around a call give its allocations, bytes and copies.
+ *
+ * @param stats [out] Counters, zero if the build does not count.
+ * @return bool true in a BI_MEMORY_STATS build, false otherwise.
+ */
+bool bigint_memory_stats(MemoryStats* stats)
+{
+#if defined(BI_MEMORY_STATS)
+    stats->malloc_num = __atomic_load_n(&memory_stats.malloc_num, __ATOMIC_RELAXED);
+    stats->calloc_num = __atomic_load_n(&memory_stats.calloc_num, __ATOMIC_RELAXED);
+    stats->realloc_num = __atomic_load_n(&memory_stats.realloc_num, __ATOMIC_RELAXED);
+    stats->free_num = __atomic_load_n(&memory_stats.free_num, __ATOMIC_RELAXED);
+    stats->allocated_byte_num = __atomic_load_n(&memory_stats.allocated_byte_num, __ATOMIC_RELAXED);
+    stats->live_byte_num = __atomic_load_n(&memory_stats.live_byte_num, __ATOMIC_RELAXED);
+    stats->peak_byte_num = __atomic_load_n(&memory_stats.peak_byte_num, __ATOMIC_RELAXED);
+    stats->copy_num = __atomic_load_n(&memory_stats.copy_num, __ATOMIC_RELAXED);
+    stats->copy_byte_num = __atomic_load_n(&memory_stats.copy_byte_num, __ATOMIC_RELAXED);
+    return true;
+#else
+    memset(stats, 0, sizeof(MemoryStats));
+    return false;
+#endif
+}
+
+/**
+ * @brief Zeroes the memory counters. The live bytes stay, and the peak restarts from them.
+ */
+void bigint_memory_stats_reset(void)
+{
+#if defined(BI_MEMORY_STATS)
+    __atomic_store_n(&memory_stats.malloc_num, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&memory_stats.calloc_num, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&memory_stats.realloc_num, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&memory_stats.free_num, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&memory_stats.allocated_byte_num, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&memory_stats.peak_byte_num, __atomic_load_n(&memory_stats.live_byte_num, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&memory_stats.copy_num, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&memory_stats.copy_byte_num, 0, __ATOMIC_RELAXED);
+#endif
+}
+
 /**
  * @brief Sets the value of a Bigint from an array of Words.
  * 
@@ -84,7 +624,7 @@ void bigint_refine(Bigint* bigint)
  * @param sign [in] Sign of the value.
  * @param digit_num [in] Number of digits.
  */
-void bigint_set_by_array(Bigint** bigint, const Word* array, Sign sign, Word digit_num)
+void bigint_set_by_array(Bigint** bigint, const Word* array, Sign sign, size_t digit_num)
 {
     /* Allocate Bigint */
     bigint_new(bigint, digit_num); 
@@ -93,10 +633,263 @@ void bigint_set_by_array(Bigint** bigint, const Word* array, Sign sign, Word dig
     (*bigint)->sign = sign; 
     
     /* Copy */
-    for (int digit_idx = 0; digit_idx < digit_num; digit_idx++) 
+    for (size_t digit_idx = 0; digit_idx < digit_num; digit_idx++) 
         (*bigint)->digits[digit_idx] = array[digit_idx];
 }
 
+/** @brief Hex digit plus one of each character, zero for characters that are not hex digits. */
+static const unsigned char hex_decode_table[256] = {
+    ['0'] = 1,  ['1'] = 2,  ['2'] = 3,  ['3'] = 4,  ['4'] = 5,  ['5'] = 6,  ['6'] = 7,  ['7'] = 8,
+    ['8'] = 9,  ['9'] = 10, ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16
+};
+
+#define HEX_CHUNK_CHARS 8                      /**< Characters converted at once, one 32-bit chunk. */
+#define HEX_BYTES(byte) (0x0101010101010101ULL * (byte))
+
+/**
+ * @brief Loads eight characters so that byte k holds the character of nibble k, the last character in byte 0.
+ *
+ * @param string [in] Eight characters, most significant first.
+ * @return uint64_t The characters, one per byte.
+ */
+static uint64_t hex_load(const char* string)
+{
+    uint64_t chars;
+    memcpy(&chars, string, sizeof(chars));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    chars = __builtin_bswap64(chars);
+#endif
+    return chars;
+}
+
+/**
+ * @brief Decodes eight hex characters into 32 bits, all eight characters in parallel.
+ *
+ * @param chunk [out] Value of the characters.
+ * @param string [in] Eight characters, most significant first.
+ * @return bool true if every character is a hex digit.
+ */
+static bool hex_decode_chunk(uint32_t* chunk, const char* string)
+{
+    uint64_t chars = hex_load(string);
+    uint64_t lower = chars | HEX_BYTES(0x20);
+
+    /* Range checks on every byte: the high bit of c + (0x80 - lo) is set iff c >= lo */
+    uint64_t is_digit = (chars + HEX_BYTES(0x80 - '0')) & ~(chars + HEX_BYTES(0x7F - '9'));
+    uint64_t is_alpha = (lower + HEX_BYTES(0x80 - 'a')) & ~(lower + HEX_BYTES(0x7F - 'f'));
+    is_digit &= HEX_BYTES(0x80);
+    is_alpha &= HEX_BYTES(0x80);
+
+    /* Non-ASCII bytes would carry into their neighbour, reject them first */
+    if ((chars & HEX_BYTES(0x80)) != 0 || (is_digit | is_alpha) != HEX_BYTES(0x80))
+        return false;
+
+    /* '0'-'9' -> c & 0xF, 'a'-'f' and 'A'-'F' -> (c & 0xF) + 9 */
+    uint64_t nibbles = (chars & HEX_BYTES(0x0F)) + (is_alpha >> 7) * 9;
+
+    /* Gather the nibbles: 8 bytes -> 4 bytes -> 2 half words -> 1 word */
+    nibbles = (nibbles | (nibbles >> 4)) & 0x00FF00FF00FF00FFULL;
+    nibbles = (nibbles | (nibbles >> 8)) & 0x0000FFFF0000FFFFULL;
+    nibbles = (nibbles | (nibbles >> 16)) & 0x00000000FFFFFFFFULL;
+
+    *chunk = (uint32_t)nibbles;
+    return true;
+}
+
+/**
+ * @brief Encodes 32 bits into eight lowercase hex characters, all eight nibbles in parallel.
+ *
+ * @param string [out] Eight characters, most significant first, not terminated.
+ * @param chunk [in] Value to encode.
+ */
+static void hex_encode_chunk(char* string, uint32_t chunk)
+{
+    /* Spread the nibbles: nibble k goes to byte k */
+    uint64_t nibbles = chunk;
+    nibbles = ((nibbles & 0x00000000FFFF0000ULL) << 16) | (nibbles & 0x000000000000FFFFULL);
+    nibbles = ((nibbles & 0x0000FF000000FF00ULL) << 8) | (nibbles & 0x000000FF000000FFULL);
+    nibbles = ((nibbles & 0x00F000F000F000F0ULL) << 4) | (nibbles & 0x000F000F000F000FULL);
+
+    /* 0-9 -> '0'-'9', 10-15 -> 'a'-'f' */
+    uint64_t is_alpha = ((nibbles + HEX_BYTES(0x06)) >> 4) & HEX_BYTES(0x01);
+    uint64_t chars = nibbles + HEX_BYTES('0') + is_alpha * ('a' - '0' - 10);
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    chars = __builtin_bswap64(chars);
+#endif
+    memcpy(string, &chars, sizeof(chars));
+}
+
+/**
+ * @brief Returns the 32-bit chunk chunk_idx of a word array, zero past its end.
+ *
+ * @param digits [in] Word array.
+ * @param digit_num [in] Number of words.
+ * @param chunk_idx [in] Index of the chunk, chunk 0 is the least significant.
+ * @return uint32_t Bits [32 * chunk_idx, 32 * chunk_idx + 32).
+ */
+static uint32_t hex_get_chunk(const Word* digits, size_t digit_num, size_t chunk_idx)
+{
+    uint32_t chunk = 0;
+    size_t bit_idx = chunk_idx * 32;
+
+    for (size_t part = 0; part < 32; part += BITLEN_OF_WORD < 32 ? BITLEN_OF_WORD : 32) {
+        size_t digit_idx = (bit_idx + part) / BITLEN_OF_WORD;
+        if (digit_idx >= digit_num)
+            break;
+        chunk |= (uint32_t)(digits[digit_idx] >> ((bit_idx + part) % BITLEN_OF_WORD)) << part;
+    }
+
+    return chunk;
+}
+
+/**
+ * @brief Stores a 32-bit chunk into a zeroed word array, dropping the bits past its end.
+ *
+ * @param digits [in, out] Word array.
+ * @param digit_num [in] Number of words.
+ * @param chunk_idx [in] Index of the chunk, chunk 0 is the least significant.
+ * @param chunk [in] Bits [32 * chunk_idx, 32 * chunk_idx + 32).
+ */
+static void hex_put_chunk(Word* digits, size_t digit_num, size_t chunk_idx, uint32_t chunk)
+{
+    size_t bit_idx = chunk_idx * 32;
+
+    for (size_t part = 0; part < 32; part += BITLEN_OF_WORD < 32 ? BITLEN_OF_WORD : 32) {
+        size_t digit_idx = (bit_idx + part) / BITLEN_OF_WORD;
+        if (digit_idx >= digit_num)
+            break;
+        digits[digit_idx] |= (Word)(chunk >> part) << ((bit_idx + part) % BITLEN_OF_WORD);
+    }
+}
+
+/**
+ * @brief Sets the value of a Bigint from a hexadecimal string.
+ *
+ * The string is an optional '-' followed by hex digits of either case, it does not need to be
+ * terminated. On error the Bigint is left unchanged.
+ *
+ * @param bigint [out] Pointer to the destination Bigint.
+ * @param string [in] Hexadecimal string representing the value.
+ * @param length [in] Number of characters in the string.
+ * @return ConvertStatus CONVERT_OK, CONVERT_EMPTY or CONVERT_INVALID_CHARACTER.
+ */
+ConvertStatus bigint_from_hex(Bigint** bigint, const char* string, size_t length)
+{
+    /* Sign prefix */
+    Sign sign = POSITIVE;
+    if (length > 0 && string[0] == '-') {
+        sign = NEGATIVE;
+        string++;
+        length--;
+    }
+
+    if (length == 0)
+        return CONVERT_EMPTY;
+
+    /* Skip leading zeros, so the Bigint is allocated at its final size */
+    size_t zero_num = 0;
+    while (zero_num < length - 1 && string[zero_num] == '0')
+        zero_num++;
+    string += zero_num;
+    length -= zero_num;
+
+    size_t new_digit_num = (length + SIZE_OF_WORD * 2 - 1) / (SIZE_OF_WORD * 2);
+
+    /* Decode into a temporary array first, the Bigint is only replaced on success */
+    Word* digits = (Word*)bigint_calloc(new_digit_num, SIZE_OF_WORD);
+    size_t chunk_num = length / HEX_CHUNK_CHARS;
+    size_t head_length = length % HEX_CHUNK_CHARS;
+
+    /* Full chunks, from the least significant end */
+    for (size_t chunk_idx = 0; chunk_idx < chunk_num; chunk_idx++) {
+        uint32_t chunk;
+        if (hex_decode_chunk(&chunk, string + length - (chunk_idx + 1) * HEX_CHUNK_CHARS) == false) {
+            bigint_free(digits);
+            return CONVERT_INVALID_CHARACTER;
+        }
+        hex_put_chunk(digits, new_digit_num, chunk_idx, chunk);
+    }
+
+    /* Leading partial chunk, one character at a time */
+    uint32_t head = 0;
+    unsigned char invalid = 0;
+    for (size_t str_idx = 0; str_idx < head_length; str_idx++) {
+        unsigned char nibble = hex_decode_table[(unsigned char)string[str_idx]] - 1; // 0xFF if invalid
+        invalid |= nibble & 0xF0;
+        head = (head << 4) | (nibble & 0x0F);
+    }
+    if (invalid != 0) {
+        bigint_free(digits);
+        return CONVERT_INVALID_CHARACTER;
+    }
+    hex_put_chunk(digits, new_digit_num, chunk_num, head);
+
+    /* Replace the Bigint */
+    bigint_new(bigint, 1);
+    bigint_free((*bigint)->digits);
+    (*bigint)->digits = digits;
+    (*bigint)->digit_num = new_digit_num;
+    (*bigint)->sign = bigint_is_zero(*bigint) ? POSITIVE : sign;
+
+    return CONVERT_OK;
+}
+
+/**
+ * @brief Writes the hexadecimal representation of a Bigint into a caller buffer.
+ *
+ * The output is lowercase without leading zeros, prefixed by '-' if negative, and terminated.
+ * If the buffer is too small nothing is written and string_length receives the required length.
+ *
+ * @param buffer [out] Destination buffer, may be NULL if buffer_length is 0.
+ * @param buffer_length [in] Size of the buffer, including the terminating null.
+ * @param string_length [out] Length of the string without the terminating null, may be NULL.
+ * @param bigint [in] Pointer to the Bigint.
+ * @return ConvertStatus CONVERT_OK or CONVERT_BUFFER_TOO_SMALL.
+ */
+ConvertStatus bigint_to_hex(char* buffer, size_t buffer_length, size_t* string_length, const Bigint* bigint)
+{
+    /* Significant words */
+    size_t digit_num = bigint->digit_num;
+    while (digit_num > 1 && bigint->digits[digit_num - 1] == 0)
+        digit_num--;
+
+    /* Significant characters */
+    size_t chunk_num = (digit_num * BITLEN_OF_WORD + 31) / 32;
+    uint32_t top = hex_get_chunk(bigint->digits, digit_num, chunk_num - 1);
+    while (chunk_num > 1 && top == 0)
+        top = hex_get_chunk(bigint->digits, digit_num, --chunk_num - 1);
+    size_t top_length = 1;
+    while (top_length < HEX_CHUNK_CHARS && (top >> (4 * top_length)) != 0)
+        top_length++;
+
+    bool is_negative = bigint->sign == NEGATIVE && !(digit_num == 1 && bigint->digits[0] == 0);
+    size_t length = is_negative + top_length + (chunk_num - 1) * HEX_CHUNK_CHARS;
+    if (string_length != NULL)
+        *string_length = length;
+
+    /* Error check : room for the string and its terminating null */
+    if (buffer_length <= length)
+        return CONVERT_BUFFER_TOO_SMALL;
+
+    /* Sign and the most significant chunk without leading zeros */
+    char* out = buffer;
+    if (is_negative)
+        *out++ = '-';
+    char top_chars[HEX_CHUNK_CHARS];
+    hex_encode_chunk(top_chars, top);
+    memcpy(out, top_chars + HEX_CHUNK_CHARS - top_length, top_length);
+    out += top_length;
+
+    /* Remaining chunks, eight characters each */
+    for (size_t chunk_idx = chunk_num - 1; chunk_idx-- > 0; out += HEX_CHUNK_CHARS)
+        hex_encode_chunk(out, hex_get_chunk(bigint->digits, digit_num, chunk_idx));
+    *out = '\0';
+
+    return CONVERT_OK;
+}
+
 /**
  * @brief Sets the value of a Bigint from a hexadecimal string.
  * 
@@ -106,53 +899,235 @@ void bigint_set_by_array(Bigint** bigint, const Word* array, Sign sign, Word dig
  */
 void bigint_set_by_hex_string(Bigint** bigint, const char* string, Sign sign)
 {
-    /* Get length of string and new digit number */
-    int length_string = (int)strlen(string);
-    Word new_digit_num = (length_string / (SIZE_OF_WORD * 2)) + (length_string % (SIZE_OF_WORD * 2) != 0);
-
     /* Error check : string is not hex format */
-    for (int str_idx = 0; str_idx < length_string; str_idx++) 
-    {
-	    if (!(('0'<=string[str_idx] && string[str_idx] <='9') || 
-              ('a'<=string[str_idx] && string[str_idx] <='f') || 
-              ('A'<=string[str_idx] && string[str_idx] <='F'))) {
-		    printf("%d-th character is invalid. Do not use %c.", str_idx, string[str_idx]);
-		    exit(1);
-	    }
+    if (bigint_from_hex(bigint, string, strlen(string)) != CONVERT_OK) {
+        printf("Invalid Case: String is not hex format.\n");
+        return;
     }
 
-    /* Allocate Bigint */
-    bigint_new(bigint, new_digit_num);
-    (*bigint)->sign = sign;
+    /* Set sign, zero is always positive */
+    if (sign == NEGATIVE && !bigint_is_zero(*bigint))
+        (*bigint)->sign = NEGATIVE;
+}
 
-    /* String to Bigint */
-    for (Word idx = 0; idx < new_digit_num; idx++) 
-    {
-        /* Char to int */
-        for (Word idx_4bit = 0; idx_4bit < BITLEN_OF_WORD; idx_4bit += 4)
-        {
-            char char_1byte = string[--length_string];
-            Word int_4bit = 0;
-
-            /* One byte char to 4-bits int */
-            if ('0' <= char_1byte && char_1byte <= '9') 
-                int_4bit = char_1byte - '0';
-            if ('A' <= char_1byte && char_1byte <= 'F') 
-                int_4bit = char_1byte - 'A' + 10;
-            if ('a' <= char_1byte && char_1byte <= 'f') 
-                int_4bit = char_1byte - 'a' + 10;
-
-            /* Fill in the digit */
-            (*bigint)->digits[idx] += int_4bit << idx_4bit;
-
-            /* String is gone */
-            if (length_string == 0) 
-                break;
+/* Byte order of a word loaded from memory */
+#if defined(BI_WORD8)
+    #define WORD_BYTE_SWAP(word) (word)
+#elif defined(BI_WORD64)
+    #define WORD_BYTE_SWAP(word) __builtin_bswap64(word)
+#else
+    #define WORD_BYTE_SWAP(word) __builtin_bswap32(word)
+#endif
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    #define WORD_FROM_LE(word) (word)
+    #define WORD_FROM_BE(word) WORD_BYTE_SWAP(word)
+#else
+    #define WORD_FROM_LE(word) WORD_BYTE_SWAP(word)
+    #define WORD_FROM_BE(word) (word)
+#endif
+
+/**
+ * @brief Sets the value of a Bigint from an octet string, OS2IP for big-endian input.
+ *
+ * Full words are loaded at once and byte-swapped if needed, the partial top word byte by byte.
+ *
+ * @param bigint [out] Pointer to the destination Bigint, non-negative.
+ * @param bytes [in] Octet string, may be NULL if length is 0.
+ * @param length [in] Number of bytes, an empty string is zero.
+ * @param is_big_endian [in] true if the most significant byte comes first.
+ * @return ConvertStatus CONVERT_OK.
+ */
+static ConvertStatus bigint_from_bytes(Bigint** bigint, const unsigned char* bytes, size_t length, bool is_big_endian)
+{
+    /* Skip leading zero bytes, so the Bigint is allocated at its final size */
+    while (length > 0 && bytes[is_big_endian ? 0 : length - 1] == 0) {
+        bytes += is_big_endian;
+        length--;
+    }
+
+    size_t new_digit_num = (length + SIZE_OF_WORD - 1) / SIZE_OF_WORD;
+    bigint_new(bigint, new_digit_num);
+    Word* digits = (*bigint)->digits;
+    size_t full_num = length / SIZE_OF_WORD;
+
+    /* Full words, word i holds bytes [i * S, i * S + S) counted from the least significant end */
+    for (size_t idx = 0; idx < full_num; idx++) {
+        Word word;
+        if (is_big_endian) {
+            memcpy(&word, bytes + length - (idx + 1) * SIZE_OF_WORD, SIZE_OF_WORD);
+            digits[idx] = WORD_FROM_BE(word);
         }
+        else {
+            memcpy(&word, bytes + idx * SIZE_OF_WORD, SIZE_OF_WORD);
+            digits[idx] = WORD_FROM_LE(word);
+        }
+    }
+
+    /* Partial top word */
+    for (size_t byte_idx = full_num * SIZE_OF_WORD; byte_idx < length; byte_idx++) {
+        unsigned char byte = is_big_endian ? bytes[length - 1 - byte_idx] : bytes[byte_idx];
+        digits[full_num] |= (Word)byte << (8 * (byte_idx % SIZE_OF_WORD));
     }
 
     /* Free unused memory */
     bigint_refine(*bigint);
+
+    return CONVERT_OK;
+}
+
+/**
+ * @brief Sets the value of a Bigint from a big-endian octet string (OS2IP).
+ *
+ * @param bigint [out] Pointer to the destination Bigint, non-negative.
+ * @param bytes [in] Octet string, most significant byte first.
+ * @param length [in] Number of bytes, an empty string is zero.
+ * @return ConvertStatus CONVERT_OK.
+ */
+ConvertStatus bigint_from_bytes_be(Bigint** bigint, const unsigned char* bytes, size_t length)
+{
+    return bigint_from_bytes(bigint, bytes, length, true);
+}
+
+/**
+ * @brief Sets the value of a Bigint from a little-endian octet string.
+ *
+ * @param bigint [out] Pointer to the destination Bigint, non-negative.
+ * @param bytes [in] Octet string, least significant byte first.
+ * @param length [in] Number of bytes, an empty string is zero.
+ * @return ConvertStatus CONVERT_OK.
+ */
+ConvertStatus bigint_from_bytes_le(Bigint** bigint, const unsigned char* bytes, size_t length)
+{
+    return bigint_from_bytes(bigint, bytes, length, false);
+}
+
+/**
+ * @brief Returns the number of bytes of the absolute value of a Bigint, zero for zero.
+ *
+ * @param bigint [in] Pointer to the Bigint.
+ * @return size_t Smallest width for bigint_to_bytes_be and bigint_to_bytes_le.
+ */
+size_t bigint_byte_length(const Bigint* bigint)
+{
+    size_t digit_num = bigint->digit_num;
+    while (digit_num > 0 && bigint->digits[digit_num - 1] == 0)
+        digit_num--;
+
+    if (digit_num == 0)
+        return 0;
+
+    size_t byte_num = digit_num * SIZE_OF_WORD;
+    while ((bigint->digits[digit_num - 1] >> (8 * ((byte_num - 1) % SIZE_OF_WORD))) == 0)
+        byte_num--;
+
+    return byte_num;
+}
+
+/**
+ * @brief Writes the absolute value of a Bigint as a fixed-width octet string, I2OSP for big-endian output.
+ *
+ * @param bytes [out] Octet string of length bytes, zero-padded.
+ * @param length [in] Width in bytes.
+ * @param bigint [in] Pointer to the Bigint.
+ * @param is_big_endian [in] true to write the most significant byte first.
+ * @return ConvertStatus CONVERT_OK, or CONVERT_BUFFER_TOO_SMALL if the value needs more bytes.
+ */
+static ConvertStatus bigint_to_bytes(unsigned char* bytes, size_t length, const Bigint* bigint, bool is_big_endian)
+{
+    /* Error check : the value must fit in the width */
+    if (bigint_byte_length(bigint) > length)
+        return CONVERT_BUFFER_TOO_SMALL;
+
+    size_t digit_num = bigint->digit_num;
+    size_t full_num = length / SIZE_OF_WORD < digit_num ? length / SIZE_OF_WORD : digit_num;
+
+    /* Full words, byte-swapped if needed */
+    for (size_t idx = 0; idx < full_num; idx++) {
+        Word word;
+        if (is_big_endian) {
+            word = WORD_FROM_BE(bigint->digits[idx]);
+            memcpy(bytes + length - (idx + 1) * SIZE_OF_WORD, &word, SIZE_OF_WORD);
+        }
+        else {
+            word = WORD_FROM_LE(bigint->digits[idx]);
+            memcpy(bytes + idx * SIZE_OF_WORD, &word, SIZE_OF_WORD);
+        }
+    }
+
+    /* Partial top word and zero padding */
+    for (size_t byte_idx = full_num * SIZE_OF_WORD; byte_idx < length; byte_idx++) {
+        size_t digit_idx = byte_idx / SIZE_OF_WORD;
+        unsigned char byte = digit_idx < digit_num ? (unsigned char)(bigint->digits[digit_idx] >> (8 * (byte_idx % SIZE_OF_WORD))) : 0;
+        if (is_big_endian)
+            bytes[length - 1 - byte_idx] = byte;
+        else
+            bytes[byte_idx] = byte;
+    }
+
+    return CONVERT_OK;
+}
+
+/**
+ * @brief Writes the absolute value of a Bigint as a fixed-width big-endian octet string (I2OSP).
+ *
+ * @param bytes [out] Octet string of length bytes, most significant byte first, zero-padded.
+ * @param length [in] Width in bytes.
+ * @param bigint [in] Pointer to the Bigint.
+ * @return ConvertStatus CONVERT_OK, or CONVERT_BUFFER_TOO_SMALL if the value needs more bytes.
+ */
+ConvertStatus bigint_to_bytes_be(unsigned char* bytes, size_t length, const Bigint* bigint)
+{
+    return bigint_to_bytes(bytes, length, bigint, true);
+}
+
+/**
+ * @brief Writes the absolute value of a Bigint as a fixed-width little-endian octet string.
+ *
+ * @param bytes [out] Octet string of length bytes, least significant byte first, zero-padded.
+ * @param length [in] Width in bytes.
+ * @param bigint [in] Pointer to the Bigint.
+ * @return ConvertStatus CONVERT_OK, or CONVERT_BUFFER_TOO_SMALL if the value needs more bytes.
+ */
+ConvertStatus bigint_to_bytes_le(unsigned char* bytes, size_t length, const Bigint* bigint)
+{
+    return bigint_to_bytes(bytes, length, bigint, false);
+}
+
+/**
+ * @brief Makes a read-only Bigint view of a little-endian buffer without copying it.
+ *
+ * The digits of the view point into the buffer, so the buffer must outlive the view, must not
+ * change while it is in use, and the view must never be passed to bigint_delete or used as an
+ * output. It needs a little-endian host, a word-aligned buffer and a length of whole words.
+ *
+ * @param view [out] Caller-owned Bigint, filled in.
+ * @param bytes [in] Little-endian buffer, word-aligned.
+ * @param length [in] Number of bytes, a non-zero multiple of the word size.
+ * @return ConvertStatus CONVERT_OK, CONVERT_EMPTY or CONVERT_UNALIGNED.
+ */
+ConvertStatus bigint_view_bytes_le(Bigint* view, const unsigned char* bytes, size_t length)
+{
+    if (length == 0)
+        return CONVERT_EMPTY;
+
+    /* Error check : the buffer must already be an array of words */
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__ && !defined(BI_WORD8)
+    return CONVERT_UNALIGNED;
+#endif
+    if ((uintptr_t)bytes % _Alignof(Word) != 0 || length % SIZE_OF_WORD != 0)
+        return CONVERT_UNALIGNED;
+
+    /* Borrow the digits, leading zero words are left out */
+    size_t digit_num = length / SIZE_OF_WORD;
+    const Word* digits = (const Word*)bytes;
+    while (digit_num > 1 && digits[digit_num - 1] == 0)
+        digit_num--;
+
+    view->sign = POSITIVE;
+    view->digit_num = digit_num;
+    view->digits = (Word*)digits;
+
+    return CONVERT_OK;
 }
 
 /**
@@ -164,12 +1139,16 @@ void bigint_set_by_hex_string(Bigint** bigint, const char* string, Sign sign)
 void bigint_copy(Bigint** bigint_dest, const Bigint* bigint_src)
 { 
     /* Allocate new Bigint */
-    int new_digit_num = bigint_src->digit_num;
+    size_t new_digit_num = bigint_src->digit_num;
     bigint_new(bigint_dest, new_digit_num);
 
     /* Copy the digits */
-    for (int idx = 0; idx < new_digit_num; idx++)
+    for (size_t idx = 0; idx < new_digit_num; idx++)
         (*bigint_dest)->digits[idx] = bigint_src->digits[idx];
+#if defined(BI_MEMORY_STATS)
+    MEMORY_COUNT(copy_num, 1);
+    MEMORY_COUNT(copy_byte_num, (uint64_t)new_digit_num * SIZE_OF_WORD);
+#endif
 
     /* Copy the sign */
     (*bigint_dest)->sign = bigint_src->sign;
@@ -183,7 +1162,7 @@ void bigint_copy(Bigint** bigint_dest, const Bigint* bigint_src)
  * @param offset_start [in] Starting offset.
  * @param offset_end [in] Ending offset.
  */
-void bigint_copy_part(Bigint** result, const Bigint* bigint, Word offset_start, Word offset_end) 
+void bigint_copy_part(Bigint** result, const Bigint* bigint, size_t offset_start, size_t offset_end) 
 {
     /* Invalid offset */
 	if (bigint->digit_num < offset_end || bigint->digit_num < offset_start || offset_end < offset_start) {
@@ -193,11 +1172,11 @@ void bigint_copy_part(Bigint** result, const Bigint* bigint, Word offset_start,
     }
 
     /* Allocate Bigint */
-    Word new_digit_num = offset_end - offset_start;
+    size_t new_digit_num = offset_end - offset_start;
     bigint_new(result, new_digit_num);
 
     /* copy the digits */
-    for(int i = 0; i < new_digit_num; i++)
+    for(size_t i = 0; i < new_digit_num; i++)
         (*result)->digits[i] = bigint->digits[offset_start + i];
 
     bigint_refine(*result);
@@ -210,10 +1189,10 @@ void bigint_copy_part(Bigint** result, const Bigint* bigint, Word offset_start,
  * @param bigint [in] Pointer to the source Bigint.
  * @param wordlen [in] Number of words to expand.
  */
-void bigint_expand(Bigint** result, const Bigint* bigint, Word wordlen) 
+void bigint_expand(Bigint** result, const Bigint* bigint, size_t wordlen) 
 {
     Bigint* tmp_result = NULL;
-    int count = bigint->digit_num;
+    size_t count = bigint->digit_num;
 
     /* Allocate Bigint */
     bigint_new(&tmp_result, bigint->digit_num + wordlen);
@@ -237,7 +1216,7 @@ void bigint_expand(Bigint** result, const Bigint* bigint, Word wordlen)
  * @param bigint [in] Pointer to the source Bigint.
  * @param wordlen [in] Number of words to compress.
  */
-void bigint_compress(Bigint** result, const Bigint* bigint, Word wordlen) 
+void bigint_compress(Bigint** result, const Bigint* bigint, size_t wordlen) 
 {
     /* Over compress */
     if (bigint->digit_num <= wordlen) {
@@ -252,7 +1231,7 @@ void bigint_compress(Bigint** result, const Bigint* bigint, Word wordlen)
     }
 
     Bigint* tmp_result = NULL;
-    Word count = bigint->digit_num - wordlen;
+    size_t count = bigint->digit_num - wordlen;
 
     /* Allocate Bigint */
     bigint_new(&tmp_result, bigint->digit_num);
@@ -284,7 +1263,7 @@ void bigint_expand_one_bit(Bigint** result, const Bigint* bigint)
     bigint_new(&tmp_result, bigint->digit_num + 1);
 
     /* One bit left shift */
-    for (int idx = 0; idx < bigint->digit_num; idx++) {
+    for (size_t idx = 0; idx < bigint->digit_num; idx++) {
         tmp_result->digits[idx] = (bigint->digits[idx] << 1) + carry;
         carry = (bigint->digits[idx] >> (BITLEN_OF_WORD - 1)) & MASK1BIT;
     }
@@ -315,7 +1294,7 @@ void bigint_compress_one_bit(Bigint** result, const Bigint* bigint)
     bigint_new(&tmp_result, bigint->digit_num);
 
     /* One bit right shift */
-    for (int idx = bigint->digit_num - 1; idx >= 0; idx--) {
+    for (size_t idx = bigint->digit_num; idx-- > 0;) {
         tmp_result->digits[idx] = (bigint->digits[idx] >> 1) + carry;
         carry = (bigint->digits[idx] & MASK1BIT) << (BITLEN_OF_WORD - 1);
     }
@@ -332,9 +1311,9 @@ void bigint_compress_one_bit(Bigint** result, const Bigint* bigint)
  * @brief Returns the total bit length of a Bigint.
  * 
  * @param bigint [in] Pointer to the Bigint.
- * @return Word Total bit length of the Bigint.
+ * @return size_t Total bit length of the Bigint.
  */
-int bigint_get_bit_length(const Bigint* bigint)
+size_t bigint_get_bit_length(const Bigint* bigint)
 {
     return bigint->digit_num * BITLEN_OF_WORD;
 }
@@ -346,7 +1325,7 @@ int bigint_get_bit_length(const Bigint* bigint)
  * @param bit_idx [in] Index of the bit to retrieve.
  * @return Word Value of the specified bit (1 or 0).
  */
-Word bigint_get_bit(const Bigint* bigint, Word digit_idx, Word bit_idx)
+Word bigint_get_bit(const Bigint* bigint, size_t digit_idx, Word bit_idx)
 {
     /* is bit 1? or 0? */
     Word bit = (bigint->digits[digit_idx] >> bit_idx) & MASK1BIT;
@@ -417,7 +1396,7 @@ char bigint_compare_abs(const Bigint* operand_x, const Bigint* operand_y)
     if (operand_x->digit_num > operand_y->digit_num) return 1;
 
     // If digit_nums are equal, compare each digit from most significant to least significant
-    for (int idx = operand_x->digit_num - 1; idx >= 0; idx--) {
+    for (size_t idx = operand_x->digit_num; idx-- > 0;) {
         // Return -1 if the digit in operand_x is less than the digit in operand_y
         if (operand_x->digits[idx] < operand_y->digits[idx]) return -1;
         // Return 1 if the digit in operand_x is greater than the digit in operand_y
@@ -459,19 +1438,14 @@ char bigint_compare(const Bigint* operand_x, const Bigint* operand_y)
  * @param sign [in] Sign of the generated Bigint (POSITIVE or NEGATIVE).
  * @param digit_num [in] Number of digits in the generated Bigint.
  */
-void bigint_generate_random_number(Bigint** bigint, Sign sign, Word digit_num)
+void bigint_generate_random_number(Bigint** bigint, Sign sign, size_t digit_num)
 {
     /* Allocate memory for Bigint */
     bigint_new(bigint, digit_num);
     (*bigint)->sign = sign;
 
-    /* Variables for generating a random number */
-    unsigned char* byte_rand_num = (unsigned char*)(*bigint)->digits; // Pointer to the bytes of the bigint.
-    Word count = digit_num * SIZE_OF_WORD;                 // Number of bytes in the bigint.
-
-    /* 8-bit random number generator */
-    while (count--)
-        *byte_rand_num++ = (Word)rand() & MASK8BIT;
+    /* Fill all words at once from the random source of this thread */
+    bigint_random_bytes((*bigint)->digits, (*bigint)->digit_num * SIZE_OF_WORD);
 
     /* Free unused memory */
     bigint_refine(*bigint);
@@ -484,16 +1458,13 @@ void bigint_generate_random_number(Bigint** bigint, Sign sign, Word digit_num)
  */
 void bigint_show_hex(const Bigint* bigint) 
 {
-    /* Display negative sign if present */
-    if (bigint->sign) printf("-");
-
-    /* Print the most significant digit */
-    printf(PRINT_WORD_FORMAT, (Word)bigint->digits[bigint->digit_num - 1]);
-
-    /* Print the remaining digits */
-    for (int idx = bigint->digit_num - 2; idx >= 0; idx--)
-        printf(PRINT_WORD_FIX_FORMAT, (Word)bigint->digits[idx]);
+    /* Required length, then the whole string at once */
+    size_t length = 0;
+    bigint_to_hex(NULL, 0, &length, bigint);
+    char* string = (char*)bigint_malloc(length + 1);
+    bigint_to_hex(string, length + 1, NULL, bigint);
 
     /* Line break for better readability */
-    printf("\n");
-}
\ No newline at end of file
+    puts(string);
+    bigint_free(string);
+}
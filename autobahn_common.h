@@ -53,29 +53,100 @@ typedef enum {
     NEGATIVE = 1
 } Sign;
 
-/** @brief Structure representing a big integer. */
+/** @brief Result of a conversion between a Bigint and an external representation. */
+typedef enum {
+    CONVERT_OK = 0,                 /**< Conversion succeeded. */
+    CONVERT_EMPTY = -1,             /**< The input has no digits. */
+    CONVERT_INVALID_CHARACTER = -2, /**< The input has a character that is not a digit. */
+    CONVERT_BUFFER_TOO_SMALL = -3,  /**< The output buffer cannot hold the result. */
+    CONVERT_TOO_LARGE = -4,         /**< Reserved, no longer returned: lengths are size_t, so every value fits in a Bigint. */
+    CONVERT_INVALID_BASE = -5,      /**< The base is not supported. */
+    CONVERT_UNALIGNED = -6          /**< The buffer is not an array of words in host order. */
+} ConvertStatus;
+
+/** @brief Fills byte_num bytes of buffer with random bytes, the pluggable random source. */
+typedef void (*RandomFill)(void* state, void* buffer, size_t byte_num);
+
+#define RANDOM_XOSHIRO_LANES 4 /**< Independent xoshiro256** streams stepped together. */
+
+/** @brief State of a xoshiro256** generator, fast but not for keys. */
+typedef struct {
+    uint64_t s[4][RANDOM_XOSHIRO_LANES]; /**< State word i of every lane, interleaved. */
+} RandomXoshiro;
+
+/** @brief State of a ChaCha20 generator, a cryptographic source when seeded from the system. */
+typedef struct {
+    uint32_t key[8];          /**< 256-bit key. */
+    uint64_t counter;         /**< Block counter. */
+    uint64_t stream;          /**< Nonce, selects an independent stream. */
+    unsigned char block[64];  /**< Current keystream block. */
+    size_t used;              /**< Bytes of the block already used. */
+} RandomChaCha;
+
+/** @brief Allocates byte_num bytes, the pluggable memory functions. */
+typedef void* (*MemoryAlloc)(void* user_data, size_t byte_num);
+/** @brief Resizes memory from MemoryAlloc to byte_num bytes, keeping the contents. */
+typedef void* (*MemoryRealloc)(void* user_data, void* pointer, size_t byte_num);
+/** @brief Frees memory from MemoryAlloc or MemoryRealloc. */
+typedef void (*MemoryFree)(void* user_data, void* pointer);
+
+/** @brief Memory counters of a BI_MEMORY_STATS build, cumulative since the last reset. */
+typedef struct {
+    uint64_t malloc_num;         /**< Calls of bigint_malloc. */
+    uint64_t calloc_num;         /**< Calls of bigint_calloc. */
+    uint64_t realloc_num;        /**< Calls of bigint_realloc. */
+    uint64_t free_num;           /**< Calls of bigint_free with a non-NULL pointer. */
+    uint64_t allocated_byte_num; /**< Bytes requested by the three allocators. */
+    uint64_t live_byte_num;      /**< Bytes allocated and not yet freed, kept by a reset. */
+    uint64_t peak_byte_num;      /**< Largest live_byte_num since the last reset. */
+    uint64_t copy_num;           /**< Calls of bigint_copy. */
+    uint64_t copy_byte_num;      /**< Bytes of digits copied by bigint_copy. */
+} MemoryStats;
+
+/** @brief Structure representing a big integer, members ordered by size so the layout has no inner padding. */
 typedef struct {
-    Sign sign;         /**< Sign of the big integer. */
-    Word digit_num;    /**< Number of digits in the big integer. */
     Word* digits;      /**< Array of digits representing the big integer. */
+    size_t digit_num;  /**< Number of digits in the big integer. */
+    Sign sign;         /**< Sign of the big integer. */
 } Bigint;
 
 /** @brief Memory Control */
-void bigint_new    (Bigint** bigint, Word new_digit_num); /**< Allocates memory for a new Bigint. */
-void bigint_delete (Bigint** bigint);                     /**< Deallocates memory for a Bigint. */
-void bigint_refine (Bigint* bigint);                      /**< Refines the memory allocated for a Bigint. */
+void bigint_new    (Bigint** bigint, size_t new_digit_num); /**< Allocates memory for a new Bigint. */
+void bigint_delete (Bigint** bigint);                       /**< Deallocates memory for a Bigint. */
+void bigint_refine (Bigint* bigint);                        /**< Refines the memory allocated for a Bigint. */
+void* bigint_malloc  (size_t byte_num);                   /**< Allocates library memory, counted in a BI_MEMORY_STATS build. */
+void* bigint_calloc  (size_t count, size_t byte_num);     /**< Allocates zeroed library memory, counted in a BI_MEMORY_STATS build. */
+void* bigint_realloc (void* pointer, size_t byte_num);    /**< Resizes library memory, counted in a BI_MEMORY_STATS build. */
+void  bigint_free    (void* pointer);                     /**< Frees library memory, counted in a BI_MEMORY_STATS build. */
+
+/** @brief Memory functions */
+void bigint_set_memory_functions (MemoryAlloc alloc_function, MemoryRealloc realloc_function, MemoryFree free_function, void* user_data);      /**< Routes every allocation of the library through the given functions, NULL for the C library. */
+void bigint_get_memory_functions (MemoryAlloc* alloc_function, MemoryRealloc* realloc_function, MemoryFree* free_function, void** user_data); /**< Reads the memory functions under the library. */
+void bigint_memory_cache_flush   (void);                                                                                                       /**< Frees the blocks cached by the calling thread in a BI_MEMORY_CACHE build. */
+
+/** @brief Memory statistics */
+bool bigint_memory_stats       (MemoryStats* stats); /**< Reads the memory counters, false if the build does not count. */
+void bigint_memory_stats_reset (void);               /**< Zeroes the memory counters, the peak restarts from the live bytes. */
 
 /** @brief Set or Copy */
-void bigint_set_by_array      (Bigint** bigint, const Word* array, Sign sign, Word digit_num); /**< Sets the value of a Bigint from an array of Words. */
-void bigint_set_by_hex_string (Bigint** bigint, const char* string, Sign sign);                /**< Sets the value of a Bigint from a hexadecimal string. */
-void bigint_copy              (Bigint** bigint_dest, const Bigint* bigint_src);                /**< Copies the value of one Bigint to another. */
-void bigint_copy_part         (Bigint** result, const Bigint* bigint, Word offset_start, Word offset_end); /**< Copies a part of a Bigint to a new Bigint. */
+void bigint_set_by_array      (Bigint** bigint, const Word* array, Sign sign, size_t digit_num); /**< Sets the value of a Bigint from an array of Words. */
+void bigint_set_by_hex_string (Bigint** bigint, const char* string, Sign sign);                  /**< Sets the value of a Bigint from a hexadecimal string. */
+ConvertStatus bigint_from_hex (Bigint** bigint, const char* string, size_t length);              /**< Sets the value of a Bigint from a signed hexadecimal string of given length. */
+ConvertStatus bigint_to_hex   (char* buffer, size_t buffer_length, size_t* string_length, const Bigint* bigint); /**< Writes the hexadecimal representation of a Bigint into a buffer. */
+ConvertStatus bigint_from_bytes_be (Bigint** bigint, const unsigned char* bytes, size_t length);  /**< Sets the value of a Bigint from a big-endian octet string (OS2IP). */
+ConvertStatus bigint_from_bytes_le (Bigint** bigint, const unsigned char* bytes, size_t length);  /**< Sets the value of a Bigint from a little-endian octet string. */
+ConvertStatus bigint_to_bytes_be   (unsigned char* bytes, size_t length, const Bigint* bigint);   /**< Writes a Bigint as a fixed-width big-endian octet string (I2OSP). */
+ConvertStatus bigint_to_bytes_le   (unsigned char* bytes, size_t length, const Bigint* bigint);   /**< Writes a Bigint as a fixed-width little-endian octet string. */
+ConvertStatus bigint_view_bytes_le (Bigint* view, const unsigned char* bytes, size_t length);     /**< Borrows an aligned little-endian buffer as the digits of a read-only Bigint. */
+size_t        bigint_byte_length   (const Bigint* bigint);                                        /**< Returns the number of bytes of the absolute value of a Bigint. */
+void bigint_copy              (Bigint** bigint_dest, const Bigint* bigint_src);                  /**< Copies the value of one Bigint to another. */
+void bigint_copy_part         (Bigint** result, const Bigint* bigint, size_t offset_start, size_t offset_end); /**< Copies a part of a Bigint to a new Bigint. */
 
 /** @brief Left or right shift */
-void bigint_expand           (Bigint** result, const Bigint* bigint, Word wordlen); /**< Sets the value of a Bigint to zero. */
-void bigint_compress         (Bigint** result, const Bigint* bigint, Word wordlen); /**< Compresses the size of a Bigint by a given number of words. */
-void bigint_expand_one_bit   (Bigint** result, const Bigint* bigint);               /**< Expands the size of a Bigint by one bit, shifting digits left. */
-void bigint_compress_one_bit (Bigint** result, const Bigint* bigint);               /**< Compresses the size of a Bigint by one bit, shifting digits right. */
+void bigint_expand           (Bigint** result, const Bigint* bigint, size_t wordlen); /**< Sets the value of a Bigint to zero. */
+void bigint_compress         (Bigint** result, const Bigint* bigint, size_t wordlen); /**< Compresses the size of a Bigint by a given number of words. */
+void bigint_expand_one_bit   (Bigint** result, const Bigint* bigint);                 /**< Expands the size of a Bigint by one bit, shifting digits left. */
+void bigint_compress_one_bit (Bigint** result, const Bigint* bigint);                 /**< Compresses the size of a Bigint by one bit, shifting digits right. */
 
 /** @brief Bit operation */
 #define GET_MSB(word) (((word) >> (BITLEN_OF_WORD - 1)) & MASK1BIT) /**< Get most significant bit of word. */
@@ -90,6 +161,17 @@ char bigint_is_one    (const Bigint* bigint); /**< Checks if a Bigint is equal t
 /** @brief Etc. */
 char bigint_compare     (const Bigint* operand_x, const Bigint* operand_y);      /**< Compares the absolute values of two Bigints. */
 char bigint_compare_abs (const Bigint* operand_x, const Bigint* operand_y);      /**< Compares two Bigints, considering sign. */
-void bigint_generate_random_number(Bigint** bigint, Sign sign, Word digit_num);  /**< Generates a random Bigint with the specified sign and digit number. */
 void bigint_show_hex    (const Bigint* bigint); /**< Displays the hexadecimal representation of a Bigint. */
+
+/** @brief Random numbers */
+void bigint_random_set_source      (RandomFill fill, void* state);                          /**< Sets the random source of the calling thread, NULL for the default. */
+void bigint_random_get_source      (RandomFill* fill, void** state);                        /**< Reads the random source of the calling thread, NULL for the default. */
+void bigint_random_bytes           (void* buffer, size_t byte_num);                         /**< Fills a buffer from the random source of the calling thread. */
+void bigint_random_xoshiro_seed    (RandomXoshiro* state, uint64_t seed);                   /**< Seeds a xoshiro256** generator. */
+void bigint_random_xoshiro_fill    (void* state, void* buffer, size_t byte_num);            /**< RandomFill of a xoshiro256** generator. */
+bool bigint_random_chacha_seed     (RandomChaCha* state, const unsigned char* key, uint64_t stream); /**< Seeds a ChaCha20 generator from a key or the system. */
+void bigint_random_chacha_fill     (void* state, void* buffer, size_t byte_num);            /**< RandomFill of a ChaCha20 generator. */
+void bigint_generate_random_number (Bigint** bigint, Sign sign, size_t digit_num);          /**< Generates a random Bigint with the specified sign and digit number. */
+void bigint_random_bits            (Bigint** result, size_t bit_length);                    /**< Generates a random Bigint of exactly bit_length bits. */
+void bigint_random_below           (Bigint** result, const Bigint* bound);                  /**< Generates a uniformly random Bigint in [0, bound). */
 #endif
@@ -1,4 +1,4 @@
-#include "autobahn.h"
+#include "autobahn_internal.h"
 
 /**
  * @brief Handles special cases in Bigint division.
@@ -107,14 +107,16 @@ static void addition_bigint_and_word(Bigint **result, const Bigint *bigint, cons
  */
 void bigint_division_binary_long(Bigint **quotient, Bigint **remainder, const Bigint *dividend, const Bigint *divisor)
 {
+    PROFILE_SCOPE(PROFILE_DIVISION_BINARY_LONG, dividend->digit_num + divisor->digit_num);
+
     /* Check for invalid or special cases of division */
     bool special_case_flag = bigint_division_special_case(quotient, remainder, dividend, divisor);
     if (special_case_flag == true)
         return;
 
     /* Number of digits for quotient and remainder */
-    Word size_quotient = dividend->digit_num - divisor->digit_num + 1;
-    Word size_remainder = divisor->digit_num;
+    size_t size_quotient = dividend->digit_num - divisor->digit_num + 1;
+    size_t size_remainder = divisor->digit_num;
 
     /* Allocate Bigint */
     Bigint *tmp_quotient = NULL;  // Resulting quotient
@@ -129,7 +131,7 @@ void bigint_division_binary_long(Bigint **quotient, Bigint **remainder, const Bi
     bigint_set_zero(&tmp_remainder);
 
     /* Iteration count */
-    Word digit_idx = dividend->digit_num;
+    size_t digit_idx = dividend->digit_num;
 
     while(digit_idx--)
     {
@@ -176,14 +178,16 @@ void bigint_division_binary_long(Bigint **quotient, Bigint **remainder, const Bi
  */
 void bigint_division_naive(Bigint **quotient, Bigint **remainder, const Bigint *dividend, const Bigint *divisor)
 {
+    PROFILE_SCOPE(PROFILE_DIVISION_NAIVE, dividend->digit_num + divisor->digit_num);
+
     /* Check invalid case or special case of division */
     bool special_case_flag = bigint_division_special_case(quotient, remainder, dividend, divisor);
     if (special_case_flag == true)
         return;
 
     /* Number of digits about quotient and remainder */
-    Word size_quotient = dividend->digit_num - divisor->digit_num + 1;
-    Word size_remainder = divisor->digit_num;
+    size_t size_quotient = dividend->digit_num - divisor->digit_num + 1;
+    size_t size_remainder = divisor->digit_num;
 
     /* Allocate Bigint */
     Bigint *tmp_quotient = NULL;  // result of quotient
@@ -213,43 +217,6 @@ void bigint_division_naive(Bigint **quotient, Bigint **remainder, const Bigint *
     bigint_delete(&tmp_remainder);
 }
 
-/**
- * @brief Computes the quotient of dividing a two-word integer by a one-word integer.
- *
- * @param dividend_high [in] The most significant word of the dividend.
- * @param dividend_low [in] The least significant word of the dividend.
- * @param divisor [in] The divisor.
- * @return Word The quotient of (dividend_high||dividend_low) / divisor.
- */
-static Word get_quotient_of_division_two_word(Word dividend_high, Word dividend_low, Word divisor)
-{
-    Word quotient = 0; // Resulting quotient
-    Word remainder = dividend_high;
-    Word bit_idx = BITLEN_OF_WORD;
-
-    /* Divide: (dividend_high||dividend_low) / divisor */
-    while(bit_idx--)
-    {
-        Word bit_dividend_low = GET_BIT(dividend_low, bit_idx);       // ai
-        Word bit_expanded = (Word)1 << bit_idx;                       // Set correct index
-
-        if (GET_MSB(remainder) == 1) {
-            quotient += bit_expanded;                               // Q <- Q + ai
-            remainder = remainder * 2 + bit_dividend_low - divisor; // R <- 2R + ai - B
-        }
-        else {
-            remainder = remainder * 2 + bit_dividend_low; // R <- 2R + ai
-
-            if (remainder >= divisor) {
-                quotient += bit_expanded;        // Q <- Q + ai
-                remainder = remainder - divisor; // R <- R - B
-            }
-        }
-    }
-
-    return quotient;
-}
-
 /**
  * @brief Computes the quotient and remainder of dividing a high two-word integer by a one-word integer.
  *
@@ -260,10 +227,13 @@ static Word get_quotient_of_division_two_word(Word dividend_high, Word dividend_
  */
 static void division_expanded_two_word(Word *quotient, Bigint **remainder, const Bigint *dividend, const Bigint *divisor)
 {
-    Word word_dividend_high = dividend->digits[divisor->digit_num];    // Most significant digit of divisor
+    Word word_dividend_high = 0;                                       // Most significant digit of divisor, zero if absent
     Word word_dividend_low = dividend->digits[divisor->digit_num - 1]; // Second most significant digit of divisor
     Word word_divisor = divisor->digits[divisor->digit_num - 1];       // Second most significant digit of divisor
 
+    if (dividend->digit_num > divisor->digit_num)
+        word_dividend_high = dividend->digits[divisor->digit_num];
+
     /* Compute quotient */
     if (dividend->digit_num == divisor->digit_num)
         *quotient = word_dividend_low / word_divisor;
@@ -354,14 +324,16 @@ void division_two_word(Word *quotient, Bigint **remainder, const Bigint *dividen
  */
 void bigint_division_word_long(Bigint **quotient, Bigint **remainder, const Bigint *dividend, const Bigint *divisor)
 {
+    PROFILE_SCOPE(PROFILE_DIVISION_WORD_LONG, dividend->digit_num + divisor->digit_num);
+
     /* Check invalid cases or special cases of division */
     bool special_case_flag = bigint_division_special_case(quotient, remainder, dividend, divisor);
     if (special_case_flag == true)
         return;
 
     /* Number of digits for quotient and remainder */
-    Word size_quotient = dividend->digit_num - divisor->digit_num + 1;
-    Word size_remainder = divisor->digit_num;
+    size_t size_quotient = dividend->digit_num - divisor->digit_num + 1;
+    size_t size_remainder = divisor->digit_num;
 
     Bigint *tmp_quotient = NULL;  // Resulting quotient
     Bigint *tmp_remainder = NULL; // Resulting remainder
@@ -377,7 +349,7 @@ void bigint_division_word_long(Bigint **quotient, Bigint **remainder, const Bigi
     bigint_set_zero(&tmp_remainder);
 
     /* Compute word-long division */
-    for (int digit_idx = dividend->digit_num - 1; digit_idx >= 0; digit_idx--)
+    for (size_t digit_idx = dividend->digit_num; digit_idx-- > 0;)
     {
         Word word_dividend = dividend->digits[digit_idx]; // Ai
         Word word_quotient = 0;                           // Qi
@@ -400,3 +372,166 @@ void bigint_division_word_long(Bigint **quotient, Bigint **remainder, const Bigi
     bigint_delete(&tmp_remainder);
     bigint_delete(&rw_plus_a);
 }
+
+/**
+ * @brief Returns the number of scratch words needed by words_division.
+ *
+ * @param dividend_digit_num [in] Number of words of the dividend.
+ * @param divisor_digit_num [in] Number of words of the divisor.
+ * @return size_t Number of scratch words.
+ */
+size_t words_division_scratch_size(size_t dividend_digit_num, size_t divisor_digit_num)
+{
+    return dividend_digit_num + divisor_digit_num + 1;
+}
+
+/**
+ * @brief Divides two arrays by schoolbook long division (Knuth algorithm D).
+ *
+ * @param quotient [out] Quotient of dividend_digit_num - divisor_digit_num + 1 words, or NULL.
+ * @param remainder [out] Remainder of divisor_digit_num words, or NULL.
+ * @param dividend [in] Dividend of at least divisor_digit_num words.
+ * @param dividend_digit_num [in] Number of words of the dividend.
+ * @param divisor [in] Divisor, its most significant word is not zero.
+ * @param divisor_digit_num [in] Number of words of the divisor.
+ * @param scratch [in] Scratch of words_division_scratch_size(dividend_digit_num, divisor_digit_num) words.
+ */
+void words_division(Word* quotient, Word* remainder, const Word* dividend, size_t dividend_digit_num, const Word* divisor, size_t divisor_digit_num, Word* scratch)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_DIVISION, dividend_digit_num + divisor_digit_num);
+
+    size_t quotient_num = dividend_digit_num - divisor_digit_num + 1;
+
+    /* One-word divisor: one two-by-one division per word */
+    if (divisor_digit_num == 1)
+    {
+        Word word_remainder = 0;
+
+        for (size_t idx = dividend_digit_num; idx-- > 0;) {
+            Word word_quotient = 0;
+            word_division_two_word(&word_quotient, &word_remainder, word_remainder, dividend[idx], divisor[0]);
+            if (quotient != NULL)
+                quotient[idx] = word_quotient;
+        }
+
+        if (remainder != NULL)
+            remainder[0] = word_remainder;
+        return;
+    }
+
+    Word* normalized_divisor = scratch;                       // V << shift
+    Word* normalized_dividend = scratch + divisor_digit_num;  // U << shift, one more word
+    Word shift = BITLEN_OF_WORD - word_bit_length(divisor[divisor_digit_num - 1]);
+
+    /* Normalize: the divisor gets its most significant bit set */
+    for (size_t idx = divisor_digit_num; idx-- > 0;)
+        normalized_divisor[idx] = (divisor[idx] << shift) | (shift != 0 && idx > 0 ? divisor[idx - 1] >> (BITLEN_OF_WORD - shift) : 0);
+    normalized_dividend[dividend_digit_num] = shift != 0 ? dividend[dividend_digit_num - 1] >> (BITLEN_OF_WORD - shift) : 0;
+    for (size_t idx = dividend_digit_num; idx-- > 0;)
+        normalized_dividend[idx] = (dividend[idx] << shift) | (shift != 0 && idx > 0 ? dividend[idx - 1] >> (BITLEN_OF_WORD - shift) : 0);
+
+    Word divisor_top = normalized_divisor[divisor_digit_num - 1];
+    Word divisor_second = normalized_divisor[divisor_digit_num - 2];
+
+    for (size_t idx = quotient_num; idx-- > 0;)
+    {
+        Word* window = normalized_dividend + idx; // U[idx .. idx + n]
+        Word word_quotient = 0;
+        Word word_remainder = 0;
+        bool remainder_overflow = false;
+
+        /* Estimate the quotient word from the top two words */
+        if (window[divisor_digit_num] >= divisor_top) {
+            word_quotient = (Word)(-1);
+            word_remainder = window[divisor_digit_num - 1] + divisor_top;
+            remainder_overflow = (word_remainder < divisor_top);
+        }
+        else
+            word_division_two_word(&word_quotient, &word_remainder, window[divisor_digit_num], window[divisor_digit_num - 1], divisor_top);
+
+        /* The estimate is at most two too large: check against the third word */
+        while (remainder_overflow == false)
+        {
+            Word high = 0;
+            Word low = 0;
+            word_multiplication_addition(&high, &low, word_quotient, divisor_second, 0, 0);
+            if (high < word_remainder || (high == word_remainder && low <= window[divisor_digit_num - 2]))
+                break;
+
+            word_quotient--;
+            word_remainder += divisor_top;
+            remainder_overflow = (word_remainder < divisor_top);
+        }
+
+        /* U <- U - q * V, add back once if it went negative */
+        Word borrow = words_multiplication_subtraction_word(window, normalized_divisor, divisor_digit_num, word_quotient);
+        Word top = window[divisor_digit_num];
+        window[divisor_digit_num] = top - borrow;
+        if (top < borrow) {
+            word_quotient--;
+            window[divisor_digit_num] += words_addition(window, window, divisor_digit_num, normalized_divisor, divisor_digit_num);
+        }
+
+        if (quotient != NULL)
+            quotient[idx] = word_quotient;
+    }
+
+    /* Denormalize the remainder */
+    if (remainder != NULL)
+        for (size_t idx = 0; idx < divisor_digit_num; idx++)
+            remainder[idx] = (normalized_dividend[idx] >> shift) | (shift != 0 ? normalized_dividend[idx + 1] << (BITLEN_OF_WORD - shift) : 0);
+}
+
+/**
+ * @brief Divides the absolute values of two Bigints with the array kernels.
+ *
+ * @param quotient [out] Pointer to the quotient |A| / |B|, may be NULL.
+ * @param remainder [out] Pointer to the remainder |A| mod |B|, may be NULL.
+ * @param dividend [in] Dividend A.
+ * @param divisor [in] Non-zero divisor B.
+ */
+void words_division_bigint(Bigint** quotient, Bigint** remainder, const Bigint* dividend, const Bigint* divisor)
+{
+    /* Invalid case: zero divisor */
+    if (bigint_is_zero(divisor) == TRUE) {
+        printf("Error: Divisor must be non-zero.\n");
+        return;
+    }
+
+    Bigint* tmp_quotient = NULL;
+    Bigint* tmp_remainder = NULL;
+
+    /* Dividend < divisor */
+    if (bigint_compare_abs(dividend, divisor) == LEFT_IS_SMALL) {
+        bigint_set_zero(&tmp_quotient);
+        bigint_copy(&tmp_remainder, dividend);
+        tmp_remainder->sign = POSITIVE;
+    }
+    else {
+        Word* scratch = (Word*)bigint_malloc(words_division_fast_scratch_size(dividend->digit_num, divisor->digit_num) * SIZE_OF_WORD);
+
+        /* Divide */
+        bigint_new(&tmp_quotient, dividend->digit_num - divisor->digit_num + 1);
+        bigint_new(&tmp_remainder, divisor->digit_num);
+        words_division_fast(tmp_quotient->digits, tmp_remainder->digits, dividend->digits, dividend->digit_num, divisor->digits, divisor->digit_num, scratch);
+        bigint_refine(tmp_quotient);
+        bigint_refine(tmp_remainder);
+
+        bigint_free(scratch);
+    }
+
+    /* Get results, the inputs may alias the outputs */
+    if (quotient != NULL) {
+        bigint_delete(quotient);
+        *quotient = tmp_quotient;
+    }
+    else
+        bigint_delete(&tmp_quotient);
+
+    if (remainder != NULL) {
+        bigint_delete(remainder);
+        *remainder = tmp_remainder;
+    }
+    else
+        bigint_delete(&tmp_remainder);
+}
@@ -3,8 +3,85 @@
 
 #include "autobahn.h"
 
-void bigint_benchmark(Word bit_length);
+/** @brief Binary test vector file being written, defined in autobahn_evaluation_dataset.c. */
+typedef struct DatasetWriter DatasetWriter;
+
+/** @brief Memory-mapped binary test vector file, defined in autobahn_evaluation_dataset.c. */
+typedef struct Dataset Dataset;
+
+/** @brief Output format of the benchmark harness. */
+typedef enum {
+    BENCHMARK_TEXT, /**< Aligned table. */
+    BENCHMARK_CSV,  /**< One header line, then one line per measurement. */
+    BENCHMARK_JSON  /**< One object with a results array. */
+} BenchmarkFormat;
+
+/** @brief Settings of a benchmark run. */
+typedef struct {
+    size_t bit_min;         /**< Smallest operand size in bits, doubled up to bit_max. */
+    size_t bit_max;         /**< Largest operand size in bits. */
+    size_t warmup_num;      /**< Untimed samples before measuring. */
+    size_t sample_num;      /**< Timed samples per operation and size. */
+    size_t sample_min;      /**< Fewest samples taken when an operation is slow. */
+    uint64_t sample_ns;     /**< Minimum duration of a sample, iterations are batched up to it. */
+    uint64_t budget_ns;     /**< Time budget of an operation at one size, bounds the samples. */
+    const char* filter;     /**< Only operations whose name contains it, NULL for all. */
+    BenchmarkFormat format; /**< Output format. */
+    FILE* output;           /**< Output stream. */
+    bool hardware_counters; /**< Read perf_event counters around each operation, Linux only, off by default. */
+} BenchmarkConfig;
+
+/** @brief Settings of a load generator run. */
+typedef struct {
+    size_t bit_length;      /**< Modulus size in bits. */
+    size_t thread_min;      /**< Fewest worker threads, doubled up to thread_max. */
+    size_t thread_max;      /**< Most worker threads. */
+    double request_rate;    /**< Target requests per second of all workers together, 0 for a closed loop. */
+    uint64_t duration_ns;   /**< Measured time of each request type and thread count. */
+    uint64_t warmup_ns;     /**< Unrecorded time before measuring. */
+    const char* filter;     /**< Only request types whose name contains it, NULL for all. */
+    BenchmarkFormat format; /**< Output format. */
+    FILE* output;           /**< Output stream. */
+} LoadConfig;
+
+/** @brief Settings of a verification run. */
+typedef struct {
+    const char* directory; /**< Root of the test vectors, holding random_test_vectors/ and bit_test_vectors/. */
+    size_t thread_num;     /**< Worker threads, 0 for one per online CPU. */
+    size_t report_max;     /**< Mismatches printed, the rest are only counted. */
+    const char* filter;    /**< Only checks whose suite/name contains it, NULL for all. */
+    FILE* output;          /**< Stream of the mismatches and the summary. */
+} VerificationConfig;
+
+/** @brief Benchmark */
+void bigint_benchmark                (size_t bit_length);
+void bigint_benchmark_config_default (BenchmarkConfig* config);
+void bigint_benchmark_run            (const BenchmarkConfig* config);
+
+/** @brief Load generator */
+void bigint_load_config_default (LoadConfig* config);
+void bigint_load_run            (const LoadConfig* config);
+
+/** @brief Word kernels */
+void bigint_kernel_benchmark (const BenchmarkConfig* config);
+bool bigint_kernel_verify    (uint64_t case_num, uint64_t seed, ThreadPool* pool);
+
 void bigint_random_test();
 void bigint_bit_test();
 
+/** @brief Verification engine */
+void bigint_verification_config_default (VerificationConfig* config);
+bool bigint_verification_run            (const VerificationConfig* config);
+
+/** @brief Binary test vector datasets */
+bool   bigint_dataset_writer_open       (DatasetWriter** writer, const char* path);
+bool   bigint_dataset_write             (DatasetWriter* writer, const Bigint* bigint);
+bool   bigint_dataset_writer_close      (DatasetWriter** writer);
+bool   bigint_dataset_open              (Dataset** dataset, const char* path);
+void   bigint_dataset_close             (Dataset** dataset);
+size_t bigint_dataset_size              (const Dataset* dataset);
+bool   bigint_dataset_view              (Bigint* view, const Dataset* dataset, size_t record_idx);
+bool   bigint_dataset_convert_text      (const char* text_path, const char* dataset_path);
+size_t bigint_dataset_convert_directory (const char* directory);
+
 #endif
\ No newline at end of file
@@ -1,114 +1,725 @@
-#include "autobahn.h"
-#include "time.h"
-
-void bigint_benchmark(Word bit_length)
-{
-    /* init operands and result of operations */
-    Bigint *operand_x = NULL;
-    Bigint *operand_y = NULL;
-    Bigint *operand_y_half = NULL;
-    Bigint *operand_z = NULL;
-    Bigint *result = NULL;
-    Bigint *pre_comp = NULL;
-    Bigint *quotient = NULL;
-    Bigint *remainder = NULL;
-
-    /* allocate memory */
-    bigint_new(&operand_x, 1);
-    bigint_new(&operand_y, 1);
-    bigint_new(&operand_y_half, 1);
-    bigint_new(&operand_z, 1);
-    bigint_new(&result, 1);
-    bigint_new(&pre_comp, 1);
-    bigint_new(&quotient, 1);
-    bigint_new(&remainder, 1);
-    
-    /* Bit length to word length */
-    Word new_digit_num = bit_length / BITLEN_OF_WORD;
-
-    /* setting variables */
-    bigint_generate_random_number(&operand_x, POSITIVE, new_digit_num);
-    bigint_generate_random_number(&operand_y, POSITIVE, new_digit_num);
-    bigint_generate_random_number(&operand_y_half, POSITIVE, new_digit_num / 2);
-    bigint_generate_random_number(&operand_z, POSITIVE, new_digit_num);
-    bigint_reduction_barrett_pre_computed(&pre_comp, operand_y_half);
-
-    /* time variable */
-    time_t start;
-    time_t end;
-    double time_result;
-    size_t count = 100;
-
-    /* time check: multiplication textbook */
-    start = clock();
-    for(size_t i = 0; i < count; i++) bigint_multiplication_textbook(&result, operand_x, operand_y);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time multiplication textbook    : %f\n", time_result);
-
-    /* time check: multiplication karatsuba */
-    start = clock();
-    for(size_t i = 0; i < count; i++) bigint_multiplication_karatsuba(&result, operand_x, operand_y);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time multiplication karatsuba   : %f\n", time_result);
-
-    /* time check: squaring textbook */
-    start = clock();
-    for(size_t i = 0; i < count; i++) bigint_squaring_textbook(&result, operand_x);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time squaring textbook          : %f\n", time_result);
-
-    /* time check: squaring karatsuba */
-    start = clock();
-    for(size_t i = 0; i < count; i++) bigint_squaring_karatsuba(&result, operand_x);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time squaring karatsuba         : %f\n", time_result);
-
-    /* time check: division binary */
-    start = clock();
-    for(size_t i = 0; i < count; i++) bigint_division_binary_long(&quotient, &remainder, operand_x, operand_y_half);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time division binary            : %f\n", time_result);
-
-    /* time check: division word */
-    start = clock();
-    for(size_t i = 0; i < count; i++) bigint_division_word_long(&quotient, &remainder, operand_x, operand_y_half);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time division word              : %f\n", time_result);
-
-    /* time check: barrett */
-    start = clock();
-    for(size_t i = 0; i < count; i++) bigint_reduction_barrett(&remainder, operand_x, operand_y_half, pre_comp);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time barrett                    : %f\n", time_result);
-
-    /* time check: exponetiation left to right */
-    start = clock();
-    bigint_exponentiation_modular_left_to_right(&result, operand_x, operand_y, operand_z);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time exponetiation left to right: %f\n", time_result);
-
-    /* time check: exponetiation montgomery ladder */
-    start = clock();
-    bigint_exponentiation_modular_montgomery_ladder(&result, operand_x, operand_y, operand_z);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time exponetiation montgomery   : %f\n", time_result);
-
-    /* free memory */
-    bigint_delete(&operand_x);
-    bigint_delete(&operand_y);
-    bigint_delete(&operand_y_half);
-    bigint_delete(&operand_z);
-    bigint_delete(&result);
-    bigint_delete(&pre_comp);
-    bigint_delete(&quotient);
-    bigint_delete(&remainder);
-}
\ No newline at end of file
+#include "autobahn_evaluation.h"
+#include "autobahn_evaluation_timing.h"
+#include "autobahn_internal.h"
+
+#include <math.h>
+#include <string.h>
+#if defined(__linux__)
+    #include <errno.h>
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#define BENCHMARK_BATCH_NUM 16                    /**< Operands of the batch operations. */
+#define BENCHMARK_LANE_NUM 4                      /**< Operands of the multi-buffer and pooled exponentiations. */
+#define BENCHMARK_SEED 0x62656e63686d6172ULL      /**< Seed of the operands, identical across runs. */
+#define BENCHMARK_ALL ((size_t)-1)                /**< No size limit. */
+
+/** @brief Hardware counters read around an operation, in the order of the output columns. */
+typedef enum {
+    COUNTER_CYCLES,                               /**< Core cycles, unlike the TSC they follow frequency scaling. */
+    COUNTER_INSTRUCTIONS,                         /**< Retired instructions. */
+    COUNTER_BRANCH_MISSES,                        /**< Mispredicted branches. */
+    COUNTER_L1D_MISSES,                           /**< L1 data cache read misses. */
+    COUNTER_LLC_MISSES,                           /**< Last level cache misses. */
+    COUNTER_NUM
+} BenchmarkCounter;
+
+/** @brief Group of perf_event counters of the calling thread, user space only. */
+typedef struct {
+    int leader;                                   /**< File descriptor of the group leader, -1 if no counter opened. */
+    int fds[COUNTER_NUM];                         /**< File descriptor of each counter, -1 if unavailable. */
+    size_t slots[COUNTER_NUM];                    /**< Position of each counter in a group read. */
+    size_t open_num;                              /**< Counters in the group. */
+} BenchmarkCounters;
+
+/** @brief Operands of one operand size, shared by every operation. */
+typedef struct {
+    size_t bit_length;                            /**< Operand size in bits. */
+    Bigint* operand_x;                            /**< bit_length bits. */
+    Bigint* operand_y;                            /**< bit_length bits. */
+    Bigint* operand_y_half;                       /**< bit_length / 2 bits, divisor and Barrett modulus. */
+    Bigint* pre_comp;                             /**< Barrett pre-computation of operand_y_half, made on demand. */
+    Bigint* base;                                 /**< bit_length - 1 bits, below modular. */
+    Bigint* exponent;                             /**< bit_length bits. */
+    Bigint* exponent_public;                      /**< 65537. */
+    Bigint* modular;                              /**< Odd, bit_length bits. */
+    ModularContext* context;                      /**< Context of modular, made on demand. */
+    Bigint* prime;                                /**< Probable prime of bit_length bits, made on demand. */
+    Bigint* result;                               /**< Reused output. */
+    Bigint* quotient;                             /**< Reused output. */
+    Bigint* remainder;                            /**< Reused output. */
+    Bigint* batch[BENCHMARK_BATCH_NUM];           /**< Operands of the batch operations. */
+    Bigint* batch_results[BENCHMARK_BATCH_NUM];   /**< Outputs of the batch operations. */
+    bool invertible[BENCHMARK_BATCH_NUM];         /**< Output of the batch inverse. */
+    Bigint* lane_results[BENCHMARK_LANE_NUM];     /**< Outputs of the multi-buffer exponentiation. */
+    ExponentiationJob jobs[BENCHMARK_LANE_NUM];   /**< Jobs of the pooled exponentiation. */
+    ThreadPool* pool;                             /**< Pool of the pooled exponentiation. */
+    char* decimal;                                /**< Decimal string of operand_x. */
+    size_t decimal_length;                        /**< Length of decimal. */
+    char* hex;                                    /**< Hexadecimal string of operand_x. */
+    size_t hex_length;                            /**< Length of hex. */
+    unsigned char* bytes;                         /**< Big-endian bytes of operand_x. */
+    size_t byte_length;                           /**< Length of bytes. */
+} BenchmarkOperands;
+
+/** @brief Operation being measured, run once per iteration. */
+typedef struct {
+    const char* name;                             /**< Name in the output. */
+    size_t bit_max;                               /**< Largest size measured, the rest take too long. */
+    void (*prepare)(BenchmarkOperands* operands); /**< Untimed setup before the first sample, or NULL. */
+    void (*run)(BenchmarkOperands* operands);     /**< Timed operation. */
+} BenchmarkOperation;
+
+/** @brief Summary of the samples of one operation at one size. */
+typedef struct {
+    size_t iteration_num;                         /**< Iterations per sample. */
+    size_t sample_num;                            /**< Samples measured. */
+    double min_ns;                                /**< Fastest iteration. */
+    double median_ns;                             /**< Median iteration. */
+    double p99_ns;                                /**< 99th percentile iteration, nearest rank. */
+    double median_cycles;                         /**< Median iteration in TSC cycles, NAN without a TSC. */
+    bool has_memory;                              /**< Whether the memory fields are counted, BI_MEMORY_STATS builds. */
+    uint64_t allocation_num;                      /**< Allocator calls of one iteration. */
+    uint64_t allocated_byte_num;                  /**< Bytes allocated by one iteration. */
+    uint64_t peak_byte_num;                       /**< Largest memory one iteration holds at once. */
+    uint64_t copy_byte_num;                       /**< Bytes bigint_copy moves in one iteration. */
+    bool has_counters;                            /**< Whether the hardware counter fields are read. */
+    double counters[COUNTER_NUM];                 /**< Hardware counters per iteration, NAN if unavailable. */
+} BenchmarkResult;
+
+/* operations, grouped as in autobahn.h */
+static void benchmark_addition(BenchmarkOperands* o)                 { bigint_addition(&o->result, o->operand_x, o->operand_y); }
+static void benchmark_subtraction(BenchmarkOperands* o)              { bigint_subtraction(&o->result, o->operand_x, o->operand_y); }
+static void benchmark_multiplication_textbook(BenchmarkOperands* o)  { bigint_multiplication_textbook(&o->result, o->operand_x, o->operand_y); }
+static void benchmark_multiplication_karatsuba(BenchmarkOperands* o) { bigint_multiplication_karatsuba(&o->result, o->operand_x, o->operand_y); }
+static void benchmark_squaring_textbook(BenchmarkOperands* o)        { bigint_squaring_textbook(&o->result, o->operand_x); }
+static void benchmark_squaring_karatsuba(BenchmarkOperands* o)       { bigint_squaring_karatsuba(&o->result, o->operand_x); }
+static void benchmark_division_word_long(BenchmarkOperands* o)       { bigint_division_word_long(&o->quotient, &o->remainder, o->operand_x, o->operand_y_half); }
+static void benchmark_division_binary_long(BenchmarkOperands* o)     { bigint_division_binary_long(&o->quotient, &o->remainder, o->operand_x, o->operand_y_half); }
+static void benchmark_division_words(BenchmarkOperands* o)           { words_division_bigint(&o->quotient, &o->remainder, o->operand_x, o->operand_y_half); }
+static void benchmark_reduction_barrett(BenchmarkOperands* o)        { bigint_reduction_barrett(&o->remainder, o->operand_x, o->operand_y_half, o->pre_comp); }
+static void benchmark_from_decimal(BenchmarkOperands* o)             { bigint_from_string(&o->result, o->decimal, o->decimal_length, 10); }
+static void benchmark_to_decimal(BenchmarkOperands* o)               { bigint_to_string(o->decimal, o->decimal_length + 1, NULL, o->operand_x, 10); }
+static void benchmark_from_hex(BenchmarkOperands* o)                 { bigint_from_hex(&o->result, o->hex, o->hex_length); }
+static void benchmark_to_hex(BenchmarkOperands* o)                   { bigint_to_hex(o->hex, o->hex_length + 1, NULL, o->operand_x); }
+static void benchmark_from_bytes(BenchmarkOperands* o)               { bigint_from_bytes_be(&o->result, o->bytes, o->byte_length); }
+static void benchmark_to_bytes(BenchmarkOperands* o)                 { bigint_to_bytes_be(o->bytes, o->byte_length, o->operand_x); }
+static void benchmark_sqrtrem(BenchmarkOperands* o)                  { bigint_sqrtrem(&o->result, &o->remainder, o->operand_x); }
+static void benchmark_cube_rootrem(BenchmarkOperands* o)             { bigint_rootrem(&o->result, &o->remainder, o->operand_x, 3); }
+static void benchmark_gcd(BenchmarkOperands* o)                      { bigint_gcd(&o->result, o->operand_x, o->operand_y); }
+static void benchmark_gcdext(BenchmarkOperands* o)                   { bigint_gcdext(&o->result, &o->quotient, &o->remainder, o->operand_x, o->operand_y); }
+static void benchmark_mod_inverse(BenchmarkOperands* o)              { bigint_mod_inverse(&o->result, o->base, o->modular); }
+static void benchmark_mod_inverse_batch(BenchmarkOperands* o)        { bigint_mod_inverse_batch(o->batch_results, o->invertible, o->batch, BENCHMARK_BATCH_NUM, o->context); }
+static void benchmark_is_probable_prime(BenchmarkOperands* o)        { bigint_is_probable_prime(o->prime, 8); }
+static void benchmark_random_prime(BenchmarkOperands* o)             { bigint_random_prime(&o->result, o->bit_length, false, 8, NULL); }
+static void benchmark_batch_gcd(BenchmarkOperands* o)                { bigint_batch_gcd(o->batch_results, o->batch, BENCHMARK_BATCH_NUM, 0, NULL, NULL); }
+static void benchmark_exponentiation_left_to_right(BenchmarkOperands* o)   { bigint_exponentiation_modular_left_to_right(&o->result, o->base, o->exponent, o->modular); }
+static void benchmark_exponentiation_ladder(BenchmarkOperands* o)          { bigint_exponentiation_modular_montgomery_ladder(&o->result, o->base, o->exponent, o->modular); }
+static void benchmark_exponentiation_fixed_window(BenchmarkOperands* o)    { bigint_exponentiation_modular_fixed_window(&o->result, o->base, o->exponent, o->modular); }
+static void benchmark_exponentiation_window_context(BenchmarkOperands* o)  { bigint_exponentiation_modular_fixed_window_context(&o->result, o->base, o->exponent, o->context); }
+static void benchmark_exponentiation_public(BenchmarkOperands* o)          { bigint_exponentiation_modular_public(&o->result, o->base, o->exponent_public, o->context); }
+static void benchmark_random_bits(BenchmarkOperands* o)              { bigint_random_bits(&o->result, o->bit_length); }
+static void benchmark_random_below(BenchmarkOperands* o)             { bigint_random_below(&o->result, o->modular); }
+
+static void benchmark_product_tree(BenchmarkOperands* o)
+{
+    ProductTree* tree = NULL;
+    bigint_product_tree_new(&tree, o->batch, BENCHMARK_BATCH_NUM, 0, NULL, NULL);
+    bigint_product_tree_delete(&tree);
+}
+
+static void benchmark_exponentiation_multi_buffer(BenchmarkOperands* o)
+{
+    Bigint* bases[BENCHMARK_LANE_NUM];
+    Bigint* exponents[BENCHMARK_LANE_NUM];
+    Bigint* modulars[BENCHMARK_LANE_NUM];
+    for (size_t idx = 0; idx < BENCHMARK_LANE_NUM; idx++) {
+        bases[idx] = o->base;
+        exponents[idx] = o->exponent;
+        modulars[idx] = o->modular;
+    }
+    bigint_exponentiation_modular_multi_buffer(o->lane_results, bases, exponents, modulars, BENCHMARK_LANE_NUM);
+}
+
+static void benchmark_exponentiation_batch(BenchmarkOperands* o)
+{
+    bigint_exponentiation_modular_batch(o->pool, o->jobs, BENCHMARK_LANE_NUM);
+}
+
+static void benchmark_prepare_prime(BenchmarkOperands* o)
+{
+    if (o->prime == NULL)
+        bigint_random_prime(&o->prime, o->bit_length, false, 8, NULL);
+}
+
+/* the library computes both pre-computations with bigint_division_word_long, too slow for the largest sizes */
+static void benchmark_prepare_barrett(BenchmarkOperands* o)
+{
+    if (o->pre_comp == NULL)
+        bigint_reduction_barrett_pre_computed(&o->pre_comp, o->operand_y_half);
+}
+
+static void benchmark_prepare_context(BenchmarkOperands* o)
+{
+    if (o->context == NULL)
+        bigint_modular_context_new(&o->context, o->modular);
+}
+
+static void benchmark_prepare_pool(BenchmarkOperands* o)
+{
+    benchmark_prepare_context(o);
+    if (o->pool == NULL)
+        bigint_thread_pool_new(&o->pool, BENCHMARK_LANE_NUM);
+    for (size_t idx = 0; idx < BENCHMARK_LANE_NUM; idx++) {
+        if (o->jobs[idx].result == NULL)
+            bigint_new(&o->jobs[idx].result, o->context->digit_num);
+        o->jobs[idx].base = o->base;
+        o->jobs[idx].exponent = o->exponent;
+        o->jobs[idx].context = o->context;
+        o->jobs[idx].exponent_is_public = false;
+    }
+}
+
+/*
+ * Every algorithm variant, with the largest size each finishes in reasonable time on one core.
+ * division_words is the array kernel the other modules divide with, bigint_division_naive is left
+ * out, it subtracts the divisor once per unit of the quotient.
+ */
+static const BenchmarkOperation benchmark_operations[] = {
+    { "addition",                         BENCHMARK_ALL, NULL,                      benchmark_addition },
+    { "subtraction",                      BENCHMARK_ALL, NULL,                      benchmark_subtraction },
+    { "multiplication_textbook",          1 << 13,       NULL,                      benchmark_multiplication_textbook },
+    { "multiplication_karatsuba",         1 << 17,       NULL,                      benchmark_multiplication_karatsuba },
+    { "squaring_textbook",                1 << 13,       NULL,                      benchmark_squaring_textbook },
+    { "squaring_karatsuba",               1 << 17,       NULL,                      benchmark_squaring_karatsuba },
+    { "division_word_long",               1 << 15,       NULL,                      benchmark_division_word_long },
+    { "division_binary_long",             1 << 14,       NULL,                      benchmark_division_binary_long },
+    { "division_words",                   BENCHMARK_ALL, NULL,                      benchmark_division_words },
+    { "reduction_barrett",                1 << 15,       benchmark_prepare_barrett, benchmark_reduction_barrett },
+    { "from_string_decimal",              BENCHMARK_ALL, NULL,                      benchmark_from_decimal },
+    { "to_string_decimal",                BENCHMARK_ALL, NULL,                      benchmark_to_decimal },
+    { "from_hex",                         BENCHMARK_ALL, NULL,                      benchmark_from_hex },
+    { "to_hex",                           BENCHMARK_ALL, NULL,                      benchmark_to_hex },
+    { "from_bytes_be",                    BENCHMARK_ALL, NULL,                      benchmark_from_bytes },
+    { "to_bytes_be",                      BENCHMARK_ALL, NULL,                      benchmark_to_bytes },
+    { "sqrtrem",                          BENCHMARK_ALL, NULL,                      benchmark_sqrtrem },
+    { "rootrem_cube",                     1 << 18,       NULL,                      benchmark_cube_rootrem },
+    { "gcd",                              1 << 18,       NULL,                      benchmark_gcd },
+    { "gcdext",                           1 << 17,       NULL,                      benchmark_gcdext },
+    { "mod_inverse",                      1 << 17,       NULL,                      benchmark_mod_inverse },
+    { "mod_inverse_batch_16",             1 << 14,       benchmark_prepare_context, benchmark_mod_inverse_batch },
+    { "is_probable_prime",                1 << 11,       benchmark_prepare_prime,   benchmark_is_probable_prime },
+    { "random_prime",                     1 << 10,       NULL,                      benchmark_random_prime },
+    { "product_tree_16",                  1 << 17,       NULL,                      benchmark_product_tree },
+    { "batch_gcd_16",                     1 << 15,       NULL,                      benchmark_batch_gcd },
+    { "exponentiation_left_to_right",     1 << 10,       NULL,                      benchmark_exponentiation_left_to_right },
+    { "exponentiation_montgomery_ladder", 1 << 10,       NULL,                      benchmark_exponentiation_ladder },
+    { "exponentiation_fixed_window",      1 << 12,       NULL,                      benchmark_exponentiation_fixed_window },
+    { "exponentiation_window_context",    1 << 12,       benchmark_prepare_context, benchmark_exponentiation_window_context },
+    { "exponentiation_public_65537",      1 << 14,       benchmark_prepare_context, benchmark_exponentiation_public },
+    { "exponentiation_multi_buffer_x4",   1 << 12,       NULL,                      benchmark_exponentiation_multi_buffer },
+    { "exponentiation_batch_x4",          1 << 12,       benchmark_prepare_pool,    benchmark_exponentiation_batch },
+    { "random_bits",                      BENCHMARK_ALL, NULL,                      benchmark_random_bits },
+    { "random_below",                     BENCHMARK_ALL, NULL,                      benchmark_random_below },
+};
+
+/**
+ * @brief Opens the hardware counters as one group, skipping the ones the kernel or the CPU refuses.
+ *
+ * Counters are optional: perf_event_paranoid, containers and virtual machines often forbid them, and a
+ * CPU may lack an event. Whatever opens is used, and nothing opening only drops the counter columns.
+ *
+ * @param counters [out] Counter group.
+ * @return bool True if at least one counter opened.
+ */
+static bool benchmark_counters_open(BenchmarkCounters* counters)
+{
+    counters->leader = -1;
+    counters->open_num = 0;
+    for (size_t idx = 0; idx < COUNTER_NUM; idx++)
+        counters->fds[idx] = -1;
+
+#if defined(__linux__)
+    static const struct { uint32_t type; uint64_t config; } events[COUNTER_NUM] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    };
+    int error = 0;
+
+    for (size_t idx = 0; idx < COUNTER_NUM; idx++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[idx].type;
+        attr.config = events[idx].config;
+        attr.disabled = counters->leader == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, counters->leader, 0);
+        if (fd < 0) {
+            error = errno;
+            continue;
+        }
+        if (counters->leader == -1)
+            counters->leader = fd;
+        counters->fds[idx] = fd;
+        counters->slots[idx] = counters->open_num++;
+    }
+
+    if (counters->leader == -1)
+        fprintf(stderr, "Hardware counters unavailable (perf_event_open: %s), continuing without them.\n", strerror(error));
+#endif
+    return counters->leader != -1;
+}
+
+/**
+ * @brief Closes the hardware counters.
+ *
+ * @param counters [in, out] Counter group.
+ */
+static void benchmark_counters_close(BenchmarkCounters* counters)
+{
+#if defined(__linux__)
+    for (size_t idx = 0; idx < COUNTER_NUM; idx++)
+        if (counters->fds[idx] != -1)
+            close(counters->fds[idx]);
+#endif
+    counters->leader = -1;
+    counters->open_num = 0;
+}
+
+/**
+ * @brief Counts the hardware events of a batch of iterations.
+ *
+ * When the kernel multiplexes the group with other users of the PMU, counts are scaled by the share of
+ * time the group was scheduled. A group that was never scheduled leaves every value NAN.
+ *
+ * @param values [out] Counters per iteration, NAN if unavailable.
+ * @param counters [in] Counter group.
+ * @param operation [in] Operation to count.
+ * @param operands [in, out] Operands of the size.
+ * @param iteration_num [in] Iterations in the batch.
+ */
+static void benchmark_counters_measure(double* values, const BenchmarkCounters* counters, const BenchmarkOperation* operation,
+                                       BenchmarkOperands* operands, size_t iteration_num)
+{
+    for (size_t idx = 0; idx < COUNTER_NUM; idx++)
+        values[idx] = NAN;
+
+#if defined(__linux__)
+    if (counters->leader == -1)
+        return;
+
+    /* nr, time_enabled, time_running, then one value per counter */
+    uint64_t buffer[3 + COUNTER_NUM];
+
+    ioctl(counters->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(counters->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    for (size_t iteration = 0; iteration < iteration_num; iteration++)
+        operation->run(operands);
+    ioctl(counters->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    ssize_t byte_num = read(counters->leader, buffer, sizeof(buffer));
+    if (byte_num < (ssize_t)(3 * sizeof(uint64_t)) || buffer[0] != counters->open_num || buffer[2] == 0)
+        return;
+
+    double scale = (double)buffer[1] / (double)buffer[2] / (double)iteration_num;
+    for (size_t idx = 0; idx < COUNTER_NUM; idx++)
+        if (counters->fds[idx] != -1)
+            values[idx] = (double)buffer[3 + counters->slots[idx]] * scale;
+#else
+    (void)counters;
+    (void)operation;
+    (void)operands;
+    (void)iteration_num;
+#endif
+}
+
+/**
+ * @brief Generates the operands of one size from the fixed seed.
+ *
+ * @param operands [out] Operands, zero-initialized.
+ * @param bit_length [in] Operand size in bits.
+ */
+static void benchmark_operands_new(BenchmarkOperands* operands, size_t bit_length)
+{
+    /* Same operands on every run, so results are comparable */
+    RandomXoshiro state;
+    bigint_random_xoshiro_seed(&state, BENCHMARK_SEED + bit_length);
+    bigint_random_set_source(bigint_random_xoshiro_fill, &state);
+
+    operands->bit_length = bit_length;
+    bigint_random_bits(&operands->operand_x, bit_length);
+    bigint_random_bits(&operands->operand_y, bit_length);
+    bigint_random_bits(&operands->operand_y_half, bit_length / 2);
+    bigint_random_bits(&operands->base, bit_length - 1);
+    bigint_random_bits(&operands->exponent, bit_length);
+    bigint_random_bits(&operands->modular, bit_length);
+    operands->modular->digits[0] |= 1;
+    for (size_t idx = 0; idx < BENCHMARK_BATCH_NUM; idx++)
+        bigint_random_below(&operands->batch[idx], operands->modular);
+    bigint_set_by_hex_string(&operands->exponent_public, "10001", POSITIVE);
+    bigint_new(&operands->result, 1);
+    bigint_new(&operands->quotient, 1);
+    bigint_new(&operands->remainder, 1);
+
+    /* Encodings of operand_x, also the buffers of the encoders */
+    bigint_to_string(NULL, 0, &operands->decimal_length, operands->operand_x, 10);
+    operands->decimal = (char*)malloc(operands->decimal_length + 1);
+    bigint_to_string(operands->decimal, operands->decimal_length + 1, NULL, operands->operand_x, 10);
+    bigint_to_hex(NULL, 0, &operands->hex_length, operands->operand_x);
+    operands->hex = (char*)malloc(operands->hex_length + 1);
+    bigint_to_hex(operands->hex, operands->hex_length + 1, NULL, operands->operand_x);
+    operands->byte_length = bigint_byte_length(operands->operand_x);
+    operands->bytes = (unsigned char*)malloc(operands->byte_length);
+    bigint_to_bytes_be(operands->bytes, operands->byte_length, operands->operand_x);
+
+    /* Back to the default source, the seeded one goes out of scope */
+    bigint_random_set_source(NULL, NULL);
+}
+
+static void benchmark_operands_delete(BenchmarkOperands* operands)
+{
+    bigint_delete(&operands->operand_x);
+    bigint_delete(&operands->operand_y);
+    bigint_delete(&operands->operand_y_half);
+    bigint_delete(&operands->pre_comp);
+    bigint_delete(&operands->base);
+    bigint_delete(&operands->exponent);
+    bigint_delete(&operands->exponent_public);
+    bigint_delete(&operands->modular);
+    bigint_delete(&operands->prime);
+    bigint_delete(&operands->result);
+    bigint_delete(&operands->quotient);
+    bigint_delete(&operands->remainder);
+    bigint_modular_context_delete(&operands->context);
+    for (size_t idx = 0; idx < BENCHMARK_BATCH_NUM; idx++) {
+        bigint_delete(&operands->batch[idx]);
+        bigint_delete(&operands->batch_results[idx]);
+    }
+    for (size_t idx = 0; idx < BENCHMARK_LANE_NUM; idx++) {
+        bigint_delete(&operands->lane_results[idx]);
+        bigint_delete(&operands->jobs[idx].result);
+    }
+    bigint_thread_pool_delete(&operands->pool);
+    free(operands->decimal);
+    free(operands->hex);
+    free(operands->bytes);
+}
+
+/** @brief Operation and operands of a timed batch. */
+typedef struct {
+    const BenchmarkOperation* operation;
+    BenchmarkOperands* operands;
+} BenchmarkBatch;
+
+/**
+ * @brief Runs one timed batch of an operation, an EvaluationBatch.
+ *
+ * @param context [in] BenchmarkBatch.
+ * @param iteration_num [in] Iterations.
+ */
+static void benchmark_batch(void* context, size_t iteration_num)
+{
+    BenchmarkBatch* batch = (BenchmarkBatch*)context;
+    for (size_t iteration = 0; iteration < iteration_num; iteration++)
+        batch->operation->run(batch->operands);
+}
+
+/**
+ * @brief Measures one operation: calibrates a batch of iterations, warms up, then samples.
+ *
+ * Each sample times a batch lasting at least config->sample_ns, so the clock resolution does not matter.
+ * Slow operations get fewer samples and warmups, bounded by config->budget_ns, but at least config->sample_min.
+ *
+ * @param result [out] Statistics per iteration.
+ * @param operation [in] Operation to measure.
+ * @param operands [in, out] Operands of the size.
+ * @param counters [in] Hardware counters, read on one more batch if any opened.
+ * @param config [in] Settings.
+ */
+static void benchmark_measure(BenchmarkResult* result, const BenchmarkOperation* operation, BenchmarkOperands* operands,
+                              const BenchmarkCounters* counters, const BenchmarkConfig* config)
+{
+    /* Calibrate: the first call also warms caches and lazily built tables */
+    operation->run(operands);
+    uint64_t start = evaluation_now_ns();
+    operation->run(operands);
+    uint64_t single_ns = evaluation_now_ns() - start;
+    if (single_ns == 0)
+        single_ns = 1;
+
+    size_t iteration_num = config->sample_ns > single_ns ? (size_t)(config->sample_ns / single_ns) : 1;
+    uint64_t batch_ns = (uint64_t)iteration_num * single_ns;
+
+    size_t sample_num = config->budget_ns / batch_ns;
+    if (sample_num > config->sample_num)
+        sample_num = config->sample_num;
+    if (sample_num < config->sample_min)
+        sample_num = config->sample_min;
+    size_t warmup_num = config->warmup_num;
+    if (warmup_num * batch_ns > config->budget_ns / 4)
+        warmup_num = 0;
+
+    /* Warm up */
+    BenchmarkBatch context = { operation, operands };
+    for (size_t idx = 0; idx < warmup_num; idx++)
+        benchmark_batch(&context, iteration_num);
+
+    /* Sample */
+    EvaluationTiming timing;
+    evaluation_sample(&timing, benchmark_batch, &context, iteration_num, sample_num);
+
+    result->iteration_num = iteration_num;
+    result->sample_num = sample_num;
+    result->min_ns = timing.min_ns;
+    result->median_ns = timing.median_ns;
+    result->p99_ns = timing.p99_ns;
+    result->median_cycles = timing.median_cycles;
+
+    /* Memory traffic of one more iteration */
+    MemoryStats memory;
+    bigint_memory_stats_reset();
+    result->has_memory = bigint_memory_stats(&memory);
+    uint64_t live_byte_num = memory.live_byte_num;
+    operation->run(operands);
+    bigint_memory_stats(&memory);
+    result->allocation_num = memory.malloc_num + memory.calloc_num + memory.realloc_num;
+    result->allocated_byte_num = memory.allocated_byte_num;
+    result->peak_byte_num = memory.peak_byte_num - live_byte_num;
+    result->copy_byte_num = memory.copy_byte_num;
+
+    /* Hardware events of one more batch, kept apart from the timed samples */
+    result->has_counters = counters->leader != -1;
+    benchmark_counters_measure(result->counters, counters, operation, operands, iteration_num);
+}
+
+/**
+ * @brief Writes the header of the output.
+ *
+ * @param config [in] Settings.
+ * @param has_memory [in] Whether the memory columns are written.
+ * @param has_counters [in] Whether the hardware counter columns are written.
+ */
+static void benchmark_print_header(const BenchmarkConfig* config, bool has_memory, bool has_counters)
+{
+    FILE* output = config->output;
+    switch (config->format) {
+    case BENCHMARK_CSV:
+        fprintf(output, "operation,word_bits,bits,limbs,iterations,samples,min_ns,median_ns,p99_ns,median_cycles,cycles_per_limb");
+        if (has_memory)
+            fprintf(output, ",allocations,allocated_bytes,peak_bytes,copy_bytes");
+        if (has_counters)
+            fprintf(output, ",hw_cycles,instructions,branch_misses,l1d_misses,llc_misses,ipc,"
+                    "branch_misses_per_limb,l1d_misses_per_limb,llc_misses_per_limb");
+        fprintf(output, "\n");
+        break;
+    case BENCHMARK_JSON:
+        fprintf(output, "{\n  \"word_bits\": %zu,\n  \"tsc\": %s,\n  \"memory_stats\": %s,\n  \"hardware_counters\": %s,\n  \"results\": [",
+                (size_t)BITLEN_OF_WORD, EVALUATION_HAS_TSC ? "true" : "false", has_memory ? "true" : "false",
+                has_counters ? "true" : "false");
+        break;
+    default:
+        fprintf(output, "%-32s %8s %6s %9s %7s %13s %13s %13s %13s %9s", "operation", "bits", "limbs", "iters",
+                "samples", "min_ns", "median_ns", "p99_ns", "med_cycles", "cyc/limb");
+        if (has_memory)
+            fprintf(output, " %8s %12s %12s %12s", "allocs", "alloc_bytes", "peak_bytes", "copy_bytes");
+        if (has_counters)
+            fprintf(output, " %6s %9s %9s %9s", "ipc", "br/limb", "l1d/limb", "llc/limb");
+        fprintf(output, "\n");
+        break;
+    }
+}
+
+/**
+ * @brief Writes a JSON member of a record, null for a value that was not measured.
+ *
+ * @param output [in] Output stream.
+ * @param name [in] Member name.
+ * @param value [in] Value, NAN for null.
+ * @param precision [in] Digits after the decimal point.
+ */
+static void benchmark_print_json_number(FILE* output, const char* name, double value, int precision)
+{
+    if (isnan(value))
+        fprintf(output, ", \"%s\": null", name);
+    else
+        fprintf(output, ", \"%s\": %.*f", name, precision, value);
+}
+
+/**
+ * @brief Writes one measurement.
+ *
+ * @param config [in] Settings.
+ * @param name [in] Operation name.
+ * @param bit_length [in] Operand size in bits.
+ * @param result [in] Statistics.
+ * @param is_first [in] Whether it is the first record, for the JSON separators.
+ */
+static void benchmark_print_result(const BenchmarkConfig* config, const char* name, size_t bit_length,
+                                   const BenchmarkResult* result, bool is_first)
+{
+    FILE* output = config->output;
+    size_t limb_num = (bit_length + BITLEN_OF_WORD - 1) / BITLEN_OF_WORD;
+    double cycles_per_limb = result->median_cycles / (double)limb_num;
+
+    /* Derived hardware metrics, NAN propagates from a missing counter */
+    const double* counters = result->counters;
+    double ipc = counters[COUNTER_INSTRUCTIONS] / counters[COUNTER_CYCLES];
+    double per_limb[3] = {
+        counters[COUNTER_BRANCH_MISSES] / (double)limb_num,
+        counters[COUNTER_L1D_MISSES] / (double)limb_num,
+        counters[COUNTER_LLC_MISSES] / (double)limb_num
+    };
+
+    switch (config->format) {
+    case BENCHMARK_CSV:
+        fprintf(output, "%s,%zu,%zu,%zu,%zu,%zu,%.1f,%.1f,%.1f,%.1f,%.3f", name, (size_t)BITLEN_OF_WORD, bit_length,
+                limb_num, result->iteration_num, result->sample_num, result->min_ns, result->median_ns, result->p99_ns,
+                result->median_cycles, cycles_per_limb);
+        if (result->has_memory)
+            fprintf(output, ",%llu,%llu,%llu,%llu", (unsigned long long)result->allocation_num,
+                    (unsigned long long)result->allocated_byte_num, (unsigned long long)result->peak_byte_num,
+                    (unsigned long long)result->copy_byte_num);
+        if (result->has_counters) {
+            for (size_t idx = 0; idx < COUNTER_NUM; idx++)
+                fprintf(output, ",%.1f", counters[idx]);
+            fprintf(output, ",%.3f,%.4f,%.4f,%.4f", ipc, per_limb[0], per_limb[1], per_limb[2]);
+        }
+        fprintf(output, "\n");
+        break;
+    case BENCHMARK_JSON:
+        fprintf(output, "%s\n    {\"operation\": \"%s\", \"bits\": %zu, \"limbs\": %zu, \"iterations\": %zu, "
+                "\"samples\": %zu, \"min_ns\": %.1f, \"median_ns\": %.1f, \"p99_ns\": %.1f, ",
+                is_first ? "" : ",", name, bit_length, limb_num, result->iteration_num, result->sample_num,
+                result->min_ns, result->median_ns, result->p99_ns);
+        if (isnan(result->median_cycles))
+            fprintf(output, "\"median_cycles\": null, \"cycles_per_limb\": null");
+        else
+            fprintf(output, "\"median_cycles\": %.1f, \"cycles_per_limb\": %.3f", result->median_cycles, cycles_per_limb);
+        if (result->has_memory)
+            fprintf(output, ", \"allocations\": %llu, \"allocated_bytes\": %llu, \"peak_bytes\": %llu, \"copy_bytes\": %llu",
+                    (unsigned long long)result->allocation_num, (unsigned long long)result->allocated_byte_num,
+                    (unsigned long long)result->peak_byte_num, (unsigned long long)result->copy_byte_num);
+        if (result->has_counters) {
+            static const char* const names[COUNTER_NUM] = { "hw_cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses" };
+            static const char* const limb_names[3] = { "branch_misses_per_limb", "l1d_misses_per_limb", "llc_misses_per_limb" };
+            for (size_t idx = 0; idx < COUNTER_NUM; idx++)
+                benchmark_print_json_number(output, names[idx], counters[idx], 1);
+            benchmark_print_json_number(output, "ipc", ipc, 3);
+            for (size_t idx = 0; idx < 3; idx++)
+                benchmark_print_json_number(output, limb_names[idx], per_limb[idx], 4);
+        }
+        fprintf(output, "}");
+        break;
+    default:
+        fprintf(output, "%-32s %8zu %6zu %9zu %7zu %13.1f %13.1f %13.1f %13.1f %9.2f", name, bit_length, limb_num,
+                result->iteration_num, result->sample_num, result->min_ns, result->median_ns, result->p99_ns,
+                result->median_cycles, cycles_per_limb);
+        if (result->has_memory)
+            fprintf(output, " %8llu %12llu %12llu %12llu", (unsigned long long)result->allocation_num,
+                    (unsigned long long)result->allocated_byte_num, (unsigned long long)result->peak_byte_num,
+                    (unsigned long long)result->copy_byte_num);
+        if (result->has_counters)
+            fprintf(output, " %6.2f %9.3f %9.3f %9.3f", ipc, per_limb[0], per_limb[1], per_limb[2]);
+        fprintf(output, "\n");
+        break;
+    }
+    fflush(output);
+}
+
+/**
+ * @brief Fills a benchmark configuration with the defaults: 256 bits to 1M bits, 31 samples of 1 ms, text.
+ *
+ * @param config [out] Settings.
+ */
+void bigint_benchmark_config_default(BenchmarkConfig* config)
+{
+    config->bit_min = 256;
+    config->bit_max = 1 << 20;
+    config->warmup_num = 3;
+    config->sample_num = 31;
+    config->sample_min = 5;
+    config->sample_ns = 1000000;
+    config->budget_ns = 2000000000;
+    config->filter = NULL;
+    config->format = BENCHMARK_TEXT;
+    config->output = stdout;
+    config->hardware_counters = false;
+}
+
+/**
+ * @brief Runs every operation over operand sizes doubling from bit_min to bit_max.
+ *
+ * Cycles are TSC reference cycles, and per limb means per Word of one full-size operand.
+ * A BI_MEMORY_STATS build adds the allocations, bytes, peak and bigint_copy volume of one call.
+ * With config->hardware_counters on Linux, perf_event counters of one more batch add the IPC and the branch,
+ * L1D and LLC misses per limb; counters the system refuses are left out or printed as NAN and null.
+ *
+ * @param config [in] Settings.
+ */
+void bigint_benchmark_run(const BenchmarkConfig* config)
+{
+    /* Invalid case */
+    if (config->bit_min < 2 * BITLEN_OF_WORD || config->bit_min > config->bit_max || config->sample_num == 0) {
+        printf("Invalid Case: Benchmark sizes or samples out of range.\n");
+        return;
+    }
+
+    size_t operation_num = sizeof(benchmark_operations) / sizeof(benchmark_operations[0]);
+    bool is_first = true;
+
+    MemoryStats memory;
+    BenchmarkCounters counters;
+    counters.leader = -1;
+    bool has_counters = config->hardware_counters && benchmark_counters_open(&counters);
+    benchmark_print_header(config, bigint_memory_stats(&memory), has_counters);
+    for (size_t bit_length = config->bit_min; bit_length <= config->bit_max; bit_length *= 2) {
+        BenchmarkOperands operands;
+        memset(&operands, 0, sizeof(operands));
+        benchmark_operands_new(&operands, bit_length);
+
+        for (size_t idx = 0; idx < operation_num; idx++) {
+            const BenchmarkOperation* operation = &benchmark_operations[idx];
+            if (bit_length > operation->bit_max)
+                continue;
+            if (config->filter != NULL && strstr(operation->name, config->filter) == NULL)
+                continue;
+
+            BenchmarkResult result;
+            if (operation->prepare != NULL)
+                operation->prepare(&operands);
+            benchmark_measure(&result, operation, &operands, &counters, config);
+            benchmark_print_result(config, operation->name, bit_length, &result, is_first);
+            is_first = false;
+        }
+
+        benchmark_operands_delete(&operands);
+    }
+    if (config->format == BENCHMARK_JSON)
+        fprintf(config->output, "\n  ]\n}\n");
+    if (has_counters)
+        benchmark_counters_close(&counters);
+}
+
+/**
+ * @brief Runs every operation at one operand size and prints a table.
+ *
+ * @param bit_length [in] Operand size in bits.
+ */
+void bigint_benchmark(size_t bit_length)
+{
+    BenchmarkConfig config;
+    bigint_benchmark_config_default(&config);
+    config.bit_min = bit_length;
+    config.bit_max = bit_length;
+    bigint_benchmark_run(&config);
+}
@@ -0,0 +1,367 @@
+#include "autobahn_evaluation.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Dataset file layout, every field in host byte order:
+ *
+ *   header   DatasetHeader, DATASET_ALIGN bytes
+ *   records  per record: uint64 meta = digit_num | sign << 63, then digit_num Words,
+ *            zero-padded to a multiple of DATASET_ALIGN bytes
+ *   index    record_num uint64 offsets of the records from the start of the file
+ *
+ * The writer streams the records and appends the index on close, then rewrites the header.
+ * Records are aligned, so the reader maps the file and points Bigint views into it.
+ */
+
+#define DATASET_MAGIC "ABDSET\r\n"          /**< First eight bytes of a dataset file. */
+#define DATASET_VERSION 1
+#define DATASET_ALIGN 8                      /**< Alignment of records, enough for every Word size. */
+#define DATASET_BYTE_ORDER 0x0102030405060708ULL
+#define DATASET_SIGN_BIT ((uint64_t)1 << 63)
+
+/** @brief Header at the start of a dataset file. */
+typedef struct {
+    char magic[8];          /**< DATASET_MAGIC. */
+    uint32_t version;       /**< DATASET_VERSION. */
+    uint32_t word_size;     /**< Bytes per Word of the writer, the reader must match. */
+    uint64_t byte_order;    /**< DATASET_BYTE_ORDER as written by the writer's host. */
+    uint64_t record_num;    /**< Number of records. */
+    uint64_t index_offset;  /**< Offset of the index, 0 while the writer is open. */
+    uint64_t reserved[2];   /**< Zero. */
+} DatasetHeader;
+
+/** @brief Structure of a dataset being written, defined here and opaque elsewhere. */
+struct DatasetWriter {
+    FILE* file;          /**< Output file. */
+    uint64_t* offsets;   /**< Offsets of the records written so far. */
+    size_t record_num;   /**< Number of records written. */
+    size_t offset_cap;   /**< Capacity of offsets. */
+    uint64_t position;   /**< Current end of the file. */
+};
+
+/** @brief Structure of a mapped dataset, defined here and opaque elsewhere. */
+struct Dataset {
+    const unsigned char* map;  /**< Read-only mapping of the whole file. */
+    size_t byte_num;           /**< Size of the file. */
+    const uint64_t* offsets;   /**< Index in the mapping. */
+    size_t record_num;         /**< Number of records. */
+};
+
+/**
+ * @brief Opens a dataset file for writing, truncating it.
+ *
+ * @param writer [out] Pointer to the new writer.
+ * @param path [in] Path of the dataset file.
+ * @return bool true on success, false with a message otherwise.
+ */
+bool bigint_dataset_writer_open(DatasetWriter** writer, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("bigint_dataset_writer_open: file open error");
+        return false;
+    }
+
+    /* Placeholder header, completed on close */
+    DatasetHeader header = { 0 };
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        perror("bigint_dataset_writer_open: write error");
+        fclose(file);
+        return false;
+    }
+
+    *writer = (DatasetWriter*)calloc(1, sizeof(DatasetWriter));
+    (*writer)->file = file;
+    (*writer)->position = sizeof(header);
+
+    return true;
+}
+
+/**
+ * @brief Appends a Bigint as the next record of a dataset.
+ *
+ * @param writer [in, out] Writer.
+ * @param bigint [in] Pointer to the Bigint.
+ * @return bool true on success, false with a message otherwise.
+ */
+bool bigint_dataset_write(DatasetWriter* writer, const Bigint* bigint)
+{
+    static const unsigned char padding[DATASET_ALIGN] = { 0 };
+
+    /* Grow the index */
+    if (writer->record_num == writer->offset_cap) {
+        writer->offset_cap = writer->offset_cap > 0 ? 2 * writer->offset_cap : 1024;
+        writer->offsets = (uint64_t*)realloc(writer->offsets, writer->offset_cap * sizeof(uint64_t));
+    }
+
+    /* Length prefix, limbs, padding */
+    uint64_t meta = (uint64_t)bigint->digit_num | (bigint->sign == NEGATIVE ? DATASET_SIGN_BIT : 0);
+    size_t digit_bytes = (size_t)bigint->digit_num * SIZE_OF_WORD;
+    size_t padding_bytes = (DATASET_ALIGN - digit_bytes % DATASET_ALIGN) % DATASET_ALIGN;
+
+    if (fwrite(&meta, sizeof(meta), 1, writer->file) != 1 ||
+        fwrite(bigint->digits, 1, digit_bytes, writer->file) != digit_bytes ||
+        fwrite(padding, 1, padding_bytes, writer->file) != padding_bytes) {
+        perror("bigint_dataset_write: write error");
+        return false;
+    }
+
+    writer->offsets[writer->record_num++] = writer->position;
+    writer->position += sizeof(meta) + digit_bytes + padding_bytes;
+
+    return true;
+}
+
+/**
+ * @brief Writes the index and the header of a dataset and closes it.
+ *
+ * @param writer [in, out] Pointer to the writer, freed.
+ * @return bool true on success, false with a message otherwise.
+ */
+bool bigint_dataset_writer_close(DatasetWriter** writer)
+{
+    /* Invalid pointer */
+    if (*writer == NULL)
+        return false;
+
+    DatasetHeader header = { 0 };
+    memcpy(header.magic, DATASET_MAGIC, sizeof(header.magic));
+    header.version = DATASET_VERSION;
+    header.word_size = SIZE_OF_WORD;
+    header.byte_order = DATASET_BYTE_ORDER;
+    header.record_num = (*writer)->record_num;
+    header.index_offset = (*writer)->position;
+
+    /* Index at the end, then the final header at the start */
+    bool is_written = fwrite((*writer)->offsets, sizeof(uint64_t), (*writer)->record_num, (*writer)->file) == (*writer)->record_num &&
+                      fseek((*writer)->file, 0, SEEK_SET) == 0 &&
+                      fwrite(&header, sizeof(header), 1, (*writer)->file) == 1;
+    if (fclose((*writer)->file) != 0)
+        is_written = false;
+    if (is_written == false)
+        perror("bigint_dataset_writer_close: write error");
+
+    free((*writer)->offsets);
+    free(*writer);
+    *writer = NULL;
+
+    return is_written;
+}
+
+/**
+ * @brief Maps a dataset file read-only and checks its header and index.
+ *
+ * @param dataset [out] Pointer to the mapped dataset.
+ * @param path [in] Path of the dataset file.
+ * @return bool true on success, false with a message otherwise.
+ */
+bool bigint_dataset_open(Dataset** dataset, const char* path)
+{
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        perror("bigint_dataset_open: file open error");
+        return false;
+    }
+
+    /* Map the whole file */
+    struct stat status;
+    void* map = MAP_FAILED;
+    if (fstat(file, &status) == 0 && (size_t)status.st_size >= sizeof(DatasetHeader))
+        map = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (map == MAP_FAILED) {
+        printf("Invalid Case: %s is not a dataset.\n", path);
+        return false;
+    }
+
+    /* Header and index must match this build and lie within the file */
+    size_t byte_num = (size_t)status.st_size;
+    const DatasetHeader* header = (const DatasetHeader*)map;
+    bool is_valid = memcmp(header->magic, DATASET_MAGIC, sizeof(header->magic)) == 0 &&
+                    header->version == DATASET_VERSION &&
+                    header->byte_order == DATASET_BYTE_ORDER &&
+                    header->index_offset % DATASET_ALIGN == 0 &&
+                    header->index_offset <= byte_num &&
+                    header->record_num <= (byte_num - header->index_offset) / sizeof(uint64_t);
+    if (is_valid == false || header->word_size != SIZE_OF_WORD) {
+        if (is_valid == false)
+            printf("Invalid Case: %s is not a dataset.\n", path);
+        else
+            printf("Invalid Case: %s has %u-byte words, this build has %zu-byte words.\n", path, header->word_size, SIZE_OF_WORD);
+        munmap(map, byte_num);
+        return false;
+    }
+
+    *dataset = (Dataset*)malloc(sizeof(Dataset));
+    (*dataset)->map = (const unsigned char*)map;
+    (*dataset)->byte_num = byte_num;
+    (*dataset)->offsets = (const uint64_t*)((const unsigned char*)map + header->index_offset);
+    (*dataset)->record_num = header->record_num;
+
+    return true;
+}
+
+/**
+ * @brief Unmaps a dataset, every view into it becomes invalid.
+ *
+ * @param dataset [in, out] Pointer to the dataset, freed.
+ */
+void bigint_dataset_close(Dataset** dataset)
+{
+    /* Invalid pointer */
+    if (*dataset == NULL)
+        return;
+
+    munmap((void*)(*dataset)->map, (*dataset)->byte_num);
+    free(*dataset);
+    *dataset = NULL;
+}
+
+/**
+ * @brief Returns the number of records of a dataset.
+ *
+ * @param dataset [in] Dataset.
+ * @return size_t Number of records.
+ */
+size_t bigint_dataset_size(const Dataset* dataset)
+{
+    return dataset->record_num;
+}
+
+/**
+ * @brief Makes a read-only view of a record without copying, in constant time.
+ *
+ * The digits of the view point into the mapping, so the view must never be passed
+ * to bigint_delete or used as an output, and dies with the dataset.
+ *
+ * @param view [out] Caller-owned Bigint, filled in.
+ * @param dataset [in] Dataset.
+ * @param record_idx [in] Index of the record.
+ * @return bool true on success, false if the index or the record is out of range.
+ */
+bool bigint_dataset_view(Bigint* view, const Dataset* dataset, size_t record_idx)
+{
+    /* Invalid index */
+    if (record_idx >= dataset->record_num)
+        return false;
+
+    /* The record must lie within the file */
+    uint64_t offset = dataset->offsets[record_idx];
+    if (offset % DATASET_ALIGN != 0 || offset < sizeof(DatasetHeader) || offset > dataset->byte_num - sizeof(uint64_t))
+        return false;
+
+    const uint64_t* meta = (const uint64_t*)(dataset->map + offset);
+    uint64_t digit_num = *meta & ~DATASET_SIGN_BIT;
+    if (digit_num == 0 || digit_num > (dataset->byte_num - offset - sizeof(uint64_t)) / SIZE_OF_WORD)
+        return false;
+
+    view->sign = (*meta & DATASET_SIGN_BIT) ? NEGATIVE : POSITIVE;
+    view->digit_num = (size_t)digit_num;
+    view->digits = (Word*)(meta + 1);
+
+    return true;
+}
+
+/**
+ * @brief Converts a text file of one hexadecimal number per line into a dataset.
+ *
+ * Empty lines are skipped, a leading '-' gives a negative record.
+ *
+ * @param text_path [in] Path of the text file.
+ * @param dataset_path [in] Path of the dataset file to write.
+ * @return bool true on success, false with a message otherwise.
+ */
+bool bigint_dataset_convert_text(const char* text_path, const char* dataset_path)
+{
+    FILE* file = fopen(text_path, "r");
+    if (file == NULL) {
+        perror("bigint_dataset_convert_text: file open error");
+        return false;
+    }
+
+    DatasetWriter* writer = NULL;
+    if (bigint_dataset_writer_open(&writer, dataset_path) == false) {
+        fclose(file);
+        return false;
+    }
+
+    /* One record per line, lines of any length */
+    Bigint* bigint = NULL;
+    char* line = NULL;
+    size_t line_cap = 0;
+    size_t line_idx = 0;
+    bool is_converted = true;
+    ssize_t length;
+
+    while (is_converted && (length = getline(&line, &line_cap, file)) >= 0) {
+        line_idx++;
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+            length--;
+        if (length == 0)
+            continue;
+
+        if (bigint_from_hex(&bigint, line, (size_t)length) != CONVERT_OK) {
+            printf("Invalid Case: line %zu of %s is not hex.\n", line_idx, text_path);
+            is_converted = false;
+        }
+        else
+            is_converted = bigint_dataset_write(writer, bigint);
+    }
+
+    if (bigint_dataset_writer_close(&writer) == false)
+        is_converted = false;
+    if (is_converted == false)
+        remove(dataset_path);
+
+    bigint_delete(&bigint);
+    free(line);
+    fclose(file);
+
+    return is_converted;
+}
+
+/**
+ * @brief Converts every .txt file of a test vector directory into a .abds dataset next to it.
+ *
+ * @param directory [in] Directory, for example verificate/random_test_vectors.
+ * @return size_t Number of files converted, files that are not hex numbers are reported and skipped.
+ */
+size_t bigint_dataset_convert_directory(const char* directory)
+{
+    DIR* dir = opendir(directory);
+    if (dir == NULL) {
+        perror("bigint_dataset_convert_directory: directory open error");
+        return 0;
+    }
+
+    size_t converted_num = 0;
+    struct dirent* entry;
+
+    while ((entry = readdir(dir)) != NULL) {
+        size_t name_length = strlen(entry->d_name);
+        if (name_length < 4 || strcmp(entry->d_name + name_length - 4, ".txt") != 0)
+            continue;
+
+        /* name.txt -> name.abds */
+        size_t path_length = strlen(directory) + name_length + 8;
+        char* text_path = (char*)malloc(path_length);
+        char* dataset_path = (char*)malloc(path_length);
+        snprintf(text_path, path_length, "%s/%s", directory, entry->d_name);
+        snprintf(dataset_path, path_length, "%s/%.*s.abds", directory, (int)(name_length - 4), entry->d_name);
+
+        if (bigint_dataset_convert_text(text_path, dataset_path))
+            converted_num++;
+
+        free(text_path);
+        free(dataset_path);
+    }
+
+    closedir(dir);
+
+    return converted_num;
+}
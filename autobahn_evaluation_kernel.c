@@ -0,0 +1,482 @@
+#include "autobahn_evaluation.h"
+#include "autobahn_evaluation_timing.h"
+#include "autobahn_internal.h"
+
+#define KERNEL_OPERAND_NUM 1024                   /**< Operands cycled through by the throughput loops, a power of two. */
+#define KERNEL_TASK_CASES ((uint64_t)1 << 20)     /**< Random cases of one verifier task. */
+#define KERNEL_BLOCK_WORDS 4096                   /**< Random words drawn at once by the verifier. */
+#define KERNEL_CASE_WORDS 4                       /**< Words of one verifier case. */
+#define KERNEL_REPORT_MAX 16                      /**< Mismatches printed, the rest are only counted. */
+#define KERNEL_WORD_MAX ((Word)~(Word)0)
+#define KERNEL_WORD_MSB ((Word)1 << (BITLEN_OF_WORD - 1))
+#define KERNEL_HALF ((Word)1 << (BITLEN_OF_WORD / 2))
+
+/** @brief Operands of the throughput loops, divisions already satisfy high < divisor. */
+typedef struct {
+    Word x[KERNEL_OPERAND_NUM];
+    Word y[KERNEL_OPERAND_NUM];
+    Word z[KERNEL_OPERAND_NUM];
+    Word high[KERNEL_OPERAND_NUM];
+    Word divisor[KERNEL_OPERAND_NUM];
+} KernelOperands;
+
+/** @brief Word kernel being measured. */
+typedef struct {
+    const char* name;                                                       /**< Name in the output. */
+    Word (*throughput)(const KernelOperands* operands, size_t call_num);    /**< Independent calls, returns a sink. */
+    Word (*latency)(const KernelOperands* operands, size_t call_num);       /**< Each call depends on the previous one. */
+} KernelOperation;
+
+/*
+ * Throughput loops feed independent operands so calls overlap in the pipeline.
+ * Latency loops feed the output of a call into the next one, so each call waits for the previous.
+ */
+
+#define KERNEL_IDX(idx) ((idx) & (KERNEL_OPERAND_NUM - 1))
+
+static Word kernel_addition_throughput(const KernelOperands* o, size_t call_num)
+{
+    Word sink = 0, result = 0, carry = 0;
+    for (size_t idx = 0; idx < call_num; idx++) {
+        word_addition_with_carry(&result, &carry, o->z[KERNEL_IDX(idx)] & 1, o->x[KERNEL_IDX(idx)], o->y[KERNEL_IDX(idx)]);
+        sink ^= result + carry;
+    }
+    return sink;
+}
+
+static Word kernel_addition_latency(const KernelOperands* o, size_t call_num)
+{
+    Word result = o->x[0], carry = 0;
+    for (size_t idx = 0; idx < call_num; idx++)
+        word_addition_with_carry(&result, &carry, carry, result, o->y[KERNEL_IDX(idx)]);
+    return result + carry;
+}
+
+static Word kernel_subtraction_throughput(const KernelOperands* o, size_t call_num)
+{
+    Word sink = 0, result = 0, borrow = 0;
+    for (size_t idx = 0; idx < call_num; idx++) {
+        word_subtraction_with_borrow(&result, &borrow, o->z[KERNEL_IDX(idx)] & 1, o->x[KERNEL_IDX(idx)], o->y[KERNEL_IDX(idx)]);
+        sink ^= result + borrow;
+    }
+    return sink;
+}
+
+static Word kernel_subtraction_latency(const KernelOperands* o, size_t call_num)
+{
+    Word result = o->x[0], borrow = 0;
+    for (size_t idx = 0; idx < call_num; idx++)
+        word_subtraction_with_borrow(&result, &borrow, borrow, result, o->y[KERNEL_IDX(idx)]);
+    return result + borrow;
+}
+
+static Word kernel_multiplication_throughput(const KernelOperands* o, size_t call_num)
+{
+    Word sink = 0, high = 0, low = 0;
+    for (size_t idx = 0; idx < call_num; idx++) {
+        word_multiplication(&high, &low, o->x[KERNEL_IDX(idx)], o->y[KERNEL_IDX(idx)]);
+        sink ^= high + low;
+    }
+    return sink;
+}
+
+static Word kernel_multiplication_latency(const KernelOperands* o, size_t call_num)
+{
+    Word high = 0, low = o->x[0];
+    for (size_t idx = 0; idx < call_num; idx++)
+        word_multiplication(&high, &low, low ^ high, o->y[KERNEL_IDX(idx)]);
+    return high + low;
+}
+
+static Word kernel_squaring_throughput(const KernelOperands* o, size_t call_num)
+{
+    Word sink = 0, high = 0, low = 0;
+    for (size_t idx = 0; idx < call_num; idx++) {
+        word_squaring(&high, &low, o->x[KERNEL_IDX(idx)]);
+        sink ^= high + low;
+    }
+    return sink;
+}
+
+static Word kernel_squaring_latency(const KernelOperands* o, size_t call_num)
+{
+    Word high = 0, low = o->x[0];
+    for (size_t idx = 0; idx < call_num; idx++)
+        word_squaring(&high, &low, low ^ high ^ o->y[KERNEL_IDX(idx)]);
+    return high + low;
+}
+
+static Word kernel_multiplication_addition_throughput(const KernelOperands* o, size_t call_num)
+{
+    Word sink = 0, high = 0, low = 0;
+    for (size_t idx = 0; idx < call_num; idx++) {
+        word_multiplication_addition(&high, &low, o->x[KERNEL_IDX(idx)], o->y[KERNEL_IDX(idx)], o->z[KERNEL_IDX(idx)], o->high[KERNEL_IDX(idx)]);
+        sink ^= high + low;
+    }
+    return sink;
+}
+
+static Word kernel_multiplication_addition_latency(const KernelOperands* o, size_t call_num)
+{
+    Word high = 0, low = 0;
+    for (size_t idx = 0; idx < call_num; idx++)
+        word_multiplication_addition(&high, &low, o->x[KERNEL_IDX(idx)], o->y[KERNEL_IDX(idx)], low, high); // carry chain of a row
+    return high + low;
+}
+
+static Word kernel_division_two_word_throughput(const KernelOperands* o, size_t call_num)
+{
+    Word sink = 0, quotient = 0, remainder = 0;
+    for (size_t idx = 0; idx < call_num; idx++) {
+        word_division_two_word(&quotient, &remainder, o->high[KERNEL_IDX(idx)], o->x[KERNEL_IDX(idx)], o->divisor[KERNEL_IDX(idx)]);
+        sink ^= quotient + remainder;
+    }
+    return sink;
+}
+
+static Word kernel_division_two_word_latency(const KernelOperands* o, size_t call_num)
+{
+    Word quotient = 0, remainder = 0;
+    for (size_t idx = 0; idx < call_num; idx++)
+        word_division_two_word(&quotient, &remainder, remainder, o->x[KERNEL_IDX(idx)] ^ quotient, o->divisor[0]); // remainder chain of a long division
+    return quotient + remainder;
+}
+
+static Word kernel_quotient_two_word_throughput(const KernelOperands* o, size_t call_num)
+{
+    Word sink = 0;
+    for (size_t idx = 0; idx < call_num; idx++)
+        sink ^= get_quotient_of_division_two_word(o->high[KERNEL_IDX(idx)], o->x[KERNEL_IDX(idx)], o->divisor[KERNEL_IDX(idx)]);
+    return sink;
+}
+
+static Word kernel_quotient_two_word_latency(const KernelOperands* o, size_t call_num)
+{
+    Word quotient = 0;
+    Word divisor = o->divisor[0];
+    for (size_t idx = 0; idx < call_num; idx++)
+        quotient = get_quotient_of_division_two_word((Word)(quotient % divisor), o->x[KERNEL_IDX(idx)], divisor);
+    return quotient;
+}
+
+/** @brief Kernels, in the order of the output. */
+static const KernelOperation kernel_operations[] = {
+    { "word_addition_with_carry",     kernel_addition_throughput,                kernel_addition_latency },
+    { "word_subtraction_with_borrow", kernel_subtraction_throughput,             kernel_subtraction_latency },
+    { "word_multiplication",          kernel_multiplication_throughput,          kernel_multiplication_latency },
+    { "word_squaring",                kernel_squaring_throughput,                kernel_squaring_latency },
+    { "word_multiplication_addition", kernel_multiplication_addition_throughput, kernel_multiplication_addition_latency },
+    { "word_division_two_word",       kernel_division_two_word_throughput,       kernel_division_two_word_latency },
+    { "get_quotient_two_word",        kernel_quotient_two_word_throughput,       kernel_quotient_two_word_latency },
+};
+
+/** @brief Keeps the sinks of the loops alive. */
+static volatile Word kernel_sink;
+
+/** @brief Loop and operands of a timed batch. */
+typedef struct {
+    Word (*loop)(const KernelOperands*, size_t);
+    const KernelOperands* operands;
+} KernelBatch;
+
+/**
+ * @brief Runs one timed batch of a loop, an EvaluationBatch.
+ *
+ * @param context [in] KernelBatch.
+ * @param call_num [in] Calls of the kernel.
+ */
+static void kernel_batch(void* context, size_t call_num)
+{
+    KernelBatch* batch = (KernelBatch*)context;
+    kernel_sink = batch->loop(batch->operands, call_num);
+}
+
+/**
+ * @brief Measures one loop: calibrates the call count to config->sample_ns, then takes config->sample_num samples.
+ *
+ * @param median_ns [out] Median nanoseconds per call.
+ * @param median_cycles [out] Median TSC cycles per call, NAN without a TSC.
+ * @param loop [in] Throughput or latency loop.
+ * @param operands [in] Operands.
+ * @param config [in] Settings.
+ */
+static void kernel_measure(double* median_ns, double* median_cycles, Word (*loop)(const KernelOperands*, size_t),
+                           const KernelOperands* operands, const BenchmarkConfig* config)
+{
+    /* Calibrate: double the calls until a sample lasts long enough */
+    KernelBatch context = { loop, operands };
+    size_t call_num = KERNEL_OPERAND_NUM;
+    for (;;) {
+        uint64_t start = evaluation_now_ns();
+        kernel_batch(&context, call_num);
+        if (evaluation_now_ns() - start >= config->sample_ns || call_num >= ((size_t)1 << 40))
+            break;
+        call_num *= 2;
+    }
+
+    /* Sample */
+    EvaluationTiming timing;
+    evaluation_sample(&timing, kernel_batch, &context, call_num, config->sample_num);
+    *median_ns = timing.median_ns;
+    *median_cycles = timing.median_cycles;
+}
+
+/**
+ * @brief Measures the throughput and the latency of every word kernel.
+ *
+ * Throughput is the time per call when calls are independent, latency the time per call when each call
+ * waits for the result of the previous one. Uses sample_num, sample_ns, filter, format and output of the
+ * configuration; the sizes and the budget do not apply to single words.
+ *
+ * @param config [in] Settings.
+ */
+void bigint_kernel_benchmark(const BenchmarkConfig* config)
+{
+    /* Invalid case */
+    if (config->sample_num == 0) {
+        printf("Invalid Case: Kernel benchmark needs at least one sample.\n");
+        return;
+    }
+
+    KernelOperands* operands = (KernelOperands*)malloc(sizeof(KernelOperands));
+    RandomXoshiro state;
+    bigint_random_xoshiro_seed(&state, 0x6b65726e656c73ULL);
+    bigint_random_xoshiro_fill(&state, operands, sizeof(KernelOperands));
+    for (size_t idx = 0; idx < KERNEL_OPERAND_NUM; idx++) {
+        operands->divisor[idx] |= KERNEL_WORD_MSB; // Normalized, as in long division
+        operands->high[idx] %= operands->divisor[idx];
+    }
+
+    FILE* output = config->output;
+    size_t operation_num = sizeof(kernel_operations) / sizeof(kernel_operations[0]);
+    bool is_first = true;
+
+    switch (config->format) {
+    case BENCHMARK_CSV:
+        fprintf(output, "kernel,word_bits,throughput_ns,throughput_cycles,latency_ns,latency_cycles\n");
+        break;
+    case BENCHMARK_JSON:
+        fprintf(output, "{\n  \"word_bits\": %zu,\n  \"tsc\": %s,\n  \"results\": [", (size_t)BITLEN_OF_WORD, EVALUATION_HAS_TSC ? "true" : "false");
+        break;
+    default:
+        fprintf(output, "%-30s %14s %14s %14s %14s\n", "kernel", "tput_ns", "tput_cycles", "lat_ns", "lat_cycles");
+        break;
+    }
+
+    for (size_t idx = 0; idx < operation_num; idx++) {
+        const KernelOperation* operation = &kernel_operations[idx];
+        if (config->filter != NULL && strstr(operation->name, config->filter) == NULL)
+            continue;
+
+        double throughput_ns, throughput_cycles, latency_ns, latency_cycles;
+        kernel_measure(&throughput_ns, &throughput_cycles, operation->throughput, operands, config);
+        kernel_measure(&latency_ns, &latency_cycles, operation->latency, operands, config);
+
+        switch (config->format) {
+        case BENCHMARK_CSV:
+            fprintf(output, "%s,%zu,%.3f,%.3f,%.3f,%.3f\n", operation->name, (size_t)BITLEN_OF_WORD,
+                    throughput_ns, throughput_cycles, latency_ns, latency_cycles);
+            break;
+        case BENCHMARK_JSON:
+            fprintf(output, "%s\n    {\"kernel\": \"%s\", \"throughput_ns\": %.3f, \"latency_ns\": %.3f, ",
+                    is_first ? "" : ",", operation->name, throughput_ns, latency_ns);
+            if (isnan(throughput_cycles))
+                fprintf(output, "\"throughput_cycles\": null, \"latency_cycles\": null}");
+            else
+                fprintf(output, "\"throughput_cycles\": %.3f, \"latency_cycles\": %.3f}", throughput_cycles, latency_cycles);
+            break;
+        default:
+            fprintf(output, "%-30s %14.3f %14.3f %14.3f %14.3f\n", operation->name, throughput_ns, throughput_cycles,
+                    latency_ns, latency_cycles);
+            break;
+        }
+        fflush(output);
+        is_first = false;
+    }
+    if (config->format == BENCHMARK_JSON)
+        fprintf(output, "\n  ]\n}\n");
+
+    free(operands);
+}
+
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 KernelReference; /**< Reference arithmetic, wide enough for two 64-bit words. */
+
+/** @brief Shared state of a verifier run. */
+typedef struct {
+    uint64_t case_num; /**< Random cases in total. */
+    uint64_t seed;     /**< Seed of the random cases, task i draws from seed + i. */
+    uint64_t failure_num; /**< Mismatches found, updated atomically. */
+} KernelVerification;
+
+/**
+ * @brief Prints a mismatch, the first KERNEL_REPORT_MAX of a run.
+ *
+ * @param verification [in, out] Run state.
+ * @param kernel [in] Kernel name.
+ * @param inputs [in] Inputs of the case.
+ * @param input_num [in] Number of inputs.
+ */
+static void kernel_report(KernelVerification* verification, const char* kernel, const Word* inputs, size_t input_num)
+{
+    if (__atomic_fetch_add(&verification->failure_num, 1, __ATOMIC_RELAXED) >= KERNEL_REPORT_MAX)
+        return;
+
+    char line[256];
+    int length = snprintf(line, sizeof(line), "Mismatch: %s(", kernel);
+    for (size_t idx = 0; idx < input_num && length > 0 && (size_t)length < sizeof(line); idx++)
+        length += snprintf(line + length, sizeof(line) - (size_t)length, "%s0x%llx", idx == 0 ? "" : ", ", (unsigned long long)inputs[idx]);
+    printf("%s)\n", line);
+}
+
+/**
+ * @brief Checks every kernel on one case against __int128 arithmetic.
+ *
+ * Carries and borrows come from the low bit of z, the two-word dividends are reduced below the divisor.
+ *
+ * @param verification [in, out] Run state.
+ * @param x [in] First word.
+ * @param y [in] Second word.
+ * @param z [in] Third word.
+ * @param w [in] Fourth word.
+ */
+static void kernel_check(KernelVerification* verification, Word x, Word y, Word z, Word w)
+{
+    const KernelReference word_base = (KernelReference)1 << BITLEN_OF_WORD;
+    Word inputs[4] = { x, y, z, w };
+    Word carry = z & 1;
+    Word result, next, high, low;
+
+    /* Addition and subtraction with carry */
+    word_addition_with_carry(&result, &next, carry, x, y);
+    if (next > 1 || (KernelReference)result + (KernelReference)next * word_base != (KernelReference)x + y + carry)
+        kernel_report(verification, "word_addition_with_carry", inputs, 3);
+
+    word_subtraction_with_borrow(&result, &next, carry, x, y);
+    if (result != (Word)(x - y - carry) || next != (Word)((KernelReference)x < (KernelReference)y + carry))
+        kernel_report(verification, "word_subtraction_with_borrow", inputs, 3);
+
+    /* Products */
+    word_multiplication(&high, &low, x, y);
+    if (((KernelReference)high << BITLEN_OF_WORD | low) != (KernelReference)x * y)
+        kernel_report(verification, "word_multiplication", inputs, 2);
+
+    word_squaring(&high, &low, x);
+    if (((KernelReference)high << BITLEN_OF_WORD | low) != (KernelReference)x * x)
+        kernel_report(verification, "word_squaring", inputs, 1);
+
+    word_multiplication_addition(&high, &low, x, y, z, w);
+    if (((KernelReference)high << BITLEN_OF_WORD | low) != (KernelReference)x * y + z + w)
+        kernel_report(verification, "word_multiplication_addition", inputs, 4);
+
+    /* Two-word divisions, high < divisor */
+    Word divisor = y == 0 ? 1 : y;
+    Word dividend_high = z % divisor;
+    KernelReference dividend = (KernelReference)dividend_high << BITLEN_OF_WORD | x;
+    Word division_inputs[3] = { dividend_high, x, divisor };
+
+    word_division_two_word(&high, &low, dividend_high, x, divisor);
+    if (high != (Word)(dividend / divisor) || low != (Word)(dividend % divisor))
+        kernel_report(verification, "word_division_two_word", division_inputs, 3);
+
+    if (get_quotient_of_division_two_word(dividend_high, x, divisor) != (Word)(dividend / divisor))
+        kernel_report(verification, "get_quotient_of_division_two_word", division_inputs, 3);
+
+    /* Masks and lengths */
+    if (word_mask_equal(x, y) != (x == y ? KERNEL_WORD_MAX : 0) || word_mask_equal(x, x) != KERNEL_WORD_MAX)
+        kernel_report(verification, "word_mask_equal", inputs, 2);
+
+    if (word_bit_length(x) != (x == 0 ? 0 : (Word)(64 - __builtin_clzll((unsigned long long)x))))
+        kernel_report(verification, "word_bit_length", inputs, 1);
+}
+
+/**
+ * @brief Runs one verifier task: task 0 takes every combination of the edge words, the others random cases.
+ *
+ * Random words are replaced by an edge word one time in eight, so carries, borrows and full words are
+ * frequent even for 64-bit words.
+ *
+ * @param argument [in] KernelVerification.
+ * @param task_idx [in] Task index.
+ * @param worker_idx [in] Unused.
+ */
+static void kernel_verify_task(void* argument, size_t task_idx, size_t worker_idx)
+{
+    (void)worker_idx;
+    KernelVerification* verification = (KernelVerification*)argument;
+    static const Word edges[] = {
+        0, 1, 2, 3, KERNEL_HALF - 1, KERNEL_HALF, KERNEL_HALF + 1, KERNEL_WORD_MSB - 1, KERNEL_WORD_MSB,
+        KERNEL_WORD_MSB + 1, KERNEL_WORD_MAX - KERNEL_HALF, KERNEL_WORD_MAX - 2, KERNEL_WORD_MAX - 1, KERNEL_WORD_MAX
+    };
+    const size_t edge_num = sizeof(edges) / sizeof(edges[0]);
+
+    if (task_idx == 0) {
+        for (size_t a = 0; a < edge_num; a++)
+            for (size_t b = 0; b < edge_num; b++)
+                for (size_t c = 0; c < edge_num; c++)
+                    for (size_t d = 0; d < edge_num; d++)
+                        kernel_check(verification, edges[a], edges[b], edges[c], edges[d]);
+        return;
+    }
+
+    uint64_t first = (uint64_t)(task_idx - 1) * KERNEL_TASK_CASES;
+    uint64_t case_num = verification->case_num - first < KERNEL_TASK_CASES ? verification->case_num - first : KERNEL_TASK_CASES;
+    RandomXoshiro state;
+    bigint_random_xoshiro_seed(&state, verification->seed + task_idx);
+
+    Word words[KERNEL_BLOCK_WORDS];
+    unsigned char choices[KERNEL_BLOCK_WORDS];
+    size_t block_case_num = KERNEL_BLOCK_WORDS / KERNEL_CASE_WORDS;
+
+    for (uint64_t done = 0; done < case_num; done += block_case_num) {
+        bigint_random_xoshiro_fill(&state, words, sizeof(words));
+        bigint_random_xoshiro_fill(&state, choices, sizeof(choices));
+        for (size_t idx = 0; idx < KERNEL_BLOCK_WORDS; idx++)
+            if ((choices[idx] & 7) == 0)
+                words[idx] = edges[(choices[idx] >> 3) % edge_num];
+
+        size_t block_end = case_num - done < block_case_num ? (size_t)(case_num - done) : block_case_num;
+        for (size_t idx = 0; idx < block_end; idx++) {
+            const Word* word = &words[idx * KERNEL_CASE_WORDS];
+            kernel_check(verification, word[0], word[1], word[2], word[3]);
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Verifies the word kernels against __int128 arithmetic: every combination of the edge words, then
+ * case_num random cases of four words each.
+ *
+ * Each case checks addition and subtraction with carry, multiplication, squaring, multiply-add, both
+ * two-word divisions, the equality mask and the bit length. Random cases are split into tasks seeded from
+ * seed and the task index, so a run is reproducible for any number of threads.
+ *
+ * @param case_num [in] Random cases.
+ * @param seed [in] Seed of the random cases.
+ * @param pool [in] Thread pool running the tasks, NULL for the calling thread.
+ * @return bool True if every kernel matched the reference on every case.
+ */
+bool bigint_kernel_verify(uint64_t case_num, uint64_t seed, ThreadPool* pool)
+{
+#if defined(__SIZEOF_INT128__)
+    KernelVerification verification = { case_num, seed, 0 };
+    size_t task_num = 1 + (size_t)((case_num + KERNEL_TASK_CASES - 1) / KERNEL_TASK_CASES);
+
+    if (pool != NULL)
+        bigint_thread_pool_run(pool, kernel_verify_task, &verification, task_num);
+    else
+        for (size_t task_idx = 0; task_idx < task_num; task_idx++)
+            kernel_verify_task(&verification, task_idx, 0);
+
+    if (verification.failure_num != 0)
+        printf("Kernel verification failed: %llu mismatches.\n", (unsigned long long)verification.failure_num);
+    return verification.failure_num == 0;
+#else
+    (void)case_num;
+    (void)seed;
+    (void)pool;
+    printf("Invalid Case: Kernel verification needs a compiler with __int128.\n");
+    return false;
+#endif
+}
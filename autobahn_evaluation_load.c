@@ -0,0 +1,581 @@
+#include "autobahn_evaluation.h"
+#include "autobahn_evaluation_timing.h"
+#include "autobahn_internal.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOAD_SEED 0x6c6f616467656e21ULL                     /**< Seed of the operands and keys, identical across runs. */
+#define LOAD_LANE_NUM 4                                     /**< Operations of one multi-buffer request. */
+#define LOAD_SUB_BITS 4                                     /**< Sub-buckets per power of two are 2^LOAD_SUB_BITS, about 6% resolution. */
+#define LOAD_SUB_NUM ((size_t)1 << LOAD_SUB_BITS)
+#define LOAD_BUCKET_NUM ((64 - LOAD_SUB_BITS + 1) * LOAD_SUB_NUM) /**< Buckets covering every uint64_t nanosecond value. */
+#define LOAD_START_DELAY_NS 2000000ULL                      /**< Head start of the workers before the first request. */
+
+/** @brief Latency histogram with logarithmic buckets, linear within each power of two. */
+typedef struct {
+    uint64_t counts[LOAD_BUCKET_NUM]; /**< Requests per bucket. */
+    uint64_t request_num;             /**< Recorded requests. */
+    uint64_t late_num;                /**< Requests that started after their scheduled time. */
+    uint64_t sum_ns;                  /**< Sum of the latencies. */
+    uint64_t max_ns;                  /**< Largest latency. */
+} LoadHistogram;
+
+/** @brief Operands and keys shared read-only by the workers. */
+typedef struct {
+    size_t bit_length;                 /**< Modulus size in bits. */
+    Bigint* base;                      /**< bit_length - 1 bits, below modular. */
+    Bigint* exponent;                  /**< bit_length bits. */
+    Bigint* exponent_public;           /**< 65537. */
+    Bigint* modular;                   /**< Odd, bit_length bits. */
+    ModularContext* context;           /**< Context of modular, made on demand. */
+    Bigint* rsa_modular;               /**< N = P * Q of the RSA key, made on demand. */
+    Bigint* rsa_prime_p;               /**< P. */
+    Bigint* rsa_prime_q;               /**< Q. */
+    Bigint* rsa_exponent_p;            /**< D mod (P - 1). */
+    Bigint* rsa_exponent_q;            /**< D mod (Q - 1). */
+    Bigint* rsa_inverse_q;             /**< Q^(-1) mod P. */
+    ModularContext* rsa_context_p;     /**< Context of P. */
+    ModularContext* rsa_context_q;     /**< Context of Q. */
+    Bigint* rsa_ciphertext;            /**< Below N. */
+    Bigint* lane_bases[LOAD_LANE_NUM];     /**< base in every lane. */
+    Bigint* lane_exponents[LOAD_LANE_NUM]; /**< exponent in every lane. */
+    Bigint* lane_modulars[LOAD_LANE_NUM];  /**< modular in every lane. */
+} LoadOperands;
+
+/** @brief Outputs owned by one worker. */
+typedef struct {
+    Bigint* result;                      /**< Reused output. */
+    Bigint* tmp_p;                       /**< CRT half modulo P. */
+    Bigint* tmp_q;                       /**< CRT half modulo Q. */
+    Bigint* lane_results[LOAD_LANE_NUM]; /**< Outputs of the multi-buffer request. */
+} LoadOutputs;
+
+/** @brief Request type issued by the load generator. */
+typedef struct {
+    const char* name;                                                 /**< Name in the output. */
+    size_t operation_num;                                             /**< Operations completed by one request. */
+    void (*prepare)(LoadOperands* operands);                          /**< Setup before the workers start, or NULL. */
+    void (*run)(const LoadOperands* operands, LoadOutputs* outputs);  /**< One request. */
+} LoadOperation;
+
+/** @brief Start signal of the workers of one run. */
+typedef struct {
+    pthread_mutex_t mutex; /**< Protects the fields below. */
+    pthread_cond_t cond;   /**< Signals is_go. */
+    bool is_go;            /**< Every worker is started, or starting failed. */
+    bool is_aborted;       /**< A worker could not be started, the others return at once. */
+    uint64_t start_ns;     /**< Start of the run. */
+} LoadStart;
+
+/** @brief State of one worker thread. */
+typedef struct {
+    pthread_t thread;                  /**< Worker thread. */
+    size_t worker_idx;                 /**< Index among the workers. */
+    size_t worker_num;                 /**< Number of workers. */
+    const LoadOperation* operation;    /**< Request type. */
+    const LoadOperands* operands;      /**< Shared operands. */
+    const LoadConfig* config;          /**< Settings. */
+    LoadStart* start;                  /**< Releases the workers together. */
+    LoadOutputs outputs;               /**< Outputs of this worker. */
+    LoadHistogram histogram;           /**< Latencies of this worker. */
+} LoadWorker;
+
+/**
+ * @brief Performs one RSA private-key operation with the Chinese remainder theorem (Garner's form).
+ *
+ * M = Mq + Q * ((Mp - Mq) * Q^(-1) mod P) with Mp = C^(D mod (P - 1)) mod P and Mq = C^(D mod (Q - 1)) mod Q.
+ *
+ * @param operands [in] Key and ciphertext.
+ * @param outputs [in, out] Outputs of the worker, the message in result.
+ */
+static void load_rsa_crt(const LoadOperands* operands, LoadOutputs* outputs)
+{
+    /* Half exponentiations */
+    bigint_exponentiation_modular_fixed_window_context(&outputs->tmp_p, operands->rsa_ciphertext, operands->rsa_exponent_p, operands->rsa_context_p);
+    bigint_exponentiation_modular_fixed_window_context(&outputs->tmp_q, operands->rsa_ciphertext, operands->rsa_exponent_q, operands->rsa_context_q);
+
+    /* H = (Mp - Mq) * Q^(-1) mod P, Mq is below Q but not always below P */
+    bigint_subtraction(&outputs->result, outputs->tmp_p, outputs->tmp_q);
+    while (outputs->result->sign == NEGATIVE && bigint_is_zero(outputs->result) == FALSE)
+        bigint_addition(&outputs->result, outputs->result, operands->rsa_prime_p);
+    words_multiplication_bigint(&outputs->tmp_p, outputs->result, operands->rsa_inverse_q);
+    words_division_bigint(NULL, &outputs->tmp_p, outputs->tmp_p, operands->rsa_prime_p);
+
+    /* M = Mq + Q * H */
+    words_multiplication_bigint(&outputs->result, outputs->tmp_p, operands->rsa_prime_q);
+    bigint_addition(&outputs->result, outputs->result, outputs->tmp_q);
+}
+
+static void load_modexp(const LoadOperands* o, LoadOutputs* out)         { bigint_exponentiation_modular_fixed_window(&out->result, o->base, o->exponent, o->modular); }
+static void load_modexp_context(const LoadOperands* o, LoadOutputs* out) { bigint_exponentiation_modular_fixed_window_context(&out->result, o->base, o->exponent, o->context); }
+static void load_modexp_public(const LoadOperands* o, LoadOutputs* out)  { bigint_exponentiation_modular_public(&out->result, o->base, o->exponent_public, o->context); }
+
+static void load_multi_buffer(const LoadOperands* o, LoadOutputs* out)
+{
+    bigint_exponentiation_modular_multi_buffer(out->lane_results, o->lane_bases, o->lane_exponents, o->lane_modulars, LOAD_LANE_NUM);
+}
+
+static void load_prepare_context(LoadOperands* o)
+{
+    if (o->context == NULL)
+        bigint_modular_context_new(&o->context, o->modular);
+}
+
+static void load_prepare_lanes(LoadOperands* o)
+{
+    for (size_t idx = 0; idx < LOAD_LANE_NUM; idx++) {
+        o->lane_bases[idx] = o->base;
+        o->lane_exponents[idx] = o->exponent;
+        o->lane_modulars[idx] = o->modular;
+    }
+}
+
+/**
+ * @brief Generates the RSA key of the operand size once, e = 65537, and checks one decryption.
+ *
+ * @param o [in, out] Operands, the RSA fields are filled.
+ */
+static void load_prepare_rsa(LoadOperands* o)
+{
+    if (o->rsa_modular != NULL)
+        return;
+
+    Bigint* one = NULL;
+    Bigint* order = NULL;
+    Bigint* check = NULL;
+    LoadOutputs outputs;
+    memset(&outputs, 0, sizeof(outputs));
+    bigint_set_one(&one);
+
+    /* Same key on every run */
+    RandomXoshiro state;
+    bigint_random_xoshiro_seed(&state, LOAD_SEED ^ o->bit_length);
+    bigint_random_set_source(bigint_random_xoshiro_fill, &state);
+
+    /* Primes of half the size with gcd(e, prime - 1) = 1, so D mod (prime - 1) exists */
+    Bigint** primes[2] = { &o->rsa_prime_p, &o->rsa_prime_q };
+    Bigint** exponents[2] = { &o->rsa_exponent_p, &o->rsa_exponent_q };
+    for (size_t idx = 0; idx < 2; idx++) {
+        do {
+            bigint_random_prime(primes[idx], o->bit_length / 2, false, 8, NULL);
+            bigint_subtraction(&order, *primes[idx], one);
+        } while (!bigint_mod_inverse(exponents[idx], o->exponent_public, order));
+    }
+
+    bigint_multiplication_karatsuba(&o->rsa_modular, o->rsa_prime_p, o->rsa_prime_q);
+    bigint_mod_inverse(&o->rsa_inverse_q, o->rsa_prime_q, o->rsa_prime_p);
+    bigint_modular_context_new(&o->rsa_context_p, o->rsa_prime_p);
+    bigint_modular_context_new(&o->rsa_context_q, o->rsa_prime_q);
+    bigint_random_below(&o->rsa_ciphertext, o->rsa_modular);
+    bigint_random_set_source(NULL, NULL);
+
+    /* M^e mod N must give the ciphertext back */
+    load_rsa_crt(o, &outputs);
+    bigint_exponentiation_modular_left_to_right(&check, outputs.result, o->exponent_public, o->rsa_modular);
+    if (bigint_compare(check, o->rsa_ciphertext) != SAME)
+        printf("Invalid Case: RSA-CRT decryption does not match the public operation.\n");
+
+    bigint_delete(&one);
+    bigint_delete(&order);
+    bigint_delete(&check);
+    bigint_delete(&outputs.result);
+    bigint_delete(&outputs.tmp_p);
+    bigint_delete(&outputs.tmp_q);
+}
+
+/** @brief Request types, in the order of the output. */
+static const LoadOperation load_operations[] = {
+    { "modexp",          1,             NULL,                 load_modexp },
+    { "modexp_context",  1,             load_prepare_context, load_modexp_context },
+    { "modexp_public",   1,             load_prepare_context, load_modexp_public },
+    { "rsa_crt",         1,             load_prepare_rsa,     load_rsa_crt },
+    { "multi_buffer",    LOAD_LANE_NUM, load_prepare_lanes,   load_multi_buffer },
+};
+
+/**
+ * @brief Sleeps until a monotonic timestamp.
+ *
+ * @param deadline_ns [in] Timestamp in nanoseconds.
+ */
+static void load_sleep_until(uint64_t deadline_ns)
+{
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)(deadline_ns / 1000000000ULL);
+    deadline.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) != 0)
+        ;
+}
+
+/**
+ * @brief Returns the bucket of a latency: exact below 2^LOAD_SUB_BITS, then LOAD_SUB_NUM buckets per power of two.
+ *
+ * @param value [in] Latency in nanoseconds.
+ * @return size_t Bucket index.
+ */
+static size_t load_bucket(uint64_t value)
+{
+    if (value < LOAD_SUB_NUM)
+        return (size_t)value;
+
+    size_t shift = (size_t)(63 - __builtin_clzll(value)) - LOAD_SUB_BITS;
+    return (shift + 1) * LOAD_SUB_NUM + (size_t)((value >> shift) & (LOAD_SUB_NUM - 1));
+}
+
+/**
+ * @brief Returns the largest latency of a bucket.
+ *
+ * @param bucket [in] Bucket index.
+ * @return uint64_t Upper bound in nanoseconds.
+ */
+static uint64_t load_bucket_upper(size_t bucket)
+{
+    if (bucket < LOAD_SUB_NUM)
+        return (uint64_t)bucket;
+
+    size_t shift = bucket / LOAD_SUB_NUM - 1;
+    uint64_t mantissa = (uint64_t)(bucket % LOAD_SUB_NUM + LOAD_SUB_NUM);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+/**
+ * @brief Records one latency.
+ *
+ * @param histogram [in, out] Histogram.
+ * @param latency_ns [in] Latency in nanoseconds.
+ */
+static void load_histogram_record(LoadHistogram* histogram, uint64_t latency_ns)
+{
+    histogram->counts[load_bucket(latency_ns)]++;
+    histogram->request_num++;
+    histogram->sum_ns += latency_ns;
+    if (latency_ns > histogram->max_ns)
+        histogram->max_ns = latency_ns;
+}
+
+/**
+ * @brief Adds a histogram into another.
+ *
+ * @param total [in, out] Accumulated histogram.
+ * @param histogram [in] Histogram to add.
+ */
+static void load_histogram_merge(LoadHistogram* total, const LoadHistogram* histogram)
+{
+    for (size_t idx = 0; idx < LOAD_BUCKET_NUM; idx++)
+        total->counts[idx] += histogram->counts[idx];
+    total->request_num += histogram->request_num;
+    total->late_num += histogram->late_num;
+    total->sum_ns += histogram->sum_ns;
+    if (histogram->max_ns > total->max_ns)
+        total->max_ns = histogram->max_ns;
+}
+
+/**
+ * @brief Returns a quantile of the recorded latencies, the upper bound of its bucket by nearest rank.
+ *
+ * @param histogram [in] Histogram.
+ * @param quantile [in] Quantile in (0, 1].
+ * @return uint64_t Latency in nanoseconds, never above the largest one recorded.
+ */
+static uint64_t load_histogram_quantile(const LoadHistogram* histogram, double quantile)
+{
+    if (histogram->request_num == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)(quantile * (double)histogram->request_num + 0.999999);
+    if (rank == 0)
+        rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t idx = 0; idx < LOAD_BUCKET_NUM; idx++) {
+        seen += histogram->counts[idx];
+        if (seen >= rank) {
+            uint64_t upper = load_bucket_upper(idx);
+            return upper < histogram->max_ns ? upper : histogram->max_ns;
+        }
+    }
+    return histogram->max_ns;
+}
+
+/**
+ * @brief Issues requests until the end of the run and records the ones completed in the measured window.
+ *
+ * With a target rate, requests follow a fixed schedule and latency counts from the scheduled start, so a
+ * request queued behind a slow one shows its wait instead of hiding it (no coordinated omission). Without
+ * one, each worker issues the next request as soon as the previous one completes.
+ *
+ * @param argument [in] LoadWorker of the thread.
+ * @return void* NULL.
+ */
+static void* load_worker_main(void* argument)
+{
+    LoadWorker* worker = (LoadWorker*)argument;
+    const LoadConfig* config = worker->config;
+
+    /* Wait until every worker is started */
+    pthread_mutex_lock(&worker->start->mutex);
+    while (!worker->start->is_go)
+        pthread_cond_wait(&worker->start->cond, &worker->start->mutex);
+    bool is_aborted = worker->start->is_aborted;
+    uint64_t start_ns = worker->start->start_ns;
+    pthread_mutex_unlock(&worker->start->mutex);
+    if (is_aborted)
+        return NULL;
+
+    uint64_t measure_ns = start_ns + config->warmup_ns;
+    uint64_t end_ns = measure_ns + config->duration_ns;
+    uint64_t interval_ns = 0;
+    if (config->request_rate > 0)
+        interval_ns = (uint64_t)((double)worker->worker_num * 1e9 / config->request_rate);
+    if (config->request_rate > 0 && interval_ns == 0)
+        interval_ns = 1;
+
+    /* Workers are staggered over one interval, so the aggregate arrivals are evenly spaced */
+    uint64_t scheduled_ns = start_ns + interval_ns * worker->worker_idx / worker->worker_num;
+    load_sleep_until(start_ns);
+
+    for (;;) {
+        uint64_t now_ns = evaluation_now_ns();
+        if (interval_ns == 0)
+            scheduled_ns = now_ns;
+        if (scheduled_ns >= end_ns || now_ns >= end_ns)
+            break;
+        if (now_ns < scheduled_ns) {
+            load_sleep_until(scheduled_ns);
+            now_ns = scheduled_ns;
+        }
+
+        worker->operation->run(worker->operands, &worker->outputs);
+        uint64_t done_ns = evaluation_now_ns();
+
+        /* Only requests scheduled inside the measured window */
+        if (scheduled_ns >= measure_ns && done_ns <= end_ns) {
+            load_histogram_record(&worker->histogram, done_ns - scheduled_ns);
+            if (interval_ns != 0 && now_ns > scheduled_ns + interval_ns / 16)
+                worker->histogram.late_num++;
+        }
+
+        if (interval_ns != 0)
+            scheduled_ns += interval_ns;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs one request type with a number of workers and merges their histograms.
+ *
+ * @param total [out] Latencies of every worker.
+ * @param operation [in] Request type.
+ * @param operands [in] Shared operands, prepared.
+ * @param worker_num [in] Number of worker threads.
+ * @param config [in] Settings.
+ * @return bool False if a thread could not be started.
+ */
+static bool load_run_workers(LoadHistogram* total, const LoadOperation* operation, const LoadOperands* operands,
+                             size_t worker_num, const LoadConfig* config)
+{
+    LoadWorker* workers = (LoadWorker*)calloc(worker_num, sizeof(LoadWorker));
+    LoadStart start = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false, false, 0 };
+    size_t started_num = 0;
+
+    for (size_t idx = 0; idx < worker_num; idx++) {
+        LoadWorker* worker = &workers[idx];
+        worker->worker_idx = idx;
+        worker->worker_num = worker_num;
+        worker->operation = operation;
+        worker->operands = operands;
+        worker->config = config;
+        worker->start = &start;
+        bigint_new(&worker->outputs.result, 1);
+        if (pthread_create(&worker->thread, NULL, load_worker_main, worker) != 0) {
+            printf("Invalid Case: Cannot start load worker %zu.\n", idx);
+            break;
+        }
+        started_num++;
+    }
+
+    /* Release the workers together, or send them home if one is missing */
+    pthread_mutex_lock(&start.mutex);
+    start.start_ns = evaluation_now_ns() + LOAD_START_DELAY_NS;
+    start.is_aborted = started_num < worker_num;
+    start.is_go = true;
+    pthread_cond_broadcast(&start.cond);
+    pthread_mutex_unlock(&start.mutex);
+
+    for (size_t idx = 0; idx < started_num; idx++)
+        pthread_join(workers[idx].thread, NULL);
+
+    memset(total, 0, sizeof(LoadHistogram));
+    for (size_t idx = 0; idx < worker_num; idx++) {
+        load_histogram_merge(total, &workers[idx].histogram);
+        bigint_delete(&workers[idx].outputs.result);
+        bigint_delete(&workers[idx].outputs.tmp_p);
+        bigint_delete(&workers[idx].outputs.tmp_q);
+        for (size_t lane = 0; lane < LOAD_LANE_NUM; lane++)
+            bigint_delete(&workers[idx].outputs.lane_results[lane]);
+    }
+
+    pthread_mutex_destroy(&start.mutex);
+    pthread_cond_destroy(&start.cond);
+    free(workers);
+    return started_num == worker_num;
+}
+
+/**
+ * @brief Writes the header of the output.
+ *
+ * @param config [in] Settings.
+ */
+static void load_print_header(const LoadConfig* config)
+{
+    FILE* output = config->output;
+    switch (config->format) {
+    case BENCHMARK_CSV:
+        fprintf(output, "operation,word_bits,bits,threads,target_rps,requests,late,ops_per_s,mean_us,p50_us,p99_us,p999_us,max_us\n");
+        break;
+    case BENCHMARK_JSON:
+        fprintf(output, "{\n  \"word_bits\": %zu,\n  \"bits\": %zu,\n  \"target_rps\": %.1f,\n  \"duration_ns\": %llu,\n  \"results\": [",
+                (size_t)BITLEN_OF_WORD, config->bit_length, config->request_rate, (unsigned long long)config->duration_ns);
+        break;
+    default:
+        fprintf(output, "%-16s %8s %7s %10s %9s %7s %12s %10s %10s %10s %10s %10s\n", "operation", "bits", "threads",
+                "target_rps", "requests", "late", "ops_per_s", "mean_us", "p50_us", "p99_us", "p99.9_us", "max_us");
+        break;
+    }
+}
+
+/**
+ * @brief Writes the latency distribution and throughput of one run.
+ *
+ * @param config [in] Settings.
+ * @param operation [in] Request type.
+ * @param worker_num [in] Number of worker threads.
+ * @param histogram [in] Latencies of every worker.
+ * @param is_first [in] Whether it is the first record, for the JSON separators.
+ */
+static void load_print_result(const LoadConfig* config, const LoadOperation* operation, size_t worker_num,
+                              const LoadHistogram* histogram, bool is_first)
+{
+    FILE* output = config->output;
+    double ops_per_s = (double)(histogram->request_num * operation->operation_num) * 1e9 / (double)config->duration_ns;
+    double mean_us = histogram->request_num == 0 ? 0.0 : (double)histogram->sum_ns / (double)histogram->request_num / 1e3;
+    double p50_us = (double)load_histogram_quantile(histogram, 0.50) / 1e3;
+    double p99_us = (double)load_histogram_quantile(histogram, 0.99) / 1e3;
+    double p999_us = (double)load_histogram_quantile(histogram, 0.999) / 1e3;
+    double max_us = (double)histogram->max_ns / 1e3;
+
+    switch (config->format) {
+    case BENCHMARK_CSV:
+        fprintf(output, "%s,%zu,%zu,%zu,%.1f,%llu,%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", operation->name, (size_t)BITLEN_OF_WORD,
+                config->bit_length, worker_num, config->request_rate, (unsigned long long)histogram->request_num,
+                (unsigned long long)histogram->late_num, ops_per_s, mean_us, p50_us, p99_us, p999_us, max_us);
+        break;
+    case BENCHMARK_JSON:
+        fprintf(output, "%s\n    {\"operation\": \"%s\", \"threads\": %zu, \"requests\": %llu, \"late\": %llu, \"ops_per_s\": %.1f, "
+                "\"mean_us\": %.1f, \"p50_us\": %.1f, \"p99_us\": %.1f, \"p999_us\": %.1f, \"max_us\": %.1f}",
+                is_first ? "" : ",", operation->name, worker_num, (unsigned long long)histogram->request_num,
+                (unsigned long long)histogram->late_num, ops_per_s, mean_us, p50_us, p99_us, p999_us, max_us);
+        break;
+    default:
+        fprintf(output, "%-16s %8zu %7zu %10.1f %9llu %7llu %12.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", operation->name,
+                config->bit_length, worker_num, config->request_rate, (unsigned long long)histogram->request_num,
+                (unsigned long long)histogram->late_num, ops_per_s, mean_us, p50_us, p99_us, p999_us, max_us);
+        break;
+    }
+    fflush(output);
+}
+
+/**
+ * @brief Fills a load configuration with the defaults: 2048 bits, 1 thread up to the online CPUs, closed loop,
+ * 2 s measured after 200 ms of warmup, text.
+ *
+ * @param config [out] Settings.
+ */
+void bigint_load_config_default(LoadConfig* config)
+{
+    long cpu_num = sysconf(_SC_NPROCESSORS_ONLN);
+
+    config->bit_length = 2048;
+    config->thread_min = 1;
+    config->thread_max = cpu_num > 0 ? (size_t)cpu_num : 1;
+    config->request_rate = 0;
+    config->duration_ns = 2000000000;
+    config->warmup_ns = 200000000;
+    config->filter = NULL;
+    config->format = BENCHMARK_TEXT;
+    config->output = stdout;
+}
+
+/**
+ * @brief Runs every request type with thread counts doubling from thread_min to thread_max.
+ *
+ * Each worker records its own histogram, so recording never contends; the histograms are merged after the
+ * run. Throughput counts operations, a multi-buffer request completes LOAD_LANE_NUM of them. A request is
+ * late when it started more than 1/16 of its interval after its scheduled time, a sign that the target
+ * rate exceeds the capacity.
+ *
+ * @param config [in] Settings.
+ */
+void bigint_load_run(const LoadConfig* config)
+{
+    /* Invalid case */
+    if (config->bit_length < 2 * BITLEN_OF_WORD || config->thread_min == 0 || config->thread_min > config->thread_max ||
+        config->duration_ns == 0 || config->request_rate < 0) {
+        printf("Invalid Case: Load size, threads, duration or rate out of range.\n");
+        return;
+    }
+
+    LoadOperands operands;
+    memset(&operands, 0, sizeof(operands));
+    operands.bit_length = config->bit_length;
+
+    /* Same operands on every run, so results are comparable */
+    RandomXoshiro state;
+    bigint_random_xoshiro_seed(&state, LOAD_SEED + config->bit_length);
+    bigint_random_set_source(bigint_random_xoshiro_fill, &state);
+    bigint_random_bits(&operands.base, config->bit_length - 1);
+    bigint_random_bits(&operands.exponent, config->bit_length);
+    bigint_random_bits(&operands.modular, config->bit_length);
+    operands.modular->digits[0] |= 1;
+    bigint_set_by_hex_string(&operands.exponent_public, "10001", POSITIVE);
+    bigint_random_set_source(NULL, NULL);
+
+    size_t operation_num = sizeof(load_operations) / sizeof(load_operations[0]);
+    bool is_first = true;
+
+    load_print_header(config);
+    for (size_t idx = 0; idx < operation_num; idx++) {
+        const LoadOperation* operation = &load_operations[idx];
+        if (config->filter != NULL && strstr(operation->name, config->filter) == NULL)
+            continue;
+        if (operation->prepare != NULL)
+            operation->prepare(&operands);
+
+        for (size_t worker_num = config->thread_min; worker_num <= config->thread_max; worker_num *= 2) {
+            LoadHistogram histogram;
+            if (!load_run_workers(&histogram, operation, &operands, worker_num, config))
+                break;
+            load_print_result(config, operation, worker_num, &histogram, is_first);
+            is_first = false;
+        }
+    }
+    if (config->format == BENCHMARK_JSON)
+        fprintf(config->output, "\n  ]\n}\n");
+
+    /* Free memory */
+    bigint_delete(&operands.base);
+    bigint_delete(&operands.exponent);
+    bigint_delete(&operands.exponent_public);
+    bigint_delete(&operands.modular);
+    bigint_modular_context_delete(&operands.context);
+    bigint_delete(&operands.rsa_modular);
+    bigint_delete(&operands.rsa_prime_p);
+    bigint_delete(&operands.rsa_prime_q);
+    bigint_delete(&operands.rsa_exponent_p);
+    bigint_delete(&operands.rsa_exponent_q);
+    bigint_delete(&operands.rsa_inverse_q);
+    bigint_modular_context_delete(&operands.rsa_context_p);
+    bigint_modular_context_delete(&operands.rsa_context_q);
+    bigint_delete(&operands.rsa_ciphertext);
+}
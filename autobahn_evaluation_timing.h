@@ -0,0 +1,104 @@
+/**
+ * @file autobahn_evaluation_timing.h
+ * @brief Clocks and sampling shared by the benchmark, kernel and load evaluation files.
+ */
+
+#ifndef AUTOBAHN_EVAL_TIMING_H
+#define AUTOBAHN_EVAL_TIMING_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define EVALUATION_HAS_TSC 1
+#else
+    #define EVALUATION_HAS_TSC 0
+#endif
+
+/** @brief Runs iteration_num iterations of the measured operation, one timed batch. */
+typedef void (*EvaluationBatch)(void* context, size_t iteration_num);
+
+/** @brief Order statistics of the samples of a measurement, per iteration. */
+typedef struct {
+    double min_ns;        /**< Fastest sample. */
+    double median_ns;     /**< Median sample. */
+    double p99_ns;        /**< 99th percentile sample. */
+    double median_cycles; /**< Median TSC cycles, NAN without a TSC. */
+} EvaluationTiming;
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ *
+ * @return uint64_t Timestamp.
+ */
+static inline uint64_t evaluation_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Returns the time stamp counter, 0 where there is none.
+ *
+ * @return uint64_t Reference cycles.
+ */
+static inline uint64_t evaluation_cycles(void)
+{
+#if EVALUATION_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static inline int evaluation_compare_double(const void* left, const void* right)
+{
+    double x = *(const double*)left;
+    double y = *(const double*)right;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Times sample_num batches of iteration_num iterations and sorts them into order statistics.
+ *
+ * Calibration and warmup are left to the caller, which knows how its operation scales.
+ *
+ * @param timing [out] Statistics per iteration.
+ * @param batch [in] Runs one batch.
+ * @param context [in] Argument of the batch.
+ * @param iteration_num [in] Iterations per batch.
+ * @param sample_num [in] Batches timed, at least 1.
+ */
+static inline void evaluation_sample(EvaluationTiming* timing, EvaluationBatch batch, void* context, size_t iteration_num, size_t sample_num)
+{
+    double* times = (double*)malloc(sample_num * sizeof(double));
+    double* cycles = (double*)malloc(sample_num * sizeof(double));
+
+    for (size_t idx = 0; idx < sample_num; idx++) {
+        uint64_t cycle_start = evaluation_cycles();
+        uint64_t start = evaluation_now_ns();
+        batch(context, iteration_num);
+        uint64_t end = evaluation_now_ns();
+        uint64_t cycle_end = evaluation_cycles();
+        times[idx] = (double)(end - start) / (double)iteration_num;
+        cycles[idx] = (double)(cycle_end - cycle_start) / (double)iteration_num;
+    }
+
+    /* Order statistics */
+    qsort(times, sample_num, sizeof(double), evaluation_compare_double);
+    qsort(cycles, sample_num, sizeof(double), evaluation_compare_double);
+    size_t p99_idx = (size_t)ceil(0.99 * (double)sample_num) - 1;
+
+    timing->min_ns = times[0];
+    timing->median_ns = times[sample_num / 2];
+    timing->p99_ns = times[p99_idx];
+    timing->median_cycles = EVALUATION_HAS_TSC ? cycles[sample_num / 2] : NAN;
+
+    free(times);
+    free(cycles);
+}
+
+#endif
@@ -65,6 +65,7 @@ void bigint_random_test()
         // bigint_reduction_barrett(&result2, operand_x, operand_y, result);
         // bigint_exponentiation_modular_left_to_right(&result, operand_x, operand_y, operand_z); //! LEAK -- clear
         // bigint_exponentiation_modular_montgomery_ladder(&result, operand_x, operand_y, operand_z);
+        // bigint_exponentiation_modular_fixed_window(&result, operand_x, operand_y, operand_z); //! odd operand_z only
 
         /* print */
         bigint_show_hex(result);
@@ -145,4 +146,656 @@ void bigint_bit_test()
     /* file close */
     fclose(file_x);
     fclose(file_y);
-}
\ No newline at end of file
+}
+
+#define VERIFICATION_CHUNK 16 /**< Cases of one task. */
+#define VERIFICATION_OPERAND_NUM 3
+
+/** @brief Test vector directories under the verification root. */
+typedef enum {
+    SUITE_RANDOM,       /**< random_test_vectors: operands x, y, z and the results of Python integers. */
+    SUITE_RANDOM_SHORT, /**< random_test_vectors of 8-bit words: 256-bit operands, for the slow exponentiations. */
+    SUITE_BIT,          /**< bit_test_vectors: every pair of all-ones operands up to 64 bits and the results of GMP. */
+    SUITE_NUM
+} VerificationSuite;
+
+/**
+ * @brief Algorithm under test, writes one or two results.
+ *
+ * @return bool false if the case is outside the domain of the algorithm, then it is skipped.
+ */
+typedef bool (*VerificationOperation)(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z);
+
+/** @brief One algorithm run on every case of a suite, against vector files or against another algorithm. */
+typedef struct {
+    const char* name;                  /**< Name in the summary, unique within the suite. */
+    VerificationSuite suite;           /**< Operands. */
+    Sign sign_x;                       /**< Sign given to the non-zero x operands. */
+    Sign sign_y;                       /**< Sign given to the non-zero y operands. */
+    VerificationOperation operation;   /**< Algorithm under test. */
+    VerificationOperation reference;   /**< Algorithm cross-checked against, NULL to check against the files. */
+    size_t result_num;                 /**< Results compared, 1 or 2. */
+    const char* expected[2];           /**< Vector files of the results without .txt, NULL for a cross-check. */
+    size_t case_max;                   /**< Most cases run, 0 for every case of the files. */
+} VerificationCheck;
+
+/** @brief Text vector file loaded in memory, one value per line. */
+typedef struct {
+    char* path;      /**< Path it was read from. */
+    Bigint** values; /**< Values, NULL for a line without a value such as DIV0!. */
+    size_t value_num;
+} VerificationFile;
+
+/** @brief Progress of one check, updated atomically by the tasks. */
+typedef struct {
+    const VerificationFile* operands[VERIFICATION_OPERAND_NUM]; /**< x, y and z, NULL if the suite has no such operand. */
+    const VerificationFile* expected[2];                         /**< Expected results, NULL if not checked. */
+    size_t case_num;                                             /**< Cases, the shortest of the files. */
+    bool is_selected;                                            /**< Matches the filter. */
+    bool is_loaded;                                              /**< Every file was read. */
+    uint64_t pass_num;
+    uint64_t mismatch_num;
+    uint64_t skip_num;
+} VerificationState;
+
+/** @brief Cases [case_begin, case_end) of one check. */
+typedef struct {
+    size_t check_idx;
+    size_t case_begin;
+    size_t case_end;
+} VerificationTask;
+
+/** @brief Shared state of a verification run. */
+typedef struct {
+    const VerificationConfig* config;
+    const VerificationCheck* checks;
+    VerificationState* states;
+    VerificationTask* tasks;
+    uint64_t report_num; /**< Mismatches printed so far, updated atomically. */
+} VerificationRun;
+
+/*
+ * Algorithms under test. The library divides non-negative integers only, so division, Barrett and
+ * exponentiation skip the signed cases and a zero divisor or modulus.
+ */
+
+static bool verification_addition(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second; (void)z;
+    bigint_addition(first, x, y);
+    return true;
+}
+
+static bool verification_subtraction(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second; (void)z;
+    bigint_subtraction(first, x, y);
+    return true;
+}
+
+static bool verification_multiplication_textbook(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second; (void)z;
+    bigint_multiplication_textbook(first, x, y);
+    return true;
+}
+
+static bool verification_multiplication_karatsuba(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second; (void)z;
+    bigint_multiplication_karatsuba(first, x, y);
+    return true;
+}
+
+static bool verification_multiplication_square(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second; (void)y; (void)z;
+    bigint_multiplication_textbook(first, x, x);
+    return true;
+}
+
+static bool verification_squaring_textbook(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second; (void)y; (void)z;
+    bigint_squaring_textbook(first, x);
+    return true;
+}
+
+static bool verification_squaring_karatsuba(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second; (void)y; (void)z;
+    bigint_squaring_karatsuba(first, (Bigint*)x); // Not modified, the prototype lacks const
+    return true;
+}
+
+/**
+ * @brief Checks that a division applies: non-negative dividend, positive divisor.
+ *
+ * @param dividend [in] Dividend.
+ * @param divisor [in] Divisor.
+ * @return bool true if the library defines the division.
+ */
+static bool verification_is_divisible(const Bigint* dividend, const Bigint* divisor)
+{
+    return dividend->sign == POSITIVE && divisor->sign == POSITIVE && bigint_is_zero(divisor) == FALSE;
+}
+
+static bool verification_division_binary_long(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)z;
+    if (!verification_is_divisible(x, y))
+        return false;
+    bigint_division_binary_long(first, second, x, y);
+    return true;
+}
+
+static bool verification_division_word_long(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)z;
+    if (!verification_is_divisible(x, y))
+        return false;
+    bigint_division_word_long(first, second, x, y);
+    return true;
+}
+
+static bool verification_remainder_word_long(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)z;
+    if (!verification_is_divisible(x, y))
+        return false;
+    bigint_division_word_long(second, first, x, y);
+    return true;
+}
+
+static bool verification_reduction_barrett(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)z;
+    if (!verification_is_divisible(x, y) || x->digit_num > 2 * (size_t)y->digit_num) // Barrett needs x < W^(2n)
+        return false;
+    bigint_reduction_barrett_pre_computed(second, y);
+    bigint_reduction_barrett(first, x, y, *second);
+    return true;
+}
+
+static bool verification_exponentiation_left_to_right(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second;
+    if (!verification_is_divisible(x, z) || y->sign == NEGATIVE)
+        return false;
+    bigint_exponentiation_modular_left_to_right(first, x, y, z);
+    return true;
+}
+
+static bool verification_exponentiation_montgomery_ladder(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second;
+    if (!verification_is_divisible(x, z) || y->sign == NEGATIVE)
+        return false;
+    bigint_exponentiation_modular_montgomery_ladder(first, x, y, z);
+    return true;
+}
+
+static bool verification_exponentiation_fixed_window(Bigint** first, Bigint** second, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    (void)second;
+    if (!verification_is_divisible(x, z) || y->sign == NEGATIVE || (z->digits[0] & 1) == 0) // Odd modulus only
+        return false;
+    bigint_exponentiation_modular_fixed_window(first, x, y, z);
+    return true;
+}
+
+#define P POSITIVE /**< Short signs of the table. */
+#define N NEGATIVE
+
+/** @brief Every check, in the order of the summary. */
+static const VerificationCheck verification_checks[] = {
+    /* Random operands against Python */
+    { "addition",                                SUITE_RANDOM, P, P, verification_addition,                         NULL, 1, { "addition", NULL }, 0 },
+    { "subtraction",                             SUITE_RANDOM, P, P, verification_subtraction,                      NULL, 1, { "subtraction", NULL }, 0 },
+    { "multiplication_textbook",                 SUITE_RANDOM, P, P, verification_multiplication_textbook,          NULL, 1, { "multiplication", NULL }, 0 },
+    { "multiplication_karatsuba",                SUITE_RANDOM, P, P, verification_multiplication_karatsuba,         NULL, 1, { "multiplication", NULL }, 0 },
+    { "squaring_textbook",                       SUITE_RANDOM, P, P, verification_squaring_textbook,                NULL, 1, { "squaring", NULL }, 0 },
+    { "squaring_karatsuba",                      SUITE_RANDOM, P, P, verification_squaring_karatsuba,               NULL, 1, { "squaring", NULL }, 0 },
+    { "division_binary_long",                    SUITE_RANDOM, P, P, verification_division_binary_long,            NULL, 2, { "quotient", "remainder" }, 0 },
+    { "division_word_long",                      SUITE_RANDOM, P, P, verification_division_word_long,              NULL, 2, { "quotient", "remainder" }, 0 },
+    { "reduction_barrett",                       SUITE_RANDOM, P, P, verification_reduction_barrett,               NULL, 1, { "remainder", NULL }, 0 },
+    { "exponentiation_fixed_window",             SUITE_RANDOM, P, P, verification_exponentiation_fixed_window,     NULL, 1, { "exponentiation", NULL }, 0 },
+
+    /* Random operands, algorithm pairs */
+    { "multiplication_textbook=karatsuba",       SUITE_RANDOM, P, P, verification_multiplication_textbook,  verification_multiplication_karatsuba,         1, { NULL, NULL }, 0 },
+    { "squaring_textbook=karatsuba",             SUITE_RANDOM, P, P, verification_squaring_textbook,        verification_squaring_karatsuba,               1, { NULL, NULL }, 0 },
+    { "squaring_karatsuba=multiplication",       SUITE_RANDOM, P, P, verification_squaring_karatsuba,       verification_multiplication_square,            1, { NULL, NULL }, 0 },
+    { "division_binary_long=word_long",          SUITE_RANDOM, P, P, verification_division_binary_long,     verification_division_word_long,               2, { NULL, NULL }, 0 },
+    { "reduction_barrett=division",              SUITE_RANDOM, P, P, verification_reduction_barrett,        verification_remainder_word_long,              1, { NULL, NULL }, 0 },
+
+    /* Short random operands: left-to-right and ladder reduce by binary division, seconds per 2048-bit call */
+    { "exponentiation_left_to_right",            SUITE_RANDOM_SHORT, P, P, verification_exponentiation_left_to_right,    NULL, 1, { "exponentiation", NULL }, 0 },
+    { "exponentiation_montgomery_ladder",        SUITE_RANDOM_SHORT, P, P, verification_exponentiation_montgomery_ladder, NULL, 1, { "exponentiation", NULL }, 0 },
+    { "exponentiation_fixed_window",             SUITE_RANDOM_SHORT, P, P, verification_exponentiation_fixed_window,     NULL, 1, { "exponentiation", NULL }, 0 },
+    { "exponentiation_left_to_right=ladder",     SUITE_RANDOM_SHORT, P, P, verification_exponentiation_left_to_right, verification_exponentiation_montgomery_ladder, 1, { NULL, NULL }, 128 },
+    { "exponentiation_fixed_window=ladder",      SUITE_RANDOM_SHORT, P, P, verification_exponentiation_fixed_window,  verification_exponentiation_montgomery_ladder, 1, { NULL, NULL }, 128 },
+
+    /* All-ones operands of every sign against GMP */
+    { "addition_pp",                             SUITE_BIT, P, P, verification_addition,                    NULL, 1, { "tv_add_pp", NULL }, 0 },
+    { "addition_pn",                             SUITE_BIT, P, N, verification_addition,                    NULL, 1, { "tv_add_pn", NULL }, 0 },
+    { "addition_np",                             SUITE_BIT, N, P, verification_addition,                    NULL, 1, { "tv_add_np", NULL }, 0 },
+    { "addition_nn",                             SUITE_BIT, N, N, verification_addition,                    NULL, 1, { "tv_add_nn", NULL }, 0 },
+    { "subtraction_pp",                          SUITE_BIT, P, P, verification_subtraction,                 NULL, 1, { "tv_sub_pp", NULL }, 0 },
+    { "subtraction_pn",                          SUITE_BIT, P, N, verification_subtraction,                 NULL, 1, { "tv_sub_pn", NULL }, 0 },
+    { "subtraction_np",                          SUITE_BIT, N, P, verification_subtraction,                 NULL, 1, { "tv_sub_np", NULL }, 0 },
+    { "subtraction_nn",                          SUITE_BIT, N, N, verification_subtraction,                 NULL, 1, { "tv_sub_nn", NULL }, 0 },
+    { "multiplication_textbook_pp",              SUITE_BIT, P, P, verification_multiplication_textbook,     NULL, 1, { "tv_mul_pp", NULL }, 0 },
+    { "multiplication_karatsuba_pp",             SUITE_BIT, P, P, verification_multiplication_karatsuba,    NULL, 1, { "tv_mul_pp", NULL }, 0 },
+    { "squaring_textbook",                       SUITE_BIT, P, P, verification_squaring_textbook,           NULL, 1, { "tv_sqr_pp", NULL }, 0 },
+    { "squaring_karatsuba",                      SUITE_BIT, P, P, verification_squaring_karatsuba,          NULL, 1, { "tv_sqr_pp", NULL }, 0 },
+    { "division_binary_long",                    SUITE_BIT, P, P, verification_division_binary_long,        NULL, 2, { "tv_div_q_pp", "tv_div_r_pp" }, 0 },
+    { "division_word_long",                      SUITE_BIT, P, P, verification_division_word_long,          NULL, 2, { "tv_div_q_pp", "tv_div_r_pp" }, 0 },
+    { "reduction_barrett",                       SUITE_BIT, P, P, verification_reduction_barrett,           NULL, 1, { "tv_div_r_pp", NULL }, 0 },
+
+    /* All-ones operands, algorithm pairs; GMP products of negative operands are not in the tree */
+    { "multiplication_textbook=karatsuba_pp",    SUITE_BIT, P, P, verification_multiplication_textbook,     verification_multiplication_karatsuba, 1, { NULL, NULL }, 0 },
+    { "multiplication_textbook=karatsuba_pn",    SUITE_BIT, P, N, verification_multiplication_textbook,     verification_multiplication_karatsuba, 1, { NULL, NULL }, 0 },
+    { "multiplication_textbook=karatsuba_np",    SUITE_BIT, N, P, verification_multiplication_textbook,     verification_multiplication_karatsuba, 1, { NULL, NULL }, 0 },
+    { "multiplication_textbook=karatsuba_nn",    SUITE_BIT, N, N, verification_multiplication_textbook,     verification_multiplication_karatsuba, 1, { NULL, NULL }, 0 },
+    { "squaring_textbook=karatsuba",             SUITE_BIT, P, P, verification_squaring_textbook,           verification_squaring_karatsuba,       1, { NULL, NULL }, 0 },
+    { "squaring_karatsuba=multiplication_n",     SUITE_BIT, N, P, verification_squaring_karatsuba,          verification_multiplication_square,    1, { NULL, NULL }, 0 },
+    { "division_binary_long=word_long",          SUITE_BIT, P, P, verification_division_binary_long,        verification_division_word_long,       2, { NULL, NULL }, 0 },
+    { "reduction_barrett=division",              SUITE_BIT, P, P, verification_reduction_barrett,           verification_remainder_word_long,      1, { NULL, NULL }, 0 },
+};
+
+#undef P
+#undef N
+
+/** @brief Directory of each suite under the verification root. */
+static const char* const verification_suite_names[SUITE_NUM] = { "random_test_vectors", "random_test_vectors", "bit_test_vectors" };
+
+/** @brief Short name of each suite in the summary. */
+static const char* const verification_suite_labels[SUITE_NUM] = { "random", "random256", "bit" };
+
+/** @brief Suffix of the vector files of each suite. */
+static const char* const verification_suite_suffixes[SUITE_NUM] = { "", "8", "" };
+
+/** @brief Operand files of each suite, NULL if the suite has no such operand. */
+static const char* const verification_operand_names[SUITE_NUM][VERIFICATION_OPERAND_NUM] = {
+    { "operand_x", "operand_y", "operand_z" },
+    { "operand_x", "operand_y", "operand_z" },
+    { "tv_x", "tv_y", NULL }
+};
+
+/**
+ * @brief Reads a text vector file, one hex value per line with an optional '-'.
+ *
+ * Empty lines are ignored and DIV0! lines are kept as NULL, so every value stays on the line of its operands.
+ *
+ * @param file [out] Loaded file.
+ * @param path [in] Path of the text file.
+ * @return bool true on success, false with a message otherwise.
+ */
+static bool verification_file_load(VerificationFile* file, const char* path)
+{
+    file->path = strdup(path);
+    file->values = NULL;
+    file->value_num = 0;
+
+    FILE* stream = fopen(path, "r");
+    if (stream == NULL) {
+        printf("Invalid Case: Cannot open %s.\n", path);
+        return false;
+    }
+
+    size_t value_cap = 1024;
+    file->values = (Bigint**)malloc(value_cap * sizeof(Bigint*));
+
+    char* line = NULL;
+    size_t line_cap = 0;
+    size_t line_idx = 0;
+    bool is_loaded = true;
+    ssize_t length;
+
+    while (is_loaded && (length = getline(&line, &line_cap, stream)) >= 0) {
+        line_idx++;
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+            length--;
+        if (length == 0)
+            continue;
+
+        if (file->value_num == value_cap) {
+            value_cap *= 2;
+            file->values = (Bigint**)realloc(file->values, value_cap * sizeof(Bigint*));
+        }
+
+        Bigint* value = NULL;
+        if (length == 5 && memcmp(line, "DIV0!", 5) == 0) {
+            /* Division by zero, no value */
+        }
+        else if (bigint_from_string(&value, line, (size_t)length, 16) != CONVERT_OK) {
+            printf("Invalid Case: line %zu of %s is not hex.\n", line_idx, path);
+            is_loaded = false;
+        }
+        file->values[file->value_num++] = value;
+    }
+
+    free(line);
+    fclose(stream);
+    return is_loaded;
+}
+
+/**
+ * @brief Deallocates the values of a file, the path is kept.
+ *
+ * @param file [in, out] Loaded file.
+ */
+static void verification_file_clear(VerificationFile* file)
+{
+    for (size_t value_idx = 0; value_idx < file->value_num; value_idx++)
+        if (file->values[value_idx] != NULL)
+            bigint_delete(&file->values[value_idx]);
+    free(file->values);
+    file->values = NULL;
+    file->value_num = 0;
+}
+
+/** @brief Vector files shared by the checks, each file is read once. */
+typedef struct {
+    VerificationFile** files; /**< Allocated one by one, checks keep pointers to them while the array grows. */
+    size_t file_num;
+    size_t file_cap;
+} VerificationFiles;
+
+/**
+ * @brief Returns a vector file of a suite, reading it on first use.
+ *
+ * @param cache [in, out] Files read so far.
+ * @param directory [in] Verification root.
+ * @param suite [in] Suite of the file.
+ * @param name [in] File name without the suffix and .txt.
+ * @return const VerificationFile* File, NULL if it cannot be read.
+ */
+static const VerificationFile* verification_file_get(VerificationFiles* cache, const char* directory, VerificationSuite suite, const char* name)
+{
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s/%s%s.txt", directory, verification_suite_names[suite], name, verification_suite_suffixes[suite]);
+
+    for (size_t file_idx = 0; file_idx < cache->file_num; file_idx++)
+        if (strcmp(cache->files[file_idx]->path, path) == 0)
+            return cache->files[file_idx]->values != NULL ? cache->files[file_idx] : NULL;
+
+    if (cache->file_num == cache->file_cap) {
+        cache->file_cap = cache->file_cap == 0 ? 16 : cache->file_cap * 2;
+        cache->files = (VerificationFile**)realloc(cache->files, cache->file_cap * sizeof(VerificationFile*));
+    }
+
+    /* A file that failed stays in the cache without values, so it is reported once */
+    VerificationFile* file = (VerificationFile*)malloc(sizeof(VerificationFile));
+    cache->files[cache->file_num++] = file;
+    if (verification_file_load(file, path) == false) {
+        verification_file_clear(file);
+        return NULL;
+    }
+    return file;
+}
+
+/**
+ * @brief Compares two results, zero is equal to zero whatever its sign.
+ *
+ * @param x [in] First result.
+ * @param y [in] Second result.
+ * @return bool true if the values are equal.
+ */
+static bool verification_is_equal(const Bigint* x, const Bigint* y)
+{
+    if (bigint_is_zero(x) == TRUE || bigint_is_zero(y) == TRUE)
+        return bigint_is_zero(x) == bigint_is_zero(y);
+    return x->sign == y->sign && bigint_compare_abs(x, y) == 0;
+}
+
+/**
+ * @brief Prints a mismatch, the first config->report_max of a run, with the values when they are short.
+ *
+ * The line is the line of the operands in the vector files.
+ *
+ * @param run [in, out] Run state.
+ * @param check [in] Failed check.
+ * @param case_idx [in] Index of the case, the line of the vector files minus one.
+ * @param result [in] Result of the algorithm under test.
+ * @param expected [in] Expected result.
+ */
+static void verification_report(VerificationRun* run, const VerificationCheck* check, size_t case_idx,
+                                const Bigint* result, const Bigint* expected)
+{
+    if (__atomic_fetch_add(&run->report_num, 1, __ATOMIC_RELAXED) >= run->config->report_max)
+        return;
+
+    char result_hex[72];
+    char expected_hex[72];
+    if (bigint_to_string(result_hex, sizeof(result_hex), NULL, result, 16) == CONVERT_OK
+        && bigint_to_string(expected_hex, sizeof(expected_hex), NULL, expected, 16) == CONVERT_OK)
+        fprintf(run->config->output, "Mismatch: %s/%s, line %zu: %s instead of %s\n",
+                verification_suite_labels[check->suite], check->name, case_idx + 1, result_hex, expected_hex);
+    else
+        fprintf(run->config->output, "Mismatch: %s/%s, line %zu\n",
+                verification_suite_labels[check->suite], check->name, case_idx + 1);
+}
+
+/**
+ * @brief Runs the cases of one task: operands get the signs of the check, then the results of the
+ * algorithm are compared with the vector files or with the reference algorithm.
+ *
+ * @param argument [in] VerificationRun.
+ * @param task_idx [in] Task index.
+ * @param worker_idx [in] Unused.
+ */
+static void verification_task(void* argument, size_t task_idx, size_t worker_idx)
+{
+    (void)worker_idx;
+    VerificationRun* run = (VerificationRun*)argument;
+    const VerificationTask* task = &run->tasks[task_idx];
+    const VerificationCheck* check = &run->checks[task->check_idx];
+    VerificationState* state = &run->states[task->check_idx];
+
+    Bigint* operands[VERIFICATION_OPERAND_NUM] = { NULL };
+    Bigint* results[2] = { NULL };
+    Bigint* references[2] = { NULL };
+    for (size_t idx = 0; idx < VERIFICATION_OPERAND_NUM; idx++)
+        bigint_new(&operands[idx], 1);
+    for (size_t idx = 0; idx < 2; idx++) {
+        bigint_new(&results[idx], 1);
+        bigint_new(&references[idx], 1);
+    }
+
+    uint64_t pass_num = 0, mismatch_num = 0, skip_num = 0;
+
+    for (size_t case_idx = task->case_begin; case_idx < task->case_end; case_idx++) {
+        /* Operands, a case without a value is skipped */
+        bool is_valid = true;
+        for (size_t idx = 0; idx < VERIFICATION_OPERAND_NUM; idx++) {
+            const VerificationFile* file = state->operands[idx];
+            if (file == NULL)
+                bigint_set_zero(&operands[idx]);
+            else if (file->values[case_idx] == NULL)
+                is_valid = false;
+            else
+                bigint_copy(&operands[idx], file->values[case_idx]);
+        }
+        for (size_t idx = 0; idx < check->result_num; idx++)
+            if (state->expected[idx] != NULL && state->expected[idx]->values[case_idx] == NULL)
+                is_valid = false;
+
+        if (is_valid) {
+            if (check->sign_x == NEGATIVE && bigint_is_zero(operands[0]) == FALSE) operands[0]->sign = NEGATIVE;
+            if (check->sign_y == NEGATIVE && bigint_is_zero(operands[1]) == FALSE) operands[1]->sign = NEGATIVE;
+            is_valid = check->operation(&results[0], &results[1], operands[0], operands[1], operands[2]);
+        }
+        if (is_valid && check->reference != NULL)
+            is_valid = check->reference(&references[0], &references[1], operands[0], operands[1], operands[2]);
+        if (is_valid == false) {
+            skip_num++;
+            continue;
+        }
+
+        /* Compare */
+        bool is_equal = true;
+        for (size_t idx = 0; idx < check->result_num && is_equal; idx++) {
+            const Bigint* expected = check->reference != NULL ? references[idx] : state->expected[idx]->values[case_idx];
+            if (verification_is_equal(results[idx], expected) == false) {
+                verification_report(run, check, case_idx, results[idx], expected);
+                is_equal = false;
+            }
+        }
+
+        if (is_equal)
+            pass_num++;
+        else
+            mismatch_num++;
+    }
+
+    __atomic_fetch_add(&state->pass_num, pass_num, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&state->mismatch_num, mismatch_num, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&state->skip_num, skip_num, __ATOMIC_RELAXED);
+
+    for (size_t idx = 0; idx < VERIFICATION_OPERAND_NUM; idx++)
+        bigint_delete(&operands[idx]);
+    for (size_t idx = 0; idx < 2; idx++) {
+        bigint_delete(&results[idx]);
+        bigint_delete(&references[idx]);
+    }
+}
+
+/**
+ * @brief Sets the default verification settings: vectors under verificate/, one thread per online CPU,
+ * the first 16 mismatches printed, every check, summary on stdout.
+ *
+ * @param config [out] Settings.
+ */
+void bigint_verification_config_default(VerificationConfig* config)
+{
+    config->directory = "verificate";
+    config->thread_num = 0;
+    config->report_max = 16;
+    config->filter = NULL;
+    config->output = stdout;
+}
+
+/**
+ * @brief Runs every algorithm on every test vector under config->directory and cross-checks algorithm pairs.
+ *
+ * Each check is split into tasks of VERIFICATION_CHUNK cases run on a thread pool. Checks against vector files
+ * compare with the results computed by Python and GMP; cross-checks compare two algorithms of the library
+ * on the same operands, which also covers the signed products the vector files lack. Cases outside the
+ * domain of an algorithm, such as a zero divisor, are counted as skipped. The run ends with one summary
+ * line per check.
+ *
+ * @param config [in] Settings.
+ * @return bool true if every vector file was read and no case mismatched.
+ */
+bool bigint_verification_run(const VerificationConfig* config)
+{
+    const size_t check_num = sizeof(verification_checks) / sizeof(verification_checks[0]);
+    VerificationState* states = (VerificationState*)calloc(check_num, sizeof(VerificationState));
+    VerificationFiles cache = { NULL, 0, 0 };
+    bool is_loaded = true;
+    size_t task_num = 0;
+
+    /* Read the files of the selected checks */
+    for (size_t check_idx = 0; check_idx < check_num; check_idx++) {
+        const VerificationCheck* check = &verification_checks[check_idx];
+        VerificationState* state = &states[check_idx];
+        char name[128];
+        snprintf(name, sizeof(name), "%s/%s", verification_suite_labels[check->suite], check->name);
+        if (config->filter != NULL && strstr(name, config->filter) == NULL)
+            continue;
+
+        state->is_selected = true;
+        state->is_loaded = true;
+        state->case_num = SIZE_MAX;
+        for (size_t idx = 0; idx < VERIFICATION_OPERAND_NUM + 2; idx++) {
+            const char* file_name = idx < VERIFICATION_OPERAND_NUM ? verification_operand_names[check->suite][idx]
+                                                                   : check->expected[idx - VERIFICATION_OPERAND_NUM];
+            if (file_name == NULL)
+                continue;
+
+            const VerificationFile* file = verification_file_get(&cache, config->directory, check->suite, file_name);
+            if (file == NULL) {
+                state->is_loaded = false;
+                continue;
+            }
+            if (idx < VERIFICATION_OPERAND_NUM)
+                state->operands[idx] = file;
+            else
+                state->expected[idx - VERIFICATION_OPERAND_NUM] = file;
+            if (file->value_num < state->case_num)
+                state->case_num = file->value_num;
+        }
+
+        if (check->case_max != 0 && check->case_max < state->case_num)
+            state->case_num = check->case_max;
+        if (state->is_loaded == false) {
+            state->case_num = 0;
+            is_loaded = false;
+        }
+        task_num += (state->case_num + VERIFICATION_CHUNK - 1) / VERIFICATION_CHUNK;
+    }
+
+    /* Split every check into tasks */
+    VerificationTask* tasks = (VerificationTask*)malloc((task_num + 1) * sizeof(VerificationTask));
+    size_t task_idx = 0;
+    for (size_t check_idx = 0; check_idx < check_num; check_idx++) {
+        for (size_t case_begin = 0; case_begin < states[check_idx].case_num; case_begin += VERIFICATION_CHUNK) {
+            size_t case_end = case_begin + VERIFICATION_CHUNK;
+            tasks[task_idx].check_idx = check_idx;
+            tasks[task_idx].case_begin = case_begin;
+            tasks[task_idx].case_end = case_end < states[check_idx].case_num ? case_end : states[check_idx].case_num;
+            task_idx++;
+        }
+    }
+
+    VerificationRun run = { config, verification_checks, states, tasks, 0 };
+    ThreadPool* pool = NULL;
+    bigint_thread_pool_new(&pool, config->thread_num);
+    bigint_thread_pool_run(pool, verification_task, &run, task_num);
+    size_t thread_num = bigint_thread_pool_size(pool);
+    bigint_thread_pool_delete(&pool);
+
+    /* Summary */
+    FILE* output = config->output;
+    uint64_t case_total = 0, mismatch_total = 0, skip_total = 0;
+    size_t run_num = 0;
+
+    fprintf(output, "%-48s %8s %8s %10s %8s\n", "check", "cases", "passed", "mismatches", "skipped");
+    for (size_t check_idx = 0; check_idx < check_num; check_idx++) {
+        const VerificationCheck* check = &verification_checks[check_idx];
+        const VerificationState* state = &states[check_idx];
+        if (state->is_selected == false)
+            continue;
+
+        char name[128];
+        snprintf(name, sizeof(name), "%s/%s", verification_suite_labels[check->suite], check->name);
+
+        if (state->is_loaded)
+            fprintf(output, "%-48s %8zu %8llu %10llu %8llu\n", name, state->case_num, (unsigned long long)state->pass_num,
+                    (unsigned long long)state->mismatch_num, (unsigned long long)state->skip_num);
+        else
+            fprintf(output, "%-48s not run, vector files missing\n", name);
+
+        case_total += state->case_num;
+        mismatch_total += state->mismatch_num;
+        skip_total += state->skip_num;
+        run_num++;
+    }
+
+    bool is_passed = is_loaded && mismatch_total == 0;
+    fprintf(output, "Verification %s: %zu checks, %llu cases, %llu mismatches, %llu skipped, %zu threads.\n",
+            is_passed ? "passed" : "FAILED", run_num, (unsigned long long)case_total,
+            (unsigned long long)mismatch_total, (unsigned long long)skip_total, thread_num);
+
+    for (size_t file_idx = 0; file_idx < cache.file_num; file_idx++) {
+        verification_file_clear(cache.files[file_idx]);
+        free(cache.files[file_idx]->path);
+        free(cache.files[file_idx]);
+    }
+    free(cache.files);
+    free(tasks);
+    free(states);
+
+    return is_passed;
+}
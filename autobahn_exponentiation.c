@@ -1,4 +1,24 @@
-#include "autobahn.h"
+#include "autobahn_internal.h"
+
+/**
+ * @brief Reduces the base of an exponentiation modulo the modulus.
+ *
+ * @param reduced [out] Base mod modulus.
+ * @param base [in] Non-negative base.
+ * @param modular [in] Modulus.
+ */
+static void exponentiation_reduce_base(Bigint** reduced, const Bigint* base, const Bigint* modular)
+{
+    if (bigint_compare_abs(base, modular) < 0) {
+        bigint_copy(reduced, base);
+        return;
+    }
+
+    Bigint* quotient = NULL;
+    bigint_new(&quotient, 1);
+    bigint_division_word_long(&quotient, reduced, base, modular);
+    bigint_delete(&quotient);
+}
 
 /**
  * @brief Performs modular exponentiation using the left-to-right method.
@@ -10,6 +30,8 @@
  */
 void bigint_exponentiation_modular_left_to_right(Bigint** result, const Bigint* base, const Bigint* exponent, const Bigint* modular)
 {
+    PROFILE_SCOPE(PROFILE_EXPONENTIATION_LEFT_TO_RIGHT, base->digit_num + exponent->digit_num);
+
     /* Ensure that base and exponent are non-negative */
     if (base->sign == NEGATIVE || exponent->sign == NEGATIVE) {
         printf("Invalid Case: Base or exponent must be positive.\n");
@@ -18,17 +40,21 @@ void bigint_exponentiation_modular_left_to_right(Bigint** result, const Bigint*
 
     Bigint* result_tmp = NULL;
     Bigint* barrett_pre_compute = NULL;
+    Bigint* base_reduced = NULL;
 
     /* Allocate Bigint */
     bigint_new(&result_tmp, 1);
     bigint_new(&barrett_pre_compute, 1);
+    bigint_new(&base_reduced, 1);
 
-    /* Initialization */
+    /* Initialization, the base is reduced so every product stays in the range of Barrett */
     bigint_set_one(&result_tmp);
     bigint_reduction_barrett_pre_computed(&barrett_pre_compute, modular);
+    exponentiation_reduce_base(&base_reduced, base, modular);
 
     /* Iteration count */
-    Word digit_idx = exponent->digit_num;
+    size_t digit_idx = exponent->digit_num;
+    bool leading_zero = true;
 
     /* Left-to-right: conditional multiplication */
     while (digit_idx--)
@@ -37,11 +63,16 @@ void bigint_exponentiation_modular_left_to_right(Bigint** result, const Bigint*
 
         while (bit_idx--)
         {
+            /* Skip the leading zero bits, squaring one is useless */
+            if (leading_zero && GET_BIT(exponent->digits[digit_idx], bit_idx) == 0)
+                continue;
+            leading_zero = false;
+
             bigint_squaring_textbook(&result_tmp, result_tmp); // always squaring.
             bigint_reduction_barrett(&result_tmp, result_tmp, modular, barrett_pre_compute); // modular     
 
             if (GET_BIT(exponent->digits[digit_idx], bit_idx) == 1) {
-                bigint_multiplication_textbook(&result_tmp, result_tmp, base); // conditional multiplication.
+                bigint_multiplication_textbook(&result_tmp, result_tmp, base_reduced); // conditional multiplication.
                 bigint_reduction_barrett(&result_tmp, result_tmp, modular, barrett_pre_compute); // modular 
             }    
         }
@@ -54,6 +85,7 @@ void bigint_exponentiation_modular_left_to_right(Bigint** result, const Bigint*
     /* Free Bigint */
     bigint_delete(&result_tmp);
     bigint_delete(&barrett_pre_compute);
+    bigint_delete(&base_reduced);
 }
 
 /**
@@ -66,6 +98,8 @@ void bigint_exponentiation_modular_left_to_right(Bigint** result, const Bigint*
  */
 void bigint_exponentiation_modular_montgomery_ladder(Bigint** result, const Bigint* base, const Bigint* exponent, const Bigint* modular)
 {
+    PROFILE_SCOPE(PROFILE_EXPONENTIATION_MONTGOMERY_LADDER, base->digit_num + exponent->digit_num);
+
     /* Ensure that base and exponent are non-negative */
     if (base->sign == NEGATIVE || exponent->sign == NEGATIVE) {
         printf("Invalid Case: Base or exponent must be positive.\n");
@@ -82,13 +116,13 @@ void bigint_exponentiation_modular_montgomery_ladder(Bigint** result, const Bigi
     bigint_new(&right, 1);
     bigint_new(&barrett_pre_compute, 1);
 
-    /* Initialization */
-    bigint_set_one(&left);     // L = 1
-    bigint_copy(&right, base); // R = x
+    /* Initialization, the base is reduced so every product stays in the range of Barrett */
+    bigint_set_one(&left);                               // L = 1
+    exponentiation_reduce_base(&right, base, modular);   // R = x mod n
     bigint_reduction_barrett_pre_computed(&barrett_pre_compute, modular);
 
     /* Iteration count */
-    Word digit_idx = exponent->digit_num;
+    size_t digit_idx = exponent->digit_num;
 
     /* Left-to-right: conditional multiplication */
     while (digit_idx--)
@@ -120,4 +154,428 @@ void bigint_exponentiation_modular_montgomery_ladder(Bigint** result, const Bigi
     bigint_delete(&left);
     bigint_delete(&right);
     bigint_delete(&barrett_pre_compute);
+}
+
+/**
+ * @brief Chooses the window size minimizing the number of multiplications for a public exponent length.
+ *
+ * @param exponent_digit_num [in] Number of digits of the exponent.
+ * @return Word Window size in bits.
+ */
+static Word exponentiation_window_size(size_t exponent_digit_num)
+{
+    size_t bit_length = exponent_digit_num * BITLEN_OF_WORD;
+    Word window_best = 1;
+    size_t cost_best = bit_length + 2;
+
+    /* Cost: one multiplication per window plus the table */
+    for (Word window = 2; window <= 6; window++) {
+        size_t cost = (bit_length + window - 1) / window + ((size_t)1 << window);
+        if (cost < cost_best) {
+            cost_best = cost;
+            window_best = window;
+        }
+    }
+
+    return window_best;
+}
+
+/**
+ * @brief Extracts the window of bits [bit_position, bit_position + window) of the exponent.
+ *
+ * @param exponent [in] Exponent digits.
+ * @param exponent_digit_num [in] Number of digits of the exponent.
+ * @param bit_position [in] Position of the lowest bit of the window.
+ * @param window [in] Window size in bits.
+ * @return Word Value of the window.
+ */
+static Word exponentiation_get_window(const Word* exponent, size_t exponent_digit_num, size_t bit_position, Word window)
+{
+    size_t digit_idx = bit_position / BITLEN_OF_WORD;
+    Word bit_idx = bit_position % BITLEN_OF_WORD;
+    Word value = exponent[digit_idx] >> bit_idx;
+
+    /* Window crosses the word boundary */
+    if (bit_idx + window > BITLEN_OF_WORD && digit_idx + 1 < exponent_digit_num)
+        value |= (Word)(exponent[digit_idx + 1] << (BITLEN_OF_WORD - bit_idx));
+
+    return value & (((Word)1 << window) - 1);
+}
+
+/**
+ * @brief Stores a table entry interleaved: digit i of entry k goes to table[i * entry_count + k].
+ *
+ * @param table [out] Interleaved table.
+ * @param entry [in] Entry of n words.
+ * @param entry_idx [in] Index of the entry.
+ * @param entry_count [in] Number of entries.
+ * @param digit_num [in] Number of digits of an entry.
+ */
+static void exponentiation_table_scatter(Word* table, const Word* entry, Word entry_idx, Word entry_count, size_t digit_num)
+{
+    for (size_t idx = 0; idx < digit_num; idx++)
+        table[idx * entry_count + entry_idx] = entry[idx];
+}
+
+/**
+ * @brief Loads a table entry by reading every entry, so the access pattern does not depend on the index.
+ *
+ * @param entry [out] Entry of n words.
+ * @param table [in] Interleaved table.
+ * @param entry_idx [in] Secret index of the entry.
+ * @param entry_count [in] Number of entries.
+ * @param digit_num [in] Number of digits of an entry.
+ */
+static void exponentiation_table_gather(Word* entry, const Word* table, Word entry_idx, Word entry_count, size_t digit_num)
+{
+    for (size_t idx = 0; idx < digit_num; idx++)
+    {
+        const Word* line = table + idx * entry_count;
+        Word digit = 0;
+
+        for (Word jdx = 0; jdx < entry_count; jdx++)
+            digit |= line[jdx] & word_mask_equal(jdx, entry_idx);
+
+        entry[idx] = digit;
+    }
+}
+
+/**
+ * @brief Returns the number of scratch words needed by words_exponentiation_fixed_window.
+ *
+ * @param digit_num [in] Number of digits of the modulus.
+ * @param exponent_digit_num [in] Number of digits of the exponent.
+ * @return size_t Number of scratch words.
+ */
+size_t words_exponentiation_scratch_size(size_t digit_num, size_t exponent_digit_num)
+{
+    size_t entry_count = (size_t)1 << exponentiation_window_size(exponent_digit_num);
+
+    return (entry_count + 2) * digit_num + words_montgomery_scratch_size(digit_num);
+}
+
+/**
+ * @brief Performs constant-time fixed-window modular exponentiation on fixed-width arrays.
+ *
+ * The sequence of operations and the memory addresses depend only on n and the number of
+ * exponent digits, never on the values of the base or the exponent.
+ *
+ * @param result [out] Fixed-width result of n words.
+ * @param base [in] Base of n words, less than N.
+ * @param exponent [in] Exponent digits.
+ * @param exponent_digit_num [in] Number of digits of the exponent.
+ * @param context [in] Modular context.
+ * @param scratch [in] Scratch of words_exponentiation_scratch_size(n, exponent_digit_num) words.
+ */
+void words_exponentiation_fixed_window(Word* result, const Word* base, const Word* exponent, size_t exponent_digit_num, const ModularContext* context, Word* scratch)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_EXPONENTIATION_FIXED_WINDOW, context->digit_num + exponent_digit_num);
+
+    size_t digit_num = context->digit_num;
+    Word window = exponentiation_window_size(exponent_digit_num);
+    Word entry_count = (Word)1 << window;
+
+    /* Scratch layout */
+    Word* table = scratch;                                       // 2^w entries, interleaved
+    Word* accumulator = table + (size_t)entry_count * digit_num; // A
+    Word* entry = accumulator + digit_num;                       // X^k, or X in the Montgomery form
+    Word* mont_scratch = entry + digit_num;                      // Montgomery multiplication
+
+    /* Table: X^k in the Montgomery form */
+    words_montgomery_to_form(entry, base, context, mont_scratch);
+    memcpy(accumulator, context->one, digit_num * SIZE_OF_WORD);
+    exponentiation_table_scatter(table, accumulator, 0, entry_count, digit_num);
+    for (Word idx = 1; idx < entry_count; idx++) {
+        words_montgomery_multiplication(accumulator, accumulator, entry, context, mont_scratch); // A <- A * X
+        exponentiation_table_scatter(table, accumulator, idx, entry_count, digit_num);
+    }
+
+    /* Number of windows */
+    size_t bit_length = exponent_digit_num * BITLEN_OF_WORD;
+    size_t window_idx = (bit_length + window - 1) / window;
+
+    /* Top window */
+    window_idx--;
+    Word value = exponentiation_get_window(exponent, exponent_digit_num, window_idx * window, window);
+    exponentiation_table_gather(accumulator, table, value, entry_count, digit_num);
+
+    /* Left-to-right: w squarings and one multiplication per window */
+    while (window_idx--)
+    {
+        for (Word idx = 0; idx < window; idx++)
+            words_montgomery_multiplication(accumulator, accumulator, accumulator, context, mont_scratch); // A <- A^2
+
+        value = exponentiation_get_window(exponent, exponent_digit_num, window_idx * window, window);
+        exponentiation_table_gather(entry, table, value, entry_count, digit_num);
+        words_montgomery_multiplication(accumulator, accumulator, entry, context, mont_scratch); // A <- A * X^k
+    }
+
+    /* Get result */
+    words_montgomery_from_form(result, accumulator, context, mont_scratch);
+}
+
+/**
+ * @brief Returns the number of scratch words needed by words_exponentiation_public.
+ *
+ * @param digit_num [in] Number of digits of the modulus.
+ * @return size_t Number of scratch words.
+ */
+size_t words_exponentiation_public_scratch_size(size_t digit_num)
+{
+    return 2 * digit_num + words_montgomery_scratch_size(digit_num);
+}
+
+/**
+ * @brief Performs variable-time left-to-right exponentiation for public exponents on fixed-width arrays.
+ *
+ * Leading zero bits are skipped and the last multiplication uses the base outside the Montgomery form,
+ * so e = 2^k + 1 (3, 17, 65537) costs one conversion, k squarings and one multiplication.
+ *
+ * @param result [out] Fixed-width result of n words.
+ * @param base [in] Base of n words, less than N.
+ * @param exponent [in] Public exponent digits.
+ * @param exponent_digit_num [in] Number of digits of the exponent.
+ * @param context [in] Modular context.
+ * @param scratch [in] Scratch of words_exponentiation_public_scratch_size(n) words.
+ */
+void words_exponentiation_public(Word* result, const Word* base, const Word* exponent, size_t exponent_digit_num, const ModularContext* context, Word* scratch)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_EXPONENTIATION_PUBLIC, context->digit_num + exponent_digit_num);
+
+    size_t digit_num = context->digit_num;
+    Word* accumulator = scratch;                // A
+    Word* base_mont = accumulator + digit_num;  // X in the Montgomery form
+    Word* mont_scratch = base_mont + digit_num; // Montgomery multiplication
+
+    /* Find the most significant bit */
+    size_t bit_idx = exponent_digit_num * BITLEN_OF_WORD;
+    while (bit_idx > 0 && GET_BIT(exponent[(bit_idx - 1) / BITLEN_OF_WORD], (bit_idx - 1) % BITLEN_OF_WORD) == 0)
+        bit_idx--;
+
+    /* Special case: exponent is zero */
+    if (bit_idx == 0) {
+        words_montgomery_from_form(result, context->one, context, mont_scratch); // 1 mod N
+        return;
+    }
+
+    /* Special case: exponent is one */
+    if (--bit_idx == 0) {
+        memcpy(result, base, digit_num * SIZE_OF_WORD);
+        return;
+    }
+
+    /* A <- X in the Montgomery form, for the top bit */
+    words_montgomery_to_form(base_mont, base, context, mont_scratch);
+    memcpy(accumulator, base_mont, digit_num * SIZE_OF_WORD);
+
+    /* Left-to-right down to bit 1 */
+    while (--bit_idx > 0)
+    {
+        words_montgomery_multiplication(accumulator, accumulator, accumulator, context, mont_scratch); // A <- A^2
+
+        if (GET_BIT(exponent[bit_idx / BITLEN_OF_WORD], bit_idx % BITLEN_OF_WORD) == 1)
+            words_montgomery_multiplication(accumulator, accumulator, base_mont, context, mont_scratch); // A <- A * X
+    }
+
+    /* Last bit: A * X with X not in the Montgomery form leaves the Montgomery form for free */
+    words_montgomery_multiplication(accumulator, accumulator, accumulator, context, mont_scratch); // A <- A^2
+    if (GET_BIT(exponent[0], 0) == 1)
+        words_montgomery_multiplication(result, accumulator, base, context, mont_scratch);
+    else
+        words_montgomery_from_form(result, accumulator, context, mont_scratch);
+}
+
+/**
+ * @brief Performs modular exponentiation for short or sparse public exponents (e = 3, 17, 65537) with a cached modular context.
+ *
+ * Not constant-time: use only when the exponent is public, e.g. RSA verification and encryption.
+ *
+ * @param result [out] Result of the modular exponentiation.
+ * @param base [in] Base value.
+ * @param exponent [in] Public exponent value.
+ * @param context [in] Modular context of an odd modulus.
+ */
+void bigint_exponentiation_modular_public(Bigint** result, const Bigint* base, const Bigint* exponent, const ModularContext* context)
+{
+    PROFILE_SCOPE(PROFILE_EXPONENTIATION_PUBLIC, base->digit_num + exponent->digit_num);
+
+    /* Ensure that base and exponent are non-negative */
+    if (base->sign == NEGATIVE || exponent->sign == NEGATIVE) {
+        printf("Invalid Case: Base or exponent must be positive.\n");
+        return;
+    }
+
+    /* Invalid context */
+    if (context == NULL) {
+        printf("Invalid Case: Modular context is not initialized.\n");
+        return;
+    }
+
+    /* Allocate fixed-width buffers once */
+    size_t digit_num = context->digit_num;
+    Word* buffer = (Word*)bigint_calloc(2 * digit_num + words_exponentiation_public_scratch_size(digit_num), SIZE_OF_WORD);
+    Word* base_words = buffer;
+    Word* result_words = buffer + digit_num;
+    Word* scratch = buffer + 2 * digit_num;
+
+    /* Exponentiation on fixed-width arrays */
+    words_reduce_operand(base_words, base, context);
+    words_exponentiation_public(result_words, base_words, exponent->digits, exponent->digit_num, context, scratch);
+
+    /* Get result */
+    bigint_set_by_array(result, result_words, POSITIVE, digit_num);
+    bigint_refine(*result);
+
+    /* Free memory */
+    bigint_free(buffer);
+}
+
+/**
+ * @brief Performs constant-time fixed-window modular exponentiation with a pre-computed modular context.
+ *
+ * @param result [out] Result of the modular exponentiation.
+ * @param base [in] Base value.
+ * @param exponent [in] Exponent value, only its number of digits is public.
+ * @param context [in] Modular context of an odd modulus.
+ */
+void bigint_exponentiation_modular_fixed_window_context(Bigint** result, const Bigint* base, const Bigint* exponent, const ModularContext* context)
+{
+    PROFILE_SCOPE(PROFILE_EXPONENTIATION_WINDOW_CONTEXT, base->digit_num + exponent->digit_num);
+
+    /* Ensure that base and exponent are non-negative */
+    if (base->sign == NEGATIVE || exponent->sign == NEGATIVE) {
+        printf("Invalid Case: Base or exponent must be positive.\n");
+        return;
+    }
+
+    /* Invalid context */
+    if (context == NULL) {
+        printf("Invalid Case: Modular context is not initialized.\n");
+        return;
+    }
+
+    /* Allocate fixed-width buffers once */
+    size_t digit_num = context->digit_num;
+    size_t scratch_size = words_exponentiation_scratch_size(digit_num, exponent->digit_num);
+    Word* buffer = (Word*)bigint_calloc(2 * digit_num + scratch_size, SIZE_OF_WORD);
+    Word* base_words = buffer;
+    Word* result_words = buffer + digit_num;
+    Word* scratch = buffer + 2 * digit_num;
+
+    /* Exponentiation on fixed-width arrays */
+    words_reduce_operand(base_words, base, context);
+    words_exponentiation_fixed_window(result_words, base_words, exponent->digits, exponent->digit_num, context, scratch);
+
+    /* Get result */
+    bigint_set_by_array(result, result_words, POSITIVE, digit_num);
+    bigint_refine(*result);
+
+    /* Clear the table and free memory */
+    memset(buffer, 0, (2 * digit_num + scratch_size) * SIZE_OF_WORD);
+    bigint_free(buffer);
+}
+
+/**
+ * @brief Performs constant-time fixed-window modular exponentiation.
+ * 
+ * @param result [out] Result of the modular exponentiation.
+ * @param base [in] Base value.
+ * @param exponent [in] Exponent value, only its number of digits is public.
+ * @param modular [in] Odd modulus value.
+ */
+void bigint_exponentiation_modular_fixed_window(Bigint** result, const Bigint* base, const Bigint* exponent, const Bigint* modular)
+{
+    PROFILE_SCOPE(PROFILE_EXPONENTIATION_FIXED_WINDOW, base->digit_num + exponent->digit_num);
+
+    ModularContext* context = NULL;
+
+    /* Pre-compute Montgomery values */
+    bigint_modular_context_new(&context, modular);
+    if (context == NULL)
+        return;
+
+    /* Exponentiation */
+    bigint_exponentiation_modular_fixed_window_context(result, base, exponent, context);
+
+    /* Free context */
+    bigint_modular_context_delete(&context);
+}
+
+/** @brief Argument of the batch modular exponentiation tasks. */
+typedef struct {
+    ThreadPool* pool;        /**< Thread pool owning the scratch arenas. */
+    ExponentiationJob* jobs; /**< Array of jobs. */
+} ExponentiationBatch;
+
+/**
+ * @brief Runs one job of a batch modular exponentiation in the scratch arena of the worker.
+ *
+ * @param argument [in] ExponentiationBatch of the run.
+ * @param task_idx [in] Index of the job.
+ * @param worker_idx [in] Index of the worker.
+ */
+static void exponentiation_batch_task(void* argument, size_t task_idx, size_t worker_idx)
+{
+    ExponentiationBatch* batch = (ExponentiationBatch*)argument;
+    ExponentiationJob* job = &batch->jobs[task_idx];
+    const ModularContext* context = job->context;
+    size_t digit_num = context->digit_num;
+
+    /* Scratch arena: base, result and the exponentiation scratch */
+    size_t scratch_size = job->exponent_is_public ? words_exponentiation_public_scratch_size(digit_num)
+                                                  : words_exponentiation_scratch_size(digit_num, job->exponent->digit_num);
+    Word* base_words = bigint_thread_pool_scratch(batch->pool, worker_idx, 2 * digit_num + scratch_size);
+    Word* result_words = base_words + digit_num;
+    Word* scratch = result_words + digit_num;
+
+    /* Exponentiation on fixed-width arrays */
+    words_reduce_operand(base_words, job->base, context);
+    if (job->exponent_is_public)
+        words_exponentiation_public(result_words, base_words, job->exponent->digits, job->exponent->digit_num, context, scratch);
+    else
+        words_exponentiation_fixed_window(result_words, base_words, job->exponent->digits, job->exponent->digit_num, context, scratch);
+
+    /* Grow the result only if it was not preallocated with n digits */
+    if (job->result->digit_num < digit_num)
+        job->result->digits = (Word*)bigint_realloc(job->result->digits, digit_num * SIZE_OF_WORD);
+
+    /* Write the result in place, refined without reallocation */
+    size_t new_digit_num = digit_num;
+    while (new_digit_num > 1 && result_words[new_digit_num - 1] == 0)
+        new_digit_num--;
+    memcpy(job->result->digits, result_words, new_digit_num * SIZE_OF_WORD);
+    job->result->digit_num = new_digit_num;
+    job->result->sign = POSITIVE;
+}
+
+/**
+ * @brief Performs independent modular exponentiations on a thread pool.
+ *
+ * Each result must be allocated beforehand, ideally with bigint_new(&result, context->digit_num) so that
+ * no worker allocates. Secret exponents use the constant-time fixed window, public ones the short path.
+ *
+ * @param pool [in] Thread pool.
+ * @param jobs [in, out] Array of jobs, their results are written in place.
+ * @param job_num [in] Number of jobs.
+ */
+void bigint_exponentiation_modular_batch(ThreadPool* pool, ExponentiationJob* jobs, size_t job_num)
+{
+    PROFILE_SCOPE(PROFILE_EXPONENTIATION_BATCH, 0);
+
+    /* Validate every job before starting the workers */
+    for (size_t idx = 0; idx < job_num; idx++) {
+        if (jobs[idx].context == NULL || jobs[idx].result == NULL) {
+            printf("Invalid Case: Job %zu has no modular context or no result.\n", idx);
+            return;
+        }
+        if (jobs[idx].base->sign == NEGATIVE || jobs[idx].exponent->sign == NEGATIVE) {
+            printf("Invalid Case: Base or exponent must be positive.\n");
+            return;
+        }
+    }
+
+    ExponentiationBatch batch = { pool, jobs };
+
+    /* Spread the jobs over the workers */
+    bigint_thread_pool_run(pool, exponentiation_batch_task, &batch, job_num);
 }
\ No newline at end of file
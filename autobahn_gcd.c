@@ -0,0 +1,1171 @@
+#include "autobahn_internal.h"
+
+#define GCD_BINARY_THRESHOLD 2                        /**< Up to this many words, binary GCD beats Lehmer. */
+#define GCD_HALF_THRESHOLD   (65536 / BITLEN_OF_WORD) /**< From this many words, the half-GCD recursion beats Lehmer. */
+
+/* Lehmer works on the leading two words if the compiler has a double word type */
+#if defined(HAS_DOUBLE_WORD)
+    typedef DoubleWord LehmerWord;
+#else
+    typedef Word LehmerWord;
+#endif
+#define LEHMER_PRECISION (sizeof(LehmerWord) * 8 - 2) /**< Bits of the leading part, two bits of headroom. */
+
+/** @brief Signed cofactor on a growable array, updated in place by the Lehmer steps. */
+typedef struct {
+    Word* digits;     /**< Magnitude. */
+    size_t digit_num; /**< Significant words, zero for the value zero. */
+    size_t capacity;  /**< Allocated words. */
+    Sign sign;        /**< Sign, zero is positive. */
+} GcdCofactor;
+
+/** @brief Running carries of one output of P * X +- Q * Y. */
+typedef struct {
+    Word carry_x;  /**< Carry word of P * X. */
+    Word carry_y;  /**< Carry word of Q * Y. */
+    Word carry;    /**< Carry or borrow of the sum. */
+    bool subtract; /**< Compute P * X - Q * Y. */
+} GcdAccumulator;
+
+/**
+ * @brief Remainder pair of a GCD computation and the cofactor rows that produce it.
+ *
+ * Each row holds the coefficients of one remainder in terms of the inputs:
+ * a = u[0] * X + u[1] * Y and b = v[0] * X + v[1] * Y. Only the first column_num columns are tracked.
+ */
+typedef struct {
+    Word* a;           /**< Larger remainder. */
+    Word* b;           /**< Smaller remainder. */
+    Word* spare;       /**< Third buffer, receives the remainder of a division step. */
+    Word* scratch;     /**< Scratch of words_division. */
+    size_t a_num;      /**< Significant words of a, zero for the value zero. */
+    size_t b_num;      /**< Significant words of b, zero for the value zero. */
+    size_t column_num; /**< Number of tracked cofactor columns, 0 to 2. */
+    size_t step_num;   /**< Number of reduction steps taken. */
+    GcdCofactor u[2];  /**< Cofactors of a. */
+    GcdCofactor v[2];  /**< Cofactors of b. */
+} GcdState;
+
+/** @brief Single-word Lehmer matrix, magnitudes only: the signs alternate with the number of steps. */
+typedef struct {
+    Word a, b, c, d; /**< Even: (a' b') = (+a -b; -c +d)(a b). Odd: all signs flipped. */
+    bool odd;        /**< Odd number of Euclid steps. */
+} LehmerMatrix;
+
+/**
+ * @brief Allocates a cofactor holding zero or one.
+ *
+ * @param cofactor [out] Cofactor.
+ * @param capacity [in] Number of words to allocate.
+ * @param is_one [in] True for one, false for zero.
+ */
+static void gcd_cofactor_new(GcdCofactor* cofactor, size_t capacity, bool is_one)
+{
+    cofactor->digits = (Word*)bigint_calloc(capacity, SIZE_OF_WORD);
+    cofactor->digits[0] = is_one ? 1 : 0;
+    cofactor->digit_num = is_one ? 1 : 0;
+    cofactor->capacity = capacity;
+    cofactor->sign = POSITIVE;
+}
+
+/**
+ * @brief Grows a cofactor to at least digit_num words, the new words are zero.
+ *
+ * @param cofactor [in, out] Cofactor.
+ * @param digit_num [in] Number of words needed.
+ */
+static void gcd_cofactor_reserve(GcdCofactor* cofactor, size_t digit_num)
+{
+    if (cofactor->capacity >= digit_num)
+        return;
+
+    cofactor->digits = (Word*)bigint_realloc(cofactor->digits, digit_num * SIZE_OF_WORD);
+    memset(cofactor->digits + cofactor->capacity, 0, (digit_num - cofactor->capacity) * SIZE_OF_WORD);
+    cofactor->capacity = digit_num;
+}
+
+/**
+ * @brief Views a cofactor as a Bigint without copying.
+ *
+ * @param view [out] Bigint view.
+ * @param cofactor [in] Cofactor.
+ */
+static void gcd_cofactor_view(Bigint* view, const GcdCofactor* cofactor)
+{
+    view->sign = cofactor->digit_num != 0 ? cofactor->sign : POSITIVE;
+    view->digit_num = cofactor->digit_num != 0 ? cofactor->digit_num : 1;
+    view->digits = cofactor->digits; // digits[0] is zero for the value zero
+}
+
+/**
+ * @brief Copies a Bigint into a cofactor.
+ *
+ * @param cofactor [in, out] Cofactor.
+ * @param bigint [in] Source Bigint.
+ */
+static void gcd_cofactor_set(GcdCofactor* cofactor, const Bigint* bigint)
+{
+    size_t digit_num = words_trim(bigint->digits, bigint->digit_num);
+
+    gcd_cofactor_reserve(cofactor, digit_num + 2);
+    memset(cofactor->digits, 0, cofactor->capacity * SIZE_OF_WORD);
+    memcpy(cofactor->digits, bigint->digits, digit_num * SIZE_OF_WORD);
+    cofactor->digit_num = digit_num;
+    cofactor->sign = digit_num != 0 ? bigint->sign : POSITIVE;
+}
+
+/**
+ * @brief Computes one word of P * X + Q * Y or P * X - Q * Y with running carries.
+ *
+ * Feeding two zero words after the last ones flushes the carries.
+ *
+ * @param accumulator [in, out] Running carries.
+ * @param multiplier_x [in] P.
+ * @param word_x [in] Word of X.
+ * @param multiplier_y [in] Q.
+ * @param word_y [in] Word of Y.
+ * @return Word Word of the result.
+ */
+static inline Word gcd_accumulate(GcdAccumulator* accumulator, Word multiplier_x, Word word_x, Word multiplier_y, Word word_y)
+{
+    Word low_x = 0;
+    Word low_y = 0;
+    Word result = 0;
+    Word next_carry = 0;
+
+    word_multiplication_addition(&accumulator->carry_x, &low_x, multiplier_x, word_x, accumulator->carry_x, 0);
+    word_multiplication_addition(&accumulator->carry_y, &low_y, multiplier_y, word_y, accumulator->carry_y, 0);
+
+    if (accumulator->subtract == false) {
+        result = low_x + low_y;
+        next_carry = (result < low_x);
+        result += accumulator->carry;
+        next_carry += (result < accumulator->carry);
+    }
+    else {
+        result = low_x - low_y;
+        next_carry = (low_x < low_y);
+        next_carry += (result < accumulator->carry);
+        result -= accumulator->carry;
+    }
+    accumulator->carry = next_carry;
+
+    return result;
+}
+
+/**
+ * @brief Updates two cofactors in place with a signed single-word matrix: (u, v) <- (P u + Q v, R u + S v).
+ *
+ * @param cofactor_u [in, out] Cofactor u.
+ * @param cofactor_v [in, out] Cofactor v.
+ * @param entries [in] Magnitudes of P, Q, R, S.
+ * @param signs [in] Signs of P, Q, R, S.
+ */
+static void gcd_cofactor_lehmer(GcdCofactor* cofactor_u, GcdCofactor* cofactor_v, const Word entries[4], const Sign signs[4])
+{
+    size_t digit_num = cofactor_u->digit_num > cofactor_v->digit_num ? cofactor_u->digit_num : cofactor_v->digit_num;
+    GcdAccumulator accumulator[2];
+    Sign result_sign[2];
+
+    /* Up to two more words */
+    gcd_cofactor_reserve(cofactor_u, digit_num + 2);
+    gcd_cofactor_reserve(cofactor_v, digit_num + 2);
+
+    /* Sign of each term decides between a sum and a difference */
+    for (size_t row = 0; row < 2; row++) {
+        Sign sign_x = signs[2 * row] ^ cofactor_u->sign;
+        Sign sign_y = signs[2 * row + 1] ^ cofactor_v->sign;
+        accumulator[row] = (GcdAccumulator){ 0, 0, 0, sign_x != sign_y };
+        result_sign[row] = sign_x;
+    }
+
+    /* Both rows in one pass, reading u and v before overwriting them */
+    for (size_t idx = 0; idx < digit_num + 2; idx++) {
+        Word word_u = idx < cofactor_u->digit_num ? cofactor_u->digits[idx] : 0;
+        Word word_v = idx < cofactor_v->digit_num ? cofactor_v->digits[idx] : 0;
+        cofactor_u->digits[idx] = gcd_accumulate(&accumulator[0], entries[0], word_u, entries[1], word_v);
+        cofactor_v->digits[idx] = gcd_accumulate(&accumulator[1], entries[2], word_u, entries[3], word_v);
+    }
+
+    GcdCofactor* cofactors[2] = { cofactor_u, cofactor_v };
+    for (size_t row = 0; row < 2; row++)
+    {
+        GcdCofactor* cofactor = cofactors[row];
+
+        /* Negative difference: two's complement back to a magnitude */
+        if (accumulator[row].subtract == true && accumulator[row].carry != 0) {
+            Word carry = 1;
+            for (size_t idx = 0; idx < digit_num + 2; idx++) {
+                cofactor->digits[idx] = (Word)~cofactor->digits[idx] + carry;
+                carry = (carry == 1 && cofactor->digits[idx] == 0);
+            }
+            result_sign[row] ^= 1;
+        }
+
+        cofactor->digit_num = words_trim(cofactor->digits, digit_num + 2);
+        cofactor->sign = cofactor->digit_num != 0 ? result_sign[row] : POSITIVE;
+    }
+}
+
+/**
+ * @brief Swaps the two remainders and their cofactor rows.
+ *
+ * @param state [in, out] GCD state.
+ */
+static void gcd_state_swap(GcdState* state)
+{
+    Word* tmp_digits = state->a;
+    size_t tmp_num = state->a_num;
+    state->a = state->b;
+    state->a_num = state->b_num;
+    state->b = tmp_digits;
+    state->b_num = tmp_num;
+
+    for (size_t column = 0; column < state->column_num; column++) {
+        GcdCofactor tmp_row = state->u[column];
+        state->u[column] = state->v[column];
+        state->v[column] = tmp_row;
+    }
+}
+
+/**
+ * @brief Initializes a GCD state with the pair (X, Y) and identity cofactor rows.
+ *
+ * @param state [out] GCD state.
+ * @param operand_x [in] First operand.
+ * @param digit_num_x [in] Number of words of the first operand.
+ * @param operand_y [in] Second operand.
+ * @param digit_num_y [in] Number of words of the second operand.
+ * @param column_num [in] Number of cofactor columns to track, 0 to 2.
+ */
+static void gcd_state_new(GcdState* state, const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y, size_t column_num)
+{
+    digit_num_x = words_trim(operand_x, digit_num_x);
+    digit_num_y = words_trim(operand_y, digit_num_y);
+    size_t capacity = (digit_num_x > digit_num_y ? digit_num_x : digit_num_y) + 1;
+
+    /* Allocate buffers */
+    state->a = (Word*)bigint_calloc(capacity, SIZE_OF_WORD);
+    state->b = (Word*)bigint_calloc(capacity, SIZE_OF_WORD);
+    state->spare = (Word*)bigint_calloc(capacity, SIZE_OF_WORD);
+    state->scratch = (Word*)bigint_malloc(words_division_scratch_size(capacity, capacity) * SIZE_OF_WORD);
+    memcpy(state->a, operand_x, digit_num_x * SIZE_OF_WORD);
+    memcpy(state->b, operand_y, digit_num_y * SIZE_OF_WORD);
+    state->a_num = digit_num_x;
+    state->b_num = digit_num_y;
+    state->column_num = column_num;
+    state->step_num = 0;
+
+    /* Identity rows: a = X, b = Y */
+    for (size_t column = 0; column < column_num; column++) {
+        gcd_cofactor_new(&state->u[column], capacity + 2, column == 0);
+        gcd_cofactor_new(&state->v[column], capacity + 2, column == 1);
+    }
+
+    /* Keep a >= b */
+    if (words_compare(state->a, state->a_num, state->b, state->b_num) == LEFT_IS_SMALL)
+        gcd_state_swap(state);
+}
+
+/**
+ * @brief Deallocates the buffers and rows of a GCD state.
+ *
+ * @param state [in, out] GCD state.
+ */
+static void gcd_state_delete(GcdState* state)
+{
+    bigint_free(state->a);
+    bigint_free(state->b);
+    bigint_free(state->spare);
+    bigint_free(state->scratch);
+
+    for (size_t column = 0; column < state->column_num; column++) {
+        bigint_free(state->u[column].digits);
+        bigint_free(state->v[column].digits);
+    }
+}
+
+/**
+ * @brief Views an array as a non-negative Bigint without copying.
+ *
+ * @param view [out] Bigint view.
+ * @param digits [in] Array of words.
+ * @param digit_num [in] Number of significant words, zero for the value zero.
+ */
+static void gcd_view(Bigint* view, Word* digits, size_t digit_num)
+{
+    static Word zero_digit = 0;
+
+    view->sign = POSITIVE;
+    view->digit_num = digit_num != 0 ? digit_num : 1;
+    view->digits = digit_num != 0 ? digits : &zero_digit;
+}
+
+/**
+ * @brief Negates a Bigint in place, zero stays positive.
+ *
+ * @param bigint [in, out] Bigint.
+ */
+static void gcd_negate(Bigint* bigint)
+{
+    if (bigint_is_zero(bigint) == FALSE)
+        bigint->sign = bigint->sign == POSITIVE ? NEGATIVE : POSITIVE;
+}
+
+/**
+ * @brief Computes result = M0 * X + M1 * Y on signed Bigints.
+ *
+ * @param result [out] Pointer to the resulting Bigint.
+ * @param multiplier_x [in] Multiplier of X.
+ * @param operand_x [in] First operand.
+ * @param multiplier_y [in] Multiplier of Y.
+ * @param operand_y [in] Second operand.
+ */
+static void gcd_combination(Bigint** result, const Bigint* multiplier_x, const Bigint* operand_x, const Bigint* multiplier_y, const Bigint* operand_y)
+{
+    Bigint* product_x = NULL;
+    Bigint* product_y = NULL;
+
+    words_multiplication_bigint(&product_x, multiplier_x, operand_x);
+    words_multiplication_bigint(&product_y, multiplier_y, operand_y);
+    bigint_addition(result, product_x, product_y);
+
+    bigint_delete(&product_x);
+    bigint_delete(&product_y);
+}
+
+/**
+ * @brief Updates the cofactor rows with a 2x2 matrix: (u, v) <- (M00 u + M01 v, M10 u + M11 v).
+ *
+ * @param state [in, out] GCD state.
+ * @param matrix [in] Matrix entries M00, M01, M10, M11.
+ */
+static void gcd_rows_apply(GcdState* state, const Bigint* const matrix[4])
+{
+    for (size_t column = 0; column < state->column_num; column++)
+    {
+        Bigint view_u, view_v;
+        Bigint* new_u = NULL;
+        Bigint* new_v = NULL;
+
+        gcd_cofactor_view(&view_u, &state->u[column]);
+        gcd_cofactor_view(&view_v, &state->v[column]);
+        gcd_combination(&new_u, matrix[0], &view_u, matrix[1], &view_v);
+        gcd_combination(&new_v, matrix[2], &view_u, matrix[3], &view_v);
+        gcd_cofactor_set(&state->u[column], new_u);
+        gcd_cofactor_set(&state->v[column], new_v);
+
+        bigint_delete(&new_u);
+        bigint_delete(&new_v);
+    }
+}
+
+/**
+ * @brief Performs one Euclid division step: (a, b) <- (b, a mod b) and (u, v) <- (v, u - q v).
+ *
+ * @param state [in, out] GCD state with b non-zero.
+ */
+static void gcd_division_step(GcdState* state)
+{
+    Bigint* quotient = NULL;
+    Word* remainder = state->spare;
+
+    /* q = a / b, the quotient is only needed for the cofactors */
+    if (state->column_num > 0)
+        bigint_new(&quotient, state->a_num - state->b_num + 1);
+    words_division(quotient != NULL ? quotient->digits : NULL, remainder, state->a, state->a_num, state->b, state->b_num, state->scratch);
+
+    /* (a, b) <- (b, a mod b) */
+    state->spare = state->a;
+    state->a = state->b;
+    state->a_num = state->b_num;
+    state->b = remainder;
+    state->b_num = words_trim(remainder, state->a_num);
+
+    /* (u, v) <- (v, u - q v) */
+    if (quotient != NULL)
+        bigint_refine(quotient);
+    for (size_t column = 0; column < state->column_num; column++)
+    {
+        Bigint view_u, view_v;
+        Bigint* product = NULL;
+        Bigint* new_v = NULL;
+
+        gcd_cofactor_view(&view_u, &state->u[column]);
+        gcd_cofactor_view(&view_v, &state->v[column]);
+        words_multiplication_bigint(&product, quotient, &view_v);
+        bigint_subtraction(&new_v, &view_u, product);
+
+        GcdCofactor tmp_row = state->u[column];
+        state->u[column] = state->v[column];
+        state->v[column] = tmp_row;
+        gcd_cofactor_set(&state->v[column], new_v);
+
+        bigint_delete(&product);
+        bigint_delete(&new_v);
+    }
+
+    bigint_delete(&quotient);
+    state->step_num++;
+}
+
+/**
+ * @brief Returns the bits [shift, shift + LEHMER_PRECISION) of an array.
+ *
+ * @param digits [in] Array of words.
+ * @param digit_num [in] Number of significant words.
+ * @param shift [in] Index of the lowest bit.
+ * @return LehmerWord Leading part.
+ */
+static LehmerWord gcd_leading_part(const Word* digits, size_t digit_num, size_t shift)
+{
+    LehmerWord value = 0;
+
+    for (size_t idx = shift / BITLEN_OF_WORD; idx < digit_num; idx++) {
+        size_t position = idx * BITLEN_OF_WORD;
+        if (position < shift)
+            value |= (LehmerWord)(digits[idx] >> (shift - position));
+        else
+            value |= (LehmerWord)digits[idx] << (position - shift);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Runs Euclid on the leading parts of a and b as long as the quotients are provably those of a and b.
+ *
+ * Knuth's Lehmer condition: the quotient is accepted only if both ends of the interval give the same value.
+ * With two-word leading parts the cofactors grow to a full word before the condition fails.
+ *
+ * @param matrix [out] Lehmer matrix of the accepted steps.
+ * @param state [in] GCD state with a >= b > 0.
+ * @return bool True if at least one step was accepted.
+ */
+static bool gcd_lehmer_matrix(LehmerMatrix* matrix, const GcdState* state)
+{
+    const LehmerWord cofactor_max = (Word)(-1);
+    size_t bit_length = (state->a_num - 1) * BITLEN_OF_WORD + word_bit_length(state->a[state->a_num - 1]);
+    size_t shift = bit_length > LEHMER_PRECISION ? bit_length - LEHMER_PRECISION : 0;
+
+    LehmerWord high_a = gcd_leading_part(state->a, state->a_num, shift);
+    LehmerWord high_b = gcd_leading_part(state->b, state->b_num, shift);
+    LehmerWord matrix_a = 1, matrix_b = 0, matrix_c = 0, matrix_d = 1;
+    bool odd = false;
+    size_t step_num = 0;
+
+    while (true)
+    {
+        LehmerWord numerator_1, denominator_1, numerator_2, denominator_2;
+
+        /* Interval of the quotient, signs alternate with the parity */
+        if (odd == false) {
+            if (high_b <= matrix_c || high_a < matrix_b)
+                break;
+            numerator_1 = high_a + matrix_a;
+            denominator_1 = high_b - matrix_c;
+            numerator_2 = high_a - matrix_b;
+            denominator_2 = high_b + matrix_d;
+        }
+        else {
+            if (high_b <= matrix_d || high_a < matrix_a)
+                break;
+            numerator_1 = high_a - matrix_a;
+            denominator_1 = high_b + matrix_c;
+            numerator_2 = high_a + matrix_b;
+            denominator_2 = high_b - matrix_d;
+        }
+
+        /* Both ends must give the same quotient */
+        LehmerWord quotient = numerator_1 / denominator_1;
+        if (quotient != numerator_2 / denominator_2 || quotient > high_a / high_b)
+            break;
+
+        /* New cofactors must fit in a word */
+        if (matrix_c != 0 && quotient > (cofactor_max - matrix_a) / matrix_c)
+            break;
+        if (matrix_d != 0 && quotient > (cofactor_max - matrix_b) / matrix_d)
+            break;
+
+        /* One Euclid step on the leading parts */
+        LehmerWord next_c = matrix_a + quotient * matrix_c;
+        LehmerWord next_d = matrix_b + quotient * matrix_d;
+        LehmerWord next_b = high_a - quotient * high_b;
+        matrix_a = matrix_c;
+        matrix_b = matrix_d;
+        matrix_c = next_c;
+        matrix_d = next_d;
+        high_a = high_b;
+        high_b = next_b;
+        odd = !odd;
+        step_num++;
+    }
+
+    matrix->a = (Word)matrix_a;
+    matrix->b = (Word)matrix_b;
+    matrix->c = (Word)matrix_c;
+    matrix->d = (Word)matrix_d;
+    matrix->odd = odd;
+
+    return step_num > 0;
+}
+
+/**
+ * @brief Performs one Lehmer step, or one division step if the leading parts give no quotient.
+ *
+ * @param state [in, out] GCD state with a >= b > 0.
+ */
+static void gcd_lehmer_step(GcdState* state)
+{
+    LehmerMatrix matrix;
+
+    /* Huge quotient or short b: plain division */
+    if (gcd_lehmer_matrix(&matrix, state) == false) {
+        gcd_division_step(state);
+        return;
+    }
+
+    GcdAccumulator accumulator_a = { 0, 0, 0, true };
+    GcdAccumulator accumulator_b = { 0, 0, 0, true };
+
+    /* Even: a' = Aa - Bb, b' = Db - Ca. Odd: a' = Bb - Aa, b' = Ca - Db. Both are exact and non-negative */
+    for (size_t idx = 0; idx < state->a_num; idx++)
+    {
+        Word word_a = state->a[idx];
+        Word word_b = idx < state->b_num ? state->b[idx] : 0;
+
+        if (matrix.odd == false) {
+            state->a[idx] = gcd_accumulate(&accumulator_a, matrix.a, word_a, matrix.b, word_b);
+            state->b[idx] = gcd_accumulate(&accumulator_b, matrix.d, word_b, matrix.c, word_a);
+        }
+        else {
+            state->a[idx] = gcd_accumulate(&accumulator_a, matrix.b, word_b, matrix.a, word_a);
+            state->b[idx] = gcd_accumulate(&accumulator_b, matrix.c, word_a, matrix.d, word_b);
+        }
+    }
+    state->b_num = words_trim(state->b, state->a_num);
+    state->a_num = words_trim(state->a, state->a_num);
+
+    /* Same matrix on the cofactor rows: (+A -B; -C +D), all signs flipped if odd */
+    Word entries[4] = { matrix.a, matrix.b, matrix.c, matrix.d };
+    Sign positive = matrix.odd ? NEGATIVE : POSITIVE;
+    Sign negative = matrix.odd ? POSITIVE : NEGATIVE;
+    Sign signs[4] = { positive, negative, negative, positive };
+    for (size_t column = 0; column < state->column_num; column++)
+        gcd_cofactor_lehmer(&state->u[column], &state->v[column], entries, signs);
+
+    state->step_num++;
+}
+
+static void gcd_half(GcdState* state);
+
+/**
+ * @brief Reduces the top part of (a, b) recursively and applies the resulting matrix to the full pair.
+ *
+ * The matrix found on the top words is unimodular, so it keeps the GCD and the cofactor relation
+ * whatever the low words are. It is only kept if it makes the pair smaller.
+ *
+ * @param state [in, out] GCD state with a >= b.
+ * @param shift_num [in] Number of low words left out of the recursion.
+ */
+static void gcd_half_top(GcdState* state, size_t shift_num)
+{
+    /* The top part of b must be worth reducing */
+    if (state->b_num <= shift_num + 2)
+        return;
+
+    GcdState top;
+    gcd_state_new(&top, state->a + shift_num, state->a_num - shift_num, state->b + shift_num, state->b_num - shift_num, 2);
+    gcd_half(&top);
+
+    /* Nothing accepted on the top part */
+    if (top.step_num == 0) {
+        gcd_state_delete(&top);
+        return;
+    }
+
+    Bigint view_a, view_b;
+    Bigint entries[4];
+    Bigint* new_a = NULL;
+    Bigint* new_b = NULL;
+    gcd_view(&view_a, state->a, state->a_num);
+    gcd_view(&view_b, state->b, state->b_num);
+    gcd_cofactor_view(&entries[0], &top.u[0]);
+    gcd_cofactor_view(&entries[1], &top.u[1]);
+    gcd_cofactor_view(&entries[2], &top.v[0]);
+    gcd_cofactor_view(&entries[3], &top.v[1]);
+
+    /* (a', b') = M (a, b) */
+    gcd_combination(&new_a, &entries[0], &view_a, &entries[1], &view_b);
+    gcd_combination(&new_b, &entries[2], &view_a, &entries[3], &view_b);
+
+    /* Negative rows are negated, M stays unimodular */
+    if (new_a->sign == NEGATIVE) {
+        gcd_negate(new_a);
+        gcd_negate(&entries[0]);
+        gcd_negate(&entries[1]);
+    }
+    if (new_b->sign == NEGATIVE) {
+        gcd_negate(new_b);
+        gcd_negate(&entries[2]);
+        gcd_negate(&entries[3]);
+    }
+
+    /* Keep the matrix only if the larger value decreased */
+    const Bigint* larger = bigint_compare_abs(new_a, new_b) == LEFT_IS_SMALL ? new_b : new_a;
+    if (bigint_compare_abs(larger, &view_a) == LEFT_IS_SMALL)
+    {
+        const Bigint* matrix[4] = { &entries[0], &entries[1], &entries[2], &entries[3] };
+
+        gcd_rows_apply(state, matrix);
+        state->a_num = words_trim(new_a->digits, new_a->digit_num);
+        state->b_num = words_trim(new_b->digits, new_b->digit_num);
+        memcpy(state->a, new_a->digits, state->a_num * SIZE_OF_WORD);
+        memcpy(state->b, new_b->digits, state->b_num * SIZE_OF_WORD);
+        if (words_compare(state->a, state->a_num, state->b, state->b_num) == LEFT_IS_SMALL)
+            gcd_state_swap(state);
+        state->step_num += top.step_num;
+    }
+
+    bigint_delete(&new_a);
+    bigint_delete(&new_b);
+    gcd_state_delete(&top);
+}
+
+/**
+ * @brief Half-GCD: reduces a pair of n words until b has about n/2 words.
+ *
+ * Two recursive calls on top parts take the pair from n to about 3n/4, then to n/2 words,
+ * so the cost is that of a few multiplications of the operand size instead of n Lehmer steps.
+ * Lehmer steps finish whatever the recursion left.
+ *
+ * @param state [in, out] GCD state with a >= b.
+ */
+static void gcd_half(GcdState* state)
+{
+    size_t digit_num = state->a_num;
+    size_t stop_num = digit_num / 2 + 1;
+
+    if (digit_num >= GCD_HALF_THRESHOLD)
+    {
+        /* Top half: n -> about 3n/4 */
+        gcd_half_top(state, digit_num / 2);
+
+        /* Top part of what is left above the stop: about 3n/4 -> n/2 */
+        if (state->b_num > stop_num) {
+            size_t top_num = 2 * (state->a_num - stop_num) + 2;
+            if (state->a_num > top_num)
+                gcd_half_top(state, state->a_num - top_num);
+        }
+    }
+
+    /* Finish with Lehmer steps */
+    while (state->b_num > stop_num)
+        gcd_lehmer_step(state);
+}
+
+/**
+ * @brief Reduces (a, b) until b has at most stop_num words.
+ *
+ * @param state [in, out] GCD state with a >= b.
+ * @param stop_num [in] Number of words of b to stop at, 0 to reach b = 0.
+ */
+static void gcd_reduce(GcdState* state, size_t stop_num)
+{
+    while (state->b_num > stop_num)
+    {
+        if (state->a_num - state->b_num >= 2)
+            gcd_division_step(state); // unbalanced: one big quotient
+        else if (state->b_num >= GCD_HALF_THRESHOLD)
+            gcd_half(state);
+        else
+            gcd_lehmer_step(state);
+    }
+}
+
+/**
+ * @brief Computes the GCD of two words by the binary algorithm.
+ *
+ * @param operand_x [in] First word.
+ * @param operand_y [in] Second word.
+ * @return Word GCD, the other word if one is zero.
+ */
+static Word gcd_word(Word operand_x, Word operand_y)
+{
+    Word shift = 0;
+
+    if (operand_x == 0 || operand_y == 0)
+        return operand_x | operand_y;
+
+    /* Common power of two */
+    while (((operand_x | operand_y) & 1) == 0) {
+        operand_x >>= 1;
+        operand_y >>= 1;
+        shift++;
+    }
+    while ((operand_x & 1) == 0)
+        operand_x >>= 1;
+
+    /* x stays odd, y <- |y - x| with its powers of two removed */
+    while (operand_y != 0) {
+        while ((operand_y & 1) == 0)
+            operand_y >>= 1;
+        if (operand_x > operand_y) {
+            Word tmp = operand_x;
+            operand_x = operand_y;
+            operand_y = tmp;
+        }
+        operand_y -= operand_x;
+    }
+
+    return (Word)(operand_x << shift);
+}
+
+/**
+ * @brief Returns the number of trailing zero bits of a non-zero array.
+ *
+ * @param digits [in] Array of words, not zero.
+ * @return size_t Number of trailing zero bits.
+ */
+static size_t gcd_trailing_zeros(const Word* digits)
+{
+    size_t zero_num = 0;
+    size_t idx = 0;
+
+    while (digits[idx] == 0) {
+        zero_num += BITLEN_OF_WORD;
+        idx++;
+    }
+    for (Word word = digits[idx]; (word & 1) == 0; word >>= 1)
+        zero_num++;
+
+    return zero_num;
+}
+
+/**
+ * @brief Shifts an array right in place.
+ *
+ * @param digits [in, out] Array of words.
+ * @param digit_num [in, out] Number of significant words, updated.
+ * @param bit_num [in] Number of bits to shift.
+ */
+static void gcd_shift_right(Word* digits, size_t* digit_num, size_t bit_num)
+{
+    size_t word_shift = bit_num / BITLEN_OF_WORD;
+    Word bit_shift = (Word)(bit_num % BITLEN_OF_WORD);
+    size_t new_num = *digit_num - word_shift;
+
+    for (size_t idx = 0; idx < new_num; idx++) {
+        Word upper = idx + word_shift + 1 < *digit_num ? digits[idx + word_shift + 1] : 0;
+        digits[idx] = (digits[idx + word_shift] >> bit_shift) | (bit_shift != 0 ? (Word)(upper << (BITLEN_OF_WORD - bit_shift)) : 0);
+    }
+
+    *digit_num = words_trim(digits, new_num);
+}
+
+/**
+ * @brief Computes the GCD of two non-zero arrays by the binary (Stein) algorithm.
+ *
+ * @param result [out] Pointer to the resulting Bigint.
+ * @param operand_x [in, out] First operand, destroyed.
+ * @param digit_num_x [in] Number of words of the first operand.
+ * @param operand_y [in, out] Second operand, destroyed.
+ * @param digit_num_y [in] Number of words of the second operand.
+ */
+static void gcd_binary(Bigint** result, Word* operand_x, size_t digit_num_x, Word* operand_y, size_t digit_num_y)
+{
+    /* Common power of two */
+    size_t zeros_x = gcd_trailing_zeros(operand_x);
+    size_t zeros_y = gcd_trailing_zeros(operand_y);
+    size_t shift = zeros_x < zeros_y ? zeros_x : zeros_y;
+    gcd_shift_right(operand_x, &digit_num_x, zeros_x);
+
+    /* x stays odd, y <- |y - x| with its powers of two removed */
+    while (digit_num_y != 0)
+    {
+        gcd_shift_right(operand_y, &digit_num_y, gcd_trailing_zeros(operand_y));
+
+        if (words_compare(operand_x, digit_num_x, operand_y, digit_num_y) == LEFT_IS_BIG) {
+            Word* tmp_digits = operand_x;
+            size_t tmp_num = digit_num_x;
+            operand_x = operand_y;
+            digit_num_x = digit_num_y;
+            operand_y = tmp_digits;
+            digit_num_y = tmp_num;
+        }
+
+        words_subtraction(operand_y, operand_y, digit_num_y, operand_x, digit_num_x);
+        digit_num_y = words_trim(operand_y, digit_num_y);
+    }
+
+    /* Result <- x * 2^shift */
+    size_t word_shift = shift / BITLEN_OF_WORD;
+    Word bit_shift = (Word)(shift % BITLEN_OF_WORD);
+    bigint_new(result, digit_num_x + word_shift + 1);
+    for (size_t idx = 0; idx < digit_num_x; idx++) {
+        (*result)->digits[idx + word_shift] |= (Word)(operand_x[idx] << bit_shift);
+        if (bit_shift != 0)
+            (*result)->digits[idx + word_shift + 1] = operand_x[idx] >> (BITLEN_OF_WORD - bit_shift);
+    }
+    bigint_refine(*result);
+}
+
+/**
+ * @brief Computes the greatest common divisor of two Bigints.
+ *
+ * Binary GCD for operands of a few words, Lehmer's algorithm on two-word leading parts above that,
+ * and the half-GCD recursion from GCD_HALF_THRESHOLD words.
+ *
+ * @param result [out] Pointer to the non-negative GCD, gcd(0, 0) = 0.
+ * @param operand_x [in] First operand.
+ * @param operand_y [in] Second operand.
+ */
+void bigint_gcd(Bigint** result, const Bigint* operand_x, const Bigint* operand_y)
+{
+    PROFILE_SCOPE(PROFILE_GCD, operand_x->digit_num + operand_y->digit_num);
+
+    /* gcd(x, 0) = |x| */
+    if (bigint_is_zero(operand_x) == TRUE || bigint_is_zero(operand_y) == TRUE) {
+        bigint_copy(result, bigint_is_zero(operand_x) == TRUE ? operand_y : operand_x);
+        (*result)->sign = POSITIVE;
+        return;
+    }
+
+    /* Small operands: binary GCD */
+    if (operand_x->digit_num <= GCD_BINARY_THRESHOLD && operand_y->digit_num <= GCD_BINARY_THRESHOLD) {
+        Word digits_x[GCD_BINARY_THRESHOLD];
+        Word digits_y[GCD_BINARY_THRESHOLD];
+        memcpy(digits_x, operand_x->digits, operand_x->digit_num * SIZE_OF_WORD);
+        memcpy(digits_y, operand_y->digits, operand_y->digit_num * SIZE_OF_WORD);
+        gcd_binary(result, digits_x, operand_x->digit_num, digits_y, operand_y->digit_num);
+        return;
+    }
+
+    GcdState state;
+    gcd_state_new(&state, operand_x->digits, operand_x->digit_num, operand_y->digits, operand_y->digit_num, 0);
+
+    /* Reduce until b fits in one word */
+    gcd_reduce(&state, 1);
+
+    /* gcd(a, b) = gcd(b, a mod b) on words */
+    if (state.b_num == 0)
+        bigint_set_by_array(result, state.a, POSITIVE, state.a_num);
+    else {
+        Word remainder = 0;
+        words_division(NULL, &remainder, state.a, state.a_num, state.b, 1, state.scratch);
+        Word gcd = gcd_word(state.b[0], remainder);
+        bigint_set_by_array(result, &gcd, POSITIVE, 1);
+    }
+
+    gcd_state_delete(&state);
+}
+
+/**
+ * @brief Computes the GCD g and cofactors s, t with g = s * X + t * Y.
+ *
+ * The cofactors are the smallest ones: |s| <= |Y| / (2g) and |t| <= |X| / (2g), unless Y divides X
+ * or one operand is zero.
+ *
+ * @param gcd [out] Pointer to the non-negative GCD.
+ * @param coefficient_x [out] Pointer to s.
+ * @param coefficient_y [out] Pointer to t.
+ * @param operand_x [in] First operand X.
+ * @param operand_y [in] Second operand Y.
+ */
+void bigint_gcdext(Bigint** gcd, Bigint** coefficient_x, Bigint** coefficient_y, const Bigint* operand_x, const Bigint* operand_y)
+{
+    PROFILE_SCOPE(PROFILE_GCDEXT, operand_x->digit_num + operand_y->digit_num);
+
+    /* gcd(x, 0) = |x| = sign(x) * x */
+    if (bigint_is_zero(operand_y) == TRUE) {
+        bigint_copy(gcd, operand_x);
+        (*gcd)->sign = POSITIVE;
+        if (bigint_is_zero(operand_x) == TRUE)
+            bigint_set_zero(coefficient_x);
+        else {
+            bigint_set_one(coefficient_x);
+            (*coefficient_x)->sign = operand_x->sign;
+        }
+        bigint_set_zero(coefficient_y);
+        return;
+    }
+
+    Bigint* tmp_gcd = NULL;
+    Bigint* cofactor = NULL;
+    Bigint* quotient = NULL;
+    Bigint* numerator = NULL;
+    Bigint view_x, view_y;
+
+    /* Track the cofactor of |X| only */
+    GcdState state;
+    gcd_state_new(&state, operand_x->digits, operand_x->digit_num, operand_y->digits, operand_y->digit_num, 1);
+    gcd_reduce(&state, 0);
+    bigint_set_by_array(&tmp_gcd, state.a, POSITIVE, state.a_num);
+    bigint_refine(tmp_gcd);
+
+    /* s <- s mod (|Y| / g), then the one of least absolute value */
+    gcd_view(&view_x, operand_x->digits, words_trim(operand_x->digits, operand_x->digit_num));
+    gcd_view(&view_y, operand_y->digits, words_trim(operand_y->digits, operand_y->digit_num));
+    words_division_bigint(&quotient, NULL, &view_y, tmp_gcd);
+    Bigint view_u;
+    gcd_cofactor_view(&view_u, &state.u[0]);
+    words_division_bigint(NULL, &cofactor, &view_u, quotient);
+    if (view_u.sign == NEGATIVE && bigint_is_zero(cofactor) == FALSE)
+        bigint_subtraction(&cofactor, quotient, cofactor);
+    bigint_expand_one_bit(&numerator, cofactor);
+    if (bigint_compare_abs(numerator, quotient) == LEFT_IS_BIG)
+        bigint_subtraction(&cofactor, cofactor, quotient);
+
+    /* t <- (g - s|X|) / |Y|, exact */
+    words_multiplication_bigint(&numerator, cofactor, &view_x);
+    bigint_subtraction(&numerator, tmp_gcd, numerator);
+    Sign numerator_sign = numerator->sign;
+    numerator->sign = POSITIVE;
+    words_division_bigint(coefficient_y, NULL, numerator, &view_y);
+    if (numerator_sign == NEGATIVE)
+        gcd_negate(*coefficient_y);
+
+    /* Signs of the operands */
+    if (operand_x->sign == NEGATIVE)
+        gcd_negate(cofactor);
+    if (operand_y->sign == NEGATIVE)
+        gcd_negate(*coefficient_y);
+
+    /* Get results */
+    bigint_copy(gcd, tmp_gcd);
+    bigint_copy(coefficient_x, cofactor);
+
+    /* Free memory */
+    gcd_state_delete(&state);
+    bigint_delete(&tmp_gcd);
+    bigint_delete(&cofactor);
+    bigint_delete(&quotient);
+    bigint_delete(&numerator);
+}
+
+/**
+ * @brief Computes the modular inverse: result = X^(-1) mod N.
+ *
+ * @param result [out] Pointer to the inverse in [0, N), zero if there is none.
+ * @param operand [in] Operand X, may be negative or larger than N.
+ * @param modular [in] Positive modulus N.
+ * @return bool True if gcd(X, N) = 1 and the inverse exists.
+ */
+bool bigint_mod_inverse(Bigint** result, const Bigint* operand, const Bigint* modular)
+{
+    PROFILE_SCOPE(PROFILE_MOD_INVERSE, operand->digit_num + modular->digit_num);
+
+    /* Invalid case: modulus must be positive */
+    if (modular->sign == NEGATIVE || bigint_is_zero(modular) == TRUE) {
+        printf("Invalid Case: Modulus must be positive.\n");
+        return false;
+    }
+
+    Bigint* reduced = NULL;
+    Bigint* inverse = NULL;
+    Bigint view;
+    bool invertible = false;
+
+    /* X mod N in [0, N) */
+    gcd_view(&view, operand->digits, words_trim(operand->digits, operand->digit_num));
+    words_division_bigint(NULL, &reduced, &view, modular);
+    if (operand->sign == NEGATIVE && bigint_is_zero(reduced) == FALSE)
+        bigint_subtraction(&reduced, modular, reduced);
+
+    /* Track the cofactor of X mod N: g = u * X mod N */
+    GcdState state;
+    gcd_state_new(&state, reduced->digits, reduced->digit_num, modular->digits, modular->digit_num, 1);
+    gcd_reduce(&state, 0);
+
+    /* Invertible only if g = 1 */
+    if (state.a_num == 1 && state.a[0] == 1) {
+        Bigint cofactor;
+        gcd_cofactor_view(&cofactor, &state.u[0]);
+        words_division_bigint(NULL, &inverse, &cofactor, modular);
+        if (cofactor.sign == NEGATIVE && bigint_is_zero(inverse) == FALSE)
+            bigint_subtraction(&inverse, modular, inverse);
+        invertible = true;
+    }
+    else
+        bigint_set_zero(&inverse);
+
+    /* Get result */
+    bigint_copy(result, inverse);
+
+    /* Free memory */
+    gcd_state_delete(&state);
+    bigint_delete(&reduced);
+    bigint_delete(&inverse);
+
+    return invertible;
+}
+
+/**
+ * @brief Checks whether a fixed-width value is coprime to a divisor of the modulus.
+ *
+ * @param digits [in] Value of n words.
+ * @param digit_num [in] Number of words n.
+ * @param divisor [in] Positive divisor.
+ * @return bool True if gcd(value, divisor) = 1.
+ */
+static bool gcd_is_coprime(Word* digits, size_t digit_num, const Bigint* divisor)
+{
+    Bigint view;
+    Bigint* gcd = NULL;
+
+    gcd_view(&view, digits, words_trim(digits, digit_num));
+    bigint_gcd(&gcd, &view, divisor);
+    bool is_coprime = (gcd->digit_num == 1 && gcd->digits[0] == 1);
+
+    bigint_delete(&gcd);
+    return is_coprime;
+}
+
+/**
+ * @brief Computes the running Montgomery products P_i = P_(i-1) * X_i * R^(-1) mod N.
+ *
+ * @param prefixes [out] Running products, n words each.
+ * @param values [in] Reduced operands, n words each.
+ * @param count [in] Number of operands.
+ * @param context [in] Modular context.
+ * @param scratch [in] Scratch of words_montgomery_scratch_size(n) words.
+ */
+static void gcd_batch_prefix(Word* prefixes, const Word* values, size_t count, const ModularContext* context, Word* scratch)
+{
+    size_t width = context->digit_num;
+
+    memcpy(prefixes, values, width * SIZE_OF_WORD);
+    for (size_t idx = 1; idx < count; idx++)
+        words_montgomery_multiplication(prefixes + idx * width, prefixes + (idx - 1) * width, values + idx * width, context, scratch);
+}
+
+/**
+ * @brief Inverts the last running product.
+ *
+ * @param inverse [out] Inverse of n words.
+ * @param last [in] Last running product of n words.
+ * @param context [in] Modular context.
+ * @return bool True if the product is invertible.
+ */
+static bool gcd_batch_invert(Word* inverse, Word* last, const ModularContext* context)
+{
+    Bigint view;
+    Bigint* tmp_inverse = NULL;
+
+    gcd_view(&view, last, words_trim(last, context->digit_num));
+    bool is_invertible = bigint_mod_inverse(&tmp_inverse, &view, context->modular);
+    memcpy(inverse, tmp_inverse->digits, tmp_inverse->digit_num * SIZE_OF_WORD);
+
+    bigint_delete(&tmp_inverse);
+    return is_invertible;
+}
+
+/**
+ * @brief Computes many modular inverses modulo the same N with Montgomery's trick.
+ *
+ * The operands are used as they are in the Montgomery domain, so the running products need no conversion:
+ * the inverse of the last product, taken once, yields every X_i^(-1) mod N with 3(count - 1) Montgomery
+ * multiplications. If the product is not invertible, every non-invertible operand shares a prime with
+ * d = gcd(product, N), so one pass of gcd(X_i, d) finds them all. They are reported and replaced by
+ * R mod N, which is neutral, before the products are taken again.
+ *
+ * @param results [out] Array of count pointers, each inverse in [0, N), zero if there is none.
+ * @param invertible [out] Array of count flags, true if the operand is invertible.
+ * @param operands [in] Array of count operands, may be negative or larger than N.
+ * @param count [in] Number of operands.
+ * @param context [in] Modular context of an odd modulus.
+ * @return size_t Number of invertible operands.
+ */
+size_t bigint_mod_inverse_batch(Bigint** results, bool* invertible, Bigint* const* operands, size_t count, const ModularContext* context)
+{
+    PROFILE_SCOPE(PROFILE_MOD_INVERSE_BATCH, 0);
+
+    /* Invalid context */
+    if (context == NULL) {
+        printf("Invalid Case: Modular context is not initialized.\n");
+        return 0;
+    }
+
+    if (count == 0)
+        return 0;
+
+    /* One buffer: reduced operands, running products, inverse, product and Montgomery scratch */
+    size_t width = context->digit_num;
+    size_t buffer_size = 2 * count * width + 2 * width + words_montgomery_scratch_size(context->digit_num);
+    Word* buffer = (Word*)bigint_calloc(buffer_size, SIZE_OF_WORD);
+    Word* values = buffer;
+    Word* prefixes = values + count * width;
+    Word* inverse = prefixes + count * width;
+    Word* product = inverse + width;
+    Word* scratch = product + width;
+    Word* last = prefixes + (count - 1) * width;
+    size_t invertible_num = count;
+
+    /* X mod N in [0, N), zero is replaced by the neutral R mod N */
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        Word* value = values + idx * width;
+        Bigint magnitude = *operands[idx];
+
+        magnitude.sign = POSITIVE;
+        words_reduce_operand(value, &magnitude, context);
+        invertible[idx] = (words_trim(value, context->digit_num) != 0);
+
+        if (invertible[idx] == false) {
+            memcpy(value, context->one, width * SIZE_OF_WORD);
+            invertible_num--;
+        }
+        else if (operands[idx]->sign == NEGATIVE)
+            words_subtraction(value, context->modular->digits, context->digit_num, value, context->digit_num); // N - (|X| mod N)
+    }
+
+    /* Running products and the one real inversion */
+    gcd_batch_prefix(prefixes, values, count, context, scratch);
+    if (gcd_batch_invert(inverse, last, context) == false)
+    {
+        Bigint view;
+        Bigint* common = NULL; // d = gcd(product, N), R is coprime to N
+
+        gcd_view(&view, last, words_trim(last, context->digit_num));
+        bigint_gcd(&common, &view, context->modular);
+
+        /* Every prime shared by an operand and N divides d */
+        for (size_t idx = 0; idx < count; idx++) {
+            if (invertible[idx] == true && gcd_is_coprime(values + idx * width, context->digit_num, common) == false) {
+                invertible[idx] = false;
+                invertible_num--;
+                memcpy(values + idx * width, context->one, width * SIZE_OF_WORD);
+            }
+        }
+
+        /* The product of the remaining operands is invertible */
+        gcd_batch_prefix(prefixes, values, count, context, scratch);
+        gcd_batch_invert(inverse, last, context);
+        bigint_delete(&common);
+    }
+
+    /* Back pass: X_i^(-1) = I_i * P_(i-1) and I_(i-1) = I_i * X_i, Montgomery products throughout */
+    for (size_t idx = count; idx-- > 0;)
+    {
+        Word* inverse_words = inverse;
+
+        if (idx > 0) {
+            words_montgomery_multiplication(product, inverse, prefixes + (idx - 1) * width, context, scratch);
+            words_montgomery_multiplication(inverse, inverse, values + idx * width, context, scratch);
+            inverse_words = product;
+        }
+
+        /* Get result */
+        if (invertible[idx] == true) {
+            bigint_set_by_array(&results[idx], inverse_words, POSITIVE, context->digit_num);
+            bigint_refine(results[idx]);
+        }
+        else
+            bigint_set_zero(&results[idx]);
+    }
+
+    /* Free memory */
+    bigint_free(buffer);
+
+    return invertible_num;
+}
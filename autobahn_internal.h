@@ -0,0 +1,392 @@
+/**
+ * @file autobahn_internal.h
+ * @brief Internal fixed-width kernels shared between the Autobahn source files.
+ *
+ * These routines work on raw Word arrays of a fixed length instead of Bigints.
+ * They never allocate and never refine, so their control flow and memory access
+ * pattern depend only on the array lengths, never on the values.
+ */
+
+#ifndef AUTOBAHN_INTERNAL_H
+#define AUTOBAHN_INTERNAL_H
+
+#include "autobahn.h"
+
+/* Double word type, if the compiler has one for the chosen word size */
+#if defined(BI_WORD8)
+    typedef uint16_t DoubleWord;
+    #define HAS_DOUBLE_WORD
+#elif defined(BI_WORD64)
+    #if defined(__SIZEOF_INT128__)
+        typedef unsigned __int128 DoubleWord;
+        #define HAS_DOUBLE_WORD
+    #endif
+#else
+    typedef uint64_t DoubleWord;
+    #define HAS_DOUBLE_WORD
+#endif
+
+/**
+ * @brief Computes (high||low) = operand_x * operand_y + addend_1 + addend_2 without overflow.
+ *
+ * @param high [out] Upper word of the result.
+ * @param low [out] Lower word of the result.
+ * @param operand_x [in] First operand word.
+ * @param operand_y [in] Second operand word.
+ * @param addend_1 [in] First word to add.
+ * @param addend_2 [in] Second word to add.
+ */
+static inline void word_multiplication_addition(Word* high, Word* low, Word operand_x, Word operand_y, Word addend_1, Word addend_2)
+{
+#if defined(HAS_DOUBLE_WORD)
+    DoubleWord product = (DoubleWord)operand_x * operand_y + addend_1 + addend_2;
+    *high = (Word)(product >> BITLEN_OF_WORD);
+    *low  = (Word)product;
+#else
+    Word bitlen_half = BITLEN_OF_WORD / 2;
+    Word mask_half = ((Word)1 << bitlen_half) - 1;
+    Word x_high = operand_x >> bitlen_half; // Upper half of operand_x
+    Word x_low  = operand_x & mask_half;    // Lower half of operand_x
+    Word y_high = operand_y >> bitlen_half; // Upper half of operand_y
+    Word y_low  = operand_y & mask_half;    // Lower half of operand_y
+
+    /* Partial products */
+    Word low_low   = x_low * y_low;   // A0B0
+    Word high_low  = x_high * y_low;  // A1B0
+    Word low_high  = x_low * y_high;  // A0B1
+    Word high_high = x_high * y_high; // A1B1
+
+    /* Middle value, never overflows */
+    Word middle = (low_low >> bitlen_half) + (high_low & mask_half) + low_high;
+
+    Word result_low  = (middle << bitlen_half) | (low_low & mask_half);
+    Word result_high = high_high + (high_low >> bitlen_half) + (middle >> bitlen_half);
+
+    /* Add the addends with carry */
+    result_low  += addend_1;
+    result_high += (result_low < addend_1);
+    result_low  += addend_2;
+    result_high += (result_low < addend_2);
+
+    *high = result_high;
+    *low  = result_low;
+#endif
+}
+
+/**
+ * @brief Perform addition of two words with carry.
+ * 
+ * @param result [out] - The result of the addition.
+ * @param next_carry [out] - The carry to be propagated to the next addition.
+ * @param current_carry [in] - The carry from the previous addition.
+ * @param operand_x [in] - The first operand.
+ * @param operand_y [in] - The second operand.
+ */
+static inline void word_addition_with_carry(Word* result, Word* next_carry, Word current_carry, Word operand_x, Word operand_y)
+{
+    *result     = operand_x + operand_y;        // Calculate sum: r = x + y
+    *next_carry = (*result < operand_x);        // Set carry if r < x
+    *result     += current_carry;               // Add the carry from the previous addition: r = x + y + c
+    *next_carry += (*result < current_carry);   // Set carry if r < c
+}
+
+/**
+ * @brief Perform word subtraction with borrow.
+ * 
+ * @param result [out] - The result of the subtraction.
+ * @param next_borrow [out] - The borrow to be propagated to the next subtraction.
+ * @param current_borrow [in] - The borrow from the previous subtraction.
+ * @param operand_x [in] - The minuend.
+ * @param operand_y [in] - The subtrahend.
+ */
+static inline void word_subtraction_with_borrow(Word* result, Word* next_borrow, Word current_borrow, Word operand_x, Word operand_y)
+{
+    *result      = operand_x - operand_y;       // Calculate difference: r = x - y
+    *next_borrow = operand_x < operand_y;       // Set borrow if x < y
+    *next_borrow += *result < current_borrow;   // Set borrow if r < c
+    *result      -= current_borrow;             // Adjust result for the borrow: r = x - y - b
+}
+
+/**
+ * @brief Performs multiplication of two words with half-word products: (high||low) = operand_x * operand_y.
+ *
+ * @param high [out] Upper word of the product.
+ * @param low [out] Lower word of the product.
+ * @param operand_x [in] First operand word.
+ * @param operand_y [in] Second operand word.
+ */
+static inline void word_multiplication(Word* high, Word* low, Word operand_x, Word operand_y)
+{
+    /* Initialize variables */
+    Word bitlen_half = BITLEN_OF_WORD / 2;
+    Word x_high = operand_x >> bitlen_half;           // Upper half of operand_x
+    Word x_low = (x_high << bitlen_half) ^ operand_x; // Lower half of operand_x
+    Word y_high = operand_y >> bitlen_half;           // Upper half of operand_y
+    Word y_low = (y_high << bitlen_half) ^ operand_y; // Lower half of operand_y
+
+    /* Compute high and low value */
+    Word result_low  = x_low * y_low;   // A0B0
+    Word result_high = x_high * y_high; // A1B1
+
+    /* Compute middle value */
+    Word middle = x_high * y_low + y_high * x_low; // A1B0 + A0B1
+    Word carry = middle < x_high * y_low;          // set carry.
+
+    /* Divide middle value */
+    Word middle_low  = middle << bitlen_half; // Lower half of A1B0 + A0B1 : L
+    Word middle_high = (middle >> bitlen_half) + (carry << bitlen_half); // Upper half of A1B0 + A0B1, consider carry : U
+
+    /* Compute the result */
+    result_low += middle_low;             // A0B0 + L
+    carry = result_low < middle_low;      // set carry
+    result_high += middle_high + carry;   // A1B1 + U + carry
+
+    *high = result_high;
+    *low  = result_low;
+}
+
+/**
+ * @brief Performs squaring of a word with half-word products: (high||low) = operand_x^2.
+ *
+ * @param high [out] Upper word of the square.
+ * @param low [out] Lower word of the square.
+ * @param operand_x [in] Operand word to be squared.
+ */
+static inline void word_squaring(Word* high, Word* low, Word operand_x)
+{
+    Word bitlen_half = BITLEN_OF_WORD / 2;
+
+    /* Initialize variables */
+    Word x_high = operand_x >> bitlen_half;               // A1: Upper half of operand_x
+    Word x_low = (x_high << bitlen_half) ^ operand_x;     // A0: Lower half of operand_x
+    Word carry = 0;
+
+    /* Compute high and low */
+    Word result_high = x_high * x_high; // A1A1
+    Word result_low  = x_low * x_low;   // A0A0
+
+    /* Divide the middle */
+    Word x_middle_low = (Word)(x_low * x_high) << bitlen_half;  // Lower half of A1A0
+    Word x_middle_high = (Word)(x_low * x_high) >> bitlen_half; // Upper half of A1A0
+
+    /* Compute the middle */
+    carry = GET_MSB(x_middle_low);    // Carry of one-bit left shift
+    x_middle_low = x_middle_low << 1; // Left shift
+    x_middle_high = (x_middle_high << 1) + carry; // Left shift with carry, we have 2A1A0
+
+    /* Compute the result */
+    result_low += x_middle_low;           // A0A0 + Lower A1A0
+    carry = result_low < x_middle_low;    // Set carry
+    result_high += x_middle_high + carry; // A1A1 + Upper A1A0 + carry
+
+    *high = result_high;
+    *low  = result_low;
+}
+
+/**
+ * @brief Returns an all-one mask if the two words are equal, zero otherwise, without branching.
+ *
+ * @param operand_x [in] First word.
+ * @param operand_y [in] Second word.
+ * @return Word All-one mask or zero.
+ */
+static inline Word word_mask_equal(Word operand_x, Word operand_y)
+{
+    Word difference = operand_x ^ operand_y;
+    Word is_zero = GET_MSB(~difference & (difference - 1)); // 1 only if difference is zero
+
+    return (Word)0 - is_zero;
+}
+
+/**
+ * @brief Computes quotient = (high||low) / divisor and its remainder, for high < divisor.
+ *
+ * @param quotient [out] Quotient word.
+ * @param remainder [out] Remainder word.
+ * @param high [in] Upper word of the dividend, less than the divisor.
+ * @param low [in] Lower word of the dividend.
+ * @param divisor [in] Non-zero divisor word.
+ */
+static inline void word_division_two_word(Word* quotient, Word* remainder, Word high, Word low, Word divisor)
+{
+#if defined(HAS_DOUBLE_WORD)
+    DoubleWord dividend = ((DoubleWord)high << BITLEN_OF_WORD) | low;
+    *quotient  = (Word)(dividend / divisor);
+    *remainder = (Word)(dividend % divisor);
+#else
+    Word tmp_quotient = 0;
+    Word tmp_remainder = high;
+
+    /* Binary long division, the remainder is always less than the divisor */
+    for (Word bit_idx = BITLEN_OF_WORD; bit_idx-- > 0;) {
+        Word overflow = GET_MSB(tmp_remainder);
+        tmp_remainder = (tmp_remainder << 1) | GET_BIT(low, bit_idx);
+        tmp_quotient <<= 1;
+        if (overflow == 1 || tmp_remainder >= divisor) {
+            tmp_remainder -= divisor;
+            tmp_quotient |= 1;
+        }
+    }
+
+    *quotient  = tmp_quotient;
+    *remainder = tmp_remainder;
+#endif
+}
+
+/**
+ * @brief Computes the quotient of dividing a two-word integer by a one-word integer, one bit at a time.
+ *
+ * @param dividend_high [in] The most significant word of the dividend, less than the divisor.
+ * @param dividend_low [in] The least significant word of the dividend.
+ * @param divisor [in] The divisor.
+ * @return Word The quotient of (dividend_high||dividend_low) / divisor.
+ */
+static inline Word get_quotient_of_division_two_word(Word dividend_high, Word dividend_low, Word divisor)
+{
+    Word quotient = 0; // Resulting quotient
+    Word remainder = dividend_high;
+    Word bit_idx = BITLEN_OF_WORD;
+
+    /* Divide: (dividend_high||dividend_low) / divisor */
+    while(bit_idx--)
+    {
+        Word bit_dividend_low = GET_BIT(dividend_low, bit_idx);       // ai
+        Word bit_expanded = (Word)1 << bit_idx;                       // Set correct index
+
+        if (GET_MSB(remainder) == 1) {
+            quotient += bit_expanded;                               // Q <- Q + ai
+            remainder = remainder * 2 + bit_dividend_low - divisor; // R <- 2R + ai - B
+        }
+        else {
+            remainder = remainder * 2 + bit_dividend_low; // R <- 2R + ai
+
+            if (remainder >= divisor) {
+                quotient += bit_expanded;        // Q <- Q + ai
+                remainder = remainder - divisor; // R <- R - B
+            }
+        }
+    }
+
+    return quotient;
+}
+
+/**
+ * @brief Returns the number of significant bits of a word.
+ *
+ * @param word [in] Word.
+ * @return Word Bit length, zero for a zero word.
+ */
+static inline Word word_bit_length(Word word)
+{
+    Word bit_length = 0;
+
+    while (word != 0) {
+        word >>= 1;
+        bit_length++;
+    }
+
+    return bit_length;
+}
+
+/**
+ * @brief Returns the length of an array without its leading zero words.
+ *
+ * @param digits [in] Array of words.
+ * @param digit_num [in] Number of words.
+ * @return size_t Number of significant words, zero for the value zero.
+ */
+static inline size_t words_trim(const Word* digits, size_t digit_num)
+{
+    while (digit_num > 0 && digits[digit_num - 1] == 0)
+        digit_num--;
+
+    return digit_num;
+}
+
+/**
+ * @brief Compares the values of two arrays, leading zero words are ignored.
+ *
+ * @param operand_x [in] First array.
+ * @param digit_num_x [in] Number of words of the first array.
+ * @param operand_y [in] Second array.
+ * @param digit_num_y [in] Number of words of the second array.
+ * @return char LEFT_IS_BIG, SAME or LEFT_IS_SMALL.
+ */
+static inline char words_compare(const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y)
+{
+    digit_num_x = words_trim(operand_x, digit_num_x);
+    digit_num_y = words_trim(operand_y, digit_num_y);
+
+    if (digit_num_x != digit_num_y)
+        return digit_num_x > digit_num_y ? LEFT_IS_BIG : LEFT_IS_SMALL;
+
+    for (size_t idx = digit_num_x; idx-- > 0;)
+        if (operand_x[idx] != operand_y[idx])
+            return operand_x[idx] > operand_y[idx] ? LEFT_IS_BIG : LEFT_IS_SMALL;
+
+    return SAME;
+}
+
+/** @brief Arithmetic on variable-length arrays */
+Word   words_addition                        (Word* result, const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y);
+Word   words_subtraction                     (Word* result, const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y);
+Word   words_multiplication_addition_word    (Word* result, const Word* operand, size_t digit_num, Word word);
+Word   words_multiplication_subtraction_word (Word* result, const Word* operand, size_t digit_num, Word word);
+size_t words_multiplication_scratch_size     (size_t digit_num_x, size_t digit_num_y);
+void   words_multiplication                  (Word* result, const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y, Word* scratch);
+size_t words_division_scratch_size           (size_t dividend_digit_num, size_t divisor_digit_num);
+void   words_division                        (Word* quotient, Word* remainder, const Word* dividend, size_t dividend_digit_num, const Word* divisor, size_t divisor_digit_num, Word* scratch);
+
+/** @brief Barrett division on arrays with a Newton reciprocal, sub-quadratic for long divisors */
+size_t words_reciprocal_scratch_size         (size_t digit_num);
+void   words_reciprocal                      (Word* reciprocal, const Word* divisor, size_t digit_num, Word* scratch);
+size_t words_reduction_barrett_scratch_size  (size_t dividend_digit_num, size_t digit_num);
+void   words_reduction_barrett               (Word* quotient, Word* remainder, const Word* dividend, size_t dividend_digit_num, const Word* modular, size_t digit_num, const Word* reciprocal, Word* scratch);
+size_t words_division_fast_scratch_size      (size_t dividend_digit_num, size_t divisor_digit_num);
+void   words_division_fast                   (Word* quotient, Word* remainder, const Word* dividend, size_t dividend_digit_num, const Word* divisor, size_t divisor_digit_num, Word* scratch);
+
+/** @brief Bigint wrappers of the array arithmetic, allocation per call instead of per word */
+void words_multiplication_bigint (Bigint** result, const Bigint* operand_x, const Bigint* operand_y);
+void words_division_bigint       (Bigint** quotient, Bigint** remainder, const Bigint* dividend, const Bigint* divisor);
+
+/** @brief Montgomery arithmetic on fixed-width arrays */
+size_t words_montgomery_scratch_size   (size_t digit_num);
+void   words_montgomery_multiplication (Word* result, const Word* operand_x, const Word* operand_y, const ModularContext* context, Word* scratch);
+void   words_montgomery_to_form        (Word* result, const Word* operand, const ModularContext* context, Word* scratch);
+void   words_montgomery_from_form      (Word* result, const Word* operand, const ModularContext* context, Word* scratch);
+void   words_reduce_operand            (Word* result, const Bigint* operand, const ModularContext* context);
+
+/** @brief Exponentiation on fixed-width arrays */
+size_t words_exponentiation_scratch_size        (size_t digit_num, size_t exponent_digit_num);
+void   words_exponentiation_fixed_window        (Word* result, const Word* base, const Word* exponent, size_t exponent_digit_num, const ModularContext* context, Word* scratch);
+size_t words_exponentiation_public_scratch_size (size_t digit_num);
+void   words_exponentiation_public              (Word* result, const Word* base, const Word* exponent, size_t exponent_digit_num, const ModularContext* context, Word* scratch);
+
+/** @brief Allocator internals */
+void*  memory_raw_alloc     (size_t byte_num, bool is_zero); /**< Allocates from the memory functions, without prefix, cache or counters. */
+size_t thread_pool_live_num (void);                          /**< Thread pools created and not yet deleted. */
+
+/**
+ * @brief Profiler scope of a BI_PROFILE build.
+ *
+ * PROFILE_SCOPE(point, limb_num) opens a scope that lasts until the enclosing block exits, on every return
+ * path, using the cleanup attribute of GCC and Clang. Without BI_PROFILE it expands to nothing, so the
+ * limb expression is not even evaluated.
+ */
+#if defined(BI_PROFILE)
+    typedef struct {
+        ProfilePoint point; /**< Profiled operation. */
+        uint64_t limb_num;  /**< Words of the operands. */
+        uint64_t start;     /**< Clock at entry, only read for the outermost call. */
+    } ProfileScope;
+
+    ProfileScope profile_scope_begin (ProfilePoint point, uint64_t limb_num);
+    void         profile_scope_end   (ProfileScope* scope);
+
+    #define PROFILE_SCOPE(point, limb_num) \
+        ProfileScope profile_scope __attribute__((cleanup(profile_scope_end))) = profile_scope_begin((point), (uint64_t)(limb_num))
+#else
+    #define PROFILE_SCOPE(point, limb_num) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,248 @@
+#include "autobahn_internal.h"
+
+/**
+ * @brief Performs one Montgomery reduction step: tmp <- (tmp + m * N) / W with m = tmp[0] * (-N^(-1)) mod W.
+ *
+ * @param tmp [in, out] Accumulator of n + 2 words.
+ * @param context [in] Modular context.
+ */
+static void montgomery_reduction_step(Word* tmp, const ModularContext* context)
+{
+    const Word* modular = context->modular->digits;
+    size_t digit_num = context->digit_num;
+    Word carry = 0;
+    Word discard = 0;
+
+    /* m makes the lowest word zero */
+    Word mont_factor = (Word)(tmp[0] * context->mont_inverse);
+
+    /* tmp <- (tmp + m * N) / W */
+    word_multiplication_addition(&carry, &discard, mont_factor, modular[0], tmp[0], 0);
+    for (size_t idx = 1; idx < digit_num; idx++)
+        word_multiplication_addition(&carry, &tmp[idx - 1], mont_factor, modular[idx], tmp[idx], carry);
+
+    /* Propagate the carry to the upper words */
+    tmp[digit_num - 1] = tmp[digit_num] + carry;
+    carry = (tmp[digit_num - 1] < carry);
+    tmp[digit_num] = tmp[digit_num + 1] + carry;
+    tmp[digit_num + 1] = 0;
+}
+
+/**
+ * @brief Subtracts N from tmp if tmp >= N, without branching on the values.
+ *
+ * @param result [out] Fixed-width result of n words.
+ * @param tmp [in] Accumulator of n + 2 words, less than 2N.
+ * @param context [in] Modular context.
+ */
+static void montgomery_final_subtraction(Word* result, const Word* tmp, const ModularContext* context)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_MONTGOMERY_FINAL_SUBTRACTION, context->digit_num);
+
+    const Word* modular = context->modular->digits;
+    size_t digit_num = context->digit_num;
+    Word borrow = 0;
+
+    /* result <- tmp - N */
+    for (size_t idx = 0; idx < digit_num; idx++) {
+        Word difference = tmp[idx] - modular[idx];
+        Word next_borrow = (tmp[idx] < modular[idx]);
+        next_borrow += (difference < borrow);
+        result[idx] = difference - borrow;
+        borrow = next_borrow;
+    }
+
+    /* Keep the difference if tmp has a carry word or the subtraction did not borrow */
+    Word mask = (Word)0 - (tmp[digit_num] | (borrow ^ 1));
+    for (size_t idx = 0; idx < digit_num; idx++)
+        result[idx] = (result[idx] & mask) | (tmp[idx] & ~mask);
+}
+
+/**
+ * @brief Returns the number of scratch words needed by the Montgomery kernels.
+ *
+ * @param digit_num [in] Number of digits of the modulus.
+ * @return size_t Number of scratch words.
+ */
+size_t words_montgomery_scratch_size(size_t digit_num)
+{
+    return digit_num + 2;
+}
+
+/**
+ * @brief Performs Montgomery multiplication (CIOS) on fixed-width arrays: result = X * Y * R^(-1) mod N.
+ *
+ * @param result [out] Fixed-width result of n words, may alias the operands.
+ * @param operand_x [in] First operand of n words, less than N.
+ * @param operand_y [in] Second operand of n words, less than N.
+ * @param context [in] Modular context.
+ * @param scratch [in] Scratch of words_montgomery_scratch_size(n) words.
+ */
+void words_montgomery_multiplication(Word* result, const Word* operand_x, const Word* operand_y, const ModularContext* context, Word* scratch)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_MONTGOMERY_MULTIPLICATION, context->digit_num);
+
+    size_t digit_num = context->digit_num;
+    Word* tmp = scratch; // T, n + 2 words
+
+    /* Initialization */
+    memset(tmp, 0, (digit_num + 2) * SIZE_OF_WORD);
+
+    for (size_t idx_y = 0; idx_y < digit_num; idx_y++)
+    {
+        Word carry = 0;
+
+        /* T <- T + X * Yi */
+        for (size_t idx_x = 0; idx_x < digit_num; idx_x++)
+            word_multiplication_addition(&carry, &tmp[idx_x], operand_x[idx_x], operand_y[idx_y], tmp[idx_x], carry);
+
+        tmp[digit_num] += carry;
+        tmp[digit_num + 1] = (tmp[digit_num] < carry);
+
+        /* T <- (T + mN) / W */
+        montgomery_reduction_step(tmp, context);
+    }
+
+    /* T is less than 2N */
+    montgomery_final_subtraction(result, tmp, context);
+}
+
+/**
+ * @brief Converts a fixed-width operand into the Montgomery form: result = X * R mod N.
+ *
+ * @param result [out] Fixed-width result of n words, may alias the operand.
+ * @param operand [in] Operand of n words, less than N.
+ * @param context [in] Modular context.
+ * @param scratch [in] Scratch of words_montgomery_scratch_size(n) words.
+ */
+void words_montgomery_to_form(Word* result, const Word* operand, const ModularContext* context, Word* scratch)
+{
+    words_montgomery_multiplication(result, operand, context->r_square, context, scratch);
+}
+
+/**
+ * @brief Converts a fixed-width operand out of the Montgomery form: result = X * R^(-1) mod N.
+ *
+ * @param result [out] Fixed-width result of n words, may alias the operand.
+ * @param operand [in] Operand of n words in the Montgomery form.
+ * @param context [in] Modular context.
+ * @param scratch [in] Scratch of words_montgomery_scratch_size(n) words.
+ */
+void words_montgomery_from_form(Word* result, const Word* operand, const ModularContext* context, Word* scratch)
+{
+    size_t digit_num = context->digit_num;
+    Word* tmp = scratch; // T, n + 2 words
+
+    /* T <- X */
+    memcpy(tmp, operand, digit_num * SIZE_OF_WORD);
+    tmp[digit_num] = 0;
+    tmp[digit_num + 1] = 0;
+
+    /* T <- T / R mod N, one word at a time */
+    for (size_t idx = 0; idx < digit_num; idx++)
+        montgomery_reduction_step(tmp, context);
+
+    montgomery_final_subtraction(result, tmp, context);
+}
+
+/**
+ * @brief Reduces a non-negative Bigint modulo N into a fixed-width array of n words.
+ *
+ * @param result [out] Fixed-width result of n words.
+ * @param operand [in] Non-negative operand.
+ * @param context [in] Modular context.
+ */
+void words_reduce_operand(Word* result, const Bigint* operand, const ModularContext* context)
+{
+    /* Already reduced: fixed-width copy without allocation */
+    if (bigint_compare_abs(operand, context->modular) == LEFT_IS_SMALL) {
+        memset(result, 0, context->digit_num * SIZE_OF_WORD);
+        memcpy(result, operand->digits, operand->digit_num * SIZE_OF_WORD);
+        return;
+    }
+
+    /* Remainder of the array division, written straight into the fixed-width result */
+    Word* scratch = (Word*)bigint_malloc(words_division_scratch_size(operand->digit_num, context->digit_num) * SIZE_OF_WORD);
+    words_division(NULL, result, operand->digits, operand->digit_num, context->modular->digits, context->digit_num, scratch);
+
+    /* Free memory */
+    bigint_free(scratch);
+}
+
+/**
+ * @brief Pre-computes the Barrett and Montgomery values of an odd modulus.
+ *
+ * @param context [out] Pointer to the modular context.
+ * @param modular [in] Positive odd modulus.
+ */
+void bigint_modular_context_new(ModularContext** context, const Bigint* modular)
+{
+    PROFILE_SCOPE(PROFILE_MODULAR_CONTEXT_NEW, modular->digit_num);
+
+    /* Free allocated memory */
+    if (*context != NULL)
+        bigint_modular_context_delete(context);
+
+    /* Invalid case: Montgomery arithmetic needs a positive odd modulus */
+    if (modular->sign == NEGATIVE || GET_BIT(modular->digits[0], 0) == 0) {
+        printf("Invalid Case: Modulus must be positive and odd.\n");
+        return;
+    }
+
+    Bigint* dividend = NULL;  // = W^(2n)
+    Bigint* remainder = NULL; // = R^2 mod N
+    size_t digit_num = modular->digit_num;
+
+    /* Allocate context */
+    *context = (ModularContext*)bigint_malloc(sizeof(ModularContext));
+    (*context)->modular = NULL;
+    (*context)->barrett_pre_computed = NULL;
+    (*context)->digit_num = digit_num;
+    (*context)->r_square = (Word*)bigint_calloc(digit_num, SIZE_OF_WORD);
+    (*context)->one = (Word*)bigint_calloc(digit_num, SIZE_OF_WORD);
+    bigint_copy(&(*context)->modular, modular);
+    bigint_new(&(*context)->barrett_pre_computed, 1);
+    bigint_new(&dividend, 1);
+    bigint_new(&remainder, 1);
+
+    /* One division gives both: W^(2n) = T * N + R^2 mod N */
+    bigint_set_one(&dividend);
+    bigint_expand(&dividend, dividend, 2 * digit_num);
+    bigint_division_word_long(&(*context)->barrett_pre_computed, &remainder, dividend, modular);
+    memcpy((*context)->r_square, remainder->digits, remainder->digit_num * SIZE_OF_WORD);
+
+    /* -N^(-1) mod W by Newton iteration, N0 is its own inverse modulo 8 */
+    Word inverse = modular->digits[0];
+    for (Word precision = 3; precision < BITLEN_OF_WORD; precision *= 2)
+        inverse = (Word)(inverse * (Word)(2 - (Word)(modular->digits[0] * inverse)));
+    (*context)->mont_inverse = (Word)(0 - inverse);
+
+    /* R mod N = R^2 / R mod N */
+    Word* scratch = (Word*)bigint_calloc(words_montgomery_scratch_size(digit_num), SIZE_OF_WORD);
+    words_montgomery_from_form((*context)->one, (*context)->r_square, *context, scratch);
+
+    /* Free memory */
+    bigint_free(scratch);
+    bigint_delete(&dividend);
+    bigint_delete(&remainder);
+}
+
+/**
+ * @brief Deallocates a modular context.
+ *
+ * @param context [in, out] Pointer to the modular context.
+ */
+void bigint_modular_context_delete(ModularContext** context)
+{
+    /* Invalid pointer */
+    if (*context == NULL)
+        return;
+
+    /* Free memory */
+    bigint_delete(&(*context)->modular);
+    bigint_delete(&(*context)->barrett_pre_computed);
+    bigint_free((*context)->r_square);
+    bigint_free((*context)->one);
+    bigint_free(*context);
+    *context = NULL;
+}
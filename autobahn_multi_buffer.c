@@ -0,0 +1,539 @@
+#include "autobahn_internal.h"
+
+#if !defined(AUTOBAHN_NO_AVX2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define MULTI_BUFFER_AVX2
+#endif
+
+#define MULTI_BUFFER_LANES 4                                    /**< Independent operations per group. */
+#define MULTI_BUFFER_RADIX 26                                   /**< Bits per limb, products fit in 52 bits. */
+#define MULTI_BUFFER_MASK  (((uint64_t)1 << MULTI_BUFFER_RADIX) - 1)
+#define MULTI_BUFFER_WINDOW_MAX 5                               /**< Largest window, bounds the table size. */
+#define MULTI_BUFFER_LIMB_MAX 1024                              /**< Unreduced 64-bit accumulation is exact below 2^11 limbs. */
+
+/**
+ * @brief Pre-computed values of a group of up to four odd moduli of the same limb count.
+ *
+ * Every vector is stored transposed: limb i of lane l is at [i * MULTI_BUFFER_LANES + l].
+ */
+typedef struct {
+    size_t limb_num;        /**< Number of 26-bit limbs m, R = 2^(26m). */
+    uint64_t* modular;      /**< N of each lane. */
+    uint64_t* r_square;     /**< R^2 mod N of each lane. */
+    uint64_t* one;          /**< 1, not in the Montgomery form. */
+    uint64_t* mont_inverse; /**< -N^(-1) mod 2^26 of each lane. */
+} MultiBufferContext;
+
+/** @brief Montgomery multiplication kernel: result = A * B * R^(-1) mod N in every lane. */
+typedef void (*MultiBufferMultiplication)(uint64_t* result, const uint64_t* operand_x, const uint64_t* operand_y, const MultiBufferContext* context, uint64_t* scratch);
+
+/**
+ * @brief Performs lane-parallel Montgomery multiplication with plain 64-bit arithmetic.
+ *
+ * Limb products are accumulated without carry propagation, which is exact for m < 2^10.
+ *
+ * @param result [out] Transposed result of m limbs, may alias the operands.
+ * @param operand_x [in] Transposed first operand, less than N.
+ * @param operand_y [in] Transposed second operand, less than N.
+ * @param context [in] Multi-buffer context.
+ * @param scratch [in] Scratch of (2m + 1) * 4 words.
+ */
+static void multi_buffer_montgomery_multiplication_scalar(uint64_t* result, const uint64_t* operand_x, const uint64_t* operand_y, const MultiBufferContext* context, uint64_t* scratch)
+{
+    size_t limb_num = context->limb_num;
+    const uint64_t* modular = context->modular;
+    uint64_t* tmp = scratch; // T, 2m + 1 limbs
+
+    /* Initialization */
+    memset(tmp, 0, (2 * limb_num + 1) * MULTI_BUFFER_LANES * sizeof(uint64_t));
+
+    for (size_t idx = 0; idx < limb_num; idx++)
+    {
+        for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++)
+        {
+            uint64_t* tmp_lane = tmp + idx * MULTI_BUFFER_LANES + lane;
+            uint64_t x_limb = operand_x[idx * MULTI_BUFFER_LANES + lane];
+
+            /* u makes the limb Ti divisible by 2^26 */
+            uint64_t low = tmp_lane[0] + x_limb * operand_y[lane];
+            uint64_t mont_factor = ((low & MULTI_BUFFER_MASK) * context->mont_inverse[lane]) & MULTI_BUFFER_MASK;
+
+            /* T <- T + (Xi * Y + u * N) * 2^(26i) */
+            tmp_lane[0] = low + mont_factor * modular[lane];
+            for (size_t jdx = 1; jdx < limb_num; jdx++)
+                tmp_lane[jdx * MULTI_BUFFER_LANES] += x_limb * operand_y[jdx * MULTI_BUFFER_LANES + lane] + mont_factor * modular[jdx * MULTI_BUFFER_LANES + lane];
+
+            /* Carry of the eliminated limb */
+            tmp_lane[MULTI_BUFFER_LANES] += tmp_lane[0] >> MULTI_BUFFER_RADIX;
+        }
+    }
+
+    for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++)
+    {
+        uint64_t* tmp_lane = tmp + limb_num * MULTI_BUFFER_LANES + lane; // T / R
+        uint64_t carry = 0;
+        uint64_t borrow = 0;
+
+        /* Normalize the limbs */
+        for (size_t jdx = 0; jdx < limb_num; jdx++) {
+            tmp_lane[jdx * MULTI_BUFFER_LANES] += carry;
+            carry = tmp_lane[jdx * MULTI_BUFFER_LANES] >> MULTI_BUFFER_RADIX;
+            tmp_lane[jdx * MULTI_BUFFER_LANES] &= MULTI_BUFFER_MASK;
+        }
+
+        /* T - N, T is less than 2N */
+        for (size_t jdx = 0; jdx < limb_num; jdx++) {
+            uint64_t difference = tmp_lane[jdx * MULTI_BUFFER_LANES] - modular[jdx * MULTI_BUFFER_LANES + lane] - borrow;
+            borrow = difference >> 63;
+            result[jdx * MULTI_BUFFER_LANES + lane] = difference & MULTI_BUFFER_MASK;
+        }
+
+        /* Keep T if the subtraction borrowed past the carry limb */
+        uint64_t mask = (uint64_t)0 - (uint64_t)((carry - borrow) != 0);
+        for (size_t jdx = 0; jdx < limb_num; jdx++)
+            result[jdx * MULTI_BUFFER_LANES + lane] = (result[jdx * MULTI_BUFFER_LANES + lane] & ~mask) | (tmp_lane[jdx * MULTI_BUFFER_LANES] & mask);
+    }
+}
+
+#if defined(MULTI_BUFFER_AVX2)
+/**
+ * @brief Performs lane-parallel Montgomery multiplication with AVX2, four lanes per instruction.
+ *
+ * Same arithmetic as multi_buffer_montgomery_multiplication_scalar, so the results are identical.
+ *
+ * @param result [out] Transposed result of m limbs, may alias the operands.
+ * @param operand_x [in] Transposed first operand, less than N.
+ * @param operand_y [in] Transposed second operand, less than N.
+ * @param context [in] Multi-buffer context.
+ * @param scratch [in] Scratch of (2m + 1) * 4 words.
+ */
+__attribute__((target("avx2")))
+static void multi_buffer_montgomery_multiplication_avx2(uint64_t* result, const uint64_t* operand_x, const uint64_t* operand_y, const MultiBufferContext* context, uint64_t* scratch)
+{
+    size_t limb_num = context->limb_num;
+    const __m256i* modular = (const __m256i*)context->modular;
+    const __m256i* y = (const __m256i*)operand_y;
+    __m256i* tmp = (__m256i*)scratch; // T, 2m + 1 limbs
+    __m256i mask = _mm256_set1_epi64x((long long)MULTI_BUFFER_MASK);
+    __m256i mont_inverse = _mm256_loadu_si256((const __m256i*)context->mont_inverse);
+    __m256i zero = _mm256_setzero_si256();
+
+    /* Initialization */
+    for (size_t idx = 0; idx < 2 * limb_num + 1; idx++)
+        _mm256_storeu_si256(&tmp[idx], zero);
+
+    for (size_t idx = 0; idx < limb_num; idx++)
+    {
+        __m256i x_limb = _mm256_loadu_si256((const __m256i*)operand_x + idx);
+        __m256i* tmp_row = tmp + idx;
+
+        /* u makes the limb Ti divisible by 2^26 */
+        __m256i low = _mm256_add_epi64(_mm256_loadu_si256(&tmp_row[0]), _mm256_mul_epu32(x_limb, _mm256_loadu_si256(&y[0])));
+        __m256i mont_factor = _mm256_and_si256(_mm256_mul_epu32(_mm256_and_si256(low, mask), mont_inverse), mask);
+
+        /* T <- T + (Xi * Y + u * N) * 2^(26i) */
+        low = _mm256_add_epi64(low, _mm256_mul_epu32(mont_factor, _mm256_loadu_si256(&modular[0])));
+        for (size_t jdx = 1; jdx < limb_num; jdx++) {
+            __m256i sum = _mm256_add_epi64(_mm256_mul_epu32(x_limb, _mm256_loadu_si256(&y[jdx])), _mm256_mul_epu32(mont_factor, _mm256_loadu_si256(&modular[jdx])));
+            _mm256_storeu_si256(&tmp_row[jdx], _mm256_add_epi64(_mm256_loadu_si256(&tmp_row[jdx]), sum));
+        }
+
+        /* Carry of the eliminated limb */
+        _mm256_storeu_si256(&tmp_row[0], low);
+        _mm256_storeu_si256(&tmp_row[1], _mm256_add_epi64(_mm256_loadu_si256(&tmp_row[1]), _mm256_srli_epi64(low, MULTI_BUFFER_RADIX)));
+    }
+
+    __m256i* tmp_high = tmp + limb_num; // T / R
+    __m256i carry = zero;
+    __m256i borrow = zero;
+
+    /* Normalize the limbs */
+    for (size_t jdx = 0; jdx < limb_num; jdx++) {
+        __m256i limb = _mm256_add_epi64(_mm256_loadu_si256(&tmp_high[jdx]), carry);
+        carry = _mm256_srli_epi64(limb, MULTI_BUFFER_RADIX);
+        _mm256_storeu_si256(&tmp_high[jdx], _mm256_and_si256(limb, mask));
+    }
+
+    /* T - N, T is less than 2N */
+    for (size_t jdx = 0; jdx < limb_num; jdx++) {
+        __m256i difference = _mm256_sub_epi64(_mm256_sub_epi64(_mm256_loadu_si256(&tmp_high[jdx]), _mm256_loadu_si256(&modular[jdx])), borrow);
+        borrow = _mm256_srli_epi64(difference, 63);
+        _mm256_storeu_si256((__m256i*)result + jdx, _mm256_and_si256(difference, mask));
+    }
+
+    /* Keep T if the subtraction borrowed past the carry limb */
+    __m256i keep = _mm256_xor_si256(_mm256_cmpeq_epi64(_mm256_sub_epi64(carry, borrow), zero), _mm256_set1_epi64x(-1));
+    for (size_t jdx = 0; jdx < limb_num; jdx++) {
+        __m256i difference = _mm256_loadu_si256((__m256i*)result + jdx);
+        __m256i limb = _mm256_loadu_si256(&tmp_high[jdx]);
+        _mm256_storeu_si256((__m256i*)result + jdx, _mm256_blendv_epi8(difference, limb, keep));
+    }
+}
+#endif
+
+/**
+ * @brief Chooses the Montgomery multiplication kernel once, AVX2 if the CPU supports it.
+ *
+ * @return MultiBufferMultiplication Kernel.
+ */
+static MultiBufferMultiplication multi_buffer_select_kernel(void)
+{
+#if defined(MULTI_BUFFER_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+        return multi_buffer_montgomery_multiplication_avx2;
+#endif
+    return multi_buffer_montgomery_multiplication_scalar;
+}
+
+/**
+ * @brief Converts the digits of a Bigint into the 26-bit limbs of one lane.
+ *
+ * @param limbs [out] Transposed vector.
+ * @param lane [in] Lane to write.
+ * @param limb_num [in] Number of limbs.
+ * @param bigint [in] Non-negative Bigint of at most 26m bits.
+ */
+static void multi_buffer_from_bigint(uint64_t* limbs, size_t lane, size_t limb_num, const Bigint* bigint)
+{
+    size_t bit_length = bigint->digit_num * BITLEN_OF_WORD;
+
+    for (size_t idx = 0; idx < limb_num; idx++)
+    {
+        uint64_t limb = 0;
+
+        /* Gather 26 bits, word by word */
+        for (size_t bit_idx = idx * MULTI_BUFFER_RADIX; bit_idx < (idx + 1) * MULTI_BUFFER_RADIX && bit_idx < bit_length; ) {
+            Word shift = bit_idx % BITLEN_OF_WORD;
+            size_t bit_count = BITLEN_OF_WORD - shift;
+            if (bit_count > (idx + 1) * MULTI_BUFFER_RADIX - bit_idx)
+                bit_count = (idx + 1) * MULTI_BUFFER_RADIX - bit_idx;
+            limb |= (uint64_t)(bigint->digits[bit_idx / BITLEN_OF_WORD] >> shift) << (bit_idx - idx * MULTI_BUFFER_RADIX);
+            bit_idx += bit_count;
+        }
+
+        limbs[idx * MULTI_BUFFER_LANES + lane] = limb & MULTI_BUFFER_MASK;
+    }
+}
+
+/**
+ * @brief Converts the 26-bit limbs of one lane into a Bigint.
+ *
+ * @param bigint [out] Pointer to the resulting Bigint.
+ * @param limbs [in] Transposed vector.
+ * @param lane [in] Lane to read.
+ * @param limb_num [in] Number of limbs.
+ */
+static void multi_buffer_to_bigint(Bigint** bigint, const uint64_t* limbs, size_t lane, size_t limb_num)
+{
+    size_t digit_num = (limb_num * MULTI_BUFFER_RADIX + BITLEN_OF_WORD - 1) / BITLEN_OF_WORD;
+
+    /* Allocate Bigint */
+    bigint_new(bigint, digit_num);
+
+    /* Scatter the bits of every limb */
+    for (size_t idx = 0; idx < limb_num; idx++)
+    {
+        uint64_t limb = limbs[idx * MULTI_BUFFER_LANES + lane];
+        size_t bit_idx = idx * MULTI_BUFFER_RADIX;
+
+        while (limb != 0) {
+            Word shift = bit_idx % BITLEN_OF_WORD;
+            size_t bit_count = BITLEN_OF_WORD - shift; // bits left in the digit
+            (*bigint)->digits[bit_idx / BITLEN_OF_WORD] |= (Word)(limb << shift);
+            if (bit_count >= MULTI_BUFFER_RADIX)
+                break;
+            limb >>= bit_count;
+            bit_idx += bit_count;
+        }
+    }
+
+    /* Free unused memory */
+    bigint_refine(*bigint);
+}
+
+/**
+ * @brief Pre-computes the multi-buffer values of up to four odd moduli.
+ *
+ * @param context [out] Multi-buffer context.
+ * @param modulars [in] Moduli of the lanes, unused lanes repeat lane 0.
+ * @param limb_num [in] Number of limbs m, 26m must exceed the bit length of every modulus.
+ */
+static void multi_buffer_context_init(MultiBufferContext* context, const Bigint* const* modulars, size_t limb_num)
+{
+    size_t vector_size = limb_num * MULTI_BUFFER_LANES * sizeof(uint64_t);
+
+    /* Allocate vectors */
+    context->limb_num = limb_num;
+    context->modular = (uint64_t*)bigint_calloc(1, vector_size);
+    context->r_square = (uint64_t*)bigint_calloc(1, vector_size);
+    context->one = (uint64_t*)bigint_calloc(1, vector_size);
+    context->mont_inverse = (uint64_t*)bigint_calloc(MULTI_BUFFER_LANES, sizeof(uint64_t));
+
+    for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++)
+    {
+        uint64_t* r_square = context->r_square + lane;
+        const uint64_t* modular = context->modular + lane;
+
+        multi_buffer_from_bigint(context->modular, lane, limb_num, modulars[lane]);
+        context->one[lane] = 1;
+
+        /* -N^(-1) mod 2^26 by Newton iteration */
+        uint64_t inverse = modular[0];
+        for (int precision = 3; precision < MULTI_BUFFER_RADIX; precision *= 2)
+            inverse = (inverse * (2 - modular[0] * inverse)) & MULTI_BUFFER_MASK;
+        context->mont_inverse[lane] = (0 - inverse) & MULTI_BUFFER_MASK;
+
+        /* R^2 mod N = 2^(52m) mod N, by doubling one: public values only */
+        r_square[0] = 1;
+        for (size_t count = 0; count < 2 * limb_num * MULTI_BUFFER_RADIX; count++)
+        {
+            uint64_t carry = 0;
+            uint64_t borrow = 0;
+
+            /* R2 <- 2 * R2 */
+            for (size_t idx = 0; idx < limb_num; idx++) {
+                uint64_t limb = (r_square[idx * MULTI_BUFFER_LANES] << 1) | carry;
+                carry = limb >> MULTI_BUFFER_RADIX;
+                r_square[idx * MULTI_BUFFER_LANES] = limb & MULTI_BUFFER_MASK;
+            }
+
+            /* Compare with N */
+            int compare = (carry != 0) ? LEFT_IS_BIG : SAME;
+            for (size_t idx = limb_num; idx-- > 0 && compare == SAME; ) {
+                if (r_square[idx * MULTI_BUFFER_LANES] > modular[idx * MULTI_BUFFER_LANES]) compare = LEFT_IS_BIG;
+                if (r_square[idx * MULTI_BUFFER_LANES] < modular[idx * MULTI_BUFFER_LANES]) compare = LEFT_IS_SMALL;
+            }
+            if (compare == LEFT_IS_SMALL)
+                continue;
+
+            /* R2 <- R2 - N */
+            for (size_t idx = 0; idx < limb_num; idx++) {
+                uint64_t difference = r_square[idx * MULTI_BUFFER_LANES] - modular[idx * MULTI_BUFFER_LANES] - borrow;
+                borrow = difference >> 63;
+                r_square[idx * MULTI_BUFFER_LANES] = difference & MULTI_BUFFER_MASK;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Frees the vectors of a multi-buffer context.
+ *
+ * @param context [in] Multi-buffer context.
+ */
+static void multi_buffer_context_free(MultiBufferContext* context)
+{
+    bigint_free(context->modular);
+    bigint_free(context->r_square);
+    bigint_free(context->one);
+    bigint_free(context->mont_inverse);
+}
+
+/**
+ * @brief Extracts the exponent window of every lane.
+ *
+ * @param window_values [out] Window value of each lane.
+ * @param exponents [in] Exponents of the lanes.
+ * @param bit_position [in] Position of the lowest bit of the window.
+ * @param window [in] Window size in bits.
+ */
+static void multi_buffer_get_windows(uint64_t* window_values, const Bigint* const* exponents, size_t bit_position, Word window)
+{
+    for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++)
+    {
+        uint64_t value = 0;
+
+        /* Bits beyond the exponent are zero */
+        for (Word bit = 0; bit < window; bit++) {
+            size_t bit_idx = bit_position + bit;
+            if (bit_idx / BITLEN_OF_WORD < exponents[lane]->digit_num)
+                value |= (uint64_t)GET_BIT(exponents[lane]->digits[bit_idx / BITLEN_OF_WORD], bit_idx % BITLEN_OF_WORD) << bit;
+        }
+
+        window_values[lane] = value;
+    }
+}
+
+/**
+ * @brief Loads the table entry of every lane by reading every entry.
+ *
+ * @param entry [out] Transposed vector.
+ * @param table [in] Table of 2^w transposed vectors.
+ * @param window_values [in] Secret index of each lane.
+ * @param entry_count [in] Number of entries.
+ * @param limb_num [in] Number of limbs.
+ */
+static void multi_buffer_table_gather(uint64_t* entry, const uint64_t* table, const uint64_t* window_values, size_t entry_count, size_t limb_num)
+{
+    size_t vector_word_num = limb_num * MULTI_BUFFER_LANES;
+
+    memset(entry, 0, vector_word_num * sizeof(uint64_t));
+
+    for (size_t entry_idx = 0; entry_idx < entry_count; entry_idx++)
+    {
+        const uint64_t* candidate = table + entry_idx * vector_word_num;
+        uint64_t masks[MULTI_BUFFER_LANES];
+
+        /* All-one mask in the lanes selecting this entry */
+        for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++) {
+            uint64_t difference = window_values[lane] ^ entry_idx;
+            masks[lane] = (uint64_t)0 - ((~difference & (difference - 1)) >> 63);
+        }
+
+        for (size_t idx = 0; idx < vector_word_num; idx++)
+            entry[idx] |= candidate[idx] & masks[idx % MULTI_BUFFER_LANES];
+    }
+}
+
+/**
+ * @brief Performs fixed-window modular exponentiation of four lanes at once.
+ *
+ * @param results [out] Results of the lanes.
+ * @param bases [in] Bases of the lanes, less than their moduli.
+ * @param exponents [in] Exponents of the lanes.
+ * @param context [in] Multi-buffer context.
+ * @param multiplication [in] Montgomery multiplication kernel.
+ */
+static void multi_buffer_exponentiation(Bigint** results, const Bigint* const* bases, const Bigint* const* exponents, const MultiBufferContext* context, MultiBufferMultiplication multiplication)
+{
+    size_t limb_num = context->limb_num;
+    size_t vector_word_num = limb_num * MULTI_BUFFER_LANES;
+
+    /* Window size from the longest exponent, a public length */
+    size_t exponent_digit_num = 1;
+    for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++)
+        if (exponents[lane]->digit_num > exponent_digit_num)
+            exponent_digit_num = exponents[lane]->digit_num;
+    size_t bit_length = exponent_digit_num * BITLEN_OF_WORD;
+    Word window = bit_length <= 64 ? 2 : (bit_length <= 512 ? 4 : MULTI_BUFFER_WINDOW_MAX);
+    size_t entry_count = (size_t)1 << window;
+
+    /* Table, accumulator, entry and scratch, 32-byte aligned */
+    size_t buffer_size = ((entry_count + 2) * vector_word_num + (2 * limb_num + 1) * MULTI_BUFFER_LANES) * sizeof(uint64_t);
+    unsigned char* buffer = (unsigned char*)bigint_malloc(buffer_size + 31);
+    uint64_t* table = (uint64_t*)(((uintptr_t)buffer + 31) & ~(uintptr_t)31);
+    uint64_t* accumulator = table + entry_count * vector_word_num;
+    uint64_t* entry = accumulator + vector_word_num;
+    uint64_t* scratch = entry + vector_word_num;
+    uint64_t window_values[MULTI_BUFFER_LANES];
+
+    /* Table: X^k in the Montgomery form */
+    for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++)
+        multi_buffer_from_bigint(entry, lane, limb_num, bases[lane]);
+    multiplication(entry, entry, context->r_square, context, scratch);           // XR
+    multiplication(table, context->r_square, context->one, context, scratch);    // R mod N
+    for (size_t idx = 1; idx < entry_count; idx++)
+        multiplication(table + idx * vector_word_num, table + (idx - 1) * vector_word_num, entry, context, scratch);
+
+    /* Top window */
+    size_t window_idx = (bit_length + window - 1) / window - 1;
+    multi_buffer_get_windows(window_values, exponents, window_idx * window, window);
+    multi_buffer_table_gather(accumulator, table, window_values, entry_count, limb_num);
+
+    /* Left-to-right: w squarings and one multiplication per window */
+    while (window_idx--)
+    {
+        for (Word idx = 0; idx < window; idx++)
+            multiplication(accumulator, accumulator, accumulator, context, scratch); // A <- A^2
+
+        multi_buffer_get_windows(window_values, exponents, window_idx * window, window);
+        multi_buffer_table_gather(entry, table, window_values, entry_count, limb_num);
+        multiplication(accumulator, accumulator, entry, context, scratch); // A <- A * X^k
+    }
+
+    /* Get results */
+    multiplication(accumulator, accumulator, context->one, context, scratch);
+    for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++)
+        multi_buffer_to_bigint(&results[lane], accumulator, lane, limb_num);
+
+    /* Clear the table and free memory */
+    memset(table, 0, buffer_size);
+    bigint_free(buffer);
+}
+
+/**
+ * @brief Performs many independent modular exponentiations, four at a time in transposed SIMD lanes.
+ *
+ * Moduli must be odd and of similar size: each group of four uses the limb count of its largest modulus.
+ * Every lane runs the same constant-time fixed-window sequence. The AVX2 kernel is used if the CPU has it,
+ * otherwise (or when built with AUTOBAHN_NO_AVX2) a scalar kernel gives identical results.
+ *
+ * @param results [out] Array of count results.
+ * @param bases [in] Array of count bases.
+ * @param exponents [in] Array of count exponents.
+ * @param modulars [in] Array of count odd moduli.
+ * @param count [in] Number of exponentiations.
+ */
+void bigint_exponentiation_modular_multi_buffer(Bigint** results, Bigint* const* bases, Bigint* const* exponents, Bigint* const* modulars, size_t count)
+{
+    PROFILE_SCOPE(PROFILE_EXPONENTIATION_MULTI_BUFFER, 0);
+
+    /* Validate every operation first */
+    for (size_t idx = 0; idx < count; idx++) {
+        if (bases[idx]->sign == NEGATIVE || exponents[idx]->sign == NEGATIVE) {
+            printf("Invalid Case: Base or exponent must be positive.\n");
+            return;
+        }
+        if (modulars[idx]->sign == NEGATIVE || GET_BIT(modulars[idx]->digits[0], 0) == 0) {
+            printf("Invalid Case: Modulus must be positive and odd.\n");
+            return;
+        }
+        if ((size_t)modulars[idx]->digit_num * BITLEN_OF_WORD >= (MULTI_BUFFER_LIMB_MAX - 1) * MULTI_BUFFER_RADIX) {
+            printf("Invalid Case: Modulus is too large for the multi-buffer engine.\n");
+            return;
+        }
+    }
+
+    MultiBufferMultiplication multiplication = multi_buffer_select_kernel();
+
+    for (size_t group = 0; group < count; group += MULTI_BUFFER_LANES)
+    {
+        const Bigint* group_bases[MULTI_BUFFER_LANES];
+        const Bigint* group_exponents[MULTI_BUFFER_LANES];
+        const Bigint* group_modulars[MULTI_BUFFER_LANES];
+        Bigint* group_results[MULTI_BUFFER_LANES] = { NULL }; // unused lanes get their own results
+        Bigint* reduced[MULTI_BUFFER_LANES] = { NULL };
+        Bigint* quotient = NULL;
+        size_t limb_num = 1;
+
+        /* Fill the lanes, unused lanes repeat the first operation */
+        for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++)
+        {
+            size_t idx = group + lane < count ? group + lane : group;
+
+            group_exponents[lane] = exponents[idx];
+            group_modulars[lane] = modulars[idx];
+            group_bases[lane] = bases[idx];
+
+            /* The base must be less than the modulus */
+            if (bigint_compare_abs(bases[idx], modulars[idx]) != LEFT_IS_SMALL) {
+                bigint_division_word_long(&quotient, &reduced[lane], bases[idx], modulars[idx]);
+                group_bases[lane] = reduced[lane];
+            }
+
+            /* R = 2^(26m) > N */
+            size_t bit_length = (size_t)modulars[idx]->digit_num * BITLEN_OF_WORD;
+            if ((bit_length + MULTI_BUFFER_RADIX) / MULTI_BUFFER_RADIX > limb_num)
+                limb_num = (bit_length + MULTI_BUFFER_RADIX) / MULTI_BUFFER_RADIX;
+        }
+
+        /* Hand the existing results to the used lanes */
+        for (size_t lane = 0; lane < MULTI_BUFFER_LANES && group + lane < count; lane++)
+            group_results[lane] = results[group + lane];
+
+        MultiBufferContext context;
+        multi_buffer_context_init(&context, group_modulars, limb_num);
+        multi_buffer_exponentiation(group_results, group_bases, group_exponents, &context, multiplication);
+        multi_buffer_context_free(&context);
+
+        /* Get results of the used lanes */
+        for (size_t lane = 0; lane < MULTI_BUFFER_LANES; lane++) {
+            if (group + lane < count)
+                results[group + lane] = group_results[lane];
+            else
+                bigint_delete(&group_results[lane]);
+            bigint_delete(&reduced[lane]);
+        }
+        bigint_delete(&quotient);
+    }
+}
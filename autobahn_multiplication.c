@@ -1,52 +1,27 @@
-#include "autobahn.h"
+#include "autobahn_internal.h"
 
 #pragma warning(disable: 28182)
 #pragma warning(disable: 6308)
 
+#define WORDS_KARATSUBA_THRESHOLD 32 /**< Below this many words, textbook multiplication is faster. */
+
 /**
- * @brief Performs multiplication of two words.
+ * @brief Performs multiplication of two words into a Bigint.
  *
  * @param result [out] Pointer to the resulting Bigint.
  * @param operand_x [in] First operand word.
  * @param operand_y [in] Second operand word.
  */
-static void word_multiplication(Bigint **result, const Word operand_x, const Word operand_y)
+static void word_multiplication_bigint(Bigint **result, const Word operand_x, const Word operand_y)
 {
-    Bigint *tmp_result = NULL;
-
-    /* Allocate Bigint */
-    bigint_new(&tmp_result, 2); // this will be the result
-
-    /* Initialize variables */
-    Word bitlen_half = BITLEN_OF_WORD / 2;
-    Word x_high = operand_x >> bitlen_half;           // Upper half of operand_x
-    Word x_low = (x_high << bitlen_half) ^ operand_x; // Lower half of operand_x
-    Word y_high = operand_y >> bitlen_half;           // Upper half of operand_y
-    Word y_low = (y_high << bitlen_half) ^ operand_y; // Lower half of operand_y
-
-    /* Compute high and low value */
-    tmp_result->digits[0] = x_low * y_low;   // A0B0
-    tmp_result->digits[1] = x_high * y_high; // A1B1
-
-    /* Compute middle value */
-    Word middle = x_high * y_low + y_high * x_low; // A1B0 + A0B1
-    Word carry = middle < x_high * y_low;          // set carry.
-
-    /* Divide middle value */
-    Word middle_low  = middle << bitlen_half; // Lower half of A1B0 + A0B1 : L
-    Word middle_high = (middle >> bitlen_half) + (carry << bitlen_half); // Upper half of A1B0 + A0B1, consider carry : U
+    Word digits[2];
 
-    /* Compute the result */
-    tmp_result->digits[0] += middle_low;          // A0B0 + L
-    carry = tmp_result->digits[0] < middle_low;   // set carry
-    tmp_result->digits[1] += middle_high + carry; // A1B1 + U + carry
+    /* (high||low) = x * y */
+    word_multiplication(&digits[1], &digits[0], operand_x, operand_y);
 
     /* Get result */
-    bigint_refine(tmp_result);
-    bigint_copy(result, tmp_result);
-
-    /* Free Bigint */
-    bigint_delete(&tmp_result);
+    bigint_set_by_array(result, digits, POSITIVE, 2);
+    bigint_refine(*result);
 }
 
 /**
@@ -58,6 +33,8 @@ static void word_multiplication(Bigint **result, const Word operand_x, const Wor
  */
 void bigint_multiplication_textbook(Bigint **result, const Bigint *operand_x, const Bigint *operand_y)
 {
+    PROFILE_SCOPE(PROFILE_MULTIPLICATION_TEXTBOOK, operand_x->digit_num + operand_y->digit_num);
+
     /* Special case: multiplication by zero */
     if (bigint_is_zero(operand_x) || bigint_is_zero(operand_y))
     {
@@ -73,11 +50,11 @@ void bigint_multiplication_textbook(Bigint **result, const Bigint *operand_x, co
     bigint_new(&word_mult, 2);
 
     /* Multiplication loop */
-    for (Word idx_x = 0; idx_x < operand_x->digit_num; idx_x++)
+    for (size_t idx_x = 0; idx_x < operand_x->digit_num; idx_x++)
     {
-        for (Word idx_y = 0; idx_y < operand_y->digit_num; idx_y++)
+        for (size_t idx_y = 0; idx_y < operand_y->digit_num; idx_y++)
         {
-            word_multiplication(&word_mult, operand_x->digits[idx_x], operand_y->digits[idx_y]); // Perform word multiplication
+            word_multiplication_bigint(&word_mult, operand_x->digits[idx_x], operand_y->digits[idx_y]); // Perform word multiplication
             bigint_expand(&word_mult, word_mult, idx_x + idx_y);                                 // Set correct index
             bigint_addition(&tmp_result, tmp_result, word_mult);                                 // Addition to the result
         }
@@ -104,6 +81,8 @@ void bigint_multiplication_textbook(Bigint **result, const Bigint *operand_x, co
  */
 void bigint_multiplication_karatsuba(Bigint **result, const Bigint *operand_x, const Bigint *operand_y)
 {
+    PROFILE_SCOPE(PROFILE_MULTIPLICATION_KARATSUBA, operand_x->digit_num + operand_y->digit_num);
+
     /* Special case: multiplication by zero */
     if (bigint_is_zero(operand_x) || bigint_is_zero(operand_y))
     {
@@ -112,9 +91,9 @@ void bigint_multiplication_karatsuba(Bigint **result, const Bigint *operand_x, c
     }
 
     /* Determine divide size */
-    Word digit_num_min = operand_x->digit_num < operand_y->digit_num ? operand_x->digit_num : operand_y->digit_num;
-    Word digit_num_max = operand_x->digit_num > operand_y->digit_num ? operand_x->digit_num : operand_y->digit_num;
-    Word digit_num_half = (digit_num_max + 1) >> 1;
+    size_t digit_num_min = operand_x->digit_num < operand_y->digit_num ? operand_x->digit_num : operand_y->digit_num;
+    size_t digit_num_max = operand_x->digit_num > operand_y->digit_num ? operand_x->digit_num : operand_y->digit_num;
+    size_t digit_num_half = (digit_num_max + 1) >> 1;
 
     /* Recursion stop condition */
     if (digit_num_min <= 4)
@@ -156,19 +135,19 @@ void bigint_multiplication_karatsuba(Bigint **result, const Bigint *operand_x, c
     bigint_copy(&tmp_y, operand_y);
 
     /* Store the original digit number of the input operands */
-    Word previous_digit_num_x = tmp_x->digit_num;
-    Word previous_digit_num_y = tmp_y->digit_num;
+    size_t previous_digit_num_x = tmp_x->digit_num;
+    size_t previous_digit_num_y = tmp_y->digit_num;
 
     /* Ensure both operands have the same number of digits for further processing */
-    tmp_x->digits = (Word *)realloc(tmp_x->digits, digit_num_half * 2 * SIZE_OF_WORD);
-    tmp_y->digits = (Word *)realloc(tmp_y->digits, digit_num_half * 2 * SIZE_OF_WORD);
+    tmp_x->digits = (Word *)bigint_realloc(tmp_x->digits, digit_num_half * 2 * SIZE_OF_WORD);
+    tmp_y->digits = (Word *)bigint_realloc(tmp_y->digits, digit_num_half * 2 * SIZE_OF_WORD);
     tmp_x->digit_num = digit_num_half * 2;
     tmp_y->digit_num = digit_num_half * 2;
 
     /* Initialize the added digits with zero to guard against trash values */
-    for (int i = tmp_x->digit_num; i > previous_digit_num_x; i--)
+    for (size_t i = tmp_x->digit_num; i > previous_digit_num_x; i--)
         tmp_x->digits[i - 1] = 0;
-    for (int i = tmp_y->digit_num; i > previous_digit_num_y; i--)
+    for (size_t i = tmp_y->digit_num; i > previous_digit_num_y; i--)
         tmp_y->digits[i - 1] = 0;
 
     /* Divide operands into upper and lower parts */
@@ -214,3 +193,236 @@ void bigint_multiplication_karatsuba(Bigint **result, const Bigint *operand_x, c
     bigint_delete(&tmp_y);
     bigint_delete(&tmp_result);
 }
+
+/**
+ * @brief Multiplies an array by a word and adds it: result = result + X * w.
+ *
+ * @param result [in, out] Accumulator of digit_num words.
+ * @param operand [in] Operand of digit_num words.
+ * @param digit_num [in] Number of words.
+ * @param word [in] Multiplier word.
+ * @return Word Carry word out of the accumulator.
+ */
+Word words_multiplication_addition_word(Word* result, const Word* operand, size_t digit_num, Word word)
+{
+    Word carry = 0;
+
+    for (size_t idx = 0; idx < digit_num; idx++)
+        word_multiplication_addition(&carry, &result[idx], operand[idx], word, result[idx], carry);
+
+    return carry;
+}
+
+/**
+ * @brief Multiplies an array by a word and subtracts it: result = result - X * w.
+ *
+ * @param result [in, out] Accumulator of digit_num words.
+ * @param operand [in] Operand of digit_num words.
+ * @param digit_num [in] Number of words.
+ * @param word [in] Multiplier word.
+ * @return Word Borrow word to subtract from the word above the accumulator.
+ */
+Word words_multiplication_subtraction_word(Word* result, const Word* operand, size_t digit_num, Word word)
+{
+    Word borrow = 0;
+
+    for (size_t idx = 0; idx < digit_num; idx++) {
+        Word high = 0;
+        Word low = 0;
+        word_multiplication_addition(&high, &low, operand[idx], word, borrow, 0);
+        Word difference = result[idx] - low;
+        borrow = high + (difference > result[idx]); // high < W - 1 whenever low > 0
+        result[idx] = difference;
+    }
+
+    return borrow;
+}
+
+/**
+ * @brief Returns the number of scratch words needed by words_multiplication.
+ *
+ * @param digit_num_x [in] Number of words of the first operand.
+ * @param digit_num_y [in] Number of words of the second operand.
+ * @return size_t Number of scratch words.
+ */
+size_t words_multiplication_scratch_size(size_t digit_num_x, size_t digit_num_y)
+{
+    /* Karatsuba needs 4n plus a few words per level, unbalanced chunks need 2n per step */
+    return 8 * (digit_num_x + digit_num_y) + 256;
+}
+
+/**
+ * @brief Performs textbook multiplication of two arrays.
+ *
+ * @param result [out] Result of digit_num_x + digit_num_y words, must not alias the operands.
+ * @param operand_x [in] First operand.
+ * @param digit_num_x [in] Number of words of the first operand.
+ * @param operand_y [in] Second operand.
+ * @param digit_num_y [in] Number of words of the second operand.
+ */
+static void words_multiplication_textbook(Word* result, const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y)
+{
+    memset(result, 0, (digit_num_x + digit_num_y) * SIZE_OF_WORD);
+
+    /* One row per word of Y */
+    for (size_t idx = 0; idx < digit_num_y; idx++)
+        result[digit_num_x + idx] = words_multiplication_addition_word(result + idx, operand_x, digit_num_x, operand_y[idx]);
+}
+
+/**
+ * @brief Computes result = |X0 - X1| of the two halves of an operand and returns 1 if X0 < X1.
+ *
+ * @param result [out] Result of digit_num_low words.
+ * @param operand [in] Operand of digit_num_low + digit_num_high words.
+ * @param digit_num_low [in] Number of words of the lower half X0.
+ * @param digit_num_high [in] Number of words of the upper half X1, at most digit_num_low.
+ * @return Word 1 if the difference is negative, 0 otherwise.
+ */
+static Word words_karatsuba_difference(Word* result, const Word* operand, size_t digit_num_low, size_t digit_num_high)
+{
+    const Word* low = operand;
+    const Word* high = operand + digit_num_low;
+
+    /* X0 - X1 */
+    if (words_compare(low, digit_num_low, high, digit_num_high) != LEFT_IS_SMALL) {
+        words_subtraction(result, low, digit_num_low, high, digit_num_high);
+        return 0;
+    }
+
+    /* X1 - X0, X0 fits in the words of X1 */
+    size_t digit_num = words_trim(low, digit_num_low);
+    words_subtraction(result, high, digit_num_high, low, digit_num);
+    memset(result + digit_num_high, 0, (digit_num_low - digit_num_high) * SIZE_OF_WORD);
+    return 1;
+}
+
+/**
+ * @brief Performs Karatsuba multiplication of two arrays of the same length.
+ *
+ * X * Y = X1Y1 * W^(2h) + (X0Y0 + X1Y1 - (X0 - X1)(Y0 - Y1)) * W^h + X0Y0
+ *
+ * @param result [out] Result of 2n words, must not alias the operands.
+ * @param operand_x [in] First operand of n words.
+ * @param operand_y [in] Second operand of n words.
+ * @param digit_num [in] Number of words n.
+ * @param scratch [in] Scratch words.
+ */
+static void words_multiplication_karatsuba(Word* result, const Word* operand_x, const Word* operand_y, size_t digit_num, Word* scratch)
+{
+    /* Recursion stop condition */
+    if (digit_num < WORDS_KARATSUBA_THRESHOLD) {
+        words_multiplication_textbook(result, operand_x, digit_num, operand_y, digit_num);
+        return;
+    }
+
+    size_t digit_num_low = (digit_num + 1) / 2; // h
+    size_t digit_num_high = digit_num - digit_num_low;
+    Word* difference_x = scratch;                   // |X0 - X1|, h words
+    Word* difference_y = scratch + digit_num_low;   // |Y0 - Y1|, h words
+    Word* middle = scratch + 2 * digit_num_low;     // (X0 - X1)(Y0 - Y1), 2h words
+    Word* next_scratch = scratch + 4 * digit_num_low;
+
+    /* Differences of the halves */
+    Word negative = words_karatsuba_difference(difference_x, operand_x, digit_num_low, digit_num_high);
+    negative ^= words_karatsuba_difference(difference_y, operand_y, digit_num_low, digit_num_high);
+
+    /* X0Y0, X1Y1 and |X0 - X1||Y0 - Y1| */
+    words_multiplication_karatsuba(result, operand_x, operand_y, digit_num_low, next_scratch);
+    words_multiplication_karatsuba(result + 2 * digit_num_low, operand_x + digit_num_low, operand_y + digit_num_low, digit_num_high, next_scratch);
+    words_multiplication_karatsuba(middle, difference_x, difference_y, digit_num_low, next_scratch);
+
+    /* T <- X0Y0 + X1Y1 -+ |X0 - X1||Y0 - Y1|, 2h words and a top word */
+    Word* sum = scratch; // the differences are no longer needed
+    Word top = words_addition(sum, result, 2 * digit_num_low, result + 2 * digit_num_low, 2 * digit_num_high);
+    if (negative == 1)
+        top += words_addition(sum, sum, 2 * digit_num_low, middle, 2 * digit_num_low);
+    else
+        top -= words_subtraction(sum, sum, 2 * digit_num_low, middle, 2 * digit_num_low);
+
+    /* Result <- Result + T * W^h */
+    Word* upper = result + digit_num_low;
+    size_t upper_num = 2 * digit_num - digit_num_low;
+    top += words_addition(upper, upper, 2 * digit_num_low, sum, 2 * digit_num_low);
+    words_addition(upper + 2 * digit_num_low, upper + 2 * digit_num_low, upper_num - 2 * digit_num_low, &top, 1);
+}
+
+/**
+ * @brief Multiplies two arrays, Karatsuba above WORDS_KARATSUBA_THRESHOLD words.
+ *
+ * Unbalanced operands are cut into chunks of the shorter length.
+ *
+ * @param result [out] Result of digit_num_x + digit_num_y words, must not alias the operands.
+ * @param operand_x [in] First operand.
+ * @param digit_num_x [in] Number of words of the first operand.
+ * @param operand_y [in] Second operand.
+ * @param digit_num_y [in] Number of words of the second operand.
+ * @param scratch [in] Scratch of words_multiplication_scratch_size(digit_num_x, digit_num_y) words.
+ */
+void words_multiplication(Word* result, const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y, Word* scratch)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_MULTIPLICATION, digit_num_x + digit_num_y);
+
+    /* X is the longer operand */
+    if (digit_num_x < digit_num_y) {
+        const Word* tmp_operand = operand_x;
+        size_t tmp_digit_num = digit_num_x;
+        operand_x = operand_y;
+        digit_num_x = digit_num_y;
+        operand_y = tmp_operand;
+        digit_num_y = tmp_digit_num;
+    }
+
+    /* Short operand: textbook */
+    if (digit_num_y < WORDS_KARATSUBA_THRESHOLD) {
+        words_multiplication_textbook(result, operand_x, digit_num_x, operand_y, digit_num_y);
+        return;
+    }
+
+    /* Balanced: Karatsuba */
+    if (digit_num_x == digit_num_y) {
+        words_multiplication_karatsuba(result, operand_x, operand_y, digit_num_x, scratch);
+        return;
+    }
+
+    Word* product = scratch; // chunk * Y, 2 * digit_num_y words
+    Word* next_scratch = scratch + 2 * digit_num_y;
+
+    /* Unbalanced: chunks of X times Y */
+    memset(result, 0, (digit_num_x + digit_num_y) * SIZE_OF_WORD);
+    for (size_t offset = 0; offset < digit_num_x; offset += digit_num_y)
+    {
+        size_t chunk_num = digit_num_x - offset < digit_num_y ? digit_num_x - offset : digit_num_y;
+        Word* upper = result + offset;
+
+        words_multiplication(product, operand_x + offset, chunk_num, operand_y, digit_num_y, next_scratch);
+        words_addition(upper, upper, digit_num_x + digit_num_y - offset, product, chunk_num + digit_num_y);
+    }
+}
+
+/**
+ * @brief Multiplies two Bigints with the array kernels: result = X * Y.
+ *
+ * @param result [out] Pointer to the resulting Bigint, may alias the operands.
+ * @param operand_x [in] First operand.
+ * @param operand_y [in] Second operand.
+ */
+void words_multiplication_bigint(Bigint** result, const Bigint* operand_x, const Bigint* operand_y)
+{
+    Bigint* tmp_result = NULL;
+    Word* scratch = (Word*)bigint_malloc(words_multiplication_scratch_size(operand_x->digit_num, operand_y->digit_num) * SIZE_OF_WORD);
+
+    /* Multiply */
+    bigint_new(&tmp_result, operand_x->digit_num + operand_y->digit_num);
+    words_multiplication(tmp_result->digits, operand_x->digits, operand_x->digit_num, operand_y->digits, operand_y->digit_num, scratch);
+    tmp_result->sign = (operand_x->sign == operand_y->sign) ? POSITIVE : NEGATIVE;
+
+    /* Get result, zero is always positive */
+    bigint_refine(tmp_result);
+    if (bigint_is_zero(tmp_result))
+        tmp_result->sign = POSITIVE;
+    bigint_delete(result);
+    *result = tmp_result;
+
+    /* Free memory */
+    bigint_free(scratch);
+}
@@ -0,0 +1,984 @@
+#include "autobahn_internal.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define PRIME_TABLE_BOUND   65536 /**< Odd primes below this bound are tabulated. */
+#define PRIME_TABLE_SIZE    6541  /**< Number of odd primes below PRIME_TABLE_BOUND. */
+#define PRIME_SIEVE_BOUND   4096  /**< Primes below this bound sieve the candidate window, the others go into the GCD product. */
+#define PRIME_PRODUCT_RATIO 16    /**< The GCD product has about this many times the bits of a candidate. */
+#define PRIME_WINDOW_SIZE   4096  /**< Number of candidates sieved at once. */
+#define PRIME_SMALL_BITS    32    /**< Up to this many bits, trial division by the table decides primality. */
+#define PRIME_TEST_VALUES   9     /**< Values of n words in PrimeTest.buffer, before the exponentiation scratch. */
+
+/** @brief Odd primes below PRIME_TABLE_BOUND, built once. */
+static uint16_t prime_table[PRIME_TABLE_SIZE];
+static size_t prime_sieve_num; /**< Number of table primes below PRIME_SIEVE_BOUND. */
+static pthread_once_t prime_table_once = PTHREAD_ONCE_INIT;
+
+/** @brief Pre-computed values of a candidate, shared by the Miller-Rabin rounds and the Lucas test. */
+typedef struct {
+    ModularContext* context; /**< Modular context of the candidate N. */
+    Word* odd_part;          /**< d with N - 1 = d * 2^s. */
+    size_t odd_part_num;     /**< Number of words of d. */
+    size_t two_power;        /**< s. */
+    Word* minus_one;         /**< N - 1 in the Montgomery form. */
+    Word* buffer;            /**< Values of n words and the exponentiation scratch. */
+} PrimeTest;
+
+/** @brief Candidate search over windows of start + step * k. */
+typedef struct {
+    const Bigint* start;          /**< First candidate, odd. */
+    Word step;                    /**< 2, or 4 for safe primes. */
+    size_t bit_length;            /**< Candidates are kept below 2^bit_length, 0 for no limit. */
+    bool is_safe;                 /**< Also require (N - 1) / 2 to be prime. */
+    size_t round_num;             /**< Miller-Rabin rounds with random bases. */
+    Bigint* product;              /**< Product of the table primes above PRIME_SIEVE_BOUND. */
+    atomic_bool found;            /**< Set once a worker found a prime. */
+    Bigint** results;             /**< Prime found in each window, or NULL. */
+    RandomFill random_fill;       /**< Random source of the caller, NULL for the default generator. */
+    void* random_state;           /**< State of the caller's random source. */
+    pthread_mutex_t random_mutex; /**< Serializes the draws of a batch from the caller's source. */
+} PrimeSearch;
+
+/**
+ * @brief Builds the table of odd primes with the sieve of Eratosthenes.
+ */
+static void prime_table_init(void)
+{
+    uint8_t* is_composite = (uint8_t*)bigint_calloc(PRIME_TABLE_BOUND, 1);
+    size_t prime_num = 0;
+
+    for (uint32_t value = 3; value < PRIME_TABLE_BOUND; value += 2)
+    {
+        if (is_composite[value] == 1)
+            continue;
+
+        prime_table[prime_num++] = (uint16_t)value;
+        if (value < PRIME_SIEVE_BOUND)
+            prime_sieve_num = prime_num;
+        for (uint32_t multiple = value * value; multiple < PRIME_TABLE_BOUND; multiple += 2 * value)
+            is_composite[multiple] = 1;
+    }
+
+    bigint_free(is_composite);
+}
+
+/**
+ * @brief Sets a fixed-width array to a small value.
+ *
+ * @param digits [out] Array of digit_num words.
+ * @param digit_num [in] Number of words.
+ * @param value [in] Value.
+ */
+static void prime_words_set_small(Word* digits, size_t digit_num, uint64_t value)
+{
+    for (size_t idx = 0; idx < digit_num; idx++) {
+        digits[idx] = (Word)value;
+        value >>= BITLEN_OF_WORD / 2; // two half shifts, a full shift is undefined for 64-bit words
+        value >>= BITLEN_OF_WORD / 2;
+    }
+}
+
+/**
+ * @brief Adds a small value to a fixed-width array.
+ *
+ * @param digits [in, out] Array of digit_num words.
+ * @param digit_num [in] Number of words.
+ * @param value [in] Value to add.
+ * @return Word Carry out of the top word.
+ */
+static Word prime_words_add_small(Word* digits, size_t digit_num, uint64_t value)
+{
+    Word carry = 0;
+
+    for (size_t idx = 0; idx < digit_num; idx++) {
+        Word addend = (Word)value;
+        digits[idx] += addend;
+        Word next_carry = (digits[idx] < addend);
+        digits[idx] += carry;
+        carry = next_carry + (digits[idx] < carry);
+        value >>= BITLEN_OF_WORD / 2;
+        value >>= BITLEN_OF_WORD / 2;
+    }
+
+    return carry;
+}
+
+/**
+ * @brief Returns the remainder of an array modulo a small odd prime.
+ *
+ * @param digits [in] Array of words.
+ * @param digit_num [in] Number of words.
+ * @param prime [in] Prime below 2^16.
+ * @return uint32_t Remainder.
+ */
+static uint32_t prime_residue(const Word* digits, size_t digit_num, uint32_t prime)
+{
+    uint64_t radix = 256 % prime; // W mod p, by squaring 2^8
+    uint64_t residue = 0;
+
+    for (Word bit_length = 8; bit_length < BITLEN_OF_WORD; bit_length *= 2)
+        radix = radix * radix % prime;
+
+    /* Horner from the top word */
+    for (size_t idx = digit_num; idx-- > 0;)
+        residue = (residue * radix + digits[idx] % prime) % prime;
+
+    return (uint32_t)residue;
+}
+
+/**
+ * @brief Computes the Jacobi symbol (a / m) of two small values.
+ *
+ * @param numerator [in] a.
+ * @param modular [in] Odd m.
+ * @return int -1, 0 or 1.
+ */
+static int prime_jacobi_small(uint32_t numerator, uint32_t modular)
+{
+    int result = 1;
+
+    numerator %= modular;
+    while (numerator != 0)
+    {
+        /* (2 / m) = -1 iff m = 3, 5 mod 8 */
+        while ((numerator & 1) == 0) {
+            numerator >>= 1;
+            if ((modular & 7) == 3 || (modular & 7) == 5)
+                result = -result;
+        }
+
+        /* Reciprocity, the sign flips iff both are 3 mod 4 */
+        uint32_t tmp = numerator;
+        numerator = modular;
+        modular = tmp;
+        if ((numerator & 3) == 3 && (modular & 3) == 3)
+            result = -result;
+        numerator %= modular;
+    }
+
+    return modular == 1 ? result : 0;
+}
+
+/**
+ * @brief Checks whether a non-negative Bigint is a perfect square.
+ *
+ * @param operand [in] Operand.
+ * @return bool True if the operand is a square.
+ */
+static bool prime_is_square(const Bigint* operand)
+{
+    Bigint* root = NULL;
+    Bigint* remainder = NULL;
+
+    bigint_sqrtrem(&root, &remainder, operand);
+    bool is_square = (bigint_is_zero(remainder) == TRUE);
+
+    bigint_delete(&root);
+    bigint_delete(&remainder);
+
+    return is_square;
+}
+
+/**
+ * @brief Checks a small non-negative Bigint by trial division with the table.
+ *
+ * @param candidate [in] Candidate below 2^PRIME_SMALL_BITS.
+ * @return bool True if the candidate is prime.
+ */
+static bool prime_is_prime_small(const Bigint* candidate)
+{
+    uint64_t value = 0;
+
+    for (size_t idx = candidate->digit_num; idx-- > 0;) {
+        value <<= BITLEN_OF_WORD / 2;
+        value <<= BITLEN_OF_WORD / 2;
+        value |= candidate->digits[idx];
+    }
+
+    if (value < 2)
+        return false;
+    if (value % 2 == 0)
+        return value == 2;
+
+    for (size_t idx = 0; idx < PRIME_TABLE_SIZE && (uint64_t)prime_table[idx] * prime_table[idx] <= value; idx++)
+        if (value % prime_table[idx] == 0)
+            return false;
+
+    return true;
+}
+
+/**
+ * @brief Returns the bit length of a Bigint.
+ *
+ * @param bigint [in] Bigint.
+ * @return size_t Number of significant bits.
+ */
+static size_t prime_bit_length(const Bigint* bigint)
+{
+    size_t digit_num = words_trim(bigint->digits, bigint->digit_num);
+
+    if (digit_num == 0)
+        return 0;
+
+    return (digit_num - 1) * BITLEN_OF_WORD + word_bit_length(bigint->digits[digit_num - 1]);
+}
+
+/**
+ * @brief Computes result = X + Y mod N on fixed-width arrays.
+ *
+ * @param result [out] Result of n words, may alias the operands.
+ * @param operand_x [in] X of n words, less than N.
+ * @param operand_y [in] Y of n words, less than N.
+ * @param context [in] Modular context.
+ */
+static void prime_mod_addition(Word* result, const Word* operand_x, const Word* operand_y, const ModularContext* context)
+{
+    size_t digit_num = context->digit_num;
+    Word carry = words_addition(result, operand_x, digit_num, operand_y, digit_num);
+
+    if (carry != 0 || words_compare(result, digit_num, context->modular->digits, digit_num) != LEFT_IS_SMALL)
+        words_subtraction(result, result, digit_num, context->modular->digits, digit_num);
+}
+
+/**
+ * @brief Computes result = X - Y mod N on fixed-width arrays.
+ *
+ * @param result [out] Result of n words, may alias the operands.
+ * @param operand_x [in] X of n words, less than N.
+ * @param operand_y [in] Y of n words, less than N.
+ * @param context [in] Modular context.
+ */
+static void prime_mod_subtraction(Word* result, const Word* operand_x, const Word* operand_y, const ModularContext* context)
+{
+    size_t digit_num = context->digit_num;
+    Word borrow = words_subtraction(result, operand_x, digit_num, operand_y, digit_num);
+
+    if (borrow != 0)
+        words_addition(result, result, digit_num, context->modular->digits, digit_num);
+}
+
+/**
+ * @brief Computes result = X / 2 mod N on fixed-width arrays, N odd.
+ *
+ * @param result [out] Result of n words, may alias the operand.
+ * @param operand [in] X of n words, less than N.
+ * @param context [in] Modular context.
+ */
+static void prime_mod_half(Word* result, const Word* operand, const ModularContext* context)
+{
+    size_t digit_num = context->digit_num;
+    Word carry = 0;
+
+    /* X + N is even if X is odd */
+    if (GET_BIT(operand[0], 0) == 1)
+        carry = words_addition(result, operand, digit_num, context->modular->digits, digit_num);
+    else if (result != operand)
+        memcpy(result, operand, digit_num * SIZE_OF_WORD);
+
+    for (size_t idx = 0; idx < digit_num; idx++) {
+        Word upper = idx + 1 < digit_num ? result[idx + 1] : carry;
+        result[idx] = (result[idx] >> 1) | (upper << (BITLEN_OF_WORD - 1));
+    }
+}
+
+/**
+ * @brief Pre-computes the values of a candidate shared by the Miller-Rabin rounds and the Lucas test.
+ *
+ * @param test [out] Candidate values.
+ * @param candidate [in] Odd candidate N greater than 3.
+ */
+static void prime_test_new(PrimeTest* test, const Bigint* candidate)
+{
+    size_t digit_num = candidate->digit_num;
+
+    test->context = NULL;
+    bigint_modular_context_new(&test->context, candidate);
+
+    /* N - 1 = d * 2^s, N is odd so the lowest bit of N - 1 is clear */
+    test->odd_part = (Word*)bigint_calloc(digit_num, SIZE_OF_WORD);
+    memcpy(test->odd_part, candidate->digits, digit_num * SIZE_OF_WORD);
+    test->odd_part[0] ^= 1;
+    test->two_power = 0;
+    while (GET_BIT(test->odd_part[test->two_power / BITLEN_OF_WORD], test->two_power % BITLEN_OF_WORD) == 0)
+        test->two_power++;
+    for (size_t shift = 0; shift < test->two_power; shift++)
+        for (size_t idx = 0; idx < digit_num; idx++)
+            test->odd_part[idx] = (test->odd_part[idx] >> 1) | (idx + 1 < digit_num ? test->odd_part[idx + 1] << (BITLEN_OF_WORD - 1) : 0);
+    test->odd_part_num = words_trim(test->odd_part, digit_num);
+
+    /* -1 = N - (R mod N) in the Montgomery form */
+    test->minus_one = (Word*)bigint_calloc(digit_num, SIZE_OF_WORD);
+    words_subtraction(test->minus_one, candidate->digits, digit_num, test->context->one, digit_num);
+
+    /* Values of n words, then the exponentiation scratch */
+    size_t scratch_size = words_exponentiation_scratch_size(digit_num, digit_num);
+    test->buffer = (Word*)bigint_calloc(PRIME_TEST_VALUES * digit_num + 1 + scratch_size, SIZE_OF_WORD);
+}
+
+/**
+ * @brief Deallocates the values of a candidate.
+ *
+ * @param test [in, out] Candidate values.
+ */
+static void prime_test_delete(PrimeTest* test)
+{
+    bigint_modular_context_delete(&test->context);
+    bigint_free(test->odd_part);
+    bigint_free(test->minus_one);
+    bigint_free(test->buffer);
+}
+
+/**
+ * @brief Performs one Miller-Rabin round.
+ *
+ * @param test [in] Candidate values.
+ * @param base [in] Base of n words in [2, N - 2].
+ * @return bool True if N is a strong probable prime to the base.
+ */
+static bool prime_miller_rabin(const PrimeTest* test, const Word* base)
+{
+    const ModularContext* context = test->context;
+    size_t digit_num = context->digit_num;
+    Word* power = test->buffer;
+    Word* scratch = test->buffer + PRIME_TEST_VALUES * digit_num + 1;
+
+    /* x = a^d, constant time since the candidate may become a secret prime */
+    words_exponentiation_fixed_window(power, base, test->odd_part, test->odd_part_num, context, scratch);
+    words_montgomery_to_form(power, power, context, scratch);
+
+    if (words_compare(power, digit_num, context->one, digit_num) == SAME || words_compare(power, digit_num, test->minus_one, digit_num) == SAME)
+        return true;
+
+    /* x <- x^2 up to s - 1 times, looking for -1 */
+    for (size_t idx = 1; idx < test->two_power; idx++)
+    {
+        words_montgomery_multiplication(power, power, power, context, scratch);
+
+        if (words_compare(power, digit_num, test->minus_one, digit_num) == SAME)
+            return true;
+        if (words_compare(power, digit_num, context->one, digit_num) == SAME)
+            return false; // non-trivial square root of one
+    }
+
+    return false;
+}
+
+/**
+ * @brief Sets a fixed-width array to a small signed value modulo N, in the Montgomery form.
+ *
+ * @param result [out] Result of n words.
+ * @param value [in] Small signed value.
+ * @param context [in] Modular context.
+ * @param scratch [in] Scratch of words_montgomery_scratch_size(n) words.
+ */
+static void prime_set_small_form(Word* result, int64_t value, const ModularContext* context, Word* scratch)
+{
+    size_t digit_num = context->digit_num;
+
+    prime_words_set_small(result, digit_num, (uint64_t)(value < 0 ? -value : value));
+    if (value < 0)
+        words_subtraction(result, context->modular->digits, digit_num, result, digit_num);
+    words_montgomery_to_form(result, result, context, scratch);
+}
+
+/**
+ * @brief Performs the strong Lucas probable prime test with the Selfridge parameters.
+ *
+ * D is the first of 5, -7, 9, -11, ... with (D / N) = -1, P = 1 and Q = (1 - D) / 4.
+ *
+ * @param test [in] Candidate values.
+ * @param candidate [in] Odd candidate N without factors below PRIME_TABLE_BOUND.
+ * @return bool True if N is a strong Lucas probable prime.
+ */
+static bool prime_lucas(const PrimeTest* test, const Bigint* candidate)
+{
+    const ModularContext* context = test->context;
+    size_t digit_num = context->digit_num;
+    int64_t parameter_d = 5;
+
+    /* Selfridge: (D / N) = (|D| / N) (-1 / N)^[D < 0], then reciprocity for the odd |D| */
+    for (size_t tries = 0;; tries++)
+    {
+        uint32_t magnitude = (uint32_t)(parameter_d < 0 ? -parameter_d : parameter_d);
+        uint32_t residue = prime_residue(candidate->digits, digit_num, magnitude);
+        int symbol = prime_jacobi_small(residue, magnitude);
+        bool candidate_is_3_mod_4 = (candidate->digits[0] & 3) == 3;
+
+        if (candidate_is_3_mod_4 == true && (magnitude & 3) == 3)
+            symbol = -symbol; // reciprocity
+        if (parameter_d < 0 && candidate_is_3_mod_4 == true)
+            symbol = -symbol; // (-1 / N)
+
+        if (symbol == -1)
+            break;
+        if (symbol == 0)
+            return false; // |D| shares a factor with N, which is larger than |D|
+
+        /* No such D exists for a square */
+        if (tries == 8 && prime_is_square(candidate) == true)
+            return false;
+
+        parameter_d = parameter_d > 0 ? -(parameter_d + 2) : -parameter_d + 2;
+    }
+
+    /* Values of n words, in the Montgomery form */
+    Word* lucas_u = test->buffer;
+    Word* lucas_v = lucas_u + digit_num;
+    Word* power_q = lucas_v + digit_num;     // Q^k
+    Word* value_q = power_q + digit_num;
+    Word* value_d = value_q + digit_num;
+    Word* tmp = value_d + digit_num;
+    Word* exponent = tmp + digit_num;        // d with N + 1 = d * 2^s, n + 1 words
+    Word* scratch = test->buffer + PRIME_TEST_VALUES * digit_num + 1;
+
+    prime_set_small_form(value_q, (1 - parameter_d) / 4, context, scratch);
+    prime_set_small_form(value_d, parameter_d, context, scratch);
+
+    /* N + 1 = d * 2^s */
+    memcpy(exponent, candidate->digits, digit_num * SIZE_OF_WORD);
+    exponent[digit_num] = prime_words_add_small(exponent, digit_num, 1);
+    size_t two_power = 0;
+    while (GET_BIT(exponent[two_power / BITLEN_OF_WORD], two_power % BITLEN_OF_WORD) == 0)
+        two_power++;
+    for (size_t shift = 0; shift < two_power; shift++)
+        for (size_t idx = 0; idx <= digit_num; idx++)
+            exponent[idx] = (exponent[idx] >> 1) | (idx < digit_num ? exponent[idx + 1] << (BITLEN_OF_WORD - 1) : 0);
+    size_t exponent_num = words_trim(exponent, digit_num + 1);
+
+    /* U_1 = 1, V_1 = P = 1, Q^1 = Q */
+    memcpy(lucas_u, context->one, digit_num * SIZE_OF_WORD);
+    memcpy(lucas_v, context->one, digit_num * SIZE_OF_WORD);
+    memcpy(power_q, value_q, digit_num * SIZE_OF_WORD);
+
+    /* Left-to-right over the bits of d below the top one */
+    size_t bit_idx = (exponent_num - 1) * BITLEN_OF_WORD + word_bit_length(exponent[exponent_num - 1]) - 1;
+    while (bit_idx-- > 0)
+    {
+        /* k -> 2k: U = U V, V = V^2 - 2 Q^k, Q^k = (Q^k)^2 */
+        words_montgomery_multiplication(lucas_u, lucas_u, lucas_v, context, scratch);
+        words_montgomery_multiplication(lucas_v, lucas_v, lucas_v, context, scratch);
+        prime_mod_subtraction(lucas_v, lucas_v, power_q, context);
+        prime_mod_subtraction(lucas_v, lucas_v, power_q, context);
+        words_montgomery_multiplication(power_q, power_q, power_q, context, scratch);
+
+        /* k -> k + 1: U = (U + V) / 2, V = (D U + V) / 2, Q^k = Q^k Q */
+        if (GET_BIT(exponent[bit_idx / BITLEN_OF_WORD], bit_idx % BITLEN_OF_WORD) == 1) {
+            words_montgomery_multiplication(tmp, value_d, lucas_u, context, scratch);
+            prime_mod_addition(lucas_u, lucas_u, lucas_v, context);
+            prime_mod_half(lucas_u, lucas_u, context);
+            prime_mod_addition(lucas_v, tmp, lucas_v, context);
+            prime_mod_half(lucas_v, lucas_v, context);
+            words_montgomery_multiplication(power_q, power_q, value_q, context, scratch);
+        }
+    }
+
+    /* Strong test: U_d = 0, or V_(d 2^r) = 0 for some r < s */
+    if (words_trim(lucas_u, digit_num) == 0 || words_trim(lucas_v, digit_num) == 0)
+        return true;
+
+    for (size_t idx = 1; idx < two_power; idx++)
+    {
+        words_montgomery_multiplication(lucas_v, lucas_v, lucas_v, context, scratch);
+        prime_mod_subtraction(lucas_v, lucas_v, power_q, context);
+        prime_mod_subtraction(lucas_v, lucas_v, power_q, context);
+        if (words_trim(lucas_v, digit_num) == 0)
+            return true;
+        words_montgomery_multiplication(power_q, power_q, power_q, context, scratch);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Runs Baillie-PSW and Miller-Rabin rounds with random bases on a candidate without small factors.
+ *
+ * @param candidate [in] Odd candidate above 2^PRIME_SMALL_BITS.
+ * @param round_num [in] Number of Miller-Rabin rounds with random bases.
+ * @return bool True if the candidate is a probable prime.
+ */
+static bool prime_test_candidate(const Bigint* candidate, size_t round_num)
+{
+    PrimeTest test;
+    size_t digit_num = candidate->digit_num;
+    bool is_prime = false;
+
+    prime_test_new(&test, candidate);
+    Word* base = test.buffer + (PRIME_TEST_VALUES - 1) * digit_num + 1; // after the values of the Lucas test
+
+    /* Baillie-PSW: Miller-Rabin to base 2, then strong Lucas */
+    prime_words_set_small(base, digit_num, 2);
+    if (prime_miller_rabin(&test, base) == false || prime_lucas(&test, candidate) == false)
+        goto END;
+
+    /* Random bases in [2, N - 2] */
+    for (size_t round = 0; round < round_num; round++)
+    {
+        Bigint* random = NULL;
+        bigint_random_below(&random, candidate);
+        words_reduce_operand(base, random, test.context);
+        bigint_delete(&random);
+
+        if (words_trim(base, digit_num) <= 1 && base[0] < 2)
+            base[0] = 2;
+        if (prime_miller_rabin(&test, base) == false)
+            goto END;
+    }
+    is_prime = true;
+
+END:
+    prime_test_delete(&test);
+    return is_prime;
+}
+
+/**
+ * @brief Tests whether a non-negative integer is a probable prime.
+ *
+ * Values below 2^32 are decided exactly by trial division. Larger values are checked by trial division
+ * with the sieve primes, Baillie-PSW (Miller-Rabin to base 2 and the strong Lucas test), and round_num further Miller-Rabin rounds
+ * with random bases. No Baillie-PSW pseudoprime is known.
+ *
+ * @param candidate [in] Candidate, negative values are not prime.
+ * @param round_num [in] Number of Miller-Rabin rounds with random bases, 0 for Baillie-PSW alone.
+ * @return bool True if the candidate is a probable prime.
+ */
+bool bigint_is_probable_prime(const Bigint* candidate, size_t round_num)
+{
+    PROFILE_SCOPE(PROFILE_IS_PROBABLE_PRIME, candidate->digit_num);
+
+    pthread_once(&prime_table_once, prime_table_init);
+
+    if (candidate->sign == NEGATIVE)
+        return false;
+
+    if (prime_bit_length(candidate) <= PRIME_SMALL_BITS)
+        return prime_is_prime_small(candidate);
+
+    if (GET_BIT(candidate->digits[0], 0) == 0)
+        return false;
+
+    /* Trial division by the sieve primes, larger factors are cheaper to find with Miller-Rabin */
+    size_t digit_num = words_trim(candidate->digits, candidate->digit_num);
+    for (size_t idx = 0; idx < prime_sieve_num; idx++)
+        if (prime_residue(candidate->digits, digit_num, prime_table[idx]) == 0)
+            return false;
+
+    Bigint view = *candidate;
+    view.digit_num = digit_num;
+    return prime_test_candidate(&view, round_num);
+}
+
+/**
+ * @brief Multiplies the table primes [first, last) with a product tree.
+ *
+ * @param product [out] Product.
+ * @param first [in] Index of the first prime.
+ * @param last [in] Index past the last prime.
+ */
+static void prime_product(Bigint** product, size_t first, size_t last)
+{
+    if (last - first == 1) {
+        Word digits[16 / BITLEN_OF_WORD + 1];
+        prime_words_set_small(digits, 16 / BITLEN_OF_WORD + 1, prime_table[first]);
+        bigint_set_by_array(product, digits, POSITIVE, 16 / BITLEN_OF_WORD + 1);
+        bigint_refine(*product);
+        return;
+    }
+
+    Bigint* left = NULL;
+    Bigint* right = NULL;
+    size_t middle = first + (last - first) / 2;
+
+    prime_product(&left, first, middle);
+    prime_product(&right, middle, last);
+    words_multiplication_bigint(product, left, right);
+
+    bigint_delete(&left);
+    bigint_delete(&right);
+}
+
+/**
+ * @brief Prepares a candidate search: the GCD product sized to the candidates.
+ *
+ * @param search [out] Candidate search.
+ * @param start [in] First candidate, odd.
+ * @param step [in] Distance between candidates.
+ * @param bit_length [in] Candidates are kept below 2^bit_length, 0 for no limit.
+ * @param is_safe [in] Search safe primes.
+ * @param round_num [in] Miller-Rabin rounds with random bases.
+ */
+static void prime_search_new(PrimeSearch* search, const Bigint* start, Word step, size_t bit_length, bool is_safe, size_t round_num)
+{
+    search->start = start;
+    search->step = step;
+    search->bit_length = bit_length;
+    search->is_safe = is_safe;
+    search->round_num = round_num;
+    search->product = NULL;
+    search->results = NULL;
+    atomic_init(&search->found, false);
+    bigint_random_get_source(&search->random_fill, &search->random_state);
+
+    /* Primes after the sieve bound, until the product has the target size in bits */
+    size_t target_bit = prime_bit_length(start) * PRIME_PRODUCT_RATIO;
+    size_t product_bit = 0;
+    size_t last = prime_sieve_num;
+
+    while (last < PRIME_TABLE_SIZE && product_bit + 16 <= target_bit)
+        for (uint32_t value = prime_table[last++]; value != 0; value >>= 1)
+            product_bit++;
+
+    if (last > prime_sieve_num)
+        prime_product(&search->product, prime_sieve_num, last);
+}
+
+/**
+ * @brief Deallocates a candidate search.
+ *
+ * @param search [in, out] Candidate search.
+ */
+static void prime_search_delete(PrimeSearch* search)
+{
+    bigint_delete(&search->product);
+}
+
+/**
+ * @brief Checks that a candidate has no factor in the GCD product.
+ *
+ * @param search [in] Candidate search.
+ * @param candidate [in] Candidate.
+ * @return bool True if gcd(candidate, product) = 1.
+ */
+static bool prime_search_coprime(const PrimeSearch* search, const Bigint* candidate)
+{
+    if (search->product == NULL)
+        return true;
+
+    Bigint* gcd = NULL;
+    bigint_gcd(&gcd, candidate, search->product);
+    bool is_coprime = (gcd->digit_num == 1 && gcd->digits[0] == 1);
+    bigint_delete(&gcd);
+
+    return is_coprime;
+}
+
+/**
+ * @brief Fully tests a sieved candidate, and (N - 1) / 2 for a safe prime.
+ *
+ * @param search [in] Candidate search.
+ * @param candidate [in] Candidate N, odd, without factors below PRIME_SIEVE_BOUND.
+ * @return bool True if the candidate is accepted.
+ */
+static bool prime_search_accept(const PrimeSearch* search, const Bigint* candidate)
+{
+    if (search->is_safe == false)
+        return prime_search_coprime(search, candidate) && prime_test_candidate(candidate, search->round_num);
+
+    Bigint* half = NULL;
+    bool is_accepted = false;
+
+    bigint_compress_one_bit(&half, candidate); // (N - 1) / 2 as N is odd
+    bigint_refine(half);
+
+    /* Cheap rejections first: both GCDs, then both base-2 rounds within the full tests */
+    if (prime_search_coprime(search, candidate) && prime_search_coprime(search, half))
+        is_accepted = prime_test_candidate(half, search->round_num) && prime_test_candidate(candidate, search->round_num);
+
+    bigint_delete(&half);
+    return is_accepted;
+}
+
+/**
+ * @brief Sieves one window of candidates start + step * (window_idx * PRIME_WINDOW_SIZE + k) and tests the survivors.
+ *
+ * A candidate is struck out if a sieve prime divides it, or for a safe prime if it divides (N - 1) / 2,
+ * that is N = 1 mod p. The residues of the window base are computed once per window.
+ *
+ * @param result [out] First accepted candidate of the window.
+ * @param search [in, out] Candidate search.
+ * @param window_idx [in] Index of the window.
+ * @return bool True if a candidate was accepted.
+ */
+static bool prime_search_window(Bigint** result, PrimeSearch* search, size_t window_idx)
+{
+    uint8_t* is_struck = (uint8_t*)bigint_calloc(PRIME_WINDOW_SIZE, 1);
+    Bigint* candidate = NULL;
+    size_t digit_num = search->start->digit_num + 1;
+    bool is_found = false;
+
+    /* Window base, one spare word for the carry */
+    bigint_new(&candidate, digit_num);
+    memcpy(candidate->digits, search->start->digits, search->start->digit_num * SIZE_OF_WORD);
+    prime_words_add_small(candidate->digits, digit_num, (uint64_t)search->step * PRIME_WINDOW_SIZE * window_idx);
+    Word* base = (Word*)bigint_malloc(digit_num * SIZE_OF_WORD);
+    memcpy(base, candidate->digits, digit_num * SIZE_OF_WORD);
+
+    /* Strike out k with base + step * k = 0 (or 1 for safe primes) mod p */
+    for (size_t idx = 0; idx < prime_sieve_num; idx++)
+    {
+        uint32_t prime = prime_table[idx];
+        uint32_t residue = prime_residue(base, digit_num, prime);
+        uint32_t step_inverse = (prime + 1) / 2; // 2^(-1) mod p
+        if (search->step == 4)
+            step_inverse = (uint32_t)((uint64_t)step_inverse * step_inverse % prime);
+
+        for (uint32_t target = 0; target <= (search->is_safe ? 1u : 0u); target++) {
+            uint32_t first = (uint32_t)((uint64_t)(target + prime - residue) % prime * step_inverse % prime);
+            for (size_t offset = first; offset < PRIME_WINDOW_SIZE; offset += prime)
+                is_struck[offset] = 1;
+        }
+    }
+
+    /* Test the survivors in order */
+    for (size_t offset = 0; offset < PRIME_WINDOW_SIZE && is_found == false; offset++)
+    {
+        if (atomic_load(&search->found) == true)
+            break;
+        if (is_struck[offset] == 1)
+            continue;
+
+        memcpy(candidate->digits, base, digit_num * SIZE_OF_WORD);
+        prime_words_add_small(candidate->digits, digit_num, (uint64_t)search->step * offset);
+
+        Bigint view = *candidate;
+        view.digit_num = words_trim(candidate->digits, digit_num);
+        if (search->bit_length != 0 && prime_bit_length(&view) > search->bit_length)
+            break;
+
+        if (prime_search_accept(search, &view) == true) {
+            bigint_set_by_array(result, view.digits, POSITIVE, view.digit_num);
+            atomic_store(&search->found, true);
+            is_found = true;
+        }
+    }
+
+    bigint_free(is_struck);
+    bigint_free(base);
+    bigint_delete(&candidate);
+
+    return is_found;
+}
+
+/**
+ * @brief RandomFill of the workers of a batch, draws from the caller's source one worker at a time.
+ *
+ * @param state [in] Candidate search of the batch.
+ * @param buffer [out] Buffer.
+ * @param byte_num [in] Number of bytes.
+ */
+static void prime_search_random_fill(void* state, void* buffer, size_t byte_num)
+{
+    PrimeSearch* search = (PrimeSearch*)state;
+
+    pthread_mutex_lock(&search->random_mutex);
+    search->random_fill(search->random_state, buffer, byte_num);
+    pthread_mutex_unlock(&search->random_mutex);
+}
+
+/**
+ * @brief Searches one window per task, so the windows of a batch are sieved and tested in parallel.
+ *
+ * Miller-Rabin bases come from the caller's source when it set one, workers keep their own
+ * default generator otherwise.
+ *
+ * @param argument [in] Candidate search.
+ * @param task_idx [in] Index of the window in the batch.
+ * @param worker_idx [in] Index of the worker, unused.
+ */
+static void prime_search_task(void* argument, size_t task_idx, size_t worker_idx)
+{
+    PrimeSearch* search = (PrimeSearch*)argument;
+    RandomFill worker_fill = NULL;
+    void* worker_state = NULL;
+    (void)worker_idx;
+
+    if (search->random_fill != NULL) {
+        bigint_random_get_source(&worker_fill, &worker_state);
+        bigint_random_set_source(prime_search_random_fill, search);
+    }
+
+    prime_search_window(&search->results[task_idx], search, task_idx);
+
+    if (search->random_fill != NULL)
+        bigint_random_set_source(worker_fill, worker_state);
+}
+
+/**
+ * @brief Searches windows from the start on until a prime is accepted or the bit length is exceeded.
+ *
+ * @param result [out] Accepted prime.
+ * @param search [in, out] Candidate search.
+ * @param pool [in] Thread pool, or NULL to search on the calling thread.
+ * @return bool True if a prime was accepted.
+ */
+static bool prime_search_run(Bigint** result, PrimeSearch* search, ThreadPool* pool)
+{
+    size_t window_num = pool != NULL ? bigint_thread_pool_size(pool) : 1;
+    size_t window_first = 0;
+
+    while (true)
+    {
+        /* Beyond the bit length: no candidate is left */
+        Bigint* first = NULL;
+        bigint_new(&first, search->start->digit_num + 1);
+        memcpy(first->digits, search->start->digits, search->start->digit_num * SIZE_OF_WORD);
+        prime_words_add_small(first->digits, first->digit_num, (uint64_t)search->step * PRIME_WINDOW_SIZE * window_first);
+        bigint_refine(first);
+        bool is_exhausted = (search->bit_length != 0 && prime_bit_length(first) > search->bit_length);
+        bigint_delete(&first);
+        if (is_exhausted)
+            return false;
+
+        /* One batch of windows */
+        if (pool == NULL) {
+            if (prime_search_window(result, search, window_first) == true)
+                return true;
+        }
+        else
+        {
+            PrimeSearch batch = *search;
+            Bigint* start = NULL;
+            bool is_found = false;
+
+            /* The batch starts at its first window */
+            bigint_new(&start, search->start->digit_num + 1);
+            memcpy(start->digits, search->start->digits, search->start->digit_num * SIZE_OF_WORD);
+            prime_words_add_small(start->digits, start->digit_num, (uint64_t)search->step * PRIME_WINDOW_SIZE * window_first);
+            bigint_refine(start);
+            batch.start = start;
+            batch.results = (Bigint**)bigint_calloc(window_num, sizeof(Bigint*));
+            atomic_init(&batch.found, false);
+            pthread_mutex_init(&batch.random_mutex, NULL);
+
+            bigint_thread_pool_run(pool, prime_search_task, &batch, window_num);
+            pthread_mutex_destroy(&batch.random_mutex);
+
+            /* Lowest window with a prime */
+            for (size_t idx = 0; idx < window_num; idx++) {
+                if (batch.results[idx] != NULL && is_found == false) {
+                    bigint_copy(result, batch.results[idx]);
+                    is_found = true;
+                }
+                bigint_delete(&batch.results[idx]);
+            }
+            bigint_free(batch.results);
+            bigint_delete(&start);
+
+            if (is_found == true)
+                return true;
+        }
+
+        window_first += window_num;
+    }
+}
+
+/**
+ * @brief Finds the smallest probable prime greater than a given value.
+ *
+ * @param result [out] Smallest probable prime greater than start.
+ * @param start [in] Starting value, may be negative.
+ * @param round_num [in] Number of Miller-Rabin rounds with random bases per candidate.
+ */
+void bigint_next_prime(Bigint** result, const Bigint* start, size_t round_num)
+{
+    PROFILE_SCOPE(PROFILE_NEXT_PRIME, start->digit_num);
+
+    pthread_once(&prime_table_once, prime_table_init);
+
+    Bigint* candidate = NULL;
+
+    /* Below 2, the answer is 2 */
+    if (start->sign == NEGATIVE || prime_bit_length(start) <= 1) {
+        bigint_set_by_array(result, (Word[]){ 2 }, POSITIVE, 1);
+        return;
+    }
+
+    /* First odd value above start, one spare word for the carry */
+    bigint_new(&candidate, start->digit_num + 1);
+    memcpy(candidate->digits, start->digits, start->digit_num * SIZE_OF_WORD);
+    prime_words_add_small(candidate->digits, candidate->digit_num, GET_BIT(start->digits[0], 0) == 1 ? 2 : 1);
+    bigint_refine(candidate);
+
+    /* Small values: trial division decides, and the sieve would strike out the table primes themselves */
+    while (prime_bit_length(candidate) <= PRIME_SMALL_BITS) {
+        if (prime_is_prime_small(candidate) == true) {
+            bigint_copy(result, candidate);
+            bigint_delete(&candidate);
+            return;
+        }
+        Bigint* two = NULL;
+        bigint_set_by_array(&two, (Word[]){ 2 }, POSITIVE, 1);
+        bigint_addition(&candidate, candidate, two);
+        bigint_delete(&two);
+    }
+
+    /* Sieved windows, without a bit length limit */
+    PrimeSearch search;
+    prime_search_new(&search, candidate, 2, 0, false, round_num);
+    prime_search_run(result, &search, NULL);
+    prime_search_delete(&search);
+    bigint_delete(&candidate);
+}
+
+/**
+ * @brief Generates a random probable prime of exactly bit_length bits.
+ *
+ * Above 32 bits the top two bits are set, so the product of two such primes has exactly twice the bits.
+ * A random odd start is drawn and the following candidates are sieved window by window; a new start is drawn
+ * if the windows run past bit_length bits. With a thread pool, each worker sieves and tests its own window.
+ *
+ * @param result [out] Random probable prime.
+ * @param bit_length [in] Number of bits, at least 2, or 3 for a safe prime.
+ * @param is_safe [in] Also require (p - 1) / 2 to be prime.
+ * @param round_num [in] Number of Miller-Rabin rounds with random bases per candidate.
+ * @param pool [in] Thread pool, or NULL to search on the calling thread.
+ */
+void bigint_random_prime(Bigint** result, size_t bit_length, bool is_safe, size_t round_num, ThreadPool* pool)
+{
+    PROFILE_SCOPE(PROFILE_RANDOM_PRIME, (bit_length + BITLEN_OF_WORD - 1) / BITLEN_OF_WORD);
+
+    pthread_once(&prime_table_once, prime_table_init);
+
+    /* Invalid case: the top two bits and the low bit(s) must fit */
+    if (bit_length < (is_safe ? 3 : 2)) {
+        printf("Invalid Case: Bit length is too small.\n");
+        return;
+    }
+
+    size_t digit_num = (bit_length + BITLEN_OF_WORD - 1) / BITLEN_OF_WORD;
+    Word top_bit = (Word)((bit_length - 1) % BITLEN_OF_WORD);
+    Bigint* start = NULL;
+    bool is_found = false;
+
+    while (is_found == false)
+    {
+        /* Random start of exactly bit_length bits, odd, 3 mod 4 for a safe prime */
+        bigint_random_bits(&start, bit_length);
+        if (bit_length > PRIME_SMALL_BITS && top_bit > 0)
+            start->digits[digit_num - 1] |= (Word)1 << (top_bit - 1);
+        else if (bit_length > PRIME_SMALL_BITS)
+            start->digits[digit_num - 2] |= (Word)1 << (BITLEN_OF_WORD - 1);
+        start->digits[0] |= is_safe ? 3 : 1;
+
+        /* Small values: draw until trial division accepts */
+        if (bit_length <= PRIME_SMALL_BITS)
+        {
+            Bigint* half = NULL;
+            bigint_compress_one_bit(&half, start);
+            is_found = prime_is_prime_small(start) && (is_safe == false || prime_is_prime_small(half));
+            bigint_delete(&half);
+            if (is_found == true)
+                bigint_copy(result, start);
+            continue;
+        }
+
+        PrimeSearch search;
+        prime_search_new(&search, start, is_safe ? 4 : 2, bit_length, is_safe, round_num);
+        is_found = prime_search_run(result, &search, pool);
+        prime_search_delete(&search);
+    }
+
+    bigint_refine(*result);
+    bigint_delete(&start);
+}
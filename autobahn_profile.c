@@ -0,0 +1,288 @@
+#include "autobahn_internal.h"
+
+#if defined(BI_PROFILE)
+    #include <pthread.h>
+    #include <time.h>
+    #if defined(__x86_64__) || defined(__i386__)
+        #include <x86intrin.h>
+        #define PROFILE_HAS_TSC 1
+    #else
+        #define PROFILE_HAS_TSC 0
+    #endif
+#endif
+
+/** @brief Metric label of each ProfilePoint, in the order of the enumeration. */
+static const char* const profile_point_names[PROFILE_POINT_NUM] = {
+    "addition", "subtraction",
+    "multiplication_textbook", "multiplication_karatsuba",
+    "squaring_textbook", "squaring_karatsuba",
+    "division_word_long", "division_binary_long", "division_naive",
+    "reduction_barrett_pre_computed", "reduction_barrett",
+    "from_string", "to_string",
+    "sqrtrem", "rootrem",
+    "gcd", "gcdext", "mod_inverse", "mod_inverse_batch",
+    "is_probable_prime", "next_prime", "random_prime",
+    "product_tree_new", "remainder_tree", "batch_gcd",
+    "modular_context_new",
+    "exponentiation_left_to_right", "exponentiation_montgomery_ladder", "exponentiation_fixed_window",
+    "exponentiation_window_context", "exponentiation_public", "exponentiation_batch", "exponentiation_multi_buffer",
+    "words_addition", "words_subtraction", "words_multiplication", "words_division",
+    "words_reciprocal", "words_reduction_barrett", "words_division_fast",
+    "words_montgomery_multiplication", "words_montgomery_final_subtraction",
+    "words_exponentiation_fixed_window", "words_exponentiation_public"
+};
+
+#if defined(BI_PROFILE)
+/**
+ * @brief Counters of one thread.
+ *
+ * Only the owning thread writes counters and depth, with relaxed atomic stores, so a snapshot from another
+ * thread reads them without a lock on the hot path. Blocks are never freed: a finished thread leaves its
+ * block retired, and the next new thread adopts it with the counts it holds.
+ */
+typedef struct ProfileThread {
+    ProfileCounter counters[PROFILE_POINT_NUM]; /**< Cumulative counters, written by the owner only. */
+    ProfileCounter baseline[PROFILE_POINT_NUM]; /**< Counters at the last reset, under profile_mutex. */
+    uint32_t depth[PROFILE_POINT_NUM];          /**< Open scopes of each operation, private to the owner. */
+    bool retired;                               /**< The owner has exited, under profile_mutex. */
+    struct ProfileThread* next;                 /**< Next block of the registry. */
+} ProfileThread;
+
+static pthread_mutex_t profile_mutex = PTHREAD_MUTEX_INITIALIZER; /**< Protects the registry and baselines. */
+static pthread_once_t profile_once = PTHREAD_ONCE_INIT;
+static pthread_key_t profile_key;                                 /**< Retires the block of an exiting thread. */
+static ProfileThread* profile_threads;                            /**< Registry of every block. */
+static size_t profile_thread_num;                                 /**< Blocks in the registry. */
+static _Thread_local ProfileThread* profile_thread;               /**< Block of the calling thread. */
+
+/**
+ * @brief Reads the profiler clock.
+ *
+ * @return uint64_t TSC cycles on x86, monotonic nanoseconds elsewhere.
+ */
+static inline uint64_t profile_clock(void)
+{
+#if PROFILE_HAS_TSC
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Marks the block of an exiting thread as free for adoption.
+ *
+ * @param block [in] Block of the exiting thread.
+ */
+static void profile_thread_retire(void* block)
+{
+    pthread_mutex_lock(&profile_mutex);
+    ((ProfileThread*)block)->retired = true;
+    pthread_mutex_unlock(&profile_mutex);
+}
+
+/** @brief Creates the key that retires blocks at thread exit. */
+static void profile_key_init(void)
+{
+    pthread_key_create(&profile_key, profile_thread_retire);
+}
+
+/**
+ * @brief Returns the block of the calling thread, adopting a retired block or registering a new one.
+ *
+ * @return ProfileThread* Block of the calling thread.
+ */
+static ProfileThread* profile_thread_get(void)
+{
+    if (profile_thread != NULL)
+        return profile_thread;
+
+    pthread_once(&profile_once, profile_key_init);
+    pthread_mutex_lock(&profile_mutex);
+
+    /* Adopt the block of a finished thread */
+    ProfileThread* block = profile_threads;
+    while (block != NULL && !block->retired)
+        block = block->next;
+
+    if (block != NULL) {
+        block->retired = false;
+        memset(block->depth, 0, sizeof(block->depth));
+    }
+    else {
+        /* The memory functions without the counters, so a BI_MEMORY_STATS build does not count the profiler */
+        block = (ProfileThread*)memory_raw_alloc(sizeof(ProfileThread), true);
+        if (block == NULL) {
+            pthread_mutex_unlock(&profile_mutex);
+            printf("Invalid Case: Out of memory for the profiler\n");
+            abort();
+        }
+        block->next = profile_threads;
+        profile_threads = block;
+        profile_thread_num++;
+    }
+
+    pthread_mutex_unlock(&profile_mutex);
+    pthread_setspecific(profile_key, block);
+    profile_thread = block;
+    return block;
+}
+
+/**
+ * @brief Opens a profiler scope, the clock is only read by the outermost call of an operation.
+ *
+ * @param point [in] Profiled operation.
+ * @param limb_num [in] Words of the operands.
+ * @return ProfileScope Scope closed by profile_scope_end.
+ */
+ProfileScope profile_scope_begin(ProfilePoint point, uint64_t limb_num)
+{
+    ProfileThread* block = profile_thread_get();
+    ProfileScope scope = { point, limb_num, 0 };
+
+    if (block->depth[point]++ == 0)
+        scope.start = profile_clock();
+
+    return scope;
+}
+
+/**
+ * @brief Closes a profiler scope and adds it to the counters of the calling thread.
+ *
+ * Recursive calls count as calls and limbs, but only the outermost one adds time, so the cycles of an
+ * operation are never counted twice.
+ *
+ * @param scope [in] Scope opened by profile_scope_begin.
+ */
+void profile_scope_end(ProfileScope* scope)
+{
+    ProfileThread* block = profile_thread;
+    ProfileCounter* counter = &block->counters[scope->point];
+
+    __atomic_store_n(&counter->call_num, counter->call_num + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&counter->limb_num, counter->limb_num + scope->limb_num, __ATOMIC_RELAXED);
+
+    if (--block->depth[scope->point] == 0)
+        __atomic_store_n(&counter->cycle_num, counter->cycle_num + (profile_clock() - scope->start), __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Reads the counters of a block.
+ *
+ * @param counter [out] Copy of the counter.
+ * @param source [in] Counter of a block.
+ */
+static void profile_counter_load(ProfileCounter* counter, const ProfileCounter* source)
+{
+    counter->call_num = __atomic_load_n(&source->call_num, __ATOMIC_RELAXED);
+    counter->limb_num = __atomic_load_n(&source->limb_num, __ATOMIC_RELAXED);
+    counter->cycle_num = __atomic_load_n(&source->cycle_num, __ATOMIC_RELAXED);
+}
+#endif
+
+/**
+ * @brief Adds up the profiler counters of every thread since the last reset.
+ *
+ * Counters of running threads are read while they are updated, so a snapshot may miss calls that finish
+ * during it, but never sees a torn value.
+ *
+ * @param snapshot [out] Counters, zero if the build does not profile.
+ * @return bool True if the build was compiled with BI_PROFILE.
+ */
+bool bigint_profile_snapshot(ProfileSnapshot* snapshot)
+{
+    memset(snapshot, 0, sizeof(ProfileSnapshot));
+
+#if defined(BI_PROFILE)
+    snapshot->cycles_are_tsc = PROFILE_HAS_TSC;
+
+    pthread_mutex_lock(&profile_mutex);
+    snapshot->thread_num = profile_thread_num;
+    for (ProfileThread* block = profile_threads; block != NULL; block = block->next) {
+        for (size_t point = 0; point < PROFILE_POINT_NUM; point++) {
+            ProfileCounter counter;
+            profile_counter_load(&counter, &block->counters[point]);
+            snapshot->counters[point].call_num += counter.call_num - block->baseline[point].call_num;
+            snapshot->counters[point].limb_num += counter.limb_num - block->baseline[point].limb_num;
+            snapshot->counters[point].cycle_num += counter.cycle_num - block->baseline[point].cycle_num;
+        }
+    }
+    pthread_mutex_unlock(&profile_mutex);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Restarts every profiler counter from zero.
+ *
+ * Counters are never written by another thread than their owner, so a reset moves the baseline that
+ * snapshots subtract instead of clearing them.
+ */
+void bigint_profile_reset(void)
+{
+#if defined(BI_PROFILE)
+    pthread_mutex_lock(&profile_mutex);
+    for (ProfileThread* block = profile_threads; block != NULL; block = block->next)
+        for (size_t point = 0; point < PROFILE_POINT_NUM; point++)
+            profile_counter_load(&block->baseline[point], &block->counters[point]);
+    pthread_mutex_unlock(&profile_mutex);
+#endif
+}
+
+/**
+ * @brief Writes a profiler snapshot in the Prometheus text exposition format.
+ *
+ * Every operation is written, called or not, so the series stay stable between scrapes. Time is exported
+ * as autobahn_profile_cycles_total with a TSC and as autobahn_profile_nanoseconds_total without one.
+ *
+ * @param stream [in] Output stream.
+ * @return bool True if the build was compiled with BI_PROFILE.
+ */
+bool bigint_profile_dump(FILE* stream)
+{
+    ProfileSnapshot snapshot;
+    if (!bigint_profile_snapshot(&snapshot))
+        return false;
+
+    const char* time_name = snapshot.cycles_are_tsc ? "cycles" : "nanoseconds";
+
+    fprintf(stream, "# HELP autobahn_profile_calls_total Calls of each profiled operation, recursive calls included.\n");
+    fprintf(stream, "# TYPE autobahn_profile_calls_total counter\n");
+    for (size_t point = 0; point < PROFILE_POINT_NUM; point++)
+        fprintf(stream, "autobahn_profile_calls_total{operation=\"%s\"} %llu\n",
+                profile_point_names[point], (unsigned long long)snapshot.counters[point].call_num);
+
+    fprintf(stream, "# HELP autobahn_profile_limbs_total Words of the operands processed by each profiled operation.\n");
+    fprintf(stream, "# TYPE autobahn_profile_limbs_total counter\n");
+    for (size_t point = 0; point < PROFILE_POINT_NUM; point++)
+        fprintf(stream, "autobahn_profile_limbs_total{operation=\"%s\",word_bits=\"%u\"} %llu\n",
+                profile_point_names[point], (unsigned)BITLEN_OF_WORD, (unsigned long long)snapshot.counters[point].limb_num);
+
+    fprintf(stream, "# HELP autobahn_profile_%s_total Inclusive %s of the outermost calls of each profiled operation.\n", time_name, time_name);
+    fprintf(stream, "# TYPE autobahn_profile_%s_total counter\n", time_name);
+    for (size_t point = 0; point < PROFILE_POINT_NUM; point++)
+        fprintf(stream, "autobahn_profile_%s_total{operation=\"%s\"} %llu\n",
+                time_name, profile_point_names[point], (unsigned long long)snapshot.counters[point].cycle_num);
+
+    fprintf(stream, "# HELP autobahn_profile_threads Threads that recorded profiler counters.\n");
+    fprintf(stream, "# TYPE autobahn_profile_threads gauge\n");
+    fprintf(stream, "autobahn_profile_threads %zu\n", snapshot.thread_num);
+    return true;
+}
+
+/**
+ * @brief Returns the metric label of a profiled operation.
+ *
+ * @param point [in] Profiled operation.
+ * @return const char* Label, or "unknown" for an out of range value.
+ */
+const char* bigint_profile_point_name(ProfilePoint point)
+{
+    if ((size_t)point >= PROFILE_POINT_NUM)
+        return "unknown";
+    return profile_point_names[point];
+}
@@ -0,0 +1,557 @@
+#include "autobahn_internal.h"
+
+#define RADIX_BASE_MIN 2
+#define RADIX_BASE_MAX 36
+#define RADIX_DC_THRESHOLD 30       /**< Length in words below which a conversion is done by repeated one-word division. */
+#define RADIX_BARRETT_THRESHOLD 64  /**< Length in words from which a cached power gets a Barrett reciprocal. */
+
+/** @brief Digit characters of every base up to 36. */
+static const char radix_digit_chars[RADIX_BASE_MAX + 1] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+/**
+ * @brief Cached powers of a base, shared by every node of a divide-and-conquer conversion.
+ *
+ * powers[i] = B^(2^i) with B = base^k the largest power of the base that fits in a Word.
+ */
+typedef struct {
+    Word base;            /**< Base of the digits, 2 to 36. */
+    Word big_base;        /**< B = base^k. */
+    size_t chunk_chars;   /**< Number k of digits per B. */
+    size_t level_num;     /**< Number of cached powers. */
+    Word** powers;        /**< powers[i] = B^(2^i), without leading zero words. */
+    size_t* power_nums;   /**< Number of words of each power. */
+    Word** reciprocals;   /**< Barrett reciprocal of each long power, NULL for short ones. */
+} RadixPowers;
+
+/**
+ * @brief Returns the value of a digit character, or RADIX_BASE_MAX if it is not a digit.
+ *
+ * @param character [in] Character, either case for letters.
+ * @return Word Digit value.
+ */
+static Word radix_digit_value(char character)
+{
+    if ('0' <= character && character <= '9')
+        return character - '0';
+    if ('a' <= character && character <= 'z')
+        return character - 'a' + 10;
+    if ('A' <= character && character <= 'Z')
+        return character - 'A' + 10;
+    return RADIX_BASE_MAX;
+}
+
+/**
+ * @brief Returns log2(base) if the base is a power of two, zero otherwise.
+ *
+ * @param base [in] Base.
+ * @return Word Bits per digit, or zero.
+ */
+static Word radix_power_of_two_bits(Word base)
+{
+    if ((base & (base - 1)) != 0)
+        return 0;
+
+    return word_bit_length(base) - 1;
+}
+
+/**
+ * @brief Returns an upper bound of the number of words of a value of the given number of digits.
+ *
+ * @param powers [in] Powers of the base.
+ * @param char_num [in] Number of digits.
+ * @return size_t Number of words, at least one.
+ */
+static size_t radix_words_of_chars(const RadixPowers* powers, size_t char_num)
+{
+    size_t chunk_num = (char_num + powers->chunk_chars - 1) / powers->chunk_chars;
+    size_t bit_num = chunk_num * word_bit_length(powers->big_base);
+
+    return bit_num / BITLEN_OF_WORD + 2;
+}
+
+/**
+ * @brief Initializes the big base of a base, without any cached power.
+ *
+ * @param powers [out] Powers to initialize.
+ * @param base [in] Base, 2 to 36.
+ */
+static void radix_powers_init(RadixPowers* powers, Word base)
+{
+    Word max_word = (Word)~(Word)0;
+
+    powers->base = base;
+    powers->big_base = base;
+    powers->chunk_chars = 1;
+    while (powers->big_base <= max_word / base) {
+        powers->big_base *= base;
+        powers->chunk_chars++;
+    }
+
+    powers->level_num = 0;
+    powers->powers = NULL;
+    powers->power_nums = NULL;
+    powers->reciprocals = NULL;
+}
+
+/**
+ * @brief Caches B^(2^i) for every i below level_num by repeated squaring, without reciprocals.
+ *
+ * @param powers [in, out] Powers, from radix_powers_init.
+ * @param level_num [in] Number of powers to cache.
+ */
+static void radix_powers_extend(RadixPowers* powers, size_t level_num)
+{
+    powers->powers = (Word**)bigint_calloc(level_num, sizeof(Word*));
+    powers->power_nums = (size_t*)bigint_calloc(level_num, sizeof(size_t));
+    powers->reciprocals = (Word**)bigint_calloc(level_num, sizeof(Word*));
+    powers->level_num = level_num;
+
+    for (size_t level_idx = 0; level_idx < level_num; level_idx++)
+    {
+        /* B^(2^i) = (B^(2^(i-1)))^2 */
+        if (level_idx == 0) {
+            powers->powers[0] = (Word*)bigint_malloc(SIZE_OF_WORD);
+            powers->powers[0][0] = powers->big_base;
+            powers->power_nums[0] = 1;
+        }
+        else {
+            const Word* previous = powers->powers[level_idx - 1];
+            size_t previous_num = powers->power_nums[level_idx - 1];
+            Word* scratch = (Word*)bigint_malloc(words_multiplication_scratch_size(previous_num, previous_num) * SIZE_OF_WORD);
+            powers->powers[level_idx] = (Word*)bigint_malloc(2 * previous_num * SIZE_OF_WORD);
+            words_multiplication(powers->powers[level_idx], previous, previous_num, previous, previous_num, scratch);
+            powers->power_nums[level_idx] = words_trim(powers->powers[level_idx], 2 * previous_num);
+            bigint_free(scratch);
+        }
+    }
+}
+
+/**
+ * @brief Computes the Barrett reciprocal of every long power below reciprocal_num, once per conversion.
+ *
+ * @param powers [in, out] Powers, from radix_powers_extend.
+ * @param reciprocal_num [in] Number of powers used as divisors.
+ */
+static void radix_powers_reciprocals(RadixPowers* powers, size_t reciprocal_num)
+{
+    for (size_t level_idx = 0; level_idx < reciprocal_num; level_idx++) {
+        size_t digit_num = powers->power_nums[level_idx];
+        if (digit_num < RADIX_BARRETT_THRESHOLD)
+            continue;
+
+        Word* scratch = (Word*)bigint_malloc(words_reciprocal_scratch_size(digit_num) * SIZE_OF_WORD);
+        powers->reciprocals[level_idx] = (Word*)bigint_malloc((digit_num + 2) * SIZE_OF_WORD);
+        words_reciprocal(powers->reciprocals[level_idx], powers->powers[level_idx], digit_num, scratch);
+        bigint_free(scratch);
+    }
+}
+
+/**
+ * @brief Frees the cached powers.
+ *
+ * @param powers [in, out] Powers.
+ */
+static void radix_powers_free(RadixPowers* powers)
+{
+    for (size_t level_idx = 0; level_idx < powers->level_num; level_idx++) {
+        bigint_free(powers->powers[level_idx]);
+        bigint_free(powers->reciprocals[level_idx]);
+    }
+
+    bigint_free(powers->powers);
+    bigint_free(powers->power_nums);
+    bigint_free(powers->reciprocals);
+}
+
+/**
+ * @brief Writes exactly char_num digits of a value by repeated division by B, quadratic in its length.
+ *
+ * @param string [out] char_num digits, most significant first, zero-padded.
+ * @param operand [in, out] Value, less than base^char_num, destroyed.
+ * @param digit_num [in] Number of words of the value.
+ * @param char_num [in] Number of digits, a multiple of k.
+ * @param powers [in] Powers of the base.
+ */
+static void radix_to_chars_basecase(char* string, Word* operand, size_t digit_num, size_t char_num, const RadixPowers* powers)
+{
+    digit_num = words_trim(operand, digit_num);
+
+    /* k digits per division by B, from the least significant end */
+    while (char_num > 0 && digit_num > 0)
+    {
+        Word chunk = 0;
+        for (size_t idx = digit_num; idx-- > 0;)
+            word_division_two_word(&operand[idx], &chunk, chunk, operand[idx], powers->big_base);
+        digit_num = words_trim(operand, digit_num);
+
+        for (size_t char_idx = 0; char_idx < powers->chunk_chars && char_num > 0; char_idx++) {
+            string[--char_num] = radix_digit_chars[chunk % powers->base];
+            chunk /= powers->base;
+        }
+    }
+
+    /* Zero padding */
+    memset(string, '0', char_num);
+}
+
+/**
+ * @brief Writes exactly k * 2^level digits of a value less than B^(2^level), divide and conquer.
+ *
+ * The value is split by B^(2^(level-1)) into a quotient and a remainder of half as many digits each.
+ * Quotient and remainder live in the arena, so the whole conversion allocates nothing.
+ *
+ * @param string [out] k * 2^level digits, zero-padded.
+ * @param operand [in, out] Value, may be destroyed.
+ * @param digit_num [in] Number of words of the value.
+ * @param level [in] Level of the value.
+ * @param powers [in] Powers of the base, at least level of them.
+ * @param arena [in] Words for the quotients and remainders of this node and its children.
+ * @param scratch [in] Scratch for the divisions and the base case.
+ */
+static void radix_to_chars(char* string, Word* operand, size_t digit_num, size_t level, const RadixPowers* powers, Word* arena, Word* scratch)
+{
+    size_t char_num = powers->chunk_chars << level;
+    digit_num = words_trim(operand, digit_num);
+
+    /* Short value: repeated division by B */
+    if (level == 0 || digit_num < RADIX_DC_THRESHOLD) {
+        radix_to_chars_basecase(string, operand, digit_num, char_num, powers);
+        return;
+    }
+
+    const Word* power = powers->powers[level - 1];
+    size_t power_num = powers->power_nums[level - 1];
+    size_t half_num = char_num / 2;
+
+    /* Value below the power: the high half is zero */
+    if (digit_num < power_num) {
+        memset(string, '0', half_num);
+        radix_to_chars(string + half_num, operand, digit_num, level - 1, powers, arena, scratch);
+        return;
+    }
+
+    /* operand = quotient * B^(2^(level-1)) + remainder */
+    size_t quotient_num = digit_num - power_num + 1;
+    Word* remainder = arena;
+    Word* quotient = arena + power_num;
+    if (powers->reciprocals[level - 1] != NULL)
+        words_reduction_barrett(quotient, remainder, operand, digit_num, power, power_num, powers->reciprocals[level - 1], scratch);
+    else
+        words_division(quotient, remainder, operand, digit_num, power, power_num, scratch);
+
+    /* Both halves reuse the arena past this node */
+    radix_to_chars(string, quotient, quotient_num, level - 1, powers, quotient + quotient_num, scratch);
+    radix_to_chars(string + half_num, remainder, power_num, level - 1, powers, quotient + quotient_num, scratch);
+}
+
+/**
+ * @brief Converts a value of at most char_num digits given as digit values, quadratic in its length.
+ *
+ * @param result [out] Value, of radix_words_of_chars(char_num) words.
+ * @param values [in] Digit values, most significant first.
+ * @param char_num [in] Number of digits.
+ * @param powers [in] Powers of the base.
+ * @return size_t Number of significant words of the value.
+ */
+static size_t radix_from_chars_basecase(Word* result, const unsigned char* values, size_t char_num, const RadixPowers* powers)
+{
+    size_t digit_num = 0;
+    size_t head_num = char_num % powers->chunk_chars;
+
+    /* First a partial chunk, then k digits per multiplication by B */
+    for (size_t char_idx = 0; char_idx < char_num;)
+    {
+        size_t chunk_chars = (char_idx == 0 && head_num != 0) ? head_num : powers->chunk_chars;
+        Word multiplier = 1;
+        Word chunk = 0;
+        for (size_t idx = 0; idx < chunk_chars; idx++) {
+            multiplier *= powers->base;
+            chunk = chunk * powers->base + values[char_idx++];
+        }
+
+        /* result <- result * base^chunk_chars + chunk */
+        Word carry = chunk;
+        for (size_t idx = 0; idx < digit_num; idx++)
+            word_multiplication_addition(&carry, &result[idx], result[idx], multiplier, carry, 0);
+        if (carry != 0)
+            result[digit_num++] = carry;
+    }
+
+    return digit_num;
+}
+
+/**
+ * @brief Returns the arena words needed by radix_from_chars for char_num digits.
+ *
+ * @param powers [in] Powers of the base.
+ * @param char_num [in] Number of digits.
+ * @return size_t Number of arena words.
+ */
+static size_t radix_from_chars_arena_size(const RadixPowers* powers, size_t char_num)
+{
+    size_t arena_num = 0;
+
+    /* Each node keeps both halves, the longer half recurses deepest */
+    while (char_num > RADIX_DC_THRESHOLD * powers->chunk_chars) {
+        size_t low_chars = powers->chunk_chars;
+        while (2 * low_chars < char_num)
+            low_chars *= 2;
+        arena_num += radix_words_of_chars(powers, char_num - low_chars) + radix_words_of_chars(powers, low_chars);
+        char_num = low_chars > char_num - low_chars ? low_chars : char_num - low_chars;
+    }
+
+    return arena_num;
+}
+
+/**
+ * @brief Converts digit values into a value, divide and conquer: high * B^(2^i) + low.
+ *
+ * The low part has k * 2^i digits with i the largest level below the length.
+ *
+ * @param result [out] Value, of radix_words_of_chars(char_num) words.
+ * @param values [in] Digit values, most significant first.
+ * @param char_num [in] Number of digits.
+ * @param powers [in] Powers of the base, covering the length.
+ * @param arena [in] Words for the halves of this node and its children.
+ * @param scratch [in] Scratch for the multiplications.
+ * @return size_t Number of significant words of the value.
+ */
+static size_t radix_from_chars(Word* result, const unsigned char* values, size_t char_num, const RadixPowers* powers, Word* arena, Word* scratch)
+{
+    /* Short value: repeated multiplication by B */
+    if (char_num <= RADIX_DC_THRESHOLD * powers->chunk_chars)
+        return radix_from_chars_basecase(result, values, char_num, powers);
+
+    size_t level = 0;
+    while ((powers->chunk_chars << (level + 1)) < char_num)
+        level++;
+    size_t low_chars = powers->chunk_chars << level;
+    size_t high_chars = char_num - low_chars;
+
+    /* Both halves, the arena past them goes to the children */
+    Word* high = arena;
+    Word* low = arena + radix_words_of_chars(powers, high_chars);
+    Word* child_arena = low + radix_words_of_chars(powers, low_chars);
+    size_t high_num = radix_from_chars(high, values, high_chars, powers, child_arena, scratch);
+    size_t low_num = radix_from_chars(low, values + high_chars, low_chars, powers, child_arena, scratch);
+
+    /* result = high * B^(2^level) + low */
+    size_t power_num = powers->power_nums[level];
+    if (high_num == 0) {
+        memcpy(result, low, low_num * SIZE_OF_WORD);
+        return low_num;
+    }
+    words_multiplication(result, high, high_num, powers->powers[level], power_num, scratch);
+    words_addition(result, result, high_num + power_num, low, low_num);
+
+    return words_trim(result, high_num + power_num);
+}
+
+/**
+ * @brief Sets the value of a Bigint from a string of digits in a base from 2 to 36.
+ *
+ * The string is an optional '-' followed by digits, letters of either case for digits above 9,
+ * it does not need to be terminated. Power-of-two bases are converted bit by bit in linear time;
+ * other bases use divide and conquer with cached powers of the base, sub-quadratic for long
+ * strings. On error the Bigint is left unchanged.
+ *
+ * @param bigint [out] Pointer to the destination Bigint.
+ * @param string [in] String of digits.
+ * @param length [in] Number of characters in the string.
+ * @param base [in] Base of the digits, 2 to 36.
+ * @return ConvertStatus CONVERT_OK, CONVERT_INVALID_BASE, CONVERT_EMPTY or CONVERT_INVALID_CHARACTER.
+ */
+ConvertStatus bigint_from_string(Bigint** bigint, const char* string, size_t length, Word base)
+{
+    PROFILE_SCOPE(PROFILE_FROM_STRING, 0);
+
+    /* Error check : base out of range */
+    if (base < RADIX_BASE_MIN || base > RADIX_BASE_MAX)
+        return CONVERT_INVALID_BASE;
+
+    /* Sign prefix */
+    Sign sign = POSITIVE;
+    if (length > 0 && string[0] == '-') {
+        sign = NEGATIVE;
+        string++;
+        length--;
+    }
+
+    if (length == 0)
+        return CONVERT_EMPTY;
+
+    /* Digit values, checked once up front */
+    unsigned char* values = (unsigned char*)bigint_malloc(length);
+    for (size_t char_idx = 0; char_idx < length; char_idx++) {
+        Word value = radix_digit_value(string[char_idx]);
+        if (value >= base) {
+            bigint_free(values);
+            return CONVERT_INVALID_CHARACTER;
+        }
+        values[char_idx] = (unsigned char)value;
+    }
+
+    RadixPowers powers;
+    radix_powers_init(&powers, base);
+
+    size_t word_num = radix_words_of_chars(&powers, length);
+
+    Word* digits = (Word*)bigint_calloc(word_num, SIZE_OF_WORD);
+    size_t digit_num = 0;
+    Word bits = radix_power_of_two_bits(base);
+
+    if (bits != 0)
+    {
+        /* Power-of-two base: every digit is a bit field */
+        for (size_t char_idx = 0; char_idx < length; char_idx++) {
+            size_t bit_idx = (length - 1 - char_idx) * bits;
+            Word value = values[char_idx];
+            digits[bit_idx / BITLEN_OF_WORD] |= value << (bit_idx % BITLEN_OF_WORD);
+            if (bit_idx % BITLEN_OF_WORD + bits > BITLEN_OF_WORD)
+                digits[bit_idx / BITLEN_OF_WORD + 1] |= value >> (BITLEN_OF_WORD - bit_idx % BITLEN_OF_WORD);
+        }
+        digit_num = words_trim(digits, word_num);
+    }
+    else
+    {
+        /* Other bases: powers B^(2^i) up to the longest low half */
+        size_t level_num = 1;
+        while ((powers.chunk_chars << level_num) < length)
+            level_num++;
+        radix_powers_extend(&powers, level_num);
+
+        size_t power_num = powers.power_nums[level_num - 1];
+        Word* arena = (Word*)bigint_malloc((radix_from_chars_arena_size(&powers, length) + 1) * SIZE_OF_WORD);
+        Word* scratch = (Word*)bigint_malloc(words_multiplication_scratch_size(power_num, power_num) * SIZE_OF_WORD);
+        digit_num = radix_from_chars(digits, values, length, &powers, arena, scratch);
+        bigint_free(arena);
+        bigint_free(scratch);
+    }
+
+    /* Replace the Bigint */
+    bigint_new(bigint, 1);
+    bigint_free((*bigint)->digits);
+    (*bigint)->digits = digits;
+    (*bigint)->digit_num = digit_num > 0 ? digit_num : 1;
+    (*bigint)->sign = digit_num > 0 ? sign : POSITIVE;
+
+    radix_powers_free(&powers);
+    bigint_free(values);
+
+    return CONVERT_OK;
+}
+
+/**
+ * @brief Writes the representation of a Bigint in a base from 2 to 36 into a caller buffer.
+ *
+ * The output is lowercase without leading zeros, prefixed by '-' if negative, and terminated.
+ * If the buffer is too small nothing is written and string_length receives the required length.
+ * Power-of-two bases are converted bit by bit in linear time; other bases use repeated division
+ * by the largest power of the base in a Word for short values, and divide and conquer with cached
+ * powers of the base for long ones, sub-quadratic in the length.
+ *
+ * @param buffer [out] Destination buffer, may be NULL if buffer_length is 0.
+ * @param buffer_length [in] Size of the buffer, including the terminating null.
+ * @param string_length [out] Length of the string without the terminating null, may be NULL.
+ * @param bigint [in] Pointer to the Bigint.
+ * @param base [in] Base of the digits, 2 to 36.
+ * @return ConvertStatus CONVERT_OK, CONVERT_INVALID_BASE or CONVERT_BUFFER_TOO_SMALL.
+ */
+ConvertStatus bigint_to_string(char* buffer, size_t buffer_length, size_t* string_length, const Bigint* bigint, Word base)
+{
+    PROFILE_SCOPE(PROFILE_TO_STRING, bigint->digit_num);
+
+    /* Error check : base out of range */
+    if (base < RADIX_BASE_MIN || base > RADIX_BASE_MAX)
+        return CONVERT_INVALID_BASE;
+
+    size_t digit_num = words_trim(bigint->digits, bigint->digit_num);
+    bool is_negative = bigint->sign == NEGATIVE && digit_num > 0;
+    Word bits = radix_power_of_two_bits(base);
+    char* digit_string = NULL;
+    size_t char_num = 0;
+
+    if (digit_num == 0)
+    {
+        /* Zero */
+        digit_string = (char*)bigint_malloc(1);
+        digit_string[0] = '0';
+        char_num = 1;
+    }
+    else if (bits != 0)
+    {
+        /* Power-of-two base: every digit is a bit field */
+        size_t bit_num = (digit_num - 1) * BITLEN_OF_WORD + word_bit_length(bigint->digits[digit_num - 1]);
+        char_num = (bit_num + bits - 1) / bits;
+        digit_string = (char*)bigint_malloc(char_num);
+        for (size_t char_idx = 0; char_idx < char_num; char_idx++) {
+            size_t bit_idx = (char_num - 1 - char_idx) * bits;
+            Word value = bigint->digits[bit_idx / BITLEN_OF_WORD] >> (bit_idx % BITLEN_OF_WORD);
+            if (bit_idx % BITLEN_OF_WORD + bits > BITLEN_OF_WORD && bit_idx / BITLEN_OF_WORD + 1 < digit_num)
+                value |= bigint->digits[bit_idx / BITLEN_OF_WORD + 1] << (BITLEN_OF_WORD - bit_idx % BITLEN_OF_WORD);
+            digit_string[char_idx] = radix_digit_chars[value & (base - 1)];
+        }
+    }
+    else
+    {
+        /* Other bases: the smallest level whose power is longer than the value */
+        RadixPowers powers;
+        radix_powers_init(&powers, base);
+        size_t level_num = 1;
+        while (((size_t)1 << (level_num - 1)) * (word_bit_length(powers.big_base) - 1) <= digit_num * BITLEN_OF_WORD)
+            level_num++;
+        radix_powers_extend(&powers, level_num);
+        while (level_num > 1 && powers.power_nums[level_num - 2] > digit_num)
+            level_num--;
+        size_t level = level_num - 1;
+        radix_powers_reciprocals(&powers, level);
+
+        /* Every node keeps a quotient and a remainder, at most the length of its value plus one */
+        size_t arena_num = 0;
+        size_t scratch_num = digit_num;
+        for (size_t level_idx = 0; level_idx <= level; level_idx++) {
+            size_t dividend_num = level_idx < level ? powers.power_nums[level_idx + 1] : digit_num;
+            arena_num += dividend_num + 2;
+            if (level_idx == 0)
+                continue;
+            size_t power_num = powers.power_nums[level_idx - 1];
+            size_t node_num = powers.reciprocals[level_idx - 1] != NULL ? words_reduction_barrett_scratch_size(dividend_num, power_num) : words_division_scratch_size(dividend_num, power_num);
+            scratch_num = node_num > scratch_num ? node_num : scratch_num;
+        }
+
+        char_num = powers.chunk_chars << level;
+        digit_string = (char*)bigint_malloc(char_num);
+        Word* operand = (Word*)bigint_malloc(digit_num * SIZE_OF_WORD);
+        Word* arena = (Word*)bigint_malloc(arena_num * SIZE_OF_WORD);
+        Word* scratch = (Word*)bigint_malloc(scratch_num * SIZE_OF_WORD);
+        memcpy(operand, bigint->digits, digit_num * SIZE_OF_WORD);
+        radix_to_chars(digit_string, operand, digit_num, level, &powers, arena, scratch);
+        bigint_free(operand);
+        bigint_free(arena);
+        bigint_free(scratch);
+        radix_powers_free(&powers);
+    }
+
+    /* Drop the zero padding */
+    size_t zero_num = 0;
+    while (zero_num < char_num - 1 && digit_string[zero_num] == '0')
+        zero_num++;
+
+    size_t length = is_negative + char_num - zero_num;
+    if (string_length != NULL)
+        *string_length = length;
+
+    /* Error check : room for the string and its terminating null */
+    if (buffer_length <= length) {
+        bigint_free(digit_string);
+        return CONVERT_BUFFER_TOO_SMALL;
+    }
+
+    if (is_negative)
+        buffer[0] = '-';
+    memcpy(buffer + is_negative, digit_string + zero_num, char_num - zero_num);
+    buffer[length] = '\0';
+    bigint_free(digit_string);
+
+    return CONVERT_OK;
+}
@@ -0,0 +1,390 @@
+#include "autobahn_common.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+    #include <sys/random.h>
+#endif
+
+/** @brief Random source of the calling thread, NULL for the default generator. */
+static _Thread_local RandomFill random_fill = NULL;
+static _Thread_local void* random_state = NULL;
+
+#if defined(BI_RANDOM_FIXED_SEED)
+    #define RANDOM_SEED_DEFAULT 0x6175746f6261686eULL /**< Seed of the first thread's default generator. */
+
+    /** @brief Default generator of the calling thread, seeded on first use. */
+    static _Thread_local RandomXoshiro random_default;
+
+    /** @brief Number of default generators seeded so far, gives every thread its own stream. */
+    static uint64_t random_default_num = 0;
+#else
+    /** @brief Default generator of the calling thread, keyed from the operating system on first use. */
+    static _Thread_local RandomChaCha random_default;
+#endif
+static _Thread_local bool random_default_is_seeded = false;
+
+/**
+ * @brief Returns the next output of splitmix64, used to expand a seed.
+ *
+ * @param seed [in, out] Splitmix64 state.
+ * @return uint64_t Output.
+ */
+static uint64_t random_splitmix64(uint64_t* seed)
+{
+    uint64_t value = (*seed += 0x9e3779b97f4a7c15ULL);
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Seeds a xoshiro256** generator, each lane from the seed expanded by splitmix64.
+ *
+ * @param state [out] Generator.
+ * @param seed [in] Seed, any value.
+ */
+void bigint_random_xoshiro_seed(RandomXoshiro* state, uint64_t seed)
+{
+    for (size_t lane = 0; lane < RANDOM_XOSHIRO_LANES; lane++)
+        for (size_t idx = 0; idx < 4; idx++)
+            state->s[idx][lane] = random_splitmix64(&seed);
+}
+
+/**
+ * @brief Fills a buffer from a xoshiro256** generator, RANDOM_XOSHIRO_LANES independent streams at once.
+ *
+ * The lanes are interleaved, so the inner loop has no dependency between lanes and vectorizes.
+ * Not suitable for keys.
+ *
+ * @param state [in, out] RandomXoshiro generator.
+ * @param buffer [out] Buffer.
+ * @param byte_num [in] Number of bytes.
+ */
+void bigint_random_xoshiro_fill(void* state, void* buffer, size_t byte_num)
+{
+    RandomXoshiro* xoshiro = (RandomXoshiro*)state;
+    unsigned char* out = (unsigned char*)buffer;
+    uint64_t s0[RANDOM_XOSHIRO_LANES], s1[RANDOM_XOSHIRO_LANES], s2[RANDOM_XOSHIRO_LANES], s3[RANDOM_XOSHIRO_LANES];
+
+    memcpy(s0, xoshiro->s[0], sizeof(s0));
+    memcpy(s1, xoshiro->s[1], sizeof(s1));
+    memcpy(s2, xoshiro->s[2], sizeof(s2));
+    memcpy(s3, xoshiro->s[3], sizeof(s3));
+
+    while (byte_num > 0)
+    {
+        uint64_t block[RANDOM_XOSHIRO_LANES];
+
+        /* One step of every lane */
+        for (size_t lane = 0; lane < RANDOM_XOSHIRO_LANES; lane++) {
+            uint64_t product = s1[lane] * 5;
+            block[lane] = ((product << 7) | (product >> 57)) * 9;
+
+            uint64_t shifted = s1[lane] << 17;
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= shifted;
+            s3[lane] = (s3[lane] << 45) | (s3[lane] >> 19);
+        }
+
+        /* Whole blocks straight out, the tail from a partial copy */
+        size_t copy_num = byte_num < sizeof(block) ? byte_num : sizeof(block);
+        memcpy(out, block, copy_num);
+        out += copy_num;
+        byte_num -= copy_num;
+    }
+
+    memcpy(xoshiro->s[0], s0, sizeof(s0));
+    memcpy(xoshiro->s[1], s1, sizeof(s1));
+    memcpy(xoshiro->s[2], s2, sizeof(s2));
+    memcpy(xoshiro->s[3], s3, sizeof(s3));
+}
+
+/**
+ * @brief Reads seed bytes from the operating system.
+ *
+ * @param buffer [out] Buffer.
+ * @param byte_num [in] Number of bytes.
+ * @return bool true on success.
+ */
+static bool random_entropy(unsigned char* buffer, size_t byte_num)
+{
+#if defined(__linux__)
+    while (byte_num > 0) {
+        ssize_t read_num = getrandom(buffer, byte_num, 0);
+        if (read_num <= 0)
+            break;
+        buffer += read_num;
+        byte_num -= (size_t)read_num;
+    }
+    if (byte_num == 0)
+        return true;
+#endif
+
+    /* Fallback for older kernels and other systems */
+    int file = open("/dev/urandom", O_RDONLY);
+    if (file < 0)
+        return false;
+    while (byte_num > 0) {
+        ssize_t read_num = read(file, buffer, byte_num);
+        if (read_num <= 0)
+            break;
+        buffer += read_num;
+        byte_num -= (size_t)read_num;
+    }
+    close(file);
+
+    return byte_num == 0;
+}
+
+/**
+ * @brief Seeds a ChaCha20 generator from a 256-bit key, or from the operating system.
+ *
+ * @param state [out] Generator.
+ * @param key [in] 32-byte key, or NULL to draw it from the operating system.
+ * @param stream [in] Stream number, the ChaCha20 nonce, so one key gives independent streams.
+ * @return bool false if the key could not be drawn from the operating system.
+ */
+bool bigint_random_chacha_seed(RandomChaCha* state, const unsigned char* key, uint64_t stream)
+{
+    unsigned char key_bytes[32];
+
+    if (key == NULL) {
+        if (random_entropy(key_bytes, sizeof(key_bytes)) == false)
+            return false;
+        key = key_bytes;
+    }
+
+    /* Key words are little-endian */
+    for (size_t idx = 0; idx < 8; idx++)
+        state->key[idx] = (uint32_t)key[4 * idx] | (uint32_t)key[4 * idx + 1] << 8 | (uint32_t)key[4 * idx + 2] << 16 | (uint32_t)key[4 * idx + 3] << 24;
+    state->counter = 0;
+    state->stream = stream;
+    state->used = sizeof(state->block);
+
+    memset(key_bytes, 0, sizeof(key_bytes));
+    return true;
+}
+
+#define CHACHA_ROTATE(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
+#define CHACHA_QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = CHACHA_ROTATE(d, 16); \
+    c += d; b ^= c; b = CHACHA_ROTATE(b, 12); \
+    a += b; d ^= a; d = CHACHA_ROTATE(d, 8);  \
+    c += d; b ^= c; b = CHACHA_ROTATE(b, 7);
+
+/**
+ * @brief Computes the next 64-byte ChaCha20 keystream block and advances the counter.
+ *
+ * @param state [in, out] Generator.
+ * @param block [out] Keystream block of 64 bytes.
+ */
+static void random_chacha_block(RandomChaCha* state, unsigned char* block)
+{
+    uint32_t input[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574, // "expand 32-byte k"
+        state->key[0], state->key[1], state->key[2], state->key[3],
+        state->key[4], state->key[5], state->key[6], state->key[7],
+        (uint32_t)state->counter, (uint32_t)(state->counter >> 32),
+        (uint32_t)state->stream, (uint32_t)(state->stream >> 32)
+    };
+    uint32_t x[16];
+    memcpy(x, input, sizeof(x));
+
+    /* 20 rounds: 10 column and 10 diagonal rounds */
+    for (size_t round = 0; round < 10; round++) {
+        CHACHA_QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+        CHACHA_QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        CHACHA_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        CHACHA_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        CHACHA_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        CHACHA_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        CHACHA_QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        CHACHA_QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+
+    /* Add the input, little-endian output */
+    for (size_t idx = 0; idx < 16; idx++) {
+        uint32_t word = x[idx] + input[idx];
+        block[4 * idx]     = (unsigned char)word;
+        block[4 * idx + 1] = (unsigned char)(word >> 8);
+        block[4 * idx + 2] = (unsigned char)(word >> 16);
+        block[4 * idx + 3] = (unsigned char)(word >> 24);
+    }
+
+    state->counter++;
+}
+
+/**
+ * @brief Fills a buffer from a ChaCha20 generator, a cryptographic source when seeded from the system.
+ *
+ * Whole blocks are written straight into the buffer, leftover keystream is kept for the next call.
+ *
+ * @param state [in, out] RandomChaCha generator.
+ * @param buffer [out] Buffer.
+ * @param byte_num [in] Number of bytes.
+ */
+void bigint_random_chacha_fill(void* state, void* buffer, size_t byte_num)
+{
+    RandomChaCha* chacha = (RandomChaCha*)state;
+    unsigned char* out = (unsigned char*)buffer;
+    size_t block_size = sizeof(chacha->block);
+
+    /* Leftover keystream first */
+    while (byte_num > 0 && chacha->used < block_size) {
+        *out++ = chacha->block[chacha->used];
+        chacha->block[chacha->used++] = 0;
+        byte_num--;
+    }
+
+    /* Whole blocks */
+    for (; byte_num >= block_size; out += block_size, byte_num -= block_size)
+        random_chacha_block(chacha, out);
+
+    /* Tail, the rest of the block is kept */
+    if (byte_num > 0) {
+        random_chacha_block(chacha, chacha->block);
+        memcpy(out, chacha->block, byte_num);
+        memset(chacha->block, 0, byte_num);
+        chacha->used = byte_num;
+    }
+}
+
+/**
+ * @brief Sets the random source of the calling thread, used by every random function of the library.
+ *
+ * The default source is a ChaCha20 generator per thread, keyed from the operating system, so keys
+ * from bigint_random_prime are unpredictable without any setup. A BI_RANDOM_FIXED_SEED build
+ * replaces it with a xoshiro256** generator per thread with a fixed seed, reproducible but not
+ * suitable for keys. The workers of bigint_random_prime draw from the source of its caller.
+ *
+ * @param fill [in] Fill function, or NULL to go back to the default generator.
+ * @param state [in] State passed to the fill function, owned by the caller.
+ */
+void bigint_random_set_source(RandomFill fill, void* state)
+{
+    random_fill = fill;
+    random_state = state;
+}
+
+/**
+ * @brief Reads the random source of the calling thread.
+ *
+ * @param fill [out] Fill function, NULL for the default generator.
+ * @param state [out] State passed to the fill function.
+ */
+void bigint_random_get_source(RandomFill* fill, void** state)
+{
+    *fill = random_fill;
+    *state = random_state;
+}
+
+/**
+ * @brief Fills a buffer from the random source of the calling thread.
+ *
+ * @param buffer [out] Buffer.
+ * @param byte_num [in] Number of bytes.
+ */
+void bigint_random_bytes(void* buffer, size_t byte_num)
+{
+    if (random_fill != NULL) {
+        random_fill(random_state, buffer, byte_num);
+        return;
+    }
+
+#if defined(BI_RANDOM_FIXED_SEED)
+    /* Default generator, a different stream for every thread */
+    if (random_default_is_seeded == false) {
+        uint64_t thread_idx = __atomic_fetch_add(&random_default_num, 1, __ATOMIC_RELAXED);
+        bigint_random_xoshiro_seed(&random_default, RANDOM_SEED_DEFAULT + thread_idx);
+        random_default_is_seeded = true;
+    }
+    bigint_random_xoshiro_fill(&random_default, buffer, byte_num);
+#else
+    /* Default generator, a key of its own for every thread */
+    if (random_default_is_seeded == false) {
+        if (bigint_random_chacha_seed(&random_default, NULL, 0) == false) {
+            printf("Invalid Case: No entropy from the operating system for the random source\n");
+            abort();
+        }
+        random_default_is_seeded = true;
+    }
+    bigint_random_chacha_fill(&random_default, buffer, byte_num);
+#endif
+}
+
+/**
+ * @brief Generates a random Bigint of exactly bit_length bits, the top bit is always set.
+ *
+ * The Bigint has exactly ceil(bit_length / BITLEN_OF_WORD) words, none of them refined away.
+ *
+ * @param result [out] Pointer to the generated Bigint, non-negative.
+ * @param bit_length [in] Number of bits, 0 gives zero.
+ */
+void bigint_random_bits(Bigint** result, size_t bit_length)
+{
+    if (bit_length == 0) {
+        bigint_set_zero(result);
+        return;
+    }
+
+    size_t digit_num = (bit_length + BITLEN_OF_WORD - 1) / BITLEN_OF_WORD;
+    bigint_new(result, digit_num);
+    bigint_random_bytes((*result)->digits, digit_num * SIZE_OF_WORD);
+
+    /* Clear the bits above the length and set the top one */
+    size_t top_bit = (bit_length - 1) % BITLEN_OF_WORD;
+    Word* top = &(*result)->digits[digit_num - 1];
+    if (top_bit + 1 < BITLEN_OF_WORD)
+        *top &= ((Word)1 << (top_bit + 1)) - 1;
+    *top |= (Word)1 << top_bit;
+}
+
+/**
+ * @brief Generates a uniformly random Bigint in [0, bound) by rejection sampling.
+ *
+ * Candidates have the bit length of the bound, so fewer than two are drawn on average.
+ *
+ * @param result [out] Pointer to the generated Bigint, may alias the bound.
+ * @param bound [in] Exclusive upper bound, positive.
+ */
+void bigint_random_below(Bigint** result, const Bigint* bound)
+{
+    /* Invalid case: empty range */
+    if (bound->sign == NEGATIVE || bigint_is_zero(bound)) {
+        printf("Invalid Case: Bound is not positive.\n");
+        return;
+    }
+
+    /* Significant words and bits of the bound */
+    size_t digit_num = bound->digit_num;
+    while (digit_num > 1 && bound->digits[digit_num - 1] == 0)
+        digit_num--;
+    Word top_word = bound->digits[digit_num - 1];
+    Word top_mask = top_word;
+    for (Word shift = 1; shift < BITLEN_OF_WORD; shift <<= 1)
+        top_mask |= top_mask >> shift;
+
+    Bigint* candidate = NULL;
+    bigint_new(&candidate, digit_num);
+
+    /* Draw until the candidate is below the bound */
+    for (;;) {
+        bigint_random_bytes(candidate->digits, digit_num * SIZE_OF_WORD);
+        candidate->digits[digit_num - 1] &= top_mask;
+
+        size_t idx = digit_num;
+        while (idx-- > 1 && candidate->digits[idx] == bound->digits[idx]);
+        if (candidate->digits[idx] < bound->digits[idx])
+            break;
+    }
+
+    /* Get result, the bound may alias it */
+    bigint_refine(candidate);
+    bigint_delete(result);
+    *result = candidate;
+}
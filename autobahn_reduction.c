@@ -1,4 +1,10 @@
-#include "autobahn.h"
+#include "autobahn_internal.h"
+
+/* Divisor length up to which the reciprocal is a single schoolbook division */
+#define RECIPROCAL_THRESHOLD 32
+
+/* Divisor length from which words_division_fast uses Barrett instead of schoolbook division */
+#define BARRETT_THRESHOLD 64
 
 /**
  * @brief Computes the pre-computed value for Barrett reduction.
@@ -8,6 +14,8 @@
  */
 void bigint_reduction_barrett_pre_computed(Bigint** barrett_pre_computed, const Bigint* modular) 
 {
+    PROFILE_SCOPE(PROFILE_REDUCTION_BARRETT_PRE_COMPUTED, modular->digit_num);
+
     /* Allocate memory for intermediate results */
     Bigint* remainder = NULL; // Remainder during computation
     Bigint* quotient = NULL;  // Pre-computed value for Barrett reduction
@@ -42,7 +50,9 @@ void bigint_reduction_barrett_pre_computed(Bigint** barrett_pre_computed, const
  * @param pre_computed [in] The pre-computed value.
  */
 void bigint_reduction_barrett(Bigint** result, const Bigint* dividend, const Bigint* modular, const Bigint* pre_computed) 
-{ 
+{
+    PROFILE_SCOPE(PROFILE_REDUCTION_BARRETT, dividend->digit_num + modular->digit_num);
+
     /* Check for invalid parameter: A is in the range [0, 2^(W * 2n) - 1] */
     if (dividend->digit_num > modular->digit_num * 2) {
         printf("Barrett reduction not applicable: A exceeds 2^(W * 2n)\n");
@@ -76,3 +86,279 @@ void bigint_reduction_barrett(Bigint** result, const Bigint* dividend, const Big
     bigint_delete(&quotient);
     bigint_delete(&remainder);
 }
+
+/**
+ * @brief Returns the number of scratch words needed by words_reciprocal.
+ *
+ * @param digit_num [in] Number of words of the divisor.
+ * @return size_t Number of scratch words.
+ */
+size_t words_reciprocal_scratch_size(size_t digit_num)
+{
+    size_t n = digit_num;
+
+    if (digit_num <= RECIPROCAL_THRESHOLD)
+        return (2 * n + 1) + words_division_scratch_size(2 * digit_num + 1, digit_num);
+
+    /* Reciprocal of the top half, then the Newton step buffers or the recursion */
+    size_t half = n / 2 + 2;
+    size_t step = 3 * (n + half + 2) + (n + 2 * half + 4) + (n + 3) + 2 * (2 * n + 3) + words_multiplication_scratch_size(n + half + 2, digit_num + 3);
+    size_t recursion = words_reciprocal_scratch_size(half);
+
+    return (half + 2) + (step > recursion ? step : recursion);
+}
+
+/**
+ * @brief Computes the Barrett reciprocal floor(W^(2n) / D) by Newton iteration.
+ *
+ * The reciprocal of the top half of D is refined by one Newton step, which doubles
+ * its precision, and the last units are corrected exactly. The cost is a few
+ * multiplications of n words instead of a quadratic schoolbook division.
+ *
+ * @param reciprocal [out] Reciprocal of digit_num + 2 words.
+ * @param divisor [in] Divisor D, its most significant word is not zero.
+ * @param digit_num [in] Number of words n of the divisor.
+ * @param scratch [in] Scratch of words_reciprocal_scratch_size(digit_num) words.
+ */
+void words_reciprocal(Word* reciprocal, const Word* divisor, size_t digit_num, Word* scratch)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_RECIPROCAL, digit_num);
+
+    size_t n = digit_num;
+
+    /* Short divisor: W^(2n) / D directly */
+    if (n <= RECIPROCAL_THRESHOLD) {
+        Word* power = scratch; // W^(2n)
+        memset(power, 0, (2 * (size_t)n + 1) * SIZE_OF_WORD);
+        power[2 * n] = 1;
+        words_division(reciprocal, NULL, power, 2 * n + 1, divisor, n, scratch + 2 * n + 1);
+        return;
+    }
+
+    /* Y <- W^(2h) / D_h for the top h words D_h of D */
+    size_t half = n / 2 + 2;
+    Word* top = scratch;            // Y, h + 2 words
+    Word* rest = scratch + half + 2;
+    words_reciprocal(top, divisor + n - half, half, rest);
+    size_t top_num = words_trim(top, half + 2);
+
+    size_t error_num = n + half + 2;
+    Word* power = rest;                   // W^(n + h)
+    Word* product = power + error_num;    // D * Y
+    Word* error = product + error_num;    // |W^(n + h) - D * Y|
+    Word* step = error + error_num;       // Y * error, then its top part
+    Word* result = step + n + 2 * half + 4; // X, n + 3 words
+    Word* check = result + n + 3;         // D * X
+    Word* power_check = check + 2 * n + 3; // W^(2n)
+    Word* multiplication_scratch = power_check + 2 * n + 3;
+
+    /* Error of the top reciprocal: W^(n + h) - D * Y */
+    memset(power, 0, 2 * error_num * SIZE_OF_WORD);
+    power[n + half] = 1;
+    words_multiplication(product, divisor, n, top, top_num, multiplication_scratch);
+    bool is_negative = words_compare(product, error_num, power, error_num) == LEFT_IS_BIG;
+    if (is_negative == true)
+        words_subtraction(error, product, error_num, power, error_num);
+    else
+        words_subtraction(error, power, error_num, product, error_num);
+    size_t error_trim = words_trim(error, error_num);
+
+    /* Newton step: X <- Y * W^(n - h) + Y * error / W^(2h) */
+    memset(result, 0, (n + 3) * SIZE_OF_WORD);
+    memcpy(result + n - half, top, (half + 2) * SIZE_OF_WORD);
+    if (error_trim > 0 && top_num + error_trim > 2 * half) {
+        words_multiplication(step, top, top_num, error, error_trim, multiplication_scratch);
+        size_t step_num = words_trim(step + 2 * half, top_num + error_trim - 2 * half);
+        if (step_num > n + 3)
+            step_num = n + 3;
+        Word borrow = 0;
+        if (is_negative == true)
+            borrow = words_subtraction(result, result, n + 3, step + 2 * half, step_num);
+        else
+            words_addition(result, result, n + 3, step + 2 * half, step_num);
+        if (borrow != 0)
+            memset(result, 0, (n + 3) * SIZE_OF_WORD);
+    }
+
+    /* Exact correction: 0 <= W^(2n) - D * X < D */
+    size_t check_num = 2 * n + 3;
+    size_t result_num = words_trim(result, n + 3);
+    Word one = 1;
+    memset(check, 0, 2 * check_num * SIZE_OF_WORD);
+    power_check[2 * n] = 1;
+    if (result_num > 0)
+        words_multiplication(check, divisor, n, result, result_num, multiplication_scratch);
+    if (words_compare(check, check_num, power_check, check_num) == LEFT_IS_BIG)
+    {
+        /* X too large: remove ceil((D * X - W^(2n)) / D) */
+        words_subtraction(check, check, check_num, power_check, check_num);
+        while (words_trim(check, check_num) > 0) {
+            words_subtraction(result, result, n + 3, &one, 1);
+            if (words_compare(check, check_num, divisor, n) == LEFT_IS_SMALL)
+                break;
+            words_subtraction(check, check, check_num, divisor, n);
+        }
+    }
+    else
+    {
+        /* X too small: add floor((W^(2n) - D * X) / D) */
+        words_subtraction(check, power_check, check_num, check, check_num);
+        while (words_compare(check, check_num, divisor, n) != LEFT_IS_SMALL) {
+            words_subtraction(check, check, check_num, divisor, n);
+            words_addition(result, result, n + 3, &one, 1);
+        }
+    }
+
+    memcpy(reciprocal, result, (n + 2) * SIZE_OF_WORD);
+}
+
+/**
+ * @brief Returns the number of scratch words needed by words_reduction_barrett.
+ *
+ * @param dividend_digit_num [in] Number of words of the dividend.
+ * @param digit_num [in] Number of words of the modulus.
+ * @return size_t Number of scratch words.
+ */
+size_t words_reduction_barrett_scratch_size(size_t dividend_digit_num, size_t digit_num)
+{
+    return dividend_digit_num + 3 * (2 * digit_num + 4) + words_multiplication_scratch_size(digit_num + 2, digit_num + 2);
+}
+
+/**
+ * @brief Divides a block of at most 2n words in place by Barrett reduction, the high words end up zero.
+ *
+ * @param block_quotient [out] Quotient of digit_num + 2 words.
+ * @param block [in, out] Block of block_digit_num words, replaced by its remainder.
+ * @param block_digit_num [in] Number of words of the block, at most 2 * digit_num.
+ * @param modular [in] Modulus N.
+ * @param digit_num [in] Number of words n of the modulus.
+ * @param reciprocal [in] floor(W^(2n) / N).
+ * @param reciprocal_num [in] Number of significant words of the reciprocal.
+ * @param scratch [in] Scratch words.
+ */
+static void reduction_barrett_block(Word* block_quotient, Word* block, size_t block_digit_num, const Word* modular, size_t digit_num, const Word* reciprocal, size_t reciprocal_num, Word* scratch)
+{
+    size_t n = digit_num;
+    size_t m = words_trim(block, block_digit_num);
+    Word one = 1;
+
+    /* Already reduced */
+    memset(block_quotient, 0, (n + 2) * SIZE_OF_WORD);
+    if (m < n)
+        return;
+
+    Word* quotient = scratch;              // (A >> W^(n-1)) * T
+    Word* product = quotient + 2 * n + 4;  // Q * N
+    Word* multiplication_scratch = product + 2 * n + 4;
+
+    /* Q <- ((A >> W^(n-1)) * T) >> W^(n+1), at most two below the true quotient */
+    size_t shifted_num = m - n + 1;
+    size_t quotient_num = 0;
+    words_multiplication(quotient, block + n - 1, shifted_num, reciprocal, reciprocal_num, multiplication_scratch);
+    if (shifted_num + reciprocal_num > n + 1)
+        quotient_num = words_trim(quotient + n + 1, shifted_num + reciprocal_num - (n + 1));
+
+    /* A <- A - Q * N */
+    if (quotient_num > 0) {
+        memcpy(block_quotient, quotient + n + 1, quotient_num * SIZE_OF_WORD);
+        words_multiplication(product, quotient + n + 1, quotient_num, modular, n, multiplication_scratch);
+        words_subtraction(block, block, m, product, words_trim(product, quotient_num + n));
+    }
+
+    /* A is R, R + N or R + 2N */
+    while (words_compare(block, m, modular, n) != LEFT_IS_SMALL) {
+        words_subtraction(block, block, m, modular, n);
+        words_addition(block_quotient, block_quotient, n + 2, &one, 1);
+    }
+}
+
+/**
+ * @brief Divides an array by an n-word modulus by Barrett reduction.
+ *
+ * A dividend longer than 2n words is folded from the top: its top 2n words are
+ * reduced to n words, one Barrett step per n words of the dividend.
+ *
+ * @param quotient [out] Quotient of dividend_digit_num - digit_num + 1 words, or NULL.
+ * @param remainder [out] Remainder of digit_num words, may alias the dividend, or NULL.
+ * @param dividend [in] Dividend, of at least digit_num words if the quotient is wanted.
+ * @param dividend_digit_num [in] Number of words of the dividend.
+ * @param modular [in] Modulus N, its most significant word is not zero.
+ * @param digit_num [in] Number of words n of the modulus.
+ * @param reciprocal [in] floor(W^(2n) / N) of digit_num + 2 words, from words_reciprocal.
+ * @param scratch [in] Scratch of words_reduction_barrett_scratch_size(dividend_digit_num, digit_num) words.
+ */
+void words_reduction_barrett(Word* quotient, Word* remainder, const Word* dividend, size_t dividend_digit_num, const Word* modular, size_t digit_num, const Word* reciprocal, Word* scratch)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_REDUCTION_BARRETT, dividend_digit_num + digit_num);
+
+    size_t n = digit_num;
+    size_t m = words_trim(dividend, dividend_digit_num);
+    size_t reciprocal_num = words_trim(reciprocal, n + 2);
+    Word* work = scratch;                       // Copy of the dividend, reduced in place
+    Word* block_quotient = scratch + m;         // Quotient of one block
+    Word* block_scratch = block_quotient + 2 * n + 4;
+
+    if (quotient != NULL)
+        memset(quotient, 0, (dividend_digit_num - n + 1) * SIZE_OF_WORD);
+
+    /* Fold the top 2n words into n words until at most 2n are left */
+    memcpy(work, dividend, m * SIZE_OF_WORD);
+    while (m > 2 * n) {
+        reduction_barrett_block(block_quotient, work + m - 2 * n, 2 * n, modular, n, reciprocal, reciprocal_num, block_scratch);
+        if (quotient != NULL)
+            words_addition(quotient + m - 2 * n, quotient + m - 2 * n, dividend_digit_num - n + 1 - (m - 2 * n), block_quotient, n + 1);
+        m -= n;
+    }
+    reduction_barrett_block(block_quotient, work, m, modular, n, reciprocal, reciprocal_num, block_scratch);
+    if (quotient != NULL && m >= n)
+        words_addition(quotient, quotient, dividend_digit_num - n + 1, block_quotient, m - n + 1);
+
+    if (remainder != NULL) {
+        memset(remainder, 0, n * SIZE_OF_WORD);
+        memcpy(remainder, work, (m < n ? m : n) * SIZE_OF_WORD);
+    }
+}
+
+/**
+ * @brief Returns the number of scratch words needed by words_division_fast.
+ *
+ * @param dividend_digit_num [in] Number of words of the dividend.
+ * @param divisor_digit_num [in] Number of words of the divisor.
+ * @return size_t Number of scratch words.
+ */
+size_t words_division_fast_scratch_size(size_t dividend_digit_num, size_t divisor_digit_num)
+{
+    size_t division_num = words_division_scratch_size(dividend_digit_num > divisor_digit_num ? dividend_digit_num : divisor_digit_num, divisor_digit_num);
+    size_t reciprocal_num = words_reciprocal_scratch_size(divisor_digit_num);
+    size_t barrett_num = words_reduction_barrett_scratch_size(dividend_digit_num, divisor_digit_num);
+
+    if (divisor_digit_num < BARRETT_THRESHOLD)
+        return division_num;
+
+    return (divisor_digit_num + 2) + (reciprocal_num > barrett_num ? reciprocal_num : barrett_num);
+}
+
+/**
+ * @brief Divides two arrays: Barrett with a Newton reciprocal for long divisors, schoolbook for short ones.
+ *
+ * @param quotient [out] Quotient of dividend_digit_num - divisor_digit_num + 1 words, or NULL.
+ * @param remainder [out] Remainder of divisor_digit_num words, or NULL.
+ * @param dividend [in] Dividend of at least divisor_digit_num words.
+ * @param dividend_digit_num [in] Number of words of the dividend.
+ * @param divisor [in] Divisor, its most significant word is not zero.
+ * @param divisor_digit_num [in] Number of words of the divisor.
+ * @param scratch [in] Scratch of words_division_fast_scratch_size(dividend_digit_num, divisor_digit_num) words.
+ */
+void words_division_fast(Word* quotient, Word* remainder, const Word* dividend, size_t dividend_digit_num, const Word* divisor, size_t divisor_digit_num, Word* scratch)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_DIVISION_FAST, dividend_digit_num + divisor_digit_num);
+
+    if (divisor_digit_num < BARRETT_THRESHOLD) {
+        words_division(quotient, remainder, dividend, dividend_digit_num, divisor, divisor_digit_num, scratch);
+        return;
+    }
+
+    Word* reciprocal = scratch;
+    words_reciprocal(reciprocal, divisor, divisor_digit_num, scratch + divisor_digit_num + 2);
+    words_reduction_barrett(quotient, remainder, dividend, dividend_digit_num, divisor, divisor_digit_num, reciprocal, scratch + divisor_digit_num + 2);
+}
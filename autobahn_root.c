@@ -0,0 +1,369 @@
+#include "autobahn_internal.h"
+
+/* Operand length in words up to which a root is found by Newton iteration on the whole operand */
+#define ROOT_NEWTON_WORDS 4
+
+/**
+ * @brief Returns the number of significant bits of a Bigint.
+ *
+ * @param operand [in] Operand.
+ * @return size_t Bit length, zero for zero.
+ */
+static size_t root_bit_length(const Bigint* operand)
+{
+    size_t digit_num = words_trim(operand->digits, operand->digit_num);
+
+    if (digit_num == 0)
+        return 0;
+
+    return (digit_num - 1) * BITLEN_OF_WORD + word_bit_length(operand->digits[digit_num - 1]);
+}
+
+/**
+ * @brief Computes result = operand * 2^bits for a non-negative operand.
+ *
+ * @param result [out] Pointer to the result, may alias the operand.
+ * @param operand [in] Operand.
+ * @param bits [in] Shift in bits.
+ */
+static void root_shift_left(Bigint** result, const Bigint* operand, size_t bits)
+{
+    Bigint* tmp_result = NULL;
+    size_t word_shift = bits / BITLEN_OF_WORD;
+    Word bit_shift = (Word)(bits % BITLEN_OF_WORD);
+
+    bigint_new(&tmp_result, operand->digit_num + word_shift + 1);
+    for (size_t idx = 0; idx < operand->digit_num; idx++) {
+        tmp_result->digits[idx + word_shift] |= operand->digits[idx] << bit_shift;
+        if (bit_shift != 0)
+            tmp_result->digits[idx + word_shift + 1] = operand->digits[idx] >> (BITLEN_OF_WORD - bit_shift);
+    }
+
+    bigint_refine(tmp_result);
+    bigint_delete(result);
+    *result = tmp_result;
+}
+
+/**
+ * @brief Computes result = floor(operand / 2^bits) for a non-negative operand.
+ *
+ * @param result [out] Pointer to the result, may alias the operand.
+ * @param operand [in] Operand.
+ * @param bits [in] Shift in bits.
+ */
+static void root_shift_right(Bigint** result, const Bigint* operand, size_t bits)
+{
+    Bigint* tmp_result = NULL;
+    size_t word_shift = bits / BITLEN_OF_WORD;
+    Word bit_shift = (Word)(bits % BITLEN_OF_WORD);
+    size_t digit_num = word_shift < operand->digit_num ? operand->digit_num - word_shift : 0;
+
+    bigint_new(&tmp_result, digit_num);
+    for (size_t idx = 0; idx < digit_num; idx++) {
+        tmp_result->digits[idx] = operand->digits[idx + word_shift] >> bit_shift;
+        if (bit_shift != 0 && idx + 1 < digit_num)
+            tmp_result->digits[idx] |= operand->digits[idx + word_shift + 1] << (BITLEN_OF_WORD - bit_shift);
+    }
+
+    bigint_refine(tmp_result);
+    bigint_delete(result);
+    *result = tmp_result;
+}
+
+/**
+ * @brief Computes result = operand mod 2^bits for a non-negative operand.
+ *
+ * @param result [out] Pointer to the result.
+ * @param operand [in] Operand.
+ * @param bits [in] Number of low bits kept.
+ */
+static void root_low_bits(Bigint** result, const Bigint* operand, size_t bits)
+{
+    Bigint* tmp_result = NULL;
+    size_t word_num = (bits + BITLEN_OF_WORD - 1) / BITLEN_OF_WORD;
+    size_t digit_num = word_num < operand->digit_num ? word_num : operand->digit_num;
+
+    bigint_set_by_array(&tmp_result, operand->digits, POSITIVE, digit_num);
+    if (digit_num == word_num && bits % BITLEN_OF_WORD != 0)
+        tmp_result->digits[digit_num - 1] &= ((Word)1 << (bits % BITLEN_OF_WORD)) - 1;
+
+    bigint_refine(tmp_result);
+    bigint_delete(result);
+    *result = tmp_result;
+}
+
+/**
+ * @brief Computes result = operand^degree by square-and-multiply.
+ *
+ * @param result [out] Pointer to the result.
+ * @param operand [in] Non-negative operand.
+ * @param degree [in] Exponent.
+ */
+static void root_power(Bigint** result, const Bigint* operand, Word degree)
+{
+    Bigint* tmp_result = NULL;
+    bigint_set_one(&tmp_result);
+
+    for (Word bit_idx = (Word)word_bit_length(degree); bit_idx-- > 0;) {
+        words_multiplication_bigint(&tmp_result, tmp_result, tmp_result);
+        if (GET_BIT(degree, bit_idx) == 1)
+            words_multiplication_bigint(&tmp_result, tmp_result, operand);
+    }
+
+    bigint_delete(result);
+    *result = tmp_result;
+}
+
+/**
+ * @brief Refines a root from above by integer Newton iteration: x <- ((k - 1) x + N / x^(k-1)) / k.
+ *
+ * The sequence decreases while x is above floor(N^(1/k)) and stops there.
+ *
+ * @param root [in, out] Start value, at least floor(N^(1/k)), replaced by floor(N^(1/k)).
+ * @param operand [in] Non-negative operand N.
+ * @param degree [in] Degree k, at least 2.
+ */
+static void root_newton(Bigint** root, const Bigint* operand, Word degree)
+{
+    Bigint* power = NULL;
+    Bigint* next = NULL;
+    Bigint* degree_minus_one = NULL;
+    Bigint* degree_bigint = NULL;
+    Word word_degree = degree - 1;
+
+    bigint_set_by_array(&degree_minus_one, &word_degree, POSITIVE, 1);
+    bigint_set_by_array(&degree_bigint, &degree, POSITIVE, 1);
+
+    while (bigint_is_zero(*root) == FALSE)
+    {
+        /* next <- ((k - 1) x + N / x^(k-1)) / k */
+        root_power(&power, *root, degree - 1);
+        words_division_bigint(&next, NULL, operand, power);
+        words_multiplication_bigint(&power, *root, degree_minus_one);
+        bigint_addition(&next, next, power);
+        words_division_bigint(&next, NULL, next, degree_bigint);
+
+        /* Stop once it no longer decreases */
+        if (bigint_compare(next, *root) != LEFT_IS_SMALL)
+            break;
+        bigint_copy(root, next);
+    }
+
+    bigint_delete(&power);
+    bigint_delete(&next);
+    bigint_delete(&degree_minus_one);
+    bigint_delete(&degree_bigint);
+}
+
+/**
+ * @brief Computes floor(sqrt(N)) of a non-negative operand by Karatsuba square root (Zimmermann).
+ *
+ * The operand is shifted by an even number of bits to 4b - 1 or 4b bits. The root of its
+ * top half gives the top half of the root, a division by twice that root gives the low half,
+ * and the remainder is corrected once. The cost is a small multiple of one multiplication.
+ *
+ * @param root [out] Pointer to the root.
+ * @param remainder [out] Pointer to N - root^2.
+ * @param operand [in] Non-negative operand N.
+ */
+static void root_sqrtrem_recursive(Bigint** root, Bigint** remainder, const Bigint* operand)
+{
+    size_t bit_length = root_bit_length(operand);
+
+    /* Short operand: Newton from 2^ceil(bits / 2) */
+    if (bit_length <= ROOT_NEWTON_WORDS * BITLEN_OF_WORD)
+    {
+        Bigint* square = NULL;
+        bigint_set_one(root);
+        root_shift_left(root, *root, (bit_length + 1) / 2);
+        root_newton(root, operand, 2);
+        words_multiplication_bigint(&square, *root, *root);
+        bigint_subtraction(remainder, operand, square);
+        bigint_delete(&square);
+        return;
+    }
+
+    Bigint* normalized = NULL;
+    Bigint* high_root = NULL;
+    Bigint* high_remainder = NULL;
+    Bigint* low_one = NULL;  // a1
+    Bigint* low_zero = NULL; // a0
+    Bigint* dividend = NULL;
+    Bigint* divisor = NULL;
+    Bigint* quotient = NULL;
+    Bigint* tmp = NULL;
+
+    /* Normalize: shift by 2c bits to 4b - 1 or 4b bits, beta = 2^b */
+    size_t quarter = (bit_length + 3) / 4;
+    size_t half_shift = bit_length + 1 < 4 * quarter ? (4 * quarter - 1 - bit_length + 1) / 2 : 0;
+    root_shift_left(&normalized, operand, 2 * half_shift);
+
+    /* (s', r') <- sqrtrem(a3 beta + a2) */
+    root_shift_right(&tmp, normalized, 2 * quarter);
+    root_sqrtrem_recursive(&high_root, &high_remainder, tmp);
+
+    /* (q, u) <- divrem(r' beta + a1, 2 s') */
+    root_shift_right(&low_one, normalized, quarter);
+    root_low_bits(&low_one, low_one, quarter);
+    root_low_bits(&low_zero, normalized, quarter);
+    root_shift_left(&dividend, high_remainder, quarter);
+    bigint_addition(&dividend, dividend, low_one);
+    root_shift_left(&divisor, high_root, 1);
+    words_division_bigint(&quotient, &dividend, dividend, divisor);
+
+    /* s <- s' beta + q, r <- u beta + a0 - q^2 */
+    root_shift_left(root, high_root, quarter);
+    bigint_addition(root, *root, quotient);
+    root_shift_left(remainder, dividend, quarter);
+    bigint_addition(remainder, *remainder, low_zero);
+    words_multiplication_bigint(&tmp, quotient, quotient);
+    bigint_subtraction(remainder, *remainder, tmp);
+
+    /* r < 0: r <- r + 2s - 1, s <- s - 1 */
+    if ((*remainder)->sign == NEGATIVE) {
+        bigint_set_one(&tmp);
+        bigint_subtraction(root, *root, tmp);
+        root_shift_left(&tmp, *root, 1);
+        bigint_addition(remainder, *remainder, tmp);
+        bigint_set_one(&tmp);
+        bigint_addition(remainder, *remainder, tmp);
+    }
+
+    /* Undo the normalization: root >> c, remainder from the operand */
+    if (half_shift != 0) {
+        root_shift_right(root, *root, half_shift);
+        words_multiplication_bigint(&tmp, *root, *root);
+        bigint_subtraction(remainder, operand, tmp);
+    }
+
+    bigint_delete(&normalized);
+    bigint_delete(&high_root);
+    bigint_delete(&high_remainder);
+    bigint_delete(&low_one);
+    bigint_delete(&low_zero);
+    bigint_delete(&dividend);
+    bigint_delete(&divisor);
+    bigint_delete(&quotient);
+    bigint_delete(&tmp);
+}
+
+/**
+ * @brief Computes the integer square root and its remainder: root = floor(sqrt(N)), remainder = N - root^2.
+ *
+ * @param root [out] Pointer to the root.
+ * @param remainder [out] Pointer to the remainder, or NULL.
+ * @param operand [in] Non-negative operand N.
+ */
+void bigint_sqrtrem(Bigint** root, Bigint** remainder, const Bigint* operand)
+{
+    PROFILE_SCOPE(PROFILE_SQRTREM, operand->digit_num);
+
+    /* Invalid case: negative operand */
+    if (operand->sign == NEGATIVE && bigint_is_zero(operand) == FALSE) {
+        printf("Invalid Case: Operand is negative.\n");
+        return;
+    }
+
+    Bigint* tmp_root = NULL;
+    Bigint* tmp_remainder = NULL;
+    root_sqrtrem_recursive(&tmp_root, &tmp_remainder, operand);
+
+    /* Get results, the operand may alias the outputs */
+    bigint_delete(root);
+    *root = tmp_root;
+    if (remainder != NULL) {
+        bigint_delete(remainder);
+        *remainder = tmp_remainder;
+    }
+    else
+        bigint_delete(&tmp_remainder);
+}
+
+/**
+ * @brief Computes floor(N^(1/k)) by Newton iteration seeded from the root of the top bits.
+ *
+ * The top bits of N give the top half of the root recursively, one above it is a start
+ * within a few units of the root, and Newton iteration from above finishes in a few steps.
+ * Each level costs a few multiplications and divisions of its own size, so the total is
+ * a small multiple of the last level.
+ *
+ * @param root [out] Pointer to the root.
+ * @param operand [in] Non-negative operand N.
+ * @param degree [in] Degree k, at least 2.
+ */
+static void root_rootrem_recursive(Bigint** root, const Bigint* operand, Word degree)
+{
+    size_t bit_length = root_bit_length(operand);
+    size_t root_bit = (bit_length + degree - 1) / degree; // Bits of 2^ceil(bits / k), above the root
+
+    /* Short root: Newton from 2^ceil(bits / k) */
+    if (root_bit <= ROOT_NEWTON_WORDS * BITLEN_OF_WORD / 2) {
+        bigint_set_one(root);
+        root_shift_left(root, *root, root_bit);
+        root_newton(root, operand, degree);
+        return;
+    }
+
+    /* Root of the top bits: N >> (k m) has a root of about half the bits */
+    Bigint* high = NULL;
+    Bigint* one = NULL;
+    size_t half_bit = root_bit / 2;
+    root_shift_right(&high, operand, (size_t)degree * half_bit);
+    root_rootrem_recursive(root, high, degree);
+
+    /* (x' + 1) 2^m is above the root, then Newton from above */
+    bigint_set_one(&one);
+    bigint_addition(root, *root, one);
+    root_shift_left(root, *root, half_bit);
+    root_newton(root, operand, degree);
+
+    bigint_delete(&high);
+    bigint_delete(&one);
+}
+
+/**
+ * @brief Computes the integer k-th root and its remainder: root = floor(N^(1/k)), remainder = N - root^k.
+ *
+ * @param root [out] Pointer to the root.
+ * @param remainder [out] Pointer to the remainder, or NULL.
+ * @param operand [in] Non-negative operand N.
+ * @param degree [in] Degree k, at least 1.
+ */
+void bigint_rootrem(Bigint** root, Bigint** remainder, const Bigint* operand, Word degree)
+{
+    PROFILE_SCOPE(PROFILE_ROOTREM, operand->digit_num);
+
+    /* Invalid case: negative operand or zeroth root */
+    if (operand->sign == NEGATIVE && bigint_is_zero(operand) == FALSE) {
+        printf("Invalid Case: Operand is negative.\n");
+        return;
+    }
+    if (degree == 0) {
+        printf("Invalid Case: Degree must be non-zero.\n");
+        return;
+    }
+
+    /* Square root: Karatsuba square root */
+    if (degree == 2) {
+        bigint_sqrtrem(root, remainder, operand);
+        return;
+    }
+
+    Bigint* tmp_root = NULL;
+    Bigint* power = NULL;
+
+    if (degree == 1)
+        bigint_copy(&tmp_root, operand);
+    else
+        root_rootrem_recursive(&tmp_root, operand, degree);
+
+    /* remainder <- N - root^k */
+    if (remainder != NULL) {
+        root_power(&power, tmp_root, degree);
+        bigint_subtraction(remainder, operand, power);
+    }
+
+    bigint_delete(root);
+    *root = tmp_root;
+    bigint_delete(&power);
+}
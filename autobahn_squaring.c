@@ -1,95 +1,41 @@
-#include "autobahn.h"
+#include "autobahn_internal.h"
 
 /**
- * @brief Performs squaring of a word.
+ * @brief Performs squaring of a word into a Bigint.
  * 
  * @param result [out] Pointer to the resulting Bigint.
  * @param operand_x [in] Operand word to be squared.
  */
-static void word_squaring(Bigint** result, Word operand_x) 
+static void word_squaring_bigint(Bigint** result, Word operand_x)
 {
-    Word bitlen_half = BITLEN_OF_WORD / 2;
-    Bigint* tmp_result = NULL;
-    
-    /* Allocate memory for Bigint */
-    bigint_new(&tmp_result, 2);
-
-    /* Initialize variables */
-    Word x_high = operand_x >> bitlen_half;               // A1: Upper half of operand_x
-    Word x_low = (x_high << bitlen_half) ^ operand_x;     // A0: Lower half of operand_x
-    Word carry = 0;
-
-    /* Compute high and low */
-    tmp_result->digits[1] = x_high * x_high; // A1A1
-    tmp_result->digits[0] = x_low * x_low;   // A0A0
-
-    /* Divide the middle */
-    Word x_middle_low = (x_low * x_high) << bitlen_half;  // Upper half of A1A0
-    Word x_middle_high = (x_low * x_high) >> bitlen_half; // Lower half of A1A0
-
-    /* Compute the middle */
-    carry = GET_MSB(x_middle_low);    // Carry of one-bit left shift
-    x_middle_low = x_middle_low << 1; // Left shift
-    x_middle_high = (x_middle_high << 1) + carry; // Left shift with carry, we have 2A1A0
+    Word digits[2];
 
-    /* Compute the result */
-    tmp_result->digits[0] += x_middle_low;          // A0A0 + Lower A1A0
-    carry = tmp_result->digits[0] < x_middle_low;   // Set carry
-    tmp_result->digits[1] += x_middle_high + carry; // A1A1 + Upper A1A0 + carry
+    /* (high||low) = x^2 */
+    word_squaring(&digits[1], &digits[0], operand_x);
 
-    /* Finalize the result */
-    bigint_refine(tmp_result);
-    bigint_copy(result, tmp_result);
-    
-    /* Free allocated memory for Bigint */
-    bigint_delete(&tmp_result); 
+    /* Get result */
+    bigint_set_by_array(result, digits, POSITIVE, 2);
+    bigint_refine(*result);
 }
 
 
 /**
- * @brief Performs multiplication of two words.
- * 
+ * @brief Performs multiplication of two words into a Bigint.
+ *
  * @param result [out] Pointer to the resulting Bigint.
  * @param operand_x [in] First operand word.
  * @param operand_y [in] Second operand word.
  */
-static void word_multiplication(Bigint** result, const Word operand_x, const Word operand_y) 
+static void word_multiplication_bigint(Bigint** result, const Word operand_x, const Word operand_y)
 {
-    Bigint *tmp_result = NULL;
-
-    /* Allocate Bigint */
-    bigint_new(&tmp_result, 2); // this will be the result
-
-    /* Initialize variables */
-    Word bitlen_half = BITLEN_OF_WORD / 2;
-    Word x_high = operand_x >> bitlen_half;           // Upper half of operand_x
-    Word x_low = (x_high << bitlen_half) ^ operand_x; // Lower half of operand_x
-    Word y_high = operand_y >> bitlen_half;           // Upper half of operand_y
-    Word y_low = (y_high << bitlen_half) ^ operand_y; // Lower half of operand_y
-
-    /* Compute high and low value */
-    tmp_result->digits[0] = x_low * y_low;   // A0B0
-    tmp_result->digits[1] = x_high * y_high; // A1B1
-
-    /* Compute middle value */
-    Word middle = x_high * y_low + y_high * x_low; // A1B0 + A0B1
-    Word carry = middle < x_high * y_low;          // set carry.
-
-    /* Divide middle value */
-    Word middle_low  = middle << bitlen_half; // Lower half of A1B0 + A0B1 : L
-    Word middle_high = (middle >> bitlen_half) + (carry << bitlen_half); // Upper half of A1B0 + A0B1, consider carry : U
+    Word digits[2];
 
-    /* Compute the result */
-    tmp_result->digits[0] += middle_low;          // A0B0 + L
-    carry = tmp_result->digits[0] < middle_low;   // set carry
-    tmp_result->digits[1] += middle_high + carry; // A1B1 + U + carry
+    /* (high||low) = x * y */
+    word_multiplication(&digits[1], &digits[0], operand_x, operand_y);
 
     /* Get result */
-    bigint_refine(tmp_result);
-    bigint_copy(result, tmp_result);
-
-    /* Free Bigint */
-    bigint_delete(&tmp_result);
+    bigint_set_by_array(result, digits, POSITIVE, 2);
+    bigint_refine(*result);
 }
 
 /**
@@ -100,6 +46,8 @@ static void word_multiplication(Bigint** result, const Word operand_x, const Wor
  */
 void bigint_squaring_textbook(Bigint** result, const Bigint* operand_x)
 {
+    PROFILE_SCOPE(PROFILE_SQUARING_TEXTBOOK, operand_x->digit_num);
+
     Bigint* tmp_result = NULL; 
     Bigint* diagonal = NULL; 
     Bigint* diagonal_sum = NULL; 
@@ -118,15 +66,15 @@ void bigint_squaring_textbook(Bigint** result, const Bigint* operand_x)
     bigint_set_zero(&upper_sum);
     
     /* Compute squaring */
-    for (int idx = 0; idx < operand_x->digit_num; idx++) 
+    for (size_t idx = 0; idx < operand_x->digit_num; idx++) 
     {
-        word_squaring(&diagonal, operand_x->digits[idx]);       // Ai * Ai
+        word_squaring_bigint(&diagonal, operand_x->digits[idx]);       // Ai * Ai
         bigint_expand(&diagonal, diagonal, idx + idx);          // Set correct index
         bigint_addition(&diagonal_sum, diagonal_sum, diagonal); // sum(Ai * Ai)
         
-        for (int jdx = idx + 1; jdx < operand_x->digit_num; jdx++) 
+        for (size_t jdx = idx + 1; jdx < operand_x->digit_num; jdx++) 
         {
-            word_multiplication(&upper, operand_x->digits[idx], operand_x->digits[jdx]); // Ai * Aj
+            word_multiplication_bigint(&upper, operand_x->digits[idx], operand_x->digits[jdx]); // Ai * Aj
             bigint_expand(&upper, upper, jdx + idx);       // Set correct index
             bigint_addition(&upper_sum, upper_sum, upper); // sum(Ai * Aj)
         }
@@ -157,6 +105,8 @@ void bigint_squaring_textbook(Bigint** result, const Bigint* operand_x)
  */
 void bigint_squaring_karatsuba(Bigint** result, Bigint* operand_x)
 {
+    PROFILE_SCOPE(PROFILE_SQUARING_KARATSUBA, operand_x->digit_num);
+
     /* Special case: multiplication by zero */
     if (bigint_is_zero(operand_x)) {
         bigint_set_zero(result);
@@ -186,7 +136,7 @@ void bigint_squaring_karatsuba(Bigint** result, Bigint* operand_x)
     bigint_new(&tmp_result, 1);
 
     /* Determine divide size */
-    Word digit_num_half = (operand_x->digit_num + 1) >> 1;
+    size_t digit_num_half = (operand_x->digit_num + 1) >> 1;
     
     /* Divide operands into upper and lower parts */
     bigint_compress(&x_high, operand_x, digit_num_half);    // A0
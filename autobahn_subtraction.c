@@ -1,25 +1,8 @@
-#include "autobahn.h"
+#include "autobahn_internal.h"
 
 #pragma warning(disable: 28182)
 #pragma warning(disable: 6308)
 
-/**
- * @brief Perform word subtraction with borrow.
- * 
- * @param result [out] - The result of the subtraction.
- * @param next_borrow [out] - The borrow to be propagated to the next subtraction.
- * @param current_borrow [in] - The borrow from the previous subtraction.
- * @param operand_x [in] - The minuend.
- * @param operand_y [in] - The subtrahend.
- */
-static void word_subtraction_with_borrow(Word* result, Word* next_borrow, Word current_borrow, Word operand_x, Word operand_y) 
-{
-    *result      = operand_x - operand_y;       // Calculate difference: r = x - y
-    *next_borrow = operand_x < operand_y;       // Set borrow if x < y
-    *next_borrow += *result < current_borrow;   // Set borrow if r < c
-    *result      -= current_borrow;             // Adjust result for the borrow: r = x - y - b
-}
-
 /**
  * @brief Perform unsigned subtraction of two big integers.
  * 
@@ -36,11 +19,11 @@ void bigint_subtraction_unsigned(Bigint** result, Bigint* operand_x, Bigint* ope
     /* Ensure operands have the same number of digits */      
     if (operand_y->digit_num != operand_x->digit_num)
     {
-        Word previous_digit_num = operand_y->digit_num; 
-        Word new_digit_num = operand_x->digit_num;    
+        size_t previous_digit_num = operand_y->digit_num; 
+        size_t new_digit_num = operand_x->digit_num;    
 
         /* Make same number of digits */
-        operand_y->digits = (Word*)realloc(operand_y->digits, (operand_x->digit_num) * SIZE_OF_WORD);
+        operand_y->digits = (Word*)bigint_realloc(operand_y->digits, (operand_x->digit_num) * SIZE_OF_WORD);
         operand_y->digit_num = new_digit_num;
 
         /* Guard the trash data */
@@ -52,7 +35,7 @@ void bigint_subtraction_unsigned(Bigint** result, Bigint* operand_x, Bigint* ope
     bigint_new(&tmp_result, operand_x->digit_num);
 
     /* Subtraction word by word with borrow */
-    for (int idx = 0; idx < operand_x->digit_num; idx++) 
+    for (size_t idx = 0; idx < operand_x->digit_num; idx++) 
     {
         word_subtraction_with_borrow(&(tmp_result->digits[idx]), &next_borrow, current_borrow, operand_x->digits[idx], operand_y->digits[idx]);
         current_borrow = next_borrow; // Update the borrow.
@@ -76,6 +59,8 @@ void bigint_subtraction_unsigned(Bigint** result, Bigint* operand_x, Bigint* ope
  */
 void bigint_subtraction(Bigint** result, const Bigint* operand_x, const Bigint* operand_y)
 {
+    PROFILE_SCOPE(PROFILE_SUBTRACTION, operand_x->digit_num + operand_y->digit_num);
+
     /* Use temporary variables to avoid modifying the input operands */
     Bigint* tmp_x = NULL;
     Bigint* tmp_y = NULL;
@@ -138,3 +123,36 @@ void bigint_subtraction(Bigint** result, const Bigint* operand_x, const Bigint*
     bigint_delete(&tmp_x);
     bigint_delete(&tmp_y);
 }
+
+/**
+ * @brief Subtracts two arrays: result = X - Y, the result may alias the operands.
+ *
+ * @param result [out] Result of digit_num_x words.
+ * @param operand_x [in] Minuend.
+ * @param digit_num_x [in] Number of words of the minuend.
+ * @param operand_y [in] Subtrahend.
+ * @param digit_num_y [in] Number of words of the subtrahend, at most digit_num_x.
+ * @return Word Final borrow, 1 if X < Y.
+ */
+Word words_subtraction(Word* result, const Word* operand_x, size_t digit_num_x, const Word* operand_y, size_t digit_num_y)
+{
+    PROFILE_SCOPE(PROFILE_WORDS_SUBTRACTION, digit_num_x + digit_num_y);
+
+    Word current_borrow = 0;
+    Word next_borrow = 0;
+
+    /* Subtraction word by word with borrow */
+    for (size_t idx = 0; idx < digit_num_y; idx++) {
+        word_subtraction_with_borrow(&result[idx], &next_borrow, current_borrow, operand_x[idx], operand_y[idx]);
+        current_borrow = next_borrow;
+    }
+
+    /* Propagate the borrow */
+    for (size_t idx = digit_num_y; idx < digit_num_x; idx++) {
+        Word word = operand_x[idx]; // Read before the write, the result may alias X
+        result[idx] = word - current_borrow;
+        current_borrow = (word < current_borrow);
+    }
+
+    return current_borrow;
+}
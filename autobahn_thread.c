@@ -0,0 +1,263 @@
+#include "autobahn_internal.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+/** @brief Range of tasks owned by one worker, other workers steal from its head. */
+typedef struct {
+    atomic_size_t next; /**< Next task index to take. */
+    size_t end;         /**< One past the last task index. */
+    char padding[64];   /**< Keep ranges on separate cache lines. */
+} TaskRange;
+
+/** @brief Scratch arena of one worker. */
+typedef struct {
+    Word* words;      /**< Scratch words. */
+    size_t word_num;  /**< Number of allocated words. */
+} ScratchArena;
+
+/** @brief Structure representing a pool of worker threads. */
+struct ThreadPool {
+    size_t thread_num;       /**< Number of workers, including the calling thread. */
+    pthread_t* threads;      /**< Spawned threads, thread_num - 1 of them. */
+    TaskRange* ranges;       /**< Task range of each worker. */
+    ScratchArena* arenas;    /**< Scratch arena of each worker. */
+    ThreadTask task;         /**< Task of the current run. */
+    void* argument;          /**< Argument of the current run. */
+    pthread_mutex_t mutex;   /**< Protects the fields below. */
+    pthread_cond_t start;    /**< Signals a new run or shutdown. */
+    pthread_cond_t done;     /**< Signals the end of a run. */
+    size_t generation;       /**< Incremented at each run. */
+    size_t finished;         /**< Number of spawned threads done with the current run. */
+    bool stop;               /**< Shutdown flag. */
+};
+
+/** @brief Pools created and not yet deleted, the memory functions cannot change while one is live. */
+static atomic_size_t thread_pool_num;
+
+/** @brief Argument of a spawned thread. */
+typedef struct {
+    ThreadPool* pool;
+    size_t worker_idx;
+} WorkerArgument;
+
+/**
+ * @brief Runs tasks from the worker's own range, then steals from the other ranges.
+ *
+ * @param pool [in] Thread pool.
+ * @param worker_idx [in] Index of the worker.
+ */
+static void thread_pool_work(ThreadPool* pool, size_t worker_idx)
+{
+    for (size_t offset = 0; offset < pool->thread_num; offset++)
+    {
+        TaskRange* range = &pool->ranges[(worker_idx + offset) % pool->thread_num];
+
+        /* Take one task at a time until the range is empty */
+        while (true) {
+            size_t task_idx = atomic_fetch_add(&range->next, 1);
+            if (task_idx >= range->end)
+                break;
+            pool->task(pool->argument, task_idx, worker_idx);
+        }
+    }
+}
+
+/**
+ * @brief Main loop of a spawned thread.
+ *
+ * @param argument [in] WorkerArgument of the thread.
+ * @return void* NULL.
+ */
+static void* thread_pool_main(void* argument)
+{
+    ThreadPool* pool = ((WorkerArgument*)argument)->pool;
+    size_t worker_idx = ((WorkerArgument*)argument)->worker_idx;
+    size_t generation_seen = 0;
+    bigint_free(argument);
+
+    while (true)
+    {
+        /* Wait for a run */
+        pthread_mutex_lock(&pool->mutex);
+        while (pool->generation == generation_seen && pool->stop == false)
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        if (pool->stop == true) {
+            pthread_mutex_unlock(&pool->mutex);
+            return NULL;
+        }
+        generation_seen = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        thread_pool_work(pool, worker_idx);
+
+        /* Report the end of the run */
+        pthread_mutex_lock(&pool->mutex);
+        if (++pool->finished == pool->thread_num - 1)
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+/**
+ * @brief Creates a pool of worker threads.
+ *
+ * The pool has fewer workers if some threads fail to start, down to the calling thread alone,
+ * see bigint_thread_pool_size.
+ *
+ * @param pool [out] Pointer to the thread pool.
+ * @param thread_num [in] Number of workers including the calling thread, 0 for one per online CPU.
+ */
+void bigint_thread_pool_new(ThreadPool** pool, size_t thread_num)
+{
+    /* Free allocated memory */
+    if (*pool != NULL)
+        bigint_thread_pool_delete(pool);
+
+    /* One worker per CPU by default */
+    if (thread_num == 0) {
+        long cpu_num = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_num = cpu_num > 0 ? (size_t)cpu_num : 1;
+    }
+
+    /* Allocate pool */
+    atomic_fetch_add(&thread_pool_num, 1);
+    *pool = (ThreadPool*)bigint_calloc(1, sizeof(ThreadPool));
+    (*pool)->thread_num = thread_num;
+    (*pool)->threads = (pthread_t*)bigint_calloc(thread_num, sizeof(pthread_t));
+    (*pool)->ranges = (TaskRange*)bigint_calloc(thread_num, sizeof(TaskRange));
+    (*pool)->arenas = (ScratchArena*)bigint_calloc(thread_num, sizeof(ScratchArena));
+    pthread_mutex_init(&(*pool)->mutex, NULL);
+    pthread_cond_init(&(*pool)->start, NULL);
+    pthread_cond_init(&(*pool)->done, NULL);
+
+    /* Spawn workers, the calling thread is worker 0 */
+    size_t started_num = 1;
+    while (started_num < thread_num) {
+        WorkerArgument* argument = (WorkerArgument*)bigint_malloc(sizeof(WorkerArgument));
+        argument->pool = *pool;
+        argument->worker_idx = started_num;
+        if (pthread_create(&(*pool)->threads[started_num], NULL, thread_pool_main, argument) != 0) {
+            bigint_free(argument);
+            break;
+        }
+        started_num++;
+    }
+
+    /* The system refused a thread (EAGAIN): run with the workers that started */
+    pthread_mutex_lock(&(*pool)->mutex);
+    (*pool)->thread_num = started_num;
+    pthread_mutex_unlock(&(*pool)->mutex);
+}
+
+/**
+ * @brief Stops the workers and deallocates a thread pool.
+ *
+ * @param pool [in, out] Pointer to the thread pool.
+ */
+void bigint_thread_pool_delete(ThreadPool** pool)
+{
+    /* Invalid pointer */
+    if (*pool == NULL)
+        return;
+
+    /* Stop workers */
+    pthread_mutex_lock(&(*pool)->mutex);
+    (*pool)->stop = true;
+    pthread_cond_broadcast(&(*pool)->start);
+    pthread_mutex_unlock(&(*pool)->mutex);
+    for (size_t idx = 1; idx < (*pool)->thread_num; idx++)
+        pthread_join((*pool)->threads[idx], NULL);
+
+    /* Free memory */
+    for (size_t idx = 0; idx < (*pool)->thread_num; idx++)
+        bigint_free((*pool)->arenas[idx].words);
+    pthread_mutex_destroy(&(*pool)->mutex);
+    pthread_cond_destroy(&(*pool)->start);
+    pthread_cond_destroy(&(*pool)->done);
+    bigint_free((*pool)->threads);
+    bigint_free((*pool)->ranges);
+    bigint_free((*pool)->arenas);
+    bigint_free(*pool);
+    *pool = NULL;
+    atomic_fetch_sub(&thread_pool_num, 1);
+}
+
+/**
+ * @brief Returns the number of thread pools created and not yet deleted.
+ *
+ * @return size_t Live pools.
+ */
+size_t thread_pool_live_num(void)
+{
+    return atomic_load(&thread_pool_num);
+}
+
+/**
+ * @brief Returns the number of workers of a thread pool.
+ *
+ * @param pool [in] Thread pool.
+ * @return size_t Number of workers, including the calling thread.
+ */
+size_t bigint_thread_pool_size(const ThreadPool* pool)
+{
+    return pool->thread_num;
+}
+
+/**
+ * @brief Returns the scratch arena of a worker, grown to at least word_num words.
+ *
+ * @param pool [in] Thread pool.
+ * @param worker_idx [in] Index of the calling worker.
+ * @param word_num [in] Number of words needed.
+ * @return Word* Scratch words, valid until the next call by the same worker.
+ */
+Word* bigint_thread_pool_scratch(ThreadPool* pool, size_t worker_idx, size_t word_num)
+{
+    ScratchArena* arena = &pool->arenas[worker_idx];
+
+    /* Grow only, the steady state does not allocate */
+    if (arena->word_num < word_num) {
+        bigint_free(arena->words);
+        arena->words = (Word*)bigint_malloc(word_num * SIZE_OF_WORD);
+        arena->word_num = word_num;
+    }
+
+    return arena->words;
+}
+
+/**
+ * @brief Runs task(argument, task_idx, worker_idx) for every task_idx in [0, task_num) and waits for all of them.
+ *
+ * @param pool [in] Thread pool.
+ * @param task [in] Task function, must be safe to call concurrently.
+ * @param argument [in] Argument passed to every task.
+ * @param task_num [in] Number of tasks.
+ */
+void bigint_thread_pool_run(ThreadPool* pool, ThreadTask task, void* argument, size_t task_num)
+{
+    /* Split tasks into one contiguous range per worker */
+    for (size_t idx = 0; idx < pool->thread_num; idx++) {
+        atomic_store(&pool->ranges[idx].next, task_num * idx / pool->thread_num);
+        pool->ranges[idx].end = task_num * (idx + 1) / pool->thread_num;
+    }
+
+    /* Start workers */
+    pthread_mutex_lock(&pool->mutex);
+    pool->task = task;
+    pool->argument = argument;
+    pool->finished = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    /* The calling thread is worker 0 */
+    thread_pool_work(pool, 0);
+
+    /* Wait for the other workers */
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->finished < pool->thread_num - 1)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
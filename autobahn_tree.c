@@ -0,0 +1,537 @@
+#include "autobahn_internal.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/** @brief Storage policy shared by the levels of a tree. */
+typedef struct {
+    size_t memory_limit;   /**< Heap bytes of all levels before spilling, 0 for no limit. */
+    char* spill_directory; /**< Directory of the spill files, NULL to never spill. */
+    size_t heap_bytes;     /**< Heap bytes currently held by levels. */
+} TreeStorage;
+
+/** @brief One level of a tree, all nodes back to back in a single array. */
+typedef struct {
+    Word* digits;     /**< Words of all nodes. */
+    size_t* offsets;  /**< Node i is digits[offsets[i]] up to digits[offsets[i + 1]]. */
+    size_t node_num;  /**< Number of nodes. */
+    size_t byte_num;  /**< Size of the digits in bytes. */
+    bool is_mapped;   /**< The digits are a mapping of an unlinked spill file. */
+} TreeLevel;
+
+/** @brief Structure representing a product tree, defined here and opaque elsewhere. */
+struct ProductTree {
+    TreeLevel* levels;   /**< levels[0] holds the leaves, the last level holds the root. */
+    size_t level_num;    /**< Number of levels. */
+    TreeStorage storage; /**< Storage policy, reused by the remainder trees. */
+};
+
+/** @brief Shared state of the per-node tasks of one level. */
+typedef struct {
+    const TreeLevel* nodes;  /**< Product tree level of the nodes being computed. */
+    const TreeLevel* parent; /**< Level the nodes are computed from. */
+    TreeLevel* result;       /**< Level being written. */
+    bool is_squared;         /**< Reduce modulo the squared nodes, for the batch GCD. */
+    Bigint** results;        /**< Leaf results, for the final pass. */
+    ThreadPool* pool;        /**< Thread pool, or NULL to run on the calling thread. */
+    Word* scratch;           /**< Scratch of the calling thread, without a thread pool. */
+    size_t scratch_num;      /**< Number of words of that scratch. */
+} TreeJob;
+
+/**
+ * @brief Returns the scratch of a worker, grown to at least word_num words.
+ *
+ * @param job [in, out] Tree job.
+ * @param worker_idx [in] Index of the calling worker.
+ * @param word_num [in] Number of words needed.
+ * @return Word* Scratch words.
+ */
+static Word* tree_scratch(TreeJob* job, size_t worker_idx, size_t word_num)
+{
+    if (job->pool != NULL)
+        return bigint_thread_pool_scratch(job->pool, worker_idx, word_num);
+
+    if (job->scratch_num < word_num) {
+        bigint_free(job->scratch);
+        job->scratch = (Word*)bigint_malloc(word_num * SIZE_OF_WORD);
+        job->scratch_num = word_num;
+    }
+
+    return job->scratch;
+}
+
+/**
+ * @brief Runs a task for every node of a level, on the thread pool if there is one.
+ *
+ * @param job [in, out] Tree job.
+ * @param task [in] Per-node task.
+ * @param task_num [in] Number of nodes.
+ */
+static void tree_run(TreeJob* job, ThreadTask task, size_t task_num)
+{
+    if (job->pool == NULL) {
+        for (size_t task_idx = 0; task_idx < task_num; task_idx++)
+            task(job, task_idx, 0);
+        return;
+    }
+
+    bigint_thread_pool_run(job->pool, task, job, task_num);
+}
+
+/**
+ * @brief Maps a zero-filled spill file of byte_num bytes, the file is unlinked at once.
+ *
+ * @param directory [in] Directory of the spill file.
+ * @param byte_num [in] Size in bytes.
+ * @return Word* Mapped words, or NULL on failure.
+ */
+static Word* tree_map(const char* directory, size_t byte_num)
+{
+    /* Create a unique file, gone as soon as it is unmapped */
+    size_t path_length = strlen(directory) + 32;
+    char* path = (char*)bigint_malloc(path_length);
+    snprintf(path, path_length, "%s/autobahn_tree_XXXXXX", directory);
+    int file = mkstemp(path);
+    if (file >= 0)
+        unlink(path);
+    bigint_free(path);
+    if (file < 0)
+        return NULL;
+
+    /* Size and map it, the mapping keeps the file alive */
+    void* map = MAP_FAILED;
+    if (ftruncate(file, (off_t)byte_num) == 0)
+        map = mmap(NULL, byte_num, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    close(file);
+
+    return map == MAP_FAILED ? NULL : (Word*)map;
+}
+
+/**
+ * @brief Allocates the zero-filled digits of a level whose offsets are set.
+ *
+ * The digits are taken from the heap while the levels fit in the memory limit,
+ * and from a spill file mapping beyond it, so the kernel can page them out.
+ *
+ * @param level [in, out] Level with node_num and offsets set.
+ * @param storage [in, out] Storage policy.
+ */
+static void tree_level_allocate(TreeLevel* level, TreeStorage* storage)
+{
+    size_t word_num = level->offsets[level->node_num];
+    level->byte_num = (word_num > 0 ? word_num : 1) * SIZE_OF_WORD;
+    level->digits = NULL;
+    level->is_mapped = false;
+
+    /* Spill beyond the memory limit */
+    if (storage->spill_directory != NULL && storage->memory_limit != 0 && storage->heap_bytes + level->byte_num > storage->memory_limit) {
+        level->digits = tree_map(storage->spill_directory, level->byte_num);
+        level->is_mapped = (level->digits != NULL);
+    }
+
+    /* Heap otherwise, or if the spill file could not be made */
+    if (level->is_mapped == false) {
+        level->digits = (Word*)bigint_calloc(level->byte_num, 1);
+        storage->heap_bytes += level->byte_num;
+    }
+}
+
+/**
+ * @brief Allocates a level shaped like another one, every node scaled by factor words.
+ *
+ * @param level [out] New level.
+ * @param shape [in] Level giving the node lengths.
+ * @param factor [in] Length multiplier, 2 for remainders modulo squared nodes.
+ * @param storage [in, out] Storage policy.
+ */
+static void tree_level_new_shaped(TreeLevel* level, const TreeLevel* shape, size_t factor, TreeStorage* storage)
+{
+    level->node_num = shape->node_num;
+    level->offsets = (size_t*)bigint_malloc((shape->node_num + 1) * sizeof(size_t));
+    for (size_t node_idx = 0; node_idx <= shape->node_num; node_idx++)
+        level->offsets[node_idx] = factor * shape->offsets[node_idx];
+
+    tree_level_allocate(level, storage);
+}
+
+/**
+ * @brief Deallocates a level.
+ *
+ * @param level [in, out] Level.
+ * @param storage [in, out] Storage policy.
+ */
+static void tree_level_delete(TreeLevel* level, TreeStorage* storage)
+{
+    if (level->digits != NULL && level->is_mapped == true)
+        munmap(level->digits, level->byte_num);
+    else if (level->digits != NULL) {
+        bigint_free(level->digits);
+        storage->heap_bytes -= level->byte_num;
+    }
+
+    bigint_free(level->offsets);
+    level->digits = NULL;
+    level->offsets = NULL;
+}
+
+/**
+ * @brief Returns the words of a node and its length without leading zero words.
+ *
+ * @param level [in] Level.
+ * @param node_idx [in] Index of the node.
+ * @param digit_num [out] Number of significant words.
+ * @return Word* Words of the node.
+ */
+static Word* tree_node(const TreeLevel* level, size_t node_idx, size_t* digit_num)
+{
+    Word* digits = level->digits + level->offsets[node_idx];
+    *digit_num = words_trim(digits, level->offsets[node_idx + 1] - level->offsets[node_idx]);
+
+    return digits;
+}
+
+/**
+ * @brief Task: multiplies two sibling nodes into their parent, a lone last node is carried up.
+ *
+ * @param argument [in] TreeJob, parent holds the children and result the parents.
+ * @param task_idx [in] Index of the parent node.
+ * @param worker_idx [in] Index of the calling worker.
+ */
+static void tree_product_task(void* argument, size_t task_idx, size_t worker_idx)
+{
+    TreeJob* job = (TreeJob*)argument;
+    size_t left_num, right_num;
+    Word* left = tree_node(job->parent, 2 * task_idx, &left_num);
+    Word* result = job->result->digits + job->result->offsets[task_idx];
+
+    /* Odd node count: carry the last one */
+    if (2 * task_idx + 1 == job->parent->node_num) {
+        memcpy(result, left, left_num * SIZE_OF_WORD);
+        return;
+    }
+
+    Word* right = tree_node(job->parent, 2 * task_idx + 1, &right_num);
+    Word* scratch = tree_scratch(job, worker_idx, words_multiplication_scratch_size(left_num, right_num));
+    words_multiplication(result, left, left_num, right, right_num, scratch);
+}
+
+/**
+ * @brief Task: reduces the remainder of a parent node modulo a node, or modulo its square.
+ *
+ * @param argument [in] TreeJob, parent holds the parent remainders and result the node remainders.
+ * @param task_idx [in] Index of the node.
+ * @param worker_idx [in] Index of the calling worker.
+ */
+static void tree_remainder_task(void* argument, size_t task_idx, size_t worker_idx)
+{
+    TreeJob* job = (TreeJob*)argument;
+    size_t node_num, dividend_num;
+    Word* node = tree_node(job->nodes, task_idx, &node_num);
+    Word* dividend = tree_node(job->parent, task_idx / 2, &dividend_num);
+    Word* result = job->result->digits + job->result->offsets[task_idx];
+
+    /* Scratch: the squared node, then the reduction scratch */
+    size_t divisor_num = job->is_squared ? 2 * node_num : node_num;
+    size_t square_num = job->is_squared ? divisor_num : 0;
+    size_t work_num = words_division_fast_scratch_size(dividend_num, divisor_num);
+    if (job->is_squared == true && work_num < words_multiplication_scratch_size(node_num, node_num))
+        work_num = words_multiplication_scratch_size(node_num, node_num);
+    Word* scratch = tree_scratch(job, worker_idx, square_num + work_num);
+    Word* work = scratch + square_num;
+
+    /* Divisor is the node, or its square */
+    Word* divisor = node;
+    if (job->is_squared == true) {
+        divisor = scratch;
+        words_multiplication(divisor, node, node_num, node, node_num, work);
+        divisor_num = words_trim(divisor, divisor_num);
+    }
+
+    /* Already reduced: copy */
+    if (dividend_num < divisor_num)
+        memcpy(result, dividend, dividend_num * SIZE_OF_WORD);
+    else
+        words_division_fast(NULL, result, dividend, dividend_num, divisor, divisor_num, work);
+}
+
+/**
+ * @brief Task: computes gcd(N, (P mod N^2) / N) for the leaf N, with P the product of all leaves.
+ *
+ * @param argument [in] TreeJob, parent holds the leaf remainders modulo the squared leaves.
+ * @param task_idx [in] Index of the leaf.
+ * @param worker_idx [in] Index of the calling worker.
+ */
+static void tree_gcd_task(void* argument, size_t task_idx, size_t worker_idx)
+{
+    TreeJob* job = (TreeJob*)argument;
+    size_t leaf_num, remainder_num;
+    Word* leaf = tree_node(job->nodes, task_idx, &leaf_num);
+    Word* remainder = tree_node(job->parent, task_idx, &remainder_num);
+    Bigint* modulus = NULL;
+    Bigint* quotient = NULL;
+
+    /* Quotient (P mod N^2) / N, zero if the remainder is below N */
+    if (remainder_num < leaf_num)
+        bigint_new(&quotient, 1);
+    else {
+        Word* scratch = tree_scratch(job, worker_idx, (remainder_num - leaf_num + 1) + words_division_scratch_size(remainder_num, leaf_num));
+        words_division(scratch, NULL, remainder, remainder_num, leaf, leaf_num, scratch + (remainder_num - leaf_num + 1));
+        bigint_set_by_array(&quotient, scratch, POSITIVE, remainder_num - leaf_num + 1);
+        bigint_refine(quotient);
+    }
+
+    bigint_set_by_array(&modulus, leaf, POSITIVE, leaf_num);
+    bigint_gcd(&job->results[task_idx], modulus, quotient);
+
+    bigint_delete(&modulus);
+    bigint_delete(&quotient);
+}
+
+/**
+ * @brief Copies the nodes of a level into Bigints.
+ *
+ * @param results [out] Array of node_num Bigint pointers.
+ * @param level [in] Level.
+ */
+static void tree_level_to_bigints(Bigint** results, const TreeLevel* level)
+{
+    for (size_t node_idx = 0; node_idx < level->node_num; node_idx++) {
+        size_t digit_num;
+        Word* digits = tree_node(level, node_idx, &digit_num);
+        bigint_set_by_array(&results[node_idx], digits, POSITIVE, digit_num);
+    }
+}
+
+/**
+ * @brief Builds a product tree: leaves multiplied pairwise, level by level, up to the root.
+ *
+ * Each level is a single array holding all its nodes, and the nodes of a level are computed
+ * in parallel on the thread pool. Once the levels would take more than memory_limit bytes of
+ * heap, further levels are backed by unlinked files in spill_directory instead, so that trees
+ * larger than RAM are paged to disk by the kernel.
+ *
+ * @param tree [out] Pointer to the product tree, NULL on an invalid input.
+ * @param leaves [in] Positive leaves.
+ * @param leaf_num [in] Number of leaves, at least 1.
+ * @param memory_limit [in] Heap bytes of the levels before spilling, 0 for no limit.
+ * @param spill_directory [in] Directory of the spill files, NULL to never spill.
+ * @param pool [in] Thread pool, or NULL to build on the calling thread.
+ */
+void bigint_product_tree_new(ProductTree** tree, Bigint* const* leaves, size_t leaf_num, size_t memory_limit, const char* spill_directory, ThreadPool* pool)
+{
+    PROFILE_SCOPE(PROFILE_PRODUCT_TREE_NEW, 0);
+
+    /* Free allocated memory */
+    if (*tree != NULL)
+        bigint_product_tree_delete(tree);
+
+    /* Invalid case: no leaf or non-positive leaf */
+    if (leaf_num == 0) {
+        printf("Invalid Case: Product tree has no leaf.\n");
+        return;
+    }
+    size_t word_num = 0;
+    for (size_t leaf_idx = 0; leaf_idx < leaf_num; leaf_idx++) {
+        if (leaves[leaf_idx]->sign == NEGATIVE || bigint_is_zero(leaves[leaf_idx])) {
+            printf("Invalid Case: Product tree leaf is not positive.\n");
+            return;
+        }
+        word_num += words_trim(leaves[leaf_idx]->digits, leaves[leaf_idx]->digit_num);
+    }
+
+    /* Allocate tree, one level per halving */
+    *tree = (ProductTree*)bigint_calloc(1, sizeof(ProductTree));
+    (*tree)->storage.memory_limit = memory_limit;
+    if (spill_directory != NULL) {
+        size_t length = strlen(spill_directory) + 1;
+        (*tree)->storage.spill_directory = (char*)bigint_malloc(length);
+        memcpy((*tree)->storage.spill_directory, spill_directory, length);
+    }
+    for (size_t node_num = leaf_num; ; node_num = (node_num + 1) / 2) {
+        (*tree)->level_num++;
+        if (node_num == 1)
+            break;
+    }
+    (*tree)->levels = (TreeLevel*)bigint_calloc((*tree)->level_num, sizeof(TreeLevel));
+
+    /* Leaves */
+    TreeLevel* level = &(*tree)->levels[0];
+    level->node_num = leaf_num;
+    level->offsets = (size_t*)bigint_malloc((leaf_num + 1) * sizeof(size_t));
+    level->offsets[0] = 0;
+    for (size_t leaf_idx = 0; leaf_idx < leaf_num; leaf_idx++)
+        level->offsets[leaf_idx + 1] = level->offsets[leaf_idx] + words_trim(leaves[leaf_idx]->digits, leaves[leaf_idx]->digit_num);
+    tree_level_allocate(level, &(*tree)->storage);
+    for (size_t leaf_idx = 0; leaf_idx < leaf_num; leaf_idx++)
+        memcpy(level->digits + level->offsets[leaf_idx], leaves[leaf_idx]->digits, (level->offsets[leaf_idx + 1] - level->offsets[leaf_idx]) * SIZE_OF_WORD);
+
+    /* Upper levels, the nodes of a level in parallel */
+    TreeJob job = { .pool = pool };
+    for (size_t level_idx = 1; level_idx < (*tree)->level_num; level_idx++)
+    {
+        TreeLevel* lower = &(*tree)->levels[level_idx - 1];
+        TreeLevel* upper = &(*tree)->levels[level_idx];
+
+        /* A parent is as long as its children together */
+        upper->node_num = (lower->node_num + 1) / 2;
+        upper->offsets = (size_t*)bigint_malloc((upper->node_num + 1) * sizeof(size_t));
+        upper->offsets[0] = 0;
+        for (size_t node_idx = 0; node_idx < upper->node_num; node_idx++)
+            upper->offsets[node_idx + 1] = upper->offsets[node_idx] + (lower->offsets[2 * node_idx + (2 * node_idx + 1 < lower->node_num ? 2 : 1)] - lower->offsets[2 * node_idx]);
+        tree_level_allocate(upper, &(*tree)->storage);
+
+        job.parent = lower;
+        job.result = upper;
+        tree_run(&job, tree_product_task, upper->node_num);
+    }
+    bigint_free(job.scratch);
+}
+
+/**
+ * @brief Deallocates a product tree and its spill files.
+ *
+ * @param tree [in, out] Pointer to the product tree.
+ */
+void bigint_product_tree_delete(ProductTree** tree)
+{
+    /* Invalid pointer */
+    if (*tree == NULL)
+        return;
+
+    for (size_t level_idx = 0; level_idx < (*tree)->level_num; level_idx++)
+        tree_level_delete(&(*tree)->levels[level_idx], &(*tree)->storage);
+    bigint_free((*tree)->storage.spill_directory);
+    bigint_free((*tree)->levels);
+    bigint_free(*tree);
+    *tree = NULL;
+}
+
+/**
+ * @brief Gets the root of a product tree, the product of all leaves.
+ *
+ * @param root [out] Pointer to the root.
+ * @param tree [in] Product tree.
+ */
+void bigint_product_tree_root(Bigint** root, const ProductTree* tree)
+{
+    tree_level_to_bigints(root, &tree->levels[tree->level_num - 1]);
+}
+
+/**
+ * @brief Descends from a root remainder to the leaf remainders, one level at a time.
+ *
+ * Only the remainders of two adjacent levels are alive at once.
+ *
+ * @param top [in, out] Remainders at the root level, deallocated here.
+ * @param tree [in] Product tree.
+ * @param storage [in, out] Storage policy of the remainder levels.
+ * @param job [in, out] Tree job, is_squared and pool set.
+ */
+static void tree_descend(TreeLevel* top, const ProductTree* tree, TreeStorage* storage, TreeJob* job)
+{
+    TreeLevel parent = *top;
+
+    for (size_t level_idx = tree->level_num - 1; level_idx-- > 0;)
+    {
+        TreeLevel child;
+        tree_level_new_shaped(&child, &tree->levels[level_idx], job->is_squared ? 2 : 1, storage);
+
+        job->nodes = &tree->levels[level_idx];
+        job->parent = &parent;
+        job->result = &child;
+        tree_run(job, tree_remainder_task, child.node_num);
+
+        tree_level_delete(&parent, storage);
+        parent = child;
+    }
+
+    *top = parent;
+}
+
+/**
+ * @brief Reduces a value modulo every leaf of a product tree with a remainder tree.
+ *
+ * The value is reduced modulo the root, then each remainder modulo the two children,
+ * down to the leaves. The nodes of a level are reduced in parallel on the thread pool.
+ *
+ * @param remainders [out] Array of one Bigint pointer per leaf, value mod leaf.
+ * @param tree [in] Product tree of the moduli.
+ * @param value [in] Non-negative value.
+ * @param pool [in] Thread pool, or NULL to reduce on the calling thread.
+ */
+void bigint_remainder_tree(Bigint** remainders, const ProductTree* tree, const Bigint* value, ThreadPool* pool)
+{
+    PROFILE_SCOPE(PROFILE_REMAINDER_TREE, value->digit_num);
+
+    /* Invalid case: negative value */
+    if (value->sign == NEGATIVE) {
+        printf("Invalid Case: Value is negative.\n");
+        return;
+    }
+
+    /* Remainder levels follow the storage policy of the tree */
+    TreeStorage storage = tree->storage;
+    TreeJob job = { .pool = pool, .is_squared = false };
+    const TreeLevel* root = &tree->levels[tree->level_num - 1];
+
+    /* Value mod root */
+    TreeLevel top;
+    size_t root_num, value_num = words_trim(value->digits, value->digit_num);
+    Word* root_digits = tree_node(root, 0, &root_num);
+    tree_level_new_shaped(&top, root, 1, &storage);
+    if (value_num < root_num)
+        memcpy(top.digits, value->digits, value_num * SIZE_OF_WORD);
+    else
+        words_division_fast(NULL, top.digits, value->digits, value_num, root_digits, root_num, tree_scratch(&job, 0, words_division_fast_scratch_size(value_num, root_num)));
+
+    /* Down to the leaves */
+    tree_descend(&top, tree, &storage, &job);
+    tree_level_to_bigints(remainders, &top);
+    tree_level_delete(&top, &storage);
+    bigint_free(job.scratch);
+}
+
+/**
+ * @brief Computes gcd(N_i, product of the other N_j) for every modulus at once (batch GCD).
+ *
+ * With P the product of all moduli, the remainder tree gives P mod N_i^2 for every i,
+ * and gcd(N_i, (P mod N_i^2) / N_i) is the part of N_i shared with the other moduli.
+ * A result of 1 means no shared factor, N_i itself means every prime factor is shared
+ * (for instance a duplicate modulus).
+ *
+ * @param results [out] Array of count Bigint pointers.
+ * @param moduli [in] Positive moduli.
+ * @param count [in] Number of moduli.
+ * @param memory_limit [in] Heap bytes of the tree levels before spilling, 0 for no limit.
+ * @param spill_directory [in] Directory of the spill files, NULL to never spill.
+ * @param pool [in] Thread pool, or NULL to run on the calling thread.
+ */
+void bigint_batch_gcd(Bigint** results, Bigint* const* moduli, size_t count, size_t memory_limit, const char* spill_directory, ThreadPool* pool)
+{
+    PROFILE_SCOPE(PROFILE_BATCH_GCD, 0);
+
+    ProductTree* tree = NULL;
+
+    /* Product tree of the moduli */
+    bigint_product_tree_new(&tree, moduli, count, memory_limit, spill_directory, pool);
+    if (tree == NULL)
+        return;
+
+    /* P mod root^2 is P itself */
+    TreeJob job = { .pool = pool, .is_squared = true };
+    TreeLevel top;
+    tree_level_new_shaped(&top, &tree->levels[tree->level_num - 1], 2, &tree->storage);
+    memcpy(top.digits, tree->levels[tree->level_num - 1].digits, tree->levels[tree->level_num - 1].byte_num);
+
+    /* P mod N_i^2 at the leaves, then the GCDs in parallel */
+    tree_descend(&top, tree, &tree->storage, &job);
+    job.nodes = &tree->levels[0];
+    job.parent = &top;
+    job.results = results;
+    tree_run(&job, tree_gcd_task, count);
+
+    tree_level_delete(&top, &tree->storage);
+    bigint_product_tree_delete(&tree);
+    bigint_free(job.scratch);
+}
@@ -1,84 +1,480 @@
-#include <stdio.h>
-#include <stdlib.h>
+/*
+ * Side-by-side comparison of Autobahn with GMP (mpz and mpn) and optionally OpenSSL BN.
+ *
+ * Every library gets the same operands, the results are checked against mpz before timing,
+ * and the table gives the median time per operation and the ratio Autobahn / library.
+ *
+ * compile: gcc -O2 benchmark/benchmark_gmp.c autobahn*.c -lgmp -lpthread -lm
+ *          add -DBENCHMARK_OPENSSL -lcrypto for the OpenSSL column
+ * run:     ./a.out [bit_min] [bit_max] [csv]
+ */
+#include "../autobahn_internal.h"
+
+#include <gmp.h>
+#include <string.h>
 #include <time.h>
-#include </opt/homebrew/Cellar/gmp/6.2.1_1/include/gmp.h> //! compile: gcc *.c -L/opt/homebrew/Cellar/gmp/6.2.1_1/lib -lgmp
-
-void gmp_benchmark(uint32_t bit_length)
-{
-    mpz_t operand_x;
-    mpz_t operand_y;
-    mpz_t operand_y_half;
-    mpz_t operand_z;
-    mpz_t result;
-    gmp_randstate_t state;
-    time_t start;
-    time_t end;
-    double time_result;
-    size_t count = 100;
-
-    
-
-    /* Allocate memory */
-    mpz_init(operand_x);
-    mpz_init(operand_y);
-    mpz_init(operand_y_half);
-    mpz_init(operand_z); 
-    mpz_init(result);
-    
-    /* Init random function */
-    gmp_randinit_default(state);
-
-    /* Generate random number */
-    mpz_urandomb(operand_x, state, bit_length);
-    mpz_urandomb(operand_y, state, bit_length);
-    mpz_urandomb(operand_y_half, state, bit_length / 2);
-    mpz_urandomb(operand_z, state, bit_length);
-
-    /* time check: multiplication textbook */
-    start = clock();
-    for(size_t i = 0; i < count; i++) mpz_mul(result, operand_x, operand_y);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time multiplication : %f\n", time_result);
-
-    /* time check: squaring textbook */
-    start = clock();
-    for(size_t i = 0; i < count; i++) mpz_pow_ui(result, operand_x, 2);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time squaring       : %f\n", time_result);
-
-    /* time check: division word */
-    start = clock();
-    for(size_t i = 0; i < count; i++) mpz_div(result, operand_x, operand_y_half);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time division       : %f\n", time_result);
-
-    /* time check: barrett */
-    start = clock();
-    for(size_t i = 0; i < count; i++) mpz_mod(result, operand_x, operand_y_half);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time reduction      : %f\n", time_result);
-
-    /* time check: exponetiation left to right */
-    start = clock();
-    mpz_powm(result, operand_x, operand_y, operand_z);
-    end = clock();
-    time_result = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("time exponetiation  : %f\n", time_result);
-
-    /* Free memory */
-    mpz_clear(operand_x);
-    mpz_clear(operand_y);
-    mpz_clear(operand_y_half);
-    mpz_clear(operand_z);
-    mpz_clear(result);
-    gmp_randclear(state);
-}
-
-int main()
-{
-    gmp_benchmark(2048);
-}
\ No newline at end of file
+#if defined(BENCHMARK_OPENSSL)
+    #include <openssl/bn.h>
+    #include <openssl/crypto.h>
+#endif
+
+#define COMPARE_SEED 0x636f6d7061726521ULL /**< Seed of the operands, identical across runs. */
+#define COMPARE_SAMPLE_NUM 11               /**< Timed samples per library, the median is reported. */
+#define COMPARE_SAMPLE_MIN 3                /**< Fewest samples when an operation is slow. */
+#define COMPARE_SAMPLE_NS 1000000ULL        /**< Minimum duration of a sample. */
+#define COMPARE_BUDGET_NS 1000000000ULL     /**< Time budget of one library for one operation and size. */
+#define COMPARE_ALL ((size_t)-1)            /**< No size limit. */
+
+/** @brief Libraries of the comparison, in column order. */
+typedef enum { LIBRARY_AUTOBAHN, LIBRARY_MPZ, LIBRARY_MPN, LIBRARY_OPENSSL, LIBRARY_NUM } Library;
+
+static const char* library_names[LIBRARY_NUM] = { "autobahn", "gmp_mpz", "gmp_mpn", "openssl" };
+
+/** @brief Operands of one size in every representation, and the result slots of every library. */
+typedef struct {
+    size_t bit_length;
+
+    /* operands: x, y of bit_length bits, y_half of half, odd modular, base below it, full exponent */
+    Bigint* operand_x;
+    Bigint* operand_y;
+    Bigint* operand_y_half;
+    Bigint* modular;
+    Bigint* base;
+    Bigint* exponent;
+    Bigint* exponent_public;
+    Bigint* pre_comp;
+    ModularContext* context;
+    char* decimal;
+    size_t decimal_length;
+
+    mpz_t z_x, z_y, z_y_half, z_modular, z_base, z_exponent;
+    mp_limb_t* scratch;                      /**< mpn_sec_powm scratch. */
+
+#if defined(BENCHMARK_OPENSSL)
+    BIGNUM *bn_x, *bn_y, *bn_y_half, *bn_modular, *bn_base, *bn_exponent, *bn_exponent_public;
+    BN_CTX* bn_ctx;
+    BN_MONT_CTX* bn_mont;
+#endif
+
+    /* results, two values (quotient and remainder, root and remainder) or a string */
+    Bigint* ab[2];
+    char* ab_string;
+    mpz_t z[2];
+    char* z_string;
+    mp_limb_t* n[2];
+    mp_size_t n_size[2];
+#if defined(BENCHMARK_OPENSSL)
+    BIGNUM* bn[2];
+    char* bn_string;
+#endif
+} CompareOperands;
+
+/** @brief Operation run by each library, NULL where the library has no counterpart. */
+typedef struct {
+    const char* name;
+    size_t bit_max;                           /**< Largest size measured. */
+    int value_num;                            /**< Values compared, 0 for a decimal string. */
+    void (*run[LIBRARY_NUM])(CompareOperands* o);
+} CompareOperation;
+
+/* multiplication */
+static void autobahn_mul(CompareOperands* o) { bigint_multiplication_karatsuba(&o->ab[0], o->operand_x, o->operand_y); }
+static void gmp_mpz_mul(CompareOperands* o)  { mpz_mul(o->z[0], o->z_x, o->z_y); }
+static void gmp_mpn_mul(CompareOperands* o)
+{
+    mpn_mul_n(o->n[0], mpz_limbs_read(o->z_x), mpz_limbs_read(o->z_y), mpz_size(o->z_x));
+    o->n_size[0] = 2 * mpz_size(o->z_x);
+}
+
+/* squaring */
+static void autobahn_sqr(CompareOperands* o) { bigint_squaring_karatsuba(&o->ab[0], o->operand_x); }
+static void gmp_mpz_sqr(CompareOperands* o)  { mpz_mul(o->z[0], o->z_x, o->z_x); }
+static void gmp_mpn_sqr(CompareOperands* o)
+{
+    mpn_sqr(o->n[0], mpz_limbs_read(o->z_x), mpz_size(o->z_x));
+    o->n_size[0] = 2 * mpz_size(o->z_x);
+}
+
+/* division x / y_half, quotient and remainder */
+static void autobahn_div_word_long(CompareOperands* o) { bigint_division_word_long(&o->ab[0], &o->ab[1], o->operand_x, o->operand_y_half); }
+static void autobahn_div_words(CompareOperands* o)     { words_division_bigint(&o->ab[0], &o->ab[1], o->operand_x, o->operand_y_half); }
+static void gmp_mpz_div(CompareOperands* o)            { mpz_tdiv_qr(o->z[0], o->z[1], o->z_x, o->z_y_half); }
+static void gmp_mpn_div(CompareOperands* o)
+{
+    mp_size_t xn = mpz_size(o->z_x);
+    mp_size_t dn = mpz_size(o->z_y_half);
+    mpn_tdiv_qr(o->n[0], o->n[1], 0, mpz_limbs_read(o->z_x), xn, mpz_limbs_read(o->z_y_half), dn);
+    o->n_size[0] = xn - dn + 1;
+    o->n_size[1] = dn;
+}
+
+/* reduction x mod y_half */
+static void autobahn_barrett(CompareOperands* o) { bigint_reduction_barrett(&o->ab[0], o->operand_x, o->operand_y_half, o->pre_comp); }
+static void gmp_mpz_mod(CompareOperands* o)      { mpz_mod(o->z[0], o->z_x, o->z_y_half); }
+
+/* modular exponentiation with a secret exponent, constant time everywhere */
+static void autobahn_powm(CompareOperands* o) { bigint_exponentiation_modular_fixed_window_context(&o->ab[0], o->base, o->exponent, o->context); }
+static void gmp_mpz_powm(CompareOperands* o)  { mpz_powm_sec(o->z[0], o->z_base, o->z_exponent, o->z_modular); }
+static void gmp_mpn_powm(CompareOperands* o)
+{
+    mp_size_t mn = mpz_size(o->z_modular);
+    mpn_sec_powm(o->n[0], mpz_limbs_read(o->z_base), mpz_size(o->z_base), mpz_limbs_read(o->z_exponent),
+                 mpz_sizeinbase(o->z_exponent, 2), mpz_limbs_read(o->z_modular), mn, o->scratch);
+    o->n_size[0] = mn;
+}
+
+/* modular exponentiation with exponent 65537 */
+static void autobahn_powm_public(CompareOperands* o) { bigint_exponentiation_modular_public(&o->ab[0], o->base, o->exponent_public, o->context); }
+static void gmp_mpz_powm_public(CompareOperands* o)  { mpz_powm_ui(o->z[0], o->z_base, 65537, o->z_modular); }
+
+/* gcd and inverse, zero when there is no inverse */
+static void autobahn_gcd(CompareOperands* o)     { bigint_gcd(&o->ab[0], o->operand_x, o->operand_y); }
+static void gmp_mpz_gcd(CompareOperands* o)      { mpz_gcd(o->z[0], o->z_x, o->z_y); }
+static void autobahn_inverse(CompareOperands* o) { if (bigint_mod_inverse(&o->ab[0], o->base, o->modular) == false) bigint_set_zero(&o->ab[0]); }
+static void gmp_mpz_inverse(CompareOperands* o)  { if (mpz_invert(o->z[0], o->z_base, o->z_modular) == 0) mpz_set_ui(o->z[0], 0); }
+
+/* square root and remainder */
+static void autobahn_sqrt(CompareOperands* o) { bigint_sqrtrem(&o->ab[0], &o->ab[1], o->operand_x); }
+static void gmp_mpz_sqrt(CompareOperands* o)  { mpz_sqrtrem(o->z[0], o->z[1], o->z_x); }
+static void gmp_mpn_sqrt(CompareOperands* o)
+{
+    mp_size_t xn = mpz_size(o->z_x);
+    o->n_size[1] = mpn_sqrtrem(o->n[0], o->n[1], mpz_limbs_read(o->z_x), xn);
+    o->n_size[0] = (xn + 1) / 2;
+}
+
+/* decimal conversion */
+static void autobahn_to_decimal(CompareOperands* o)   { bigint_to_string(o->ab_string, o->decimal_length + 1, NULL, o->operand_x, 10); }
+static void gmp_mpz_to_decimal(CompareOperands* o)    { mpz_get_str(o->z_string, 10, o->z_x); }
+static void autobahn_from_decimal(CompareOperands* o) { bigint_from_string(&o->ab[0], o->decimal, o->decimal_length, 10); }
+static void gmp_mpz_from_decimal(CompareOperands* o)  { mpz_set_str(o->z[0], o->decimal, 10); }
+
+#if defined(BENCHMARK_OPENSSL)
+static void openssl_mul(CompareOperands* o)         { BN_mul(o->bn[0], o->bn_x, o->bn_y, o->bn_ctx); }
+static void openssl_sqr(CompareOperands* o)         { BN_sqr(o->bn[0], o->bn_x, o->bn_ctx); }
+static void openssl_div(CompareOperands* o)         { BN_div(o->bn[0], o->bn[1], o->bn_x, o->bn_y_half, o->bn_ctx); }
+static void openssl_mod(CompareOperands* o)         { BN_mod(o->bn[0], o->bn_x, o->bn_y_half, o->bn_ctx); }
+static void openssl_powm(CompareOperands* o)        { BN_mod_exp_mont_consttime(o->bn[0], o->bn_base, o->bn_exponent, o->bn_modular, o->bn_ctx, o->bn_mont); }
+static void openssl_powm_public(CompareOperands* o) { BN_mod_exp_mont(o->bn[0], o->bn_base, o->bn_exponent_public, o->bn_modular, o->bn_ctx, o->bn_mont); }
+static void openssl_gcd(CompareOperands* o)         { BN_gcd(o->bn[0], o->bn_x, o->bn_y, o->bn_ctx); }
+static void openssl_inverse(CompareOperands* o)     { if (BN_mod_inverse(o->bn[0], o->bn_base, o->bn_modular, o->bn_ctx) == NULL) BN_zero(o->bn[0]); }
+static void openssl_to_decimal(CompareOperands* o)
+{
+    OPENSSL_free(o->bn_string);
+    o->bn_string = BN_bn2dec(o->bn_x);
+}
+static void openssl_from_decimal(CompareOperands* o) { BN_dec2bn(&o->bn[0], o->decimal); }
+    #define BN_RUN(function) function
+#else
+    #define BN_RUN(function) NULL
+#endif
+
+/* Caps follow the harness in autobahn_evaluation_benchmark.c, Autobahn is the slow side */
+static const CompareOperation compare_operations[] = {
+    { "multiplication_karatsuba",      1 << 17,     1, { autobahn_mul,           gmp_mpz_mul,          gmp_mpn_mul,  BN_RUN(openssl_mul) } },
+    { "squaring_karatsuba",            1 << 17,     1, { autobahn_sqr,           gmp_mpz_sqr,          gmp_mpn_sqr,  BN_RUN(openssl_sqr) } },
+    { "division_word_long",            1 << 15,     2, { autobahn_div_word_long, gmp_mpz_div,          gmp_mpn_div,  BN_RUN(openssl_div) } },
+    { "division_words",                COMPARE_ALL, 2, { autobahn_div_words,     gmp_mpz_div,          gmp_mpn_div,  BN_RUN(openssl_div) } },
+    { "reduction_barrett",             1 << 15,     1, { autobahn_barrett,       gmp_mpz_mod,          NULL,         BN_RUN(openssl_mod) } },
+    { "exponentiation_window_context", 1 << 12,     1, { autobahn_powm,          gmp_mpz_powm,         gmp_mpn_powm, BN_RUN(openssl_powm) } },
+    { "exponentiation_public_65537",   1 << 14,     1, { autobahn_powm_public,   gmp_mpz_powm_public,  NULL,         BN_RUN(openssl_powm_public) } },
+    { "gcd",                           1 << 18,     1, { autobahn_gcd,           gmp_mpz_gcd,          NULL,         BN_RUN(openssl_gcd) } },
+    { "mod_inverse",                   1 << 17,     1, { autobahn_inverse,       gmp_mpz_inverse,      NULL,         BN_RUN(openssl_inverse) } },
+    { "sqrtrem",                       COMPARE_ALL, 2, { autobahn_sqrt,          gmp_mpz_sqrt,         gmp_mpn_sqrt, NULL } },
+    { "to_string_decimal",             COMPARE_ALL, 0, { autobahn_to_decimal,    gmp_mpz_to_decimal,   NULL,         BN_RUN(openssl_to_decimal) } },
+    { "from_string_decimal",           COMPARE_ALL, 1, { autobahn_from_decimal,  gmp_mpz_from_decimal, NULL,         BN_RUN(openssl_from_decimal) } },
+};
+
+static uint64_t compare_now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static int compare_double(const void* left, const void* right)
+{
+    double x = *(const double*)left;
+    double y = *(const double*)right;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns the median time of one call in ns, over batches of at least COMPARE_SAMPLE_NS.
+ */
+static double compare_time(void (*run)(CompareOperands*), CompareOperands* o)
+{
+    uint64_t start = compare_now_ns();
+    run(o);
+    uint64_t single_ns = compare_now_ns() - start + 1;
+
+    size_t iteration_num = single_ns < COMPARE_SAMPLE_NS ? (size_t)(COMPARE_SAMPLE_NS / single_ns) : 1;
+    size_t sample_num = COMPARE_BUDGET_NS / (iteration_num * single_ns);
+    if (sample_num > COMPARE_SAMPLE_NUM)
+        sample_num = COMPARE_SAMPLE_NUM;
+    if (sample_num < COMPARE_SAMPLE_MIN)
+        sample_num = COMPARE_SAMPLE_MIN;
+
+    double times[COMPARE_SAMPLE_NUM];
+    for (size_t idx = 0; idx < sample_num; idx++) {
+        start = compare_now_ns();
+        for (size_t iteration = 0; iteration < iteration_num; iteration++)
+            run(o);
+        times[idx] = (double)(compare_now_ns() - start) / (double)iteration_num;
+    }
+    qsort(times, sample_num, sizeof(double), compare_double);
+    return times[sample_num / 2];
+}
+
+/* conversions into mpz for the checks, through big-endian bytes */
+static void compare_set_mpz(mpz_t result, const Bigint* bigint)
+{
+    size_t length = bigint_byte_length(bigint);
+    unsigned char* bytes = (unsigned char*)malloc(length + 1);
+    bigint_to_bytes_be(bytes, length, bigint);
+    mpz_import(result, length, 1, 1, 1, 0, bytes);
+    free(bytes);
+}
+
+#if defined(BENCHMARK_OPENSSL)
+static void compare_set_mpz_bn(mpz_t result, const BIGNUM* value)
+{
+    size_t length = BN_num_bytes(value);
+    unsigned char* bytes = (unsigned char*)malloc(length + 1);
+    BN_bn2bin(value, bytes);
+    mpz_import(result, length, 1, 1, 1, 0, bytes);
+    free(bytes);
+}
+
+static BIGNUM* compare_new_bn(const mpz_t value)
+{
+    size_t length = 0;
+    unsigned char* bytes = (unsigned char*)mpz_export(NULL, &length, 1, 1, 1, 0, value);
+    BIGNUM* result = BN_bin2bn(bytes, length, NULL);
+    free(bytes);
+    return result;
+}
+#endif
+
+/**
+ * @brief Generates the operands of one size with Autobahn and copies them into the other libraries.
+ */
+static void compare_operands_new(CompareOperands* o, size_t bit_length)
+{
+    memset(o, 0, sizeof(*o));
+    o->bit_length = bit_length;
+
+    /* Same operands on every run */
+    RandomXoshiro state;
+    bigint_random_xoshiro_seed(&state, COMPARE_SEED + bit_length);
+    bigint_random_set_source(bigint_random_xoshiro_fill, &state);
+    bigint_random_bits(&o->operand_x, bit_length);
+    bigint_random_bits(&o->operand_y, bit_length);
+    bigint_random_bits(&o->operand_y_half, bit_length / 2);
+    bigint_random_bits(&o->modular, bit_length);
+    o->modular->digits[0] |= 1;
+    bigint_random_bits(&o->base, bit_length - 1);
+    bigint_random_bits(&o->exponent, bit_length);
+    bigint_random_set_source(NULL, NULL);
+    bigint_set_by_hex_string(&o->exponent_public, "10001", POSITIVE);
+
+    /* Library-specific pre-computations, outside the timing, only up to the caps of their operations */
+    if (bit_length <= 1 << 15)
+        bigint_reduction_barrett_pre_computed(&o->pre_comp, o->operand_y_half);
+    if (bit_length <= 1 << 14)
+        bigint_modular_context_new(&o->context, o->modular);
+    bigint_to_string(NULL, 0, &o->decimal_length, o->operand_x, 10);
+    o->decimal = (char*)malloc(o->decimal_length + 1);
+    bigint_to_string(o->decimal, o->decimal_length + 1, NULL, o->operand_x, 10);
+    o->ab_string = (char*)malloc(o->decimal_length + 1);
+    bigint_new(&o->ab[0], 1);
+    bigint_new(&o->ab[1], 1);
+
+    /* GMP */
+    mpz_inits(o->z_x, o->z_y, o->z_y_half, o->z_modular, o->z_base, o->z_exponent, o->z[0], o->z[1], NULL);
+    compare_set_mpz(o->z_x, o->operand_x);
+    compare_set_mpz(o->z_y, o->operand_y);
+    compare_set_mpz(o->z_y_half, o->operand_y_half);
+    compare_set_mpz(o->z_modular, o->modular);
+    compare_set_mpz(o->z_base, o->base);
+    compare_set_mpz(o->z_exponent, o->exponent);
+    o->z_string = (char*)malloc(mpz_sizeinbase(o->z_x, 10) + 2);
+    size_t limb_num = 2 * mpz_size(o->z_x) + 2;
+    o->n[0] = (mp_limb_t*)calloc(limb_num, sizeof(mp_limb_t));
+    o->n[1] = (mp_limb_t*)calloc(limb_num, sizeof(mp_limb_t));
+    mp_size_t modular_num = mpz_size(o->z_modular);
+    o->scratch = (mp_limb_t*)malloc(mpn_sec_powm_itch(mpz_size(o->z_base), bit_length, modular_num) * sizeof(mp_limb_t));
+
+#if defined(BENCHMARK_OPENSSL)
+    o->bn_ctx = BN_CTX_new();
+    o->bn_x = compare_new_bn(o->z_x);
+    o->bn_y = compare_new_bn(o->z_y);
+    o->bn_y_half = compare_new_bn(o->z_y_half);
+    o->bn_modular = compare_new_bn(o->z_modular);
+    o->bn_base = compare_new_bn(o->z_base);
+    o->bn_exponent = compare_new_bn(o->z_exponent);
+    o->bn_exponent_public = BN_new();
+    BN_set_word(o->bn_exponent_public, 65537);
+    BN_set_flags(o->bn_exponent, BN_FLG_CONSTTIME);
+    o->bn_mont = BN_MONT_CTX_new();
+    BN_MONT_CTX_set(o->bn_mont, o->bn_modular, o->bn_ctx);
+    o->bn[0] = BN_new();
+    o->bn[1] = BN_new();
+#endif
+}
+
+static void compare_operands_delete(CompareOperands* o)
+{
+    bigint_delete(&o->operand_x);
+    bigint_delete(&o->operand_y);
+    bigint_delete(&o->operand_y_half);
+    bigint_delete(&o->modular);
+    bigint_delete(&o->base);
+    bigint_delete(&o->exponent);
+    bigint_delete(&o->exponent_public);
+    bigint_delete(&o->pre_comp);
+    bigint_delete(&o->ab[0]);
+    bigint_delete(&o->ab[1]);
+    bigint_modular_context_delete(&o->context);
+    free(o->decimal);
+    free(o->ab_string);
+
+    mpz_clears(o->z_x, o->z_y, o->z_y_half, o->z_modular, o->z_base, o->z_exponent, o->z[0], o->z[1], NULL);
+    free(o->z_string);
+    free(o->n[0]);
+    free(o->n[1]);
+    free(o->scratch);
+
+#if defined(BENCHMARK_OPENSSL)
+    BN_free(o->bn_x);
+    BN_free(o->bn_y);
+    BN_free(o->bn_y_half);
+    BN_free(o->bn_modular);
+    BN_free(o->bn_base);
+    BN_free(o->bn_exponent);
+    BN_free(o->bn_exponent_public);
+    BN_free(o->bn[0]);
+    BN_free(o->bn[1]);
+    OPENSSL_free(o->bn_string);
+    BN_MONT_CTX_free(o->bn_mont);
+    BN_CTX_free(o->bn_ctx);
+#endif
+}
+
+/**
+ * @brief Runs every library once and compares its results with mpz.
+ *
+ * @return bool true if all results match.
+ */
+static bool compare_check(const CompareOperation* operation, CompareOperands* o)
+{
+    for (int library = 0; library < LIBRARY_NUM; library++)
+        if (operation->run[library] != NULL)
+            operation->run[library](o);
+
+    /* Decimal strings */
+    if (operation->value_num == 0) {
+        bool is_same = strcmp(o->ab_string, o->z_string) == 0;
+#if defined(BENCHMARK_OPENSSL)
+        if (operation->run[LIBRARY_OPENSSL] != NULL)
+            is_same = is_same && strcmp(o->bn_string, o->z_string) == 0;
+#endif
+        return is_same;
+    }
+
+    bool is_same = true;
+    mpz_t value;
+    mpz_init(value);
+    for (int idx = 0; idx < operation->value_num; idx++) {
+        compare_set_mpz(value, o->ab[idx]);
+        is_same = is_same && mpz_cmp(value, o->z[idx]) == 0;
+        if (operation->run[LIBRARY_MPN] != NULL) {
+            mpz_t limbs;
+            is_same = is_same && mpz_cmp(mpz_roinit_n(limbs, o->n[idx], o->n_size[idx]), o->z[idx]) == 0;
+        }
+#if defined(BENCHMARK_OPENSSL)
+        if (operation->run[LIBRARY_OPENSSL] != NULL) {
+            compare_set_mpz_bn(value, o->bn[idx]);
+            is_same = is_same && mpz_cmp(value, o->z[idx]) == 0;
+        }
+#endif
+    }
+    mpz_clear(value);
+    return is_same;
+}
+
+static void compare_print_header(bool is_csv)
+{
+    if (is_csv) {
+        printf("operation,bits");
+        for (int library = 0; library < LIBRARY_NUM; library++)
+            printf(",%s_ns", library_names[library]);
+        for (int library = 1; library < LIBRARY_NUM; library++)
+            printf(",ratio_%s", library_names[library]);
+        printf(",match\n");
+        return;
+    }
+    printf("%-30s %8s %13s %13s %13s %13s %9s %9s %9s  %s\n", "operation", "bits", "autobahn_ns", "mpz_ns", "mpn_ns",
+           "openssl_ns", "x_mpz", "x_mpn", "x_openssl", "match");
+}
+
+static void compare_print_row(bool is_csv, const char* name, size_t bit_length, const double* times, bool is_same)
+{
+    if (is_csv) {
+        printf("%s,%zu", name, bit_length);
+        for (int library = 0; library < LIBRARY_NUM; library++)
+            times[library] > 0 ? printf(",%.1f", times[library]) : printf(",");
+        for (int library = 1; library < LIBRARY_NUM; library++)
+            times[library] > 0 ? printf(",%.2f", times[LIBRARY_AUTOBAHN] / times[library]) : printf(",");
+        printf(",%s\n", is_same ? "ok" : "MISMATCH");
+        return;
+    }
+    printf("%-30s %8zu", name, bit_length);
+    for (int library = 0; library < LIBRARY_NUM; library++)
+        times[library] > 0 ? printf(" %13.1f", times[library]) : printf(" %13s", "-");
+    for (int library = 1; library < LIBRARY_NUM; library++)
+        times[library] > 0 ? printf(" %9.2f", times[LIBRARY_AUTOBAHN] / times[library]) : printf(" %9s", "-");
+    printf("  %s\n", is_same ? "ok" : "MISMATCH");
+}
+
+int main(int argc, char** argv)
+{
+    size_t bit_min = argc > 1 ? strtoull(argv[1], NULL, 10) : 256;
+    size_t bit_max = argc > 2 ? strtoull(argv[2], NULL, 10) : 16384;
+    bool is_csv = argc > 3 && strcmp(argv[3], "csv") == 0;
+    size_t mismatch_num = 0;
+
+    /* Invalid case */
+    if (bit_min < 2 * BITLEN_OF_WORD || bit_min < 2 * GMP_NUMB_BITS || bit_min > bit_max) {
+        printf("Invalid Case: Sizes out of range.\n");
+        return 2;
+    }
+
+    compare_print_header(is_csv);
+    for (size_t bit_length = bit_min; bit_length <= bit_max; bit_length *= 2) {
+        CompareOperands operands;
+        compare_operands_new(&operands, bit_length);
+
+        for (size_t idx = 0; idx < sizeof(compare_operations) / sizeof(compare_operations[0]); idx++) {
+            const CompareOperation* operation = &compare_operations[idx];
+            if (bit_length > operation->bit_max)
+                continue;
+
+            /* Check first, the check run also warms up every library */
+            bool is_same = compare_check(operation, &operands);
+            if (is_same == false)
+                mismatch_num++;
+
+            double times[LIBRARY_NUM] = { 0 };
+            for (int library = 0; library < LIBRARY_NUM; library++)
+                if (operation->run[library] != NULL)
+                    times[library] = compare_time(operation->run[library], &operands);
+            compare_print_row(is_csv, operation->name, bit_length, times, is_same);
+            fflush(stdout);
+        }
+
+        compare_operands_delete(&operands);
+    }
+
+    return mismatch_num == 0 ? 0 : 1;
+}
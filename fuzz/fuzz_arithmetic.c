@@ -0,0 +1,451 @@
+/*
+ * Differential fuzzing of the arithmetic: every algorithm of an operation gets the same operands and
+ * the results must agree and satisfy the algebraic identities of the operation.
+ *
+ * The first byte of an input selects the operation, the rest is decoded into operands of any length up
+ * to FUZZ_WORD_MAX words and either sign, raw or shaped into all-ones words, powers of two or normalized
+ * values to reach the carry and correction paths. A failure prints the operands and aborts.
+ *
+ * libFuzzer: clang -g -O1 -fsanitize=fuzzer,address,undefined fuzz/fuzz_arithmetic.c autobahn*.c -lpthread -lm
+ *            ./a.out -max_len=4096 corpus/
+ * no clang:  gcc -g -O1 -fsanitize=address,undefined -DFUZZ_STANDALONE fuzz/fuzz_arithmetic.c autobahn*.c -lpthread -lm
+ *            ./a.out [run_num] [seed], or ./a.out file... to replay inputs
+ */
+#include "../autobahn.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define FUZZ_WORD_MAX 80       /**< Largest operand, past the Karatsuba and Barrett thresholds of 32 and 64 words. */
+#define FUZZ_MODULAR_BITS 256  /**< Largest modulus of the exponentiations, left-to-right reduces by binary division. */
+#define FUZZ_EXPONENT_BITS 64  /**< Largest exponent of the exponentiations. */
+#define FUZZ_DEGREE_MAX 5      /**< Largest degree of rootrem. */
+#define FUZZ_OPERAND_NUM 3
+
+/** @brief Operations, selected by the first byte of an input. */
+typedef enum {
+    FUZZ_ADDITION,       /**< (x + y) - y = x, x - y = -(y - x). */
+    FUZZ_MULTIPLICATION, /**< Textbook = Karatsuba, x * (y + z) = x * y + x * z. */
+    FUZZ_SQUARING,       /**< Textbook = Karatsuba = x * x. */
+    FUZZ_DIVISION,       /**< q * d + r = a with r < d, binary = word long division. */
+    FUZZ_REDUCTION,      /**< (x * y) mod n = Barrett(x * y). */
+    FUZZ_EXPONENTIATION, /**< Left-to-right = ladder = fixed window = context window = public. */
+    FUZZ_GCD,            /**< s * x + t * y = g = gcd(x, y), g divides x and y. */
+    FUZZ_ROOT,           /**< s^k + r = a < (s + 1)^k. */
+    FUZZ_OPERATION_NUM
+} FuzzOperation;
+
+static const char* const fuzz_operation_names[FUZZ_OPERATION_NUM] = {
+    "addition", "multiplication", "squaring", "division", "reduction", "exponentiation", "gcd", "root"
+};
+
+/** @brief Remaining bytes of an input, read as zeros once exhausted. */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+} FuzzInput;
+
+/** @brief Operands of the current input, printed on a failure. */
+static Bigint* fuzz_operands[FUZZ_OPERAND_NUM];
+static FuzzOperation fuzz_operation;
+
+static uint8_t fuzz_byte(FuzzInput* input)
+{
+    if (input->size == 0)
+        return 0;
+    input->size--;
+    return *input->data++;
+}
+
+/**
+ * @brief Decodes an operand: a header byte for the sign and shape, two bytes of length, then the words.
+ *
+ * @param operand [out] Operand.
+ * @param input [in, out] Input.
+ * @param word_max [in] Most words.
+ */
+static void fuzz_operand(Bigint** operand, FuzzInput* input, size_t word_max)
+{
+    uint8_t header = fuzz_byte(input); // Bit 0: sign, bits 1-2: shape, bits 3-4: +-1 on a power of two
+    uint8_t shape = (header >> 1) & 3;
+    size_t word_num = (size_t)(fuzz_byte(input) | fuzz_byte(input) << 8) % (word_max + 1);
+
+    if (word_num == 0) {
+        bigint_set_zero(operand);
+        return;
+    }
+
+    Word digits[FUZZ_WORD_MAX] = { 0 };
+    switch (shape) {
+    case 0: // Raw bytes
+    case 3: // Raw bytes, top bit and bottom bit set: normalized divisors and odd moduli
+        for (size_t word_idx = 0; word_idx < word_num; word_idx++)
+            for (size_t byte_idx = 0; byte_idx < SIZE_OF_WORD; byte_idx++)
+                digits[word_idx] |= (Word)fuzz_byte(input) << (8 * byte_idx);
+        if (shape == 3) {
+            digits[word_num - 1] |= (Word)1 << (BITLEN_OF_WORD - 1);
+            digits[0] |= 1;
+        }
+        break;
+    case 1: // All ones, the longest carry chains
+        memset(digits, 0xff, word_num * SIZE_OF_WORD);
+        break;
+    case 2: // Power of two
+        digits[word_num - 1] = (Word)1 << (fuzz_byte(input) % BITLEN_OF_WORD);
+        break;
+    }
+
+    bigint_set_by_array(operand, digits, POSITIVE, word_num);
+    bigint_refine(*operand);
+    if (shape == 2 && (header & 8) != 0) {
+        Bigint* one = NULL;
+        bigint_new(&one, 1);
+        bigint_set_one(&one);
+        if (header & 16)
+            bigint_addition(operand, *operand, one);
+        else
+            bigint_subtraction(operand, *operand, one);
+        bigint_delete(&one);
+    }
+    if ((header & 1) && bigint_is_zero(*operand) == FALSE)
+        (*operand)->sign = NEGATIVE;
+}
+
+/**
+ * @brief Prints the failed identity and the operands, then aborts so the fuzzer keeps the input.
+ *
+ * @param identity [in] Identity that does not hold.
+ */
+static void fuzz_fail(const char* identity)
+{
+    printf("Fuzz failure: %s: %s\n", fuzz_operation_names[fuzz_operation], identity);
+    for (size_t idx = 0; idx < FUZZ_OPERAND_NUM; idx++) {
+        printf("operand_%c : %s", (int)('x' + idx), fuzz_operands[idx]->sign == NEGATIVE ? "-" : "");
+        bigint_show_hex(fuzz_operands[idx]);
+    }
+    fflush(stdout);
+    abort();
+}
+
+#define FUZZ_CHECK(condition) do { if (!(condition)) fuzz_fail(#condition); } while (0)
+
+/**
+ * @brief Compares two values, zero is equal to zero whatever its sign.
+ *
+ * @param x [in] First value.
+ * @param y [in] Second value.
+ * @return bool true if the values are equal.
+ */
+static bool fuzz_is_equal(const Bigint* x, const Bigint* y)
+{
+    if (bigint_is_zero(x) == TRUE || bigint_is_zero(y) == TRUE)
+        return bigint_is_zero(x) == bigint_is_zero(y);
+    return x->sign == y->sign && bigint_compare_abs(x, y) == 0;
+}
+
+/** @brief Sets an operand to its absolute value. */
+static void fuzz_absolute(Bigint* operand)
+{
+    operand->sign = POSITIVE;
+}
+
+/** @brief Temporaries of the checks. */
+typedef struct {
+    Bigint* t[8];
+} FuzzScratch;
+
+static void fuzz_addition(FuzzScratch* s, const Bigint* x, const Bigint* y)
+{
+    bigint_addition(&s->t[0], x, y);
+    bigint_subtraction(&s->t[1], s->t[0], y);
+    FUZZ_CHECK(fuzz_is_equal(s->t[1], x)); // (x + y) - y = x
+
+    bigint_addition(&s->t[2], y, x);
+    FUZZ_CHECK(fuzz_is_equal(s->t[2], s->t[0])); // x + y = y + x
+
+    bigint_subtraction(&s->t[3], x, y);
+    bigint_subtraction(&s->t[4], y, x);
+    bigint_addition(&s->t[5], s->t[3], s->t[4]);
+    FUZZ_CHECK(bigint_is_zero(s->t[5]) == TRUE); // x - y = -(y - x)
+}
+
+static void fuzz_multiplication(FuzzScratch* s, const Bigint* x, const Bigint* y, const Bigint* z)
+{
+    bigint_multiplication_textbook(&s->t[0], x, y);
+    bigint_multiplication_karatsuba(&s->t[1], x, y);
+    FUZZ_CHECK(fuzz_is_equal(s->t[0], s->t[1])); // Textbook = Karatsuba
+
+    bigint_multiplication_karatsuba(&s->t[2], y, x);
+    FUZZ_CHECK(fuzz_is_equal(s->t[2], s->t[1])); // x * y = y * x
+
+    bigint_addition(&s->t[3], y, z);
+    bigint_multiplication_karatsuba(&s->t[4], x, s->t[3]);
+    bigint_multiplication_karatsuba(&s->t[5], x, z);
+    bigint_addition(&s->t[6], s->t[1], s->t[5]);
+    FUZZ_CHECK(fuzz_is_equal(s->t[4], s->t[6])); // x * (y + z) = x * y + x * z
+}
+
+static void fuzz_squaring(FuzzScratch* s, const Bigint* x)
+{
+    bigint_squaring_textbook(&s->t[0], x);
+    bigint_squaring_karatsuba(&s->t[1], (Bigint*)x); // Not modified, the prototype lacks const
+    bigint_multiplication_textbook(&s->t[2], x, x);
+    FUZZ_CHECK(fuzz_is_equal(s->t[0], s->t[2])); // Textbook squaring = x * x
+    FUZZ_CHECK(fuzz_is_equal(s->t[1], s->t[2])); // Karatsuba squaring = x * x
+}
+
+/**
+ * @brief Checks q * d + r = a and 0 <= r < d for one division.
+ *
+ * @param s [in, out] Temporaries, t[6] and t[7] are left untouched.
+ * @param quotient [in] Quotient.
+ * @param remainder [in] Remainder.
+ * @param dividend [in] Non-negative dividend.
+ * @param divisor [in] Positive divisor.
+ */
+static void fuzz_division_identity(FuzzScratch* s, const Bigint* quotient, const Bigint* remainder, const Bigint* dividend, const Bigint* divisor)
+{
+    bigint_multiplication_karatsuba(&s->t[4], quotient, divisor);
+    bigint_addition(&s->t[5], s->t[4], remainder);
+    FUZZ_CHECK(fuzz_is_equal(s->t[5], dividend));                                              // q * d + r = a
+    FUZZ_CHECK(remainder->sign == POSITIVE && bigint_compare_abs(remainder, divisor) < 0); // 0 <= r < d
+}
+
+static void fuzz_division(FuzzScratch* s, Bigint* x, Bigint* y)
+{
+    fuzz_absolute(x);
+    fuzz_absolute(y);
+    if (bigint_is_zero(y) == TRUE)
+        return;
+
+    bigint_division_word_long(&s->t[0], &s->t[1], x, y);
+    fuzz_division_identity(s, s->t[0], s->t[1], x, y);
+
+    bigint_division_binary_long(&s->t[2], &s->t[3], x, y);
+    fuzz_division_identity(s, s->t[2], s->t[3], x, y);
+
+    FUZZ_CHECK(fuzz_is_equal(s->t[0], s->t[2])); // Binary quotient = word quotient
+    FUZZ_CHECK(fuzz_is_equal(s->t[1], s->t[3])); // Binary remainder = word remainder
+}
+
+static void fuzz_reduction(FuzzScratch* s, Bigint* x, Bigint* y, Bigint* n)
+{
+    fuzz_absolute(x);
+    fuzz_absolute(y);
+    fuzz_absolute(n);
+    if (bigint_is_zero(n) == TRUE)
+        return;
+
+    /* x, y < n, so x * y < n^2 is in the range of Barrett */
+    bigint_division_word_long(&s->t[0], &s->t[1], x, n);
+    bigint_division_word_long(&s->t[0], &s->t[2], y, n);
+    bigint_multiplication_karatsuba(&s->t[3], s->t[1], s->t[2]);
+
+    bigint_reduction_barrett_pre_computed(&s->t[4], n);
+    bigint_reduction_barrett(&s->t[5], s->t[3], n, s->t[4]);
+    bigint_division_word_long(&s->t[0], &s->t[6], s->t[3], n);
+    FUZZ_CHECK(fuzz_is_equal(s->t[5], s->t[6])); // (x * y) mod n = Barrett(x * y)
+
+    /* Unreduced x, when it is in the range */
+    if (x->digit_num <= 2 * n->digit_num) {
+        bigint_reduction_barrett(&s->t[5], x, n, s->t[4]);
+        FUZZ_CHECK(fuzz_is_equal(s->t[5], s->t[1])); // x mod n = Barrett(x)
+    }
+}
+
+static void fuzz_exponentiation(FuzzScratch* s, Bigint* base, Bigint* exponent, Bigint* n)
+{
+    fuzz_absolute(base);
+    fuzz_absolute(exponent);
+    fuzz_absolute(n);
+    if (bigint_is_zero(n) == TRUE)
+        return;
+
+    bigint_exponentiation_modular_montgomery_ladder(&s->t[0], base, exponent, n);
+    bigint_exponentiation_modular_left_to_right(&s->t[1], base, exponent, n);
+    FUZZ_CHECK(fuzz_is_equal(s->t[0], s->t[1])); // Left-to-right = ladder
+
+    /* Montgomery forms need an odd modulus */
+    if ((n->digits[0] & 1) == 0)
+        return;
+
+    bigint_exponentiation_modular_fixed_window(&s->t[2], base, exponent, n);
+    FUZZ_CHECK(fuzz_is_equal(s->t[0], s->t[2])); // Fixed window = ladder
+
+    ModularContext* context = NULL;
+    bigint_modular_context_new(&context, n);
+    bigint_exponentiation_modular_fixed_window_context(&s->t[3], base, exponent, context);
+    bigint_exponentiation_modular_public(&s->t[4], base, exponent, context);
+    bigint_modular_context_delete(&context);
+    FUZZ_CHECK(fuzz_is_equal(s->t[0], s->t[3])); // Context fixed window = ladder
+    FUZZ_CHECK(fuzz_is_equal(s->t[0], s->t[4])); // Public = ladder
+}
+
+static void fuzz_gcd(FuzzScratch* s, const Bigint* x, const Bigint* y)
+{
+    bigint_gcdext(&s->t[0], &s->t[1], &s->t[2], x, y);
+    bigint_gcd(&s->t[3], x, y);
+    FUZZ_CHECK(fuzz_is_equal(s->t[0], s->t[3])); // gcdext = gcd
+    FUZZ_CHECK(s->t[0]->sign == POSITIVE);       // g >= 0
+
+    bigint_multiplication_karatsuba(&s->t[4], s->t[1], x);
+    bigint_multiplication_karatsuba(&s->t[5], s->t[2], y);
+    bigint_addition(&s->t[6], s->t[4], s->t[5]);
+    FUZZ_CHECK(fuzz_is_equal(s->t[6], s->t[0])); // s * x + t * y = g
+
+    if (bigint_is_zero(s->t[0]) == TRUE)
+        return;
+
+    /* g divides |x| and |y| */
+    bigint_copy(&s->t[7], x);
+    fuzz_absolute(s->t[7]);
+    bigint_division_word_long(&s->t[4], &s->t[5], s->t[7], s->t[0]);
+    FUZZ_CHECK(bigint_is_zero(s->t[5]) == TRUE);
+    bigint_copy(&s->t[7], y);
+    fuzz_absolute(s->t[7]);
+    bigint_division_word_long(&s->t[4], &s->t[5], s->t[7], s->t[0]);
+    FUZZ_CHECK(bigint_is_zero(s->t[5]) == TRUE);
+}
+
+/**
+ * @brief Computes root^degree.
+ *
+ * @param s [in, out] Temporaries, result in t[4], uses t[5].
+ * @param root [in] Root.
+ * @param degree [in] Degree, at least 1.
+ */
+static void fuzz_power(FuzzScratch* s, const Bigint* root, Word degree)
+{
+    bigint_copy(&s->t[4], root);
+    for (size_t idx = 1; idx < degree; idx++) {
+        bigint_multiplication_karatsuba(&s->t[5], s->t[4], root);
+        bigint_copy(&s->t[4], s->t[5]);
+    }
+}
+
+static void fuzz_root(FuzzScratch* s, Bigint* x, Word degree)
+{
+    fuzz_absolute(x);
+
+    bigint_sqrtrem(&s->t[0], &s->t[1], x);
+    bigint_squaring_textbook(&s->t[2], s->t[0]);
+    bigint_addition(&s->t[3], s->t[2], s->t[1]);
+    FUZZ_CHECK(fuzz_is_equal(s->t[3], x));                                             // s^2 + r = a
+    FUZZ_CHECK(s->t[1]->sign == POSITIVE);                                             // r >= 0
+    bigint_addition(&s->t[2], s->t[0], s->t[0]);
+    FUZZ_CHECK(bigint_compare_abs(s->t[1], s->t[2]) <= 0);                             // r <= 2s, so a < (s + 1)^2
+
+    bigint_rootrem(&s->t[0], &s->t[1], x, degree);
+    fuzz_power(s, s->t[0], degree);
+    bigint_addition(&s->t[3], s->t[4], s->t[1]);
+    FUZZ_CHECK(fuzz_is_equal(s->t[3], x));                                             // s^k + r = a
+    FUZZ_CHECK(s->t[1]->sign == POSITIVE);                                             // r >= 0
+
+    bigint_set_one(&s->t[2]);
+    bigint_addition(&s->t[6], s->t[0], s->t[2]);
+    fuzz_power(s, s->t[6], degree);
+    FUZZ_CHECK(bigint_compare_abs(s->t[4], x) > 0);                                    // (s + 1)^k > a
+}
+
+/**
+ * @brief libFuzzer entry point: runs one operation on the operands decoded from the input.
+ *
+ * @param data [in] Input.
+ * @param size [in] Input length.
+ * @return int Always 0.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    FuzzInput input = { data, size };
+    fuzz_operation = (FuzzOperation)(fuzz_byte(&input) % FUZZ_OPERATION_NUM);
+
+    /* Exponentiations are slow, their operands are kept short */
+    size_t word_max = FUZZ_WORD_MAX;
+    size_t exponent_word_max = FUZZ_WORD_MAX;
+    if (fuzz_operation == FUZZ_EXPONENTIATION) {
+        word_max = FUZZ_MODULAR_BITS / BITLEN_OF_WORD;
+        exponent_word_max = FUZZ_EXPONENT_BITS / BITLEN_OF_WORD;
+    }
+
+    for (size_t idx = 0; idx < FUZZ_OPERAND_NUM; idx++) {
+        fuzz_operands[idx] = NULL; // bigint_delete does not reset the pointer of the previous input
+        bigint_new(&fuzz_operands[idx], 1);
+    }
+    fuzz_operand(&fuzz_operands[0], &input, word_max);
+    fuzz_operand(&fuzz_operands[1], &input, fuzz_operation == FUZZ_EXPONENTIATION ? exponent_word_max : word_max);
+    fuzz_operand(&fuzz_operands[2], &input, word_max);
+
+    FuzzScratch scratch = { { NULL } };
+    for (size_t idx = 0; idx < sizeof(scratch.t) / sizeof(scratch.t[0]); idx++)
+        bigint_new(&scratch.t[idx], 1);
+
+    Bigint** o = fuzz_operands;
+    switch (fuzz_operation) {
+    case FUZZ_ADDITION:       fuzz_addition(&scratch, o[0], o[1]);                                  break;
+    case FUZZ_MULTIPLICATION: fuzz_multiplication(&scratch, o[0], o[1], o[2]);                      break;
+    case FUZZ_SQUARING:       fuzz_squaring(&scratch, o[0]);                                        break;
+    case FUZZ_DIVISION:       fuzz_division(&scratch, o[0], o[1]);                                  break;
+    case FUZZ_REDUCTION:      fuzz_reduction(&scratch, o[0], o[1], o[2]);                           break;
+    case FUZZ_EXPONENTIATION: fuzz_exponentiation(&scratch, o[0], o[1], o[2]);                      break;
+    case FUZZ_GCD:            fuzz_gcd(&scratch, o[0], o[1]);                                       break;
+    case FUZZ_ROOT:           fuzz_root(&scratch, o[0], 2 + fuzz_byte(&input) % (FUZZ_DEGREE_MAX - 1)); break;
+    default:                                                                                        break;
+    }
+
+    for (size_t idx = 0; idx < sizeof(scratch.t) / sizeof(scratch.t[0]); idx++)
+        bigint_delete(&scratch.t[idx]);
+    for (size_t idx = 0; idx < FUZZ_OPERAND_NUM; idx++)
+        bigint_delete(&fuzz_operands[idx]);
+    return 0;
+}
+
+#if defined(FUZZ_STANDALONE)
+/**
+ * @brief Driver without libFuzzer: replays the files given as arguments, or runs random inputs.
+ *
+ * Random inputs are biased like the decoder: short lengths are as likely as long ones, so small and
+ * threshold-sized operands are both frequent.
+ */
+int main(int argc, char** argv)
+{
+    /* Replay, unless the first argument is a number of runs */
+    if (argc > 1 && strspn(argv[1], "0123456789") != strlen(argv[1])) {
+        for (int arg_idx = 1; arg_idx < argc; arg_idx++) {
+            FILE* file = fopen(argv[arg_idx], "rb");
+            if (file == NULL) {
+                perror("fuzz: file open error");
+                return 1;
+            }
+            uint8_t buffer[1 << 16];
+            size_t size = fread(buffer, 1, sizeof(buffer), file);
+            fclose(file);
+            LLVMFuzzerTestOneInput(buffer, size);
+        }
+        printf("fuzz: %d inputs replayed, no failure\n", argc - 1);
+        return 0;
+    }
+
+    /* Random inputs */
+    uint64_t run_num = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 10) : 0;
+    RandomXoshiro state;
+    bigint_random_xoshiro_seed(&state, seed);
+
+    uint8_t buffer[4 + FUZZ_OPERAND_NUM * (3 + FUZZ_WORD_MAX * SIZE_OF_WORD)];
+    for (uint64_t run_idx = 0; run_idx < run_num; run_idx++) {
+        bigint_random_xoshiro_fill(&state, buffer, sizeof(buffer));
+
+        /* Lengths: a random number of words up to 2^(1..8), so short operands are frequent */
+        size_t offset = 1;
+        for (size_t idx = 0; idx < FUZZ_OPERAND_NUM && offset + 3 <= sizeof(buffer); idx++) {
+            size_t word_num = (buffer[offset + 1] | (size_t)buffer[offset + 2] << 8) & ((2u << (buffer[offset + 2] % 8)) - 1);
+            buffer[offset + 1] = (uint8_t)word_num;
+            buffer[offset + 2] = (uint8_t)(word_num >> 8);
+            offset += 3 + word_num * SIZE_OF_WORD;
+        }
+        LLVMFuzzerTestOneInput(buffer, sizeof(buffer));
+    }
+    printf("fuzz: %llu random inputs, seed %llu, no failure\n", (unsigned long long)run_num, (unsigned long long)seed);
+    return 0;
+}
+#endif
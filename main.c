@@ -1,4 +1,5 @@
 #include "autobahn.h"
+#include "autobahn_evaluation.h"
 
 /* sample code list */
 void addition_and_subtraction()
@@ -268,6 +269,13 @@ void modular_exponentiation()
     printf("   result montgomery : ");
     bigint_show_hex(result);
 
+    /* Constant-time fixed window, modular must be odd */
+    bigint_exponentiation_modular_fixed_window(&result, base, exponent, modular);
+
+    /* show result */
+    printf(" result fixed window : ");
+    bigint_show_hex(result);
+
     /* free memory */
     bigint_delete(&base);
     bigint_delete(&exponent);
@@ -277,8 +285,17 @@ void modular_exponentiation()
     printf("\n");
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    /* Verification engine: verify [directory] [thread_num], exits with 1 on a mismatch */
+    if (argc > 1 && strcmp(argv[1], "verify") == 0) {
+        VerificationConfig config;
+        bigint_verification_config_default(&config);
+        if (argc > 2) config.directory = argv[2];
+        if (argc > 3) config.thread_num = (size_t)strtoul(argv[3], NULL, 10);
+        return bigint_verification_run(&config) ? 0 : 1;
+    }
+
     /* Sample Code */
     addition_and_subtraction();
     multiplication();